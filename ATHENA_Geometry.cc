@@ -1,44 +1,119 @@
 #include "DetectorConstruction.hh"
 #include "ActionInitialization.hh"
+#include "EmPhysics.hh"
+#include "PhysicsConfig.hh"
+#include "PhysicsTableCache.hh"
+#include "ShardConfig.hh"
 
 #include "G4RunManagerFactory.hh"
+#include "G4MTRunManager.hh"
+#include "G4Threading.hh"
 #include "G4UImanager.hh"
 #include "G4UIcommand.hh"
-#include "QGSP_BERT.hh"
+#include "G4PhysListFactory.hh"
+#include "G4StepLimiterPhysics.hh"
+#include "G4FastSimulationPhysics.hh"
 #include "Randomize.hh"
 #include "G4VisExecutive.hh"
 #include "G4UIExecutive.hh"
 
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <utility>
+#include <vector>
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
 namespace {
   void PrintUsage() {
     G4cerr << " Usage: " << G4endl;
-    G4cerr << " ATHENA_Geometry [-m macro ] [-u UIsession] [-t nThreads]" 
-          << G4endl;
-    G4cerr << "   note: -t option is available only for multi-threaded mode."
+    G4cerr << " ATHENA_Geometry [-m macro ] [-u UIsession] [-t nThreads|auto]"
+           << " [-r runManager] [-c eventsPerChunk]" << G4endl;
+    G4cerr << "                 [-p physicsList] [-e emOption] [-f fastSimulation]"
+           << " [-s index/count]" << G4endl;
+    G4cerr << "   runManager: default, serial, mt, tasking or tbb" << G4endl;
+    G4cerr << "   eventsPerChunk: events dispatched to a thread at once, e.g. 1;"
+           << " the Geant4 default if not given" << G4endl;
+    G4cerr << "   physicsList: reference list, e.g. QGSP_BERT (default), FTFP_BERT,"
+           << " FTFP_BERT_HP" << G4endl;
+    G4cerr << "   emOption: opt0 (default), opt1, opt2, opt3, opt4, liv or pen" << G4endl;
+    G4cerr << "   fastSimulation: on or off (default), the process needed by"
+           << " /ATHENA/fastsim/ and /ATHENA/showerlib/use" << G4endl;
+    G4cerr << "   index/count: shard run by /ATHENA/shard/beamOn, e.g. 3/16" << G4endl;
+    G4cerr << "   note: -t, -c options are available only for multi-threaded mode."
            << G4endl;
   }
+
+#ifdef G4MULTITHREADED
+  // Cores the process may use: those of its CPU affinity mask, limited by
+  // the CPU quota of its cgroup (v2 cpu.max or v1 cpu.cfs_quota_us), as set
+  // by batch systems and containers
+  G4int GetAvailableCores() {
+    G4int nCores = G4Threading::G4GetNumberOfCores();
+#ifdef __linux__
+    cpu_set_t cpuSet;
+    if ( sched_getaffinity(0, sizeof(cpuSet), &cpuSet) == 0 ) {
+      nCores = std::min(nCores, G4int(CPU_COUNT(&cpuSet)));
+    }
+    G4double quota = -1., period = 0.;
+    std::ifstream cpuMax("/sys/fs/cgroup/cpu.max");
+    std::string value;
+    if ( cpuMax >> value >> period && value != "max" ) {
+      quota = std::atof(value.c_str());
+    }
+    else {
+      std::ifstream cfsQuota("/sys/fs/cgroup/cpu/cpu.cfs_quota_us");
+      std::ifstream cfsPeriod("/sys/fs/cgroup/cpu/cpu.cfs_period_us");
+      if ( ! ( cfsQuota >> quota && cfsPeriod >> period ) ) quota = -1.;
+    }
+    if ( quota > 0. && period > 0. ) {
+      nCores = std::min(nCores, G4int(std::ceil(quota/period)));
+    }
+#endif
+    return std::max(nCores, 1);
+  }
+#endif
 }
 
 int main(int argc,char** argv)
 {
   // Evaluate arguments
   //
-  if ( argc > 7 ) {
+  if ( argc > 19 ) {
     PrintUsage();
     return 1;
   }
   
   G4String macro;
   G4String session;
+  G4String physicsListName = "QGSP_BERT";
+  G4String emOption = "opt0";
+  G4String fastSimulation = "off";
+  G4String shard;
+  G4String runManagerName = "default";
 #ifdef G4MULTITHREADED
   G4int nThreads = 0;
+  G4int nEventsPerChunk = 0;
 #endif
   for ( G4int i=1; i<argc; i=i+2 ) {
     if      ( G4String(argv[i]) == "-m" ) macro = argv[i+1];
     else if ( G4String(argv[i]) == "-u" ) session = argv[i+1];
+    else if ( G4String(argv[i]) == "-p" ) physicsListName = argv[i+1];
+    else if ( G4String(argv[i]) == "-e" ) emOption = argv[i+1];
+    else if ( G4String(argv[i]) == "-f" ) fastSimulation = argv[i+1];
+    else if ( G4String(argv[i]) == "-s" ) shard = argv[i+1];
+    else if ( G4String(argv[i]) == "-r" ) runManagerName = argv[i+1];
 #ifdef G4MULTITHREADED
     else if ( G4String(argv[i]) == "-t" ) {
-      nThreads = G4UIcommand::ConvertToInt(argv[i+1]);
+      nThreads = ( G4String(argv[i+1]) == "auto" )
+                 ? GetAvailableCores() : G4UIcommand::ConvertToInt(argv[i+1]);
+    }
+    else if ( G4String(argv[i]) == "-c" ) {
+      nEventsPerChunk = G4UIcommand::ConvertToInt(argv[i+1]);
     }
 #endif
     else {
@@ -46,6 +121,50 @@ int main(int argc,char** argv)
       return 1;
     }
   }  
+
+  // The EM option is set by EmPhysics, so only the reference lists
+  // without EM suffix are accepted
+  G4PhysListFactory physListFactory;
+  const auto& physicsLists = physListFactory.AvailablePhysLists();
+  if ( std::find(physicsLists.begin(), physicsLists.end(), physicsListName)
+         == physicsLists.end() || ! EmPhysics::IsOption(emOption) ) {
+    G4cerr << "Unknown physics list " << physicsListName << " or EM option "
+           << emOption << G4endl;
+    PrintUsage();
+    return 1;
+  }
+  if ( fastSimulation != "on" && fastSimulation != "off" ) {
+    G4cerr << "Unknown fast simulation option " << fastSimulation << G4endl;
+    PrintUsage();
+    return 1;
+  }
+
+  // The task-based run managers dispatch the events to the threads with
+  // work stealing (tasking: PTL, tbb: TBB, if Geant4 is built with it)
+  const std::vector<std::pair<G4String, G4RunManagerType>> runManagerTypes
+    = { { "default", G4RunManagerType::Default }, { "serial", G4RunManagerType::Serial },
+        { "mt", G4RunManagerType::MT }, { "tasking", G4RunManagerType::Tasking },
+        { "tbb", G4RunManagerType::TBB } };
+  auto runManagerType = std::find_if(runManagerTypes.begin(), runManagerTypes.end(),
+    [&runManagerName](const std::pair<G4String, G4RunManagerType>& type) {
+      return type.first == runManagerName; });
+  if ( runManagerType == runManagerTypes.end() ) {
+    G4cerr << "Unknown run manager " << runManagerName << G4endl;
+    PrintUsage();
+    return 1;
+  }
+
+  // The shard is given as index/count
+  if ( shard.size() ) {
+    auto slash = shard.find('/');
+    if ( slash == std::string::npos
+         || ! ShardConfig::Instance()->SetShard(
+                G4UIcommand::ConvertToInt(shard.substr(0, slash).c_str()),
+                G4UIcommand::ConvertToInt(shard.substr(slash+1).c_str())) ) {
+      PrintUsage();
+      return 1;
+    }
+  }
   
   // Detect interactive mode (if no macro provided) and define UI session
   //
@@ -54,16 +173,38 @@ int main(int argc,char** argv)
     ui = new G4UIExecutive(argc, argv, session);
   }
 
-  // Use default random engine. Important when using multi-threading apparently
+  // The default random engine is kept; each event is reseeded with seeds
+  // derived from the run seed (/ATHENA/random/seed) and its eventID, so
+  // that it does not depend on the threads and can be replayed (see
+  // RandomConfig)
 
-  // Construct the default run manager
+  // Construct the run manager
   //
   auto* runManager =
-    G4RunManagerFactory::CreateRunManager(G4RunManagerType::Default);
+    G4RunManagerFactory::CreateRunManager(runManagerType->second);
 #ifdef G4MULTITHREADED
   if ( nThreads > 0 ) { 
     runManager->SetNumberOfThreads(nThreads);
   }  
+  // Only an explicit -c overrides the dispatch of Geant4. The events per
+  // task of the task-based run managers are only set by the environment
+  if ( nEventsPerChunk > 0 ) {
+    auto mtRunManager = dynamic_cast<G4MTRunManager*>(runManager);
+    if ( mtRunManager ) mtRunManager->SetEventModulo(nEventsPerChunk);
+    if ( G4RunManagerFactory::GetMasterRunManagerType() == G4RunManagerType::Tasking
+         || G4RunManagerFactory::GetMasterRunManagerType() == G4RunManagerType::TBB ) {
+      setenv("G4FORCE_EVENTS_PER_TASK", std::to_string(nEventsPerChunk).c_str(), 0);
+    }
+  }
+  G4cout << "---> Run manager: "
+         << G4RunManagerFactory::GetName(G4RunManagerFactory::GetMasterRunManagerType())
+         << ", " << runManager->GetNumberOfThreads() << " threads, ";
+  if ( nEventsPerChunk > 0 ) {
+    G4cout << nEventsPerChunk << " events per chunk" << G4endl;
+  }
+  else {
+    G4cout << "default event chunks" << G4endl;
+  }
 #endif
 
   // Set mandatory initialization classes
@@ -71,7 +212,28 @@ int main(int argc,char** argv)
   auto detConstruction = new DetectorConstruction();
   runManager->SetUserInitialization(detConstruction);
 
-  auto physicsList = new QGSP_BERT;
+  auto physicsConfig = PhysicsConfig::Instance();
+  physicsConfig->SetPhysicsList(physicsListName);
+  physicsConfig->SetEmOption(emOption);
+  physicsConfig->SetFastSimulation(fastSimulation == "on");
+  auto physicsList = physListFactory.GetReferencePhysList(physicsListName);
+  // EM option and photon transport options of the ECal (see PhysicsConfig)
+  physicsList->ReplacePhysics(new EmPhysics(emOption));
+  // Store and retrieve the physics tables (owned by the state manager)
+  new PhysicsTableCache(physicsList);
+  // Step limits of the detector regions (see RegionConfig)
+  physicsList->RegisterPhysics(new G4StepLimiterPhysics());
+  // Shower parameterisation of the ECal (see FastSimConfig) and shower
+  // libraries of the ECal and HCal (see ShowerLibraryConfig); only on
+  // request, as the process is added to every step of these particles
+  if ( physicsConfig->IsFastSimulation() ) {
+    auto fastSimulationPhysics = new G4FastSimulationPhysics();
+    for ( const auto& particle : { "e-", "e+", "gamma", "pi+", "pi-", "kaon+", "kaon-",
+                                   "proton", "neutron" } ) {
+      fastSimulationPhysics->ActivateFastSimulation(particle);
+    }
+    physicsList->RegisterPhysics(fastSimulationPhysics);
+  }
   runManager->SetUserInitialization(physicsList);
   
   auto actionInitialization = new ActionInitialization();
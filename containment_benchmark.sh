@@ -0,0 +1,57 @@
+#!/bin/bash
+# Containment monitor benchmark: runs the same beam configuration at several
+# energies without the monitor and with the events above the containment
+# limits tagged or aborted, and reports the run time, the fraction of stopped
+# events and the time saved estimated by RunAction.
+# Run from the build directory: ./containment_benchmark.sh [num_events] [num_threads] [tail] [edge]
+set -e
+
+num_events=${1:-500}
+num_threads=${2:-4}
+tail_fraction=${3:-0.01}
+edge_fraction=${4:-0}
+particle="pi+"
+
+energies=(20 50 100)
+modes=(off tag abort)
+
+macro="containment_benchmark.mac"
+report="containment_benchmark.txt"
+echo "energy(GeV) mode run_time(s) stopped/events saved(s) saved(%)" > $report
+
+for energy in "${energies[@]}"
+do
+	for mode in "${modes[@]}"
+	do
+		output="containment_benchmark_${energy}GeV_${mode}"
+		cat > $macro <<MAC
+/ATHENA/analysis/containment ${mode}
+/ATHENA/analysis/containmentCut ${tail_fraction} ${edge_fraction}
+/analysis/setFileName ${output}
+/run/initialize
+/run/setCut .01 mm
+/gps/particle ${particle}
+/gps/ene/type Mono
+/gps/ene/mono ${energy} GeV
+/gps/pos/type Plane
+/gps/pos/shape Square
+/gps/pos/rot1 1 0 0
+/gps/pos/rot2 0 1 0
+/gps/pos/halfx 0.25 cm
+/gps/pos/halfy 0.25 cm
+/gps/pos/centre 2.5025 2.4747 -8.5 cm
+/gps/direction 0 .08715574275 .9961946981
+/run/beamOn ${num_events}
+MAC
+		echo "Running ${energy} GeV, containment ${mode}"
+		log="${output}.log"
+		./ATHENA_Geometry -m $macro -t ${num_threads} > $log 2>&1
+		run_time=$(grep "run time" $log | sed 's/.*run time: \([0-9.e+]*\) s/\1/')
+		stopped=$(grep "events stopped" $log | sed 's/.*Containment: \([0-9.e+]*\) of \([0-9.e+]*\) events.*/\1\/\2/')
+		saved=$(grep "estimated time saved" $log | sed 's/.*saved: \([0-9.e+-]*\) s, \([0-9.e+-]*\)%.*/\1 \2/')
+		echo "${energy} ${mode} ${run_time} ${stopped:--} ${saved:-- -}" >> $report
+		rm -f ${output}.root
+	done
+done
+
+column -t $report
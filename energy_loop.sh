@@ -1,23 +1,26 @@
 #!/bin/bash
+# Energy scan: simulates the energies of the resolution study back-to-back in
+# one process (/ATHENA/scan/), so that the geometry, the physics and the
+# worker threads are set up once. Each energy is written to
+# <particle>_<energy>GeV, with the settings of mymac_WScFi.mac.
+# Run from the build directory: ./energy_loop.sh [num_events] [num_threads] [particle]
 set -e
 
-filename="../mymac_WScFi.mac"
-num_threads=12
+num_events=${1:-5000}
+num_threads=${2:-12}
+particle=${3:-pi+}
+angle=5
 
-particle="pi+"
-
-num_events=5000
 energies=(1 2 5 10 20 30 40 50 60 70 80 90 100)
 
-for (( k=0; k<13; k++ ))
+# The settings of mymac_WScFi.mac without its run, then one point per energy
+macro="energy_loop.mac"
+grep -v "^/run/beamOn" mymac_WScFi.mac > $macro
+for energy in "${energies[@]}"
 do
-
-	sed -i "s/\/analysis\/setFileName .*/\/analysis\/setFileName ${particle}_${energies[k]}GeV/" $filename
-	sed -i "s/\/gps\/particle .*/\/gps\/particle ${particle}/" $filename
-	sed -i "s/\/gps\/ene\/mono .*/\/gps\/ene\/mono ${energies[k]} GeV/" $filename
-	sed -i "s/\/run\/beamOn .*/\/run\/beamOn ${num_events}/" $filename
-	make
-	echo "Working on energy ${energies[k]}"
-	echo "./ATHENA_Geometry -m mymac_WScFi.mac -t ${num_threads}"
-	time ./ATHENA_Geometry -m mymac_WScFi.mac -t ${num_threads}
+	echo "/ATHENA/scan/addPoint ${particle} ${energy} GeV ${angle} deg ${num_events} ${particle}_${energy}GeV" >> $macro
 done
+echo "/ATHENA/scan/run" >> $macro
+
+echo "./ATHENA_Geometry -m ${macro} -t ${num_threads}"
+time ./ATHENA_Geometry -m $macro -t ${num_threads}
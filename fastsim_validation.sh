@@ -0,0 +1,51 @@
+#!/bin/bash
+# ECal fast simulation validation: runs electrons at several energies with
+# every other event parameterised by ECalShowerModel, and reports the
+# fast/full ratios of the ECal active and total energy, of the sampling
+# fraction and of the shower width, with the speed-up printed by RunAction.
+# Run from the build directory: ./fastsim_validation.sh [num_events] [num_threads] [active_scale]
+set -e
+
+num_events=${1:-1000}
+num_threads=${2:-4}
+active_scale=${3:-1}
+particle="e-"
+
+energies=(1 5 10 20)
+
+macro="fastsim_validation.mac"
+report="fastsim_validation.txt"
+echo "energy(GeV) active total sampling widthX widthY speed-up" > $report
+
+for energy in "${energies[@]}"
+do
+	output="fastsim_validation_${energy}GeV"
+	cat > $macro <<MAC
+/ATHENA/fastsim/mode validate
+/ATHENA/fastsim/activeScale ${active_scale}
+/analysis/setFileName ${output}
+/run/initialize
+/run/setCut .01 mm
+/gps/particle ${particle}
+/gps/ene/type Mono
+/gps/ene/mono ${energy} GeV
+/gps/pos/type Plane
+/gps/pos/shape Square
+/gps/pos/rot1 1 0 0
+/gps/pos/rot2 0 1 0
+/gps/pos/halfx 0.25 cm
+/gps/pos/halfy 0.25 cm
+/gps/pos/centre 2.5025 2.4747 -8.5 cm
+/gps/direction 0 .08715574275 .9961946981
+/run/beamOn ${num_events}
+MAC
+	echo "Running ${energy} GeV"
+	log="${output}.log"
+	./ATHENA_Geometry -m $macro -t ${num_threads} -f on > $log 2>&1
+	ratio() { grep "$1" $log | tail -1 | awk '{ print $NF }'; }
+	speedup=$(grep "speed-up:" $log | sed 's/.*speed-up: \([0-9.e+-]*\)/\1/')
+	echo "${energy} $(ratio 'ECal active') $(ratio 'ECal total') $(ratio 'ECal sampling') $(ratio 'ECal width X') $(ratio 'ECal width Y') ${speedup:--}" >> $report
+	rm -f ${output}.root
+done
+
+column -t $report
@@ -1,4 +1,3 @@
-
 /// \file Analysis.hh
 /// \brief Selection of the analysis technology
 
@@ -6,5 +5,40 @@
 #define Analysis_h 1
 
 #include "g4root.hh"
+#include "OutputConfig.hh"
+#include "RowSink.hh"
+
+/// Fill an energy column which was booked as float or double according
+/// to the ntuple precision in OutputConfig
+
+inline void FillNtupleEnergyColumn(G4int ntupleId, G4int columnId, G4double value)
+{
+  auto analysisManager = G4AnalysisManager::Instance();
+  if ( OutputConfig::Instance()->IsFloatPrecision(ntupleId) ) {
+    analysisManager->FillNtupleFColumn(ntupleId, columnId, G4float(value));
+  }
+  else {
+    analysisManager->FillNtupleDColumn(ntupleId, columnId, value);
+  }
+}
+
+/// RowSink filling the ntuples of the analysis manager of this thread
+
+class NtupleRowSink : public RowSink
+{
+  public:
+    virtual void FillEnergyColumn(int ntupleId, int columnId, double value) {
+      FillNtupleEnergyColumn(ntupleId, columnId, value);
+    }
+    virtual void FillPositionColumn(int ntupleId, int columnId, double value) {
+      G4AnalysisManager::Instance()->FillNtupleDColumn(ntupleId, columnId, value);
+    }
+    virtual void FillIntColumn(int ntupleId, int columnId, int value) {
+      G4AnalysisManager::Instance()->FillNtupleIColumn(ntupleId, columnId, value);
+    }
+    virtual void AddRow(int ntupleId) {
+      G4AnalysisManager::Instance()->AddNtupleRow(ntupleId);
+    }
+};
 
 #endif
@@ -0,0 +1,151 @@
+/// \file AnalysisConfig.hh
+/// \brief Definition of the AnalysisConfig class
+
+#ifndef AnalysisConfig_h
+#define AnalysisConfig_h 1
+
+#include "globals.hh"
+
+#include <vector>
+
+class AnalysisMessenger;
+
+/// Configuration of the analysis done during the run, shared by the master
+/// and worker threads.
+///
+/// The settings are filled on the master via the /ATHENA/analysis/ commands
+/// (see AnalysisMessenger) and are read by the workers at the beginning of
+/// each run:
+/// - resolution scan (see ResolutionScan): on/off, grid of ECal weights,
+///   tail-catcher veto, HCal tile cut and binning of the energy histograms;
+/// - shower maps (see ShowerMaps): on/off;
+/// - clustering of the ECal blocks and HCal towers (see TopoClustering):
+///   on/off, seed and neighbour thresholds of each detector;
+/// - containment monitor (see ContainmentMonitor): off/tag/abort, limits on
+///   the tail-catcher ratio of the analysis and on the edge deposit as a
+///   fraction of the primary energy.
+
+class AnalysisConfig
+{
+  public:
+    static AnalysisConfig* Instance();
+    ~AnalysisConfig();
+
+    // set methods
+    void SetResolutionScan(G4bool scan);
+    void SetWeights(G4double first, G4double step, G4int nofWeights);
+    void SetTailVeto(G4double fraction);
+    void SetTileCut(G4double energy);
+    void SetEnergyHistogram(G4int nofBins, G4double maxEnergy);
+    void SetShowerMaps(G4bool maps);
+    void SetClustering(G4bool clustering);
+    void SetClusterThresholds(G4double ecalSeed, G4double ecalNeighbour,
+                              G4double hcalSeed, G4double hcalNeighbour);
+    void SetContainmentMode(const G4String& mode);
+    void SetContainmentCut(G4double tailFraction, G4double edgeFraction);
+
+    // get methods
+    G4bool   IsResolutionScan() const;
+    std::vector<G4double> GetWeights() const;
+    G4double GetTailVeto() const;
+    G4double GetTileCut() const;
+    G4int    GetNofEnergyBins() const;
+    G4double GetMaxEnergy() const;
+    G4bool   IsShowerMaps() const;
+    G4bool   IsClustering() const;
+    G4double GetECalSeedThreshold() const;
+    G4double GetECalNeighbourThreshold() const;
+    G4double GetHCalSeedThreshold() const;
+    G4double GetHCalNeighbourThreshold() const;
+    const G4String& GetContainmentMode() const;
+    G4double GetContainmentTailFraction() const;
+    G4double GetContainmentEdgeFraction() const;
+
+    void Print() const;
+
+  private:
+    AnalysisConfig();
+
+    static AnalysisConfig* fInstance;
+
+    AnalysisMessenger* fMessenger;
+    G4bool   fResolutionScan;  ///< Accumulate the resolution scan
+    G4double fFirstWeight;     ///< ECal weight grid: first value,
+    G4double fWeightStep;      ///< step
+    G4int    fNofWeights;      ///< and number of weights
+    G4double fTailVeto;        ///< Maximum tail-catcher fraction of an event
+    G4double fTileCut;         ///< Minimum energy of an HCal tile
+    G4int    fNofEnergyBins;   ///< Binning of the energy histograms
+    G4double fMaxEnergy;
+    G4bool   fShowerMaps;      ///< Accumulate the run-averaged shower maps
+    G4bool   fClustering;      ///< Cluster the ECal blocks and HCal towers
+    G4double fECalSeed;        ///< Cluster thresholds on the active energy
+    G4double fECalNeighbour;
+    G4double fHCalSeed;
+    G4double fHCalNeighbour;
+    G4String fContainmentMode; ///< off, tag or abort
+    G4double fContainmentTail; ///< Limit of tail/(ECal/weight + HCal),
+    G4double fContainmentEdge; ///< of edge/primary energy; 0 disables a limit
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+inline G4bool AnalysisConfig::IsResolutionScan() const {
+  return fResolutionScan;
+}
+
+inline G4double AnalysisConfig::GetTailVeto() const {
+  return fTailVeto;
+}
+
+inline G4double AnalysisConfig::GetTileCut() const {
+  return fTileCut;
+}
+
+inline G4int AnalysisConfig::GetNofEnergyBins() const {
+  return fNofEnergyBins;
+}
+
+inline G4double AnalysisConfig::GetMaxEnergy() const {
+  return fMaxEnergy;
+}
+
+inline G4bool AnalysisConfig::IsShowerMaps() const {
+  return fShowerMaps;
+}
+
+inline G4bool AnalysisConfig::IsClustering() const {
+  return fClustering;
+}
+
+inline G4double AnalysisConfig::GetECalSeedThreshold() const {
+  return fECalSeed;
+}
+
+inline G4double AnalysisConfig::GetECalNeighbourThreshold() const {
+  return fECalNeighbour;
+}
+
+inline G4double AnalysisConfig::GetHCalSeedThreshold() const {
+  return fHCalSeed;
+}
+
+inline G4double AnalysisConfig::GetHCalNeighbourThreshold() const {
+  return fHCalNeighbour;
+}
+
+inline const G4String& AnalysisConfig::GetContainmentMode() const {
+  return fContainmentMode;
+}
+
+inline G4double AnalysisConfig::GetContainmentTailFraction() const {
+  return fContainmentTail;
+}
+
+inline G4double AnalysisConfig::GetContainmentEdgeFraction() const {
+  return fContainmentEdge;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,51 @@
+/// \file AnalysisMessenger.hh
+/// \brief Definition of the AnalysisMessenger class
+
+#ifndef AnalysisMessenger_h
+#define AnalysisMessenger_h 1
+
+#include "G4UImessenger.hh"
+#include "globals.hh"
+
+class AnalysisConfig;
+class G4UIdirectory;
+class G4UIcommand;
+class G4UIcmdWithABool;
+class G4UIcmdWithAString;
+class G4UIcmdWithADouble;
+class G4UIcmdWithADoubleAndUnit;
+class G4UIcmdWithoutParameter;
+
+/// Messenger for the AnalysisConfig class.
+///
+/// Defines the /ATHENA/analysis/ commands. The commands are executed on the
+/// master only, the workers read the shared AnalysisConfig.
+
+class AnalysisMessenger : public G4UImessenger
+{
+  public:
+    AnalysisMessenger(AnalysisConfig* config);
+    virtual ~AnalysisMessenger();
+
+    virtual void SetNewValue(G4UIcommand* command, G4String newValue);
+
+  private:
+    AnalysisConfig*            fConfig;
+
+    G4UIdirectory*             fAnalysisDir;
+    G4UIcmdWithABool*          fResolutionScanCmd;
+    G4UIcommand*               fWeightsCmd;
+    G4UIcmdWithADouble*        fTailVetoCmd;
+    G4UIcmdWithADoubleAndUnit* fTileCutCmd;
+    G4UIcommand*               fEnergyHistogramCmd;
+    G4UIcmdWithABool*          fShowerMapsCmd;
+    G4UIcmdWithABool*          fClusteringCmd;
+    G4UIcommand*               fClusterThresholdsCmd;
+    G4UIcmdWithAString*        fContainmentCmd;
+    G4UIcommand*               fContainmentCutCmd;
+    G4UIcmdWithoutParameter*   fPrintCmd;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
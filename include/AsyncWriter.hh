@@ -0,0 +1,141 @@
+/// \file AsyncWriter.hh
+/// \brief Definition of the AsyncWriter class
+
+#ifndef AsyncWriter_h
+#define AsyncWriter_h 1
+
+#include "globals.hh"
+#include "BoundedQueue.hh"
+#include "ColumnarFormat.hh"
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+class ColumnarWriter;
+class TensorWriter;
+struct EventRecord;
+
+/// Writer thread decoupling the columnar output from the event processing.
+///
+/// The workers hand their EventRecord over with Push(): the record is
+/// swapped with a recycled one and its pointer is pushed into a lock-free
+/// bounded queue, so a worker only pays for a few atomic operations per
+/// event. A dedicated thread pops the records, serialises and compresses
+/// them into a single columnar file and/or a single set of tensor files,
+/// and returns them to the pool.
+///
+/// When the queue is full the workers wait (back-pressure); the queue depth
+/// and the number and duration of these waits are reported at the end of
+/// the run. The writer is started and stopped by the master RunAction,
+/// around the event loop of all workers.
+///
+/// The writer thread has no Geant4 state: the first write error is kept,
+/// the records pushed afterwards are dropped, and the error is raised by
+/// Stop() on the master after the files are closed.
+///
+/// Optionally the records are written in eventID order, starting from the
+/// first eventID of the run given to Start() (that of the shard or of the
+/// replayed event): a record arriving before its predecessors is held back
+/// in a reorder buffer of at most queueSize records. When the buffer is full the lowest
+/// held record is written anyway, and the events still missing are written
+/// when they arrive and counted as out of order.
+
+class AsyncWriter
+{
+  public:
+    static AsyncWriter* Instance();
+    ~AsyncWriter();
+
+    // Start the writer thread; takes the ownership of the opened writers,
+    // either of which may be null; the records are reordered from the
+    // eventID of the first event of the run
+    void Start(ColumnarWriter* columnarWriter, TensorWriter* tensorWriter,
+               G4int firstEventID = 0);
+    // Write the queued records, stop the thread and close the files;
+    // the given run-level histograms are written to the columnar file
+    // before it is closed; the writers stay available until the next Start()
+    void Stop(const std::vector<ColumnarFormat::Histogram>& histograms = {});
+
+    // Hand over a record; it is replaced by an empty one of the pool
+    void Push(EventRecord& record);
+
+    // get methods
+    G4bool        IsRunning() const;
+    std::size_t   GetQueueDepth() const;
+    const ColumnarWriter* GetColumnarWriter() const;
+    const TensorWriter*   GetTensorWriter() const;
+
+    void PrintMetrics() const;
+
+  private:
+    AsyncWriter();
+
+    void Run();
+    void Reorder(EventRecord* record);
+    void Write(EventRecord* record);
+    void UpdateMaxDepth(std::size_t depth);
+
+    static AsyncWriter* fInstance;
+
+    ColumnarWriter*              fColumnarWriter;
+    TensorWriter*                fTensorWriter;
+    BoundedQueue<EventRecord*>*  fQueue;       ///< Records to be written
+    BoundedQueue<EventRecord*>*  fFreeRecords; ///< Written records for reuse
+    std::thread                  fThread;
+    G4bool                       fRunning;
+    std::atomic<bool>            fStopRequested;
+
+    // settings of the current run
+    std::size_t fQueueSize;   ///< Configured size, bound of the reorder buffer
+    G4int       fFlushEvents;
+    G4double    fFlushSize;
+    G4bool      fReorder;
+    G4bool      fCellTables;
+
+    // writer thread state
+    std::string                   fError;       ///< First write error
+    std::atomic<bool>             fFailed;      ///< Set with fError
+    std::map<G4int, EventRecord*> fHeldRecords; ///< Reorder buffer
+    G4int                         fNextEventID; ///< Next eventID in order
+    G4int                         fNofEventsSinceFlush;
+
+    // metrics; the counters are updated by the workers and the writer
+    std::atomic<std::uint64_t> fNofPushed;
+    std::atomic<std::uint64_t> fNofStalls;     ///< Pushes which found the queue full
+    std::atomic<std::uint64_t> fStallTime;     ///< Time waited by the workers [ns]
+    std::atomic<std::uint64_t> fDepthSum;      ///< Sum of the depths seen at push
+    std::atomic<std::size_t>   fMaxDepth;
+    std::uint64_t              fNofWritten;    ///< Writer thread only
+    std::uint64_t              fNofFlushes;    ///< Writer thread only
+    std::uint64_t              fNofHeld;       ///< Writer thread only
+    std::size_t                fMaxHeld;       ///< Writer thread only
+    std::uint64_t              fNofOutOfOrder; ///< Writer thread only
+    G4double                   fBusyTime;      ///< Writer thread only [s]
+    G4double                   fRunTime;       ///< From Start() to Stop() [s]
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+inline G4bool AsyncWriter::IsRunning() const {
+  return fRunning;
+}
+
+inline std::size_t AsyncWriter::GetQueueDepth() const {
+  return fQueue ? fQueue->Size() : 0;
+}
+
+inline const ColumnarWriter* AsyncWriter::GetColumnarWriter() const {
+  return fColumnarWriter;
+}
+
+inline const TensorWriter* AsyncWriter::GetTensorWriter() const {
+  return fTensorWriter;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,155 @@
+/// \file BoundedQueue.hh
+/// \brief Definition of the BoundedQueue class template
+
+#ifndef BoundedQueue_h
+#define BoundedQueue_h 1
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+/// Lock-free bounded multi-producer multi-consumer queue.
+///
+/// Each cell carries a sequence number telling whether it is free for the
+/// producer of a given position or holds data for the consumer of that
+/// position (D. Vyukov's bounded MPMC queue). TryPush() and TryPop() never
+/// block: they return false when the queue is full or empty and the caller
+/// decides how to wait. The capacity is rounded up to a power of two.
+/// The class does not depend on Geant4.
+
+template <typename T>
+class BoundedQueue
+{
+  public:
+    explicit BoundedQueue(std::size_t capacity);
+
+    BoundedQueue(const BoundedQueue&) = delete;
+    BoundedQueue& operator=(const BoundedQueue&) = delete;
+
+    bool TryPush(const T& value);
+    bool TryPop(T& value);
+
+    // Number of elements; only approximate while other threads are active
+    std::size_t Size() const;
+    std::size_t Capacity() const;
+
+  private:
+    struct Cell
+    {
+      std::atomic<std::size_t> sequence;
+      T                        value;
+    };
+
+    static std::size_t RoundCapacity(std::size_t capacity);
+
+    std::vector<Cell>        fCells;
+    const std::size_t        fMask;
+    // The positions are on separate cache lines so that producers and
+    // consumers do not invalidate each other's line
+    alignas(64) std::atomic<std::size_t> fPushPosition;
+    alignas(64) std::atomic<std::size_t> fPopPosition;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+template <typename T>
+std::size_t BoundedQueue<T>::RoundCapacity(std::size_t capacity)
+{
+  std::size_t rounded = 2;
+  while ( rounded < capacity ) rounded <<= 1;
+  return rounded;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+template <typename T>
+BoundedQueue<T>::BoundedQueue(std::size_t capacity)
+ : fCells(RoundCapacity(capacity)),
+   fMask(fCells.size() - 1),
+   fPushPosition(0),
+   fPopPosition(0)
+{
+  for ( std::size_t i=0; i<fCells.size(); ++i ) {
+    fCells[i].sequence.store(i, std::memory_order_relaxed);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+template <typename T>
+bool BoundedQueue<T>::TryPush(const T& value)
+{
+  auto position = fPushPosition.load(std::memory_order_relaxed);
+  for ( ;; ) {
+    auto& cell = fCells[position & fMask];
+    auto sequence = cell.sequence.load(std::memory_order_acquire);
+    auto diff = std::ptrdiff_t(sequence) - std::ptrdiff_t(position);
+    if ( diff == 0 ) {
+      // The cell is free for this position; claim it
+      if ( fPushPosition.compare_exchange_weak(position, position + 1,
+                                               std::memory_order_relaxed) ) {
+        cell.value = value;
+        cell.sequence.store(position + 1, std::memory_order_release);
+        return true;
+      }
+    }
+    else if ( diff < 0 ) {
+      // The cell still holds the value of the previous round: full
+      return false;
+    }
+    else {
+      position = fPushPosition.load(std::memory_order_relaxed);
+    }
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+template <typename T>
+bool BoundedQueue<T>::TryPop(T& value)
+{
+  auto position = fPopPosition.load(std::memory_order_relaxed);
+  for ( ;; ) {
+    auto& cell = fCells[position & fMask];
+    auto sequence = cell.sequence.load(std::memory_order_acquire);
+    auto diff = std::ptrdiff_t(sequence) - std::ptrdiff_t(position + 1);
+    if ( diff == 0 ) {
+      // The cell holds the value of this position; claim it
+      if ( fPopPosition.compare_exchange_weak(position, position + 1,
+                                              std::memory_order_relaxed) ) {
+        value = cell.value;
+        cell.sequence.store(position + fMask + 1, std::memory_order_release);
+        return true;
+      }
+    }
+    else if ( diff < 0 ) {
+      // Nothing pushed at this position yet: empty
+      return false;
+    }
+    else {
+      position = fPopPosition.load(std::memory_order_relaxed);
+    }
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+template <typename T>
+std::size_t BoundedQueue<T>::Size() const
+{
+  auto pushed = fPushPosition.load(std::memory_order_relaxed);
+  auto popped = fPopPosition.load(std::memory_order_relaxed);
+  return ( pushed > popped ) ? pushed - popped : 0;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+template <typename T>
+std::size_t BoundedQueue<T>::Capacity() const
+{
+  return fCells.size();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -8,6 +8,8 @@
 #include "G4VSensitiveDetector.hh"
 
 #include "CalorHit.hh"
+#include "EventRecord.hh"
+#include "ContainmentMonitor.hh"
 
 #include <vector>
 
@@ -20,7 +22,20 @@ class G4HCofThisEvent;
 /// hit for accounting the total quantities in all layers.
 ///
 /// The values are accounted in hits in ProcessHits() function which is called
-/// by Geant4 kernel at each step.
+/// by Geant4 kernel at each step. Steps of pi0 are also collected in a
+/// per-thread list (GetPi0Records()) which is moved to the EventRecord
+/// at the end of the event.
+///
+/// The sensitive detectors of the ECal are given a step volume code
+/// (SetStepVolume()); their steps are then passed to the StepRecorder
+/// of the thread while it records a sampled event.
+///
+/// The deposits of all sensitive detectors are passed to the
+/// ContainmentMonitor of the thread while it monitors the event; the HCal
+/// detectors are given their containment zone (SetContainmentZone()) and
+/// the active detectors their signal (SetContainmentSignal()).
+/// While a shower library is generated, they are also passed to the
+/// ShowerLibraryBuilder of the thread.
 
 class CalorimeterSD : public G4VSensitiveDetector
 {
@@ -35,12 +50,42 @@ class CalorimeterSD : public G4VSensitiveDetector
     virtual G4bool ProcessHits(G4Step* step, G4TouchableHistory* history);
     virtual void   EndOfEvent(G4HCofThisEvent* hitCollection);
 
+    // Pi0 steps of the current event in this thread
+    static std::vector<Pi0Record>& GetPi0Records();
+
+    // Volume code of the recorded steps (see StepFormat), -1 = not recorded
+    void SetStepVolume(G4int volume);
+    // First layer of the tail catcher (-1 = none) and whether the detector
+    // is on the lateral edge of the calorimeter
+    void SetContainmentZone(G4int firstTailLayer, G4bool edge);
+    // Active deposits summed by the containment monitor
+    void SetContainmentSignal(ContainmentMonitor::Signal signal);
+
   private:
     CalorHitsCollection* fHitsCollection;
     G4int  fNofCells;
+    G4int  fStepVolume;
+    G4int  fContainmentTailLayer;
+    G4bool fContainmentEdge;
+    ContainmentMonitor::Signal fContainmentSignal;
 };
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
+inline void CalorimeterSD::SetStepVolume(G4int volume) {
+  fStepVolume = volume;
+}
+
+inline void CalorimeterSD::SetContainmentZone(G4int firstTailLayer, G4bool edge) {
+  fContainmentTailLayer = firstTailLayer;
+  fContainmentEdge = edge;
+}
+
+inline void CalorimeterSD::SetContainmentSignal(ContainmentMonitor::Signal signal) {
+  fContainmentSignal = signal;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
 #endif
 
@@ -0,0 +1,128 @@
+/// \file ColumnarFormat.hh
+/// \brief Definition of the append-only columnar file format
+///
+/// The columnar files written by ColumnarWriter are laid out as
+///
+///   file header : magic "ATHCOL01", format version, schema
+///   block       : block header, then one payload per column
+///   block       : ...
+///
+/// Row blocks hold the rows of one table. Index blocks map the events
+/// written since the previous index block to their rows: the first chunk
+/// holds the eventIDs (Int32), followed for every table by the first row
+/// (UInt64) and the number of rows (UInt32) of each event in that table.
+/// The rows of one event are contiguous in every table of a file.
+/// Histogram blocks hold one run-level histogram: its name, binning and
+/// contents (Float64). The contents are additive (counts, sums, sums of
+/// squares), so the histograms of several files are merged by summing them.
+///
+/// Each block is self-contained (its header gives the table, the number of
+/// rows and the codec, stored and raw size of every column), so a file can
+/// be read up to its last complete block even if the writer was killed.
+/// Numbers are stored in the byte order of the host (little endian on all
+/// supported platforms).
+///
+/// This header and ColumnarFormat.cc do not depend on Geant4 so that they
+/// can be used by the stand-alone tools.
+
+#ifndef ColumnarFormat_h
+#define ColumnarFormat_h 1
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace ColumnarFormat
+{
+  const char          kFileMagic[8] = { 'A', 'T', 'H', 'C', 'O', 'L', '0', '1' };
+  const std::uint32_t kVersion      = 1;
+  const std::uint32_t kBlockMagic   = 0x4b4c4241; // "ABLK"
+
+  /// Extensions of the per-thread files and of the dataset manifest
+  const std::string kFileExtension     = ".acol";
+  const std::string kManifestExtension = ".acolset";
+
+  enum class ColumnType : std::uint8_t  { Int32 = 'I', Float32 = 'F', Float64 = 'D' };
+  enum class Codec      : std::uint8_t  { None = 0, Zlib = 1 };
+  enum class BlockKind  : std::uint32_t { Rows = 0, Index = 1, Histogram = 2 };
+
+  struct Column
+  {
+    std::string name;
+    ColumnType  type;
+  };
+
+  struct Table
+  {
+    std::string         name;
+    std::vector<Column> columns;
+  };
+
+  using Schema = std::vector<Table>;
+
+  /// Storage description of one column inside a block
+  struct Chunk
+  {
+    Codec         codec;
+    std::uint64_t rawSize;    ///< Size of the uncompressed column data
+    std::uint64_t storedSize; ///< Size of the payload in the file
+  };
+
+  /// Block header; the chunk payloads follow in column order
+  struct BlockHeader
+  {
+    BlockKind          kind;
+    std::uint32_t      table;
+    std::uint32_t      nofRows;
+    std::vector<Chunk> chunks;
+  };
+
+  /// Run-level histogram; the binning is free-form (e.g. number of bins,
+  /// lower and upper edge per axis) and must match for a merge
+  struct Histogram
+  {
+    std::string         name;
+    std::vector<double> binning;
+    std::vector<double> contents;
+  };
+
+  std::size_t TypeSize(ColumnType type);
+  bool        SameSchema(const Schema& left, const Schema& right);
+  int         FindTable(const Schema& schema, const std::string& name);
+  int         FindColumn(const Table& table, const std::string& name);
+
+  // Serialisation; the functions return false on a short read or write
+  bool WriteFileHeader(std::FILE* file, const Schema& schema);
+  bool ReadFileHeader(std::FILE* file, Schema& schema);
+  bool WriteBlockHeader(std::FILE* file, const BlockHeader& header);
+  bool ReadBlockHeader(std::FILE* file, BlockHeader& header);
+  /// Append the serialised header to a buffer, as written by WriteBlockHeader()
+  void EncodeBlockHeader(const BlockHeader& header, std::vector<char>& out);
+
+  /// Encode column data with the given codec. Falls back to Codec::None
+  /// (and returns it) when compression does not reduce the size.
+  Codec Encode(Codec codec, int level,
+               const char* data, std::size_t size, std::vector<char>& out);
+  bool  Decode(const Chunk& chunk, const char* payload, char* out);
+
+  /// Encode the columns of a block and append the block (header, then
+  /// payloads) to a buffer; the chunks of the header are filled
+  void EncodeBlock(BlockHeader& header, const std::vector<std::vector<char>>& columns,
+                   Codec codec, int level, std::vector<char>& out);
+
+  /// Add histograms to a list, summing those with the same name; returns
+  /// false if a histogram does not match the binning of its namesake
+  bool MergeHistograms(std::vector<Histogram>& merged,
+                       const std::vector<Histogram>& histograms);
+
+  /// The manifest of a dataset is a text file listing its files, one per
+  /// line, relative to the directory of the manifest. ReadManifest()
+  /// returns the paths resolved against that directory. The lines starting
+  /// with # are comments, e.g. the optional comment of WriteManifest().
+  bool WriteManifest(const std::string& path, const std::vector<std::string>& files,
+                     const std::string& comment = "");
+  bool ReadManifest(const std::string& path, std::vector<std::string>& files);
+}
+
+#endif
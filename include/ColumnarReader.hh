@@ -0,0 +1,220 @@
+/// \file ColumnarReader.hh
+/// \brief Definition of the ColumnarReader and ColumnarDataset classes
+
+#ifndef ColumnarReader_h
+#define ColumnarReader_h 1
+
+#include "ColumnarFormat.hh"
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/// Reader of one columnar file.
+///
+/// Open() reads the schema, scans the block headers and loads the event
+/// index and the histograms; the column data is only read on request. A trailing incomplete
+/// block (e.g. from a killed job) is ignored and flagged by IsTruncated().
+/// The index lists the events completed at the last flush; the rows
+/// written after it by a killed job are not indexed. Files without index
+/// blocks get their index rebuilt from the eventID columns.
+/// The chunk reads use positional I/O, so one reader can be used from
+/// several threads.
+
+class ColumnarReader
+{
+  public:
+    struct Block
+    {
+      ColumnarFormat::BlockHeader header;
+      std::vector<std::uint64_t>  offsets;  ///< File offset of each chunk
+      std::uint64_t               firstRow; ///< First row of the block in its table
+    };
+
+    /// Rows of one event in one table
+    struct RowRange
+    {
+      std::uint64_t firstRow;
+      std::uint64_t nofRows;
+    };
+
+    ColumnarReader();
+    ~ColumnarReader();
+
+    bool Open(const std::string& fileName);
+    void Close();
+
+    // get methods
+    const std::string&            GetFileName() const;
+    const ColumnarFormat::Schema& GetSchema() const;
+    const std::vector<Block>&     GetBlocks() const;
+    std::uint64_t                 GetNumberOfRows(int tableId) const;
+    bool                          IsTruncated() const;
+    const std::vector<ColumnarFormat::Histogram>& GetHistograms() const;
+
+    // event index; the entries are in the order of the events in the file
+    std::size_t GetNumberOfEvents() const;
+    int         GetEventID(std::size_t entry) const;
+    RowRange    GetEventRows(std::size_t entry, int tableId) const;
+    bool        IsIndexRebuilt() const;
+
+    /// Read the decoded data of one column of a block
+    bool ReadChunk(const Block& block, int columnId, std::vector<char>& data) const;
+    /// Read the payload of one column of a block as stored in the file
+    bool ReadStoredChunk(const Block& block, int columnId, std::vector<char>& data) const;
+    /// Read the payloads of all columns of a block as stored in the file
+    bool ReadStoredBlock(const Block& block, std::vector<char>& data) const;
+
+    /// Read a whole column converted to double or int
+    std::vector<double> ReadColumnAsDouble(int tableId, int columnId) const;
+    std::vector<int>    ReadColumnAsInt(int tableId, int columnId) const;
+    /// Read a range of rows of a column, only the blocks holding them are read
+    std::vector<double> ReadRowsAsDouble(int tableId, int columnId, RowRange rows) const;
+    std::vector<int>    ReadRowsAsInt(int tableId, int columnId, RowRange rows) const;
+
+  private:
+    template <typename T>
+    std::vector<T> ReadColumn(int tableId, int columnId) const;
+    template <typename T>
+    std::vector<T> ReadRows(int tableId, int columnId, RowRange rows) const;
+    bool ReadIndex();
+    bool BuildIndex();
+    void ReadHistograms();
+    bool ReadStored(std::uint64_t offset, std::uint64_t size, char* data) const;
+
+    std::string                            fFileName;
+    int                                    fDescriptor;
+    ColumnarFormat::Schema                 fSchema;
+    std::vector<Block>                     fBlocks;
+    std::vector<std::vector<std::size_t>>  fTableBlocks; ///< Row blocks of each table
+    std::vector<std::uint64_t>             fNofRows;
+    bool                                   fTruncated;
+    std::vector<int>                       fEventIDs;
+    std::vector<RowRange>                  fEventRows; ///< Per event, one range per table
+    bool                                   fIndexRebuilt;
+    std::vector<ColumnarFormat::Histogram> fHistograms;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// Virtual concatenation of the columnar files of a dataset.
+///
+/// A dataset is opened from a manifest (see ColumnarFormat::ReadManifest())
+/// or from a single file. The files are scanned in parallel, must share the
+/// same schema, and are presented as one set of tables in manifest order.
+/// Whole columns are read in parallel, one thread per file.
+///
+/// The event indices of the files are merged into a hash map, so the rows
+/// of any event are found in constant time with FindEvent(). GetEventIDs()
+/// gives the events in eventID order, whatever the order of the files.
+
+class ColumnarDataset
+{
+  public:
+    /// Position of an event in the dataset
+    struct EventLocation
+    {
+      std::size_t file;
+      std::size_t entry; ///< Entry in the index of the file
+    };
+
+    ColumnarDataset();
+    ~ColumnarDataset();
+
+    bool Open(const std::string& path);
+    bool Open(const std::vector<std::string>& fileNames);
+
+    // get methods
+    std::size_t                   GetNumberOfFiles() const;
+    const ColumnarReader&         GetFile(std::size_t index) const;
+    const ColumnarFormat::Schema& GetSchema() const;
+    std::uint64_t                 GetNumberOfRows(int tableId) const;
+    std::size_t                   GetNumberOfEvents() const;
+    /// Histograms of all files, summed; false if their binnings differ
+    bool GetHistograms(std::vector<ColumnarFormat::Histogram>& histograms) const;
+    std::size_t                   GetNumberOfDuplicateEvents() const;
+
+    std::vector<double> ReadColumnAsDouble(int tableId, int columnId) const;
+    std::vector<int>    ReadColumnAsInt(int tableId, int columnId) const;
+
+    /// Location of an event, null if the dataset does not hold it
+    const EventLocation* FindEvent(int eventID) const;
+    /// All eventIDs in increasing order
+    std::vector<int> GetEventIDs() const;
+    /// Rows of one event in a column; empty if the event is unknown
+    std::vector<double> ReadEventAsDouble(int eventID, int tableId, int columnId) const;
+    std::vector<int>    ReadEventAsInt(int eventID, int tableId, int columnId) const;
+
+  private:
+    template <typename T>
+    std::vector<T> ReadColumn(int tableId, int columnId) const;
+
+    std::vector<ColumnarReader*>            fFiles;
+    std::unordered_map<int, EventLocation>  fEvents;
+    std::size_t                             fNofDuplicateEvents;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+inline const std::string& ColumnarReader::GetFileName() const {
+  return fFileName;
+}
+
+inline const ColumnarFormat::Schema& ColumnarReader::GetSchema() const {
+  return fSchema;
+}
+
+inline const std::vector<ColumnarReader::Block>& ColumnarReader::GetBlocks() const {
+  return fBlocks;
+}
+
+inline std::uint64_t ColumnarReader::GetNumberOfRows(int tableId) const {
+  return fNofRows[tableId];
+}
+
+inline bool ColumnarReader::IsTruncated() const {
+  return fTruncated;
+}
+
+inline const std::vector<ColumnarFormat::Histogram>&
+ColumnarReader::GetHistograms() const {
+  return fHistograms;
+}
+
+inline std::size_t ColumnarReader::GetNumberOfEvents() const {
+  return fEventIDs.size();
+}
+
+inline int ColumnarReader::GetEventID(std::size_t entry) const {
+  return fEventIDs[entry];
+}
+
+inline ColumnarReader::RowRange ColumnarReader::GetEventRows(std::size_t entry,
+                                                             int tableId) const {
+  return fEventRows[entry*fSchema.size() + tableId];
+}
+
+inline bool ColumnarReader::IsIndexRebuilt() const {
+  return fIndexRebuilt;
+}
+
+inline std::size_t ColumnarDataset::GetNumberOfFiles() const {
+  return fFiles.size();
+}
+
+inline const ColumnarReader& ColumnarDataset::GetFile(std::size_t index) const {
+  return *fFiles[index];
+}
+
+inline std::size_t ColumnarDataset::GetNumberOfEvents() const {
+  return fEvents.size();
+}
+
+inline std::size_t ColumnarDataset::GetNumberOfDuplicateEvents() const {
+  return fNofDuplicateEvents;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
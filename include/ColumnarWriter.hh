@@ -0,0 +1,125 @@
+/// \file ColumnarWriter.hh
+/// \brief Definition of the ColumnarWriter class
+
+#ifndef ColumnarWriter_h
+#define ColumnarWriter_h 1
+
+#include "RowSink.hh"
+#include "ColumnarFormat.hh"
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+/// Append-only writer of a columnar file (see ColumnarFormat.hh).
+///
+/// Rows are filled column by column as with the analysis manager and
+/// buffered per table; a table is written as a block when its buffer
+/// exceeds the block size, and all buffers are written at Flush() and
+/// Close(). After Flush() the file holds only complete blocks, so it stays
+/// readable if the process is killed later.
+/// The events closed by EndEvent() are indexed: each Flush() also writes
+/// an index block with the row range of these events in every table.
+/// Run-level histograms are written with WriteHistogram().
+/// Each thread owns its writer and file, so no locking is needed.
+/// Open() returns false if the file or its header cannot be written; the
+/// other methods throw std::runtime_error on a write error or an
+/// incomplete row, which the owner reports (Close() closes the file
+/// before rethrowing).
+/// The class does not depend on Geant4.
+
+class ColumnarWriter : public RowSink
+{
+  public:
+    ColumnarWriter(const ColumnarFormat::Schema& schema);
+    virtual ~ColumnarWriter();
+
+    bool Open(const std::string& fileName);
+    void Close();
+    void Flush();
+    void WriteHistogram(const ColumnarFormat::Histogram& histogram);
+
+    // settings
+    void SetCompression(ColumnarFormat::Codec codec, int level);
+    void SetBlockSize(std::size_t blockSize);
+
+    // methods from RowSink
+    virtual void FillEnergyColumn(int tableId, int columnId, double value);
+    virtual void FillPositionColumn(int tableId, int columnId, double value);
+    virtual void FillIntColumn(int tableId, int columnId, int value);
+    virtual void AddRow(int tableId);
+    virtual void EndEvent(int eventID);
+
+    // get methods
+    bool               IsOpen() const;
+    const std::string& GetFileName() const;
+    std::uint64_t      GetBytesWritten() const;
+    std::size_t        GetBufferedBytes() const;
+    std::uint64_t      GetNumberOfRows(int tableId) const;
+    std::uint64_t      GetNumberOfEvents() const;
+
+  private:
+    struct TableBuffer
+    {
+      std::vector<std::vector<char>> columns;
+      std::uint32_t nofRows  = 0;
+      std::size_t   nofBytes = 0;
+      std::uint64_t nofRowsWritten = 0;
+      // index of the events not yet written
+      std::uint64_t eventFirstRow = 0;  ///< First row of the current event
+      std::vector<std::uint64_t> indexFirstRows;
+      std::vector<std::uint32_t> indexNofRows;
+    };
+
+    // methods
+    void Append(int tableId, int columnId, const void* value, std::size_t size);
+    void WriteBlock(int tableId);
+    void WriteIndexBlock();
+    void WriteChunks(ColumnarFormat::BlockHeader& header,
+                     const std::vector<std::vector<char>>& columns);
+
+    // data members
+    ColumnarFormat::Schema    fSchema;
+    std::vector<TableBuffer>  fTables;
+    std::FILE*                fFile;
+    std::string               fFileName;
+    ColumnarFormat::Codec     fCodec;
+    int                       fCompressionLevel;
+    std::size_t               fBlockSize;
+    std::uint64_t             fBytesWritten;
+    std::vector<std::int32_t> fIndexEventIDs; ///< Events not yet indexed in the file
+    std::uint64_t             fNofEventsIndexed;
+    std::vector<char>         fBlockBuffer;   ///< Encoded block being written
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+inline bool ColumnarWriter::IsOpen() const {
+  return fFile != nullptr;
+}
+
+inline const std::string& ColumnarWriter::GetFileName() const {
+  return fFileName;
+}
+
+inline std::uint64_t ColumnarWriter::GetBytesWritten() const {
+  return fBytesWritten;
+}
+
+inline std::size_t ColumnarWriter::GetBufferedBytes() const {
+  std::size_t nofBytes = 0;
+  for ( const auto& table : fTables ) nofBytes += table.nofBytes;
+  return nofBytes;
+}
+
+inline std::uint64_t ColumnarWriter::GetNumberOfRows(int tableId) const {
+  return fTables[tableId].nofRowsWritten + fTables[tableId].nofRows;
+}
+
+inline std::uint64_t ColumnarWriter::GetNumberOfEvents() const {
+  return fNofEventsIndexed + fIndexEventIDs.size();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
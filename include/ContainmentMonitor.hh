@@ -0,0 +1,121 @@
+/// \file ContainmentMonitor.hh
+/// \brief Definition of the ContainmentMonitor class
+
+#ifndef ContainmentMonitor_h
+#define ContainmentMonitor_h 1
+
+#include "globals.hh"
+#include "EventRecord.hh"
+
+#include <chrono>
+
+class G4Step;
+
+/// Monitor of the shower containment during the event, which stops the
+/// simulation of the events that have clearly failed the containment cut
+/// (see /ATHENA/analysis/containment).
+///
+/// The sensitive detectors pass their deposits to the monitor of their
+/// thread (Instance()) while it IsMonitoring(): before the Birks correction
+/// for the total and the lateral edge (outer ring of HCal towers), and after
+/// it for the active ECal and HCal deposits and the HCal active deposit in
+/// the tail catcher (last NumTailCatcherLayers layers), the quantities of
+/// the EdepTotal table. The tail-catcher cut is the one of Resolution.cpp
+/// and of the resolution scan, tail/(ECal/weight + HCal), with the limit of
+/// /ATHENA/analysis/containmentCut. As the deposits of an event cannot
+/// exceed the primary energy, the final denominator is at most the current
+/// one plus the energy not yet deposited, counted as ECal active energy
+/// divided by the smallest weight of the scan: an event is stopped once
+/// it fails the cut with this bound, so that it fails it at the end of
+/// the event whatever it deposits afterwards, for every weight of the
+/// scan. This holds for the deposits of the ntuple; Resolution.cpp smears
+/// the tiles and cuts those below 0.5 MeV, which can bring an event close
+/// to the limit below it. The edge limit is a fraction of the primary
+/// energy, not a cut of the analysis. A stopped event is
+///   - tagged: the current track, its secondaries and the stacked tracks
+///     are killed and the event is written with what it has deposited,
+///   - or aborted: the event is aborted and only its containment record
+///     is written.
+/// The status and deposits are kept in the ContainmentRecord of the event,
+/// which is written to the Containment table for the stopped events.
+///
+/// The processing time of the events is measured, to estimate the time
+/// saved: each stopped event would have taken the mean time of the
+/// complete events.
+
+class ContainmentMonitor
+{
+  public:
+    enum class Mode { Off, Tag, Abort };
+    /// Active deposits of a sensitive detector, as summed in EventAction
+    enum class Signal { None, ECal, HCal };
+
+    /// Processing times of the run, merged over the threads
+    struct Statistics
+    {
+      G4double nofComplete  = 0.;
+      G4double nofStopped   = 0.;
+      G4double completeTime = 0.; ///< [s]
+      G4double stoppedTime  = 0.; ///< [s]
+
+      void Merge(const Statistics& other);
+      void Print() const;
+    };
+
+    static ContainmentMonitor* Instance();
+    ~ContainmentMonitor();
+
+    // Take the settings of AnalysisConfig and clear the statistics
+    void Configure();
+
+    void BeginEvent(G4double primaryEnergy);
+    // edep before and after the Birks correction
+    void Add(const G4Step* step, G4double edep, G4double birksEdep, Signal signal,
+             G4bool tail, G4bool edge);
+    void EndEvent();
+
+    // get methods
+    G4bool IsMonitoring() const;
+    const ContainmentRecord& GetRecord() const;
+    const Statistics& GetStatistics() const;
+
+  private:
+    ContainmentMonitor();
+
+    void Stop(const G4Step* step);
+
+    static G4ThreadLocal ContainmentMonitor* fInstance;
+
+    // settings
+    Mode     fMode;
+    G4double fTailCut;         ///< Limit of tail/(ECal/weight + HCal), 0 = none
+    G4double fEdgeFraction;
+    G4double fMinWeight;       ///< Smallest ECal weight of the resolution scan
+
+    // current event
+    G4bool            fMonitoring;
+    G4double          fPrimaryEnergy;
+    G4double          fEdgeLimit;
+    ContainmentRecord fRecord;
+    std::chrono::steady_clock::time_point fStart;
+
+    Statistics fStatistics;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+inline G4bool ContainmentMonitor::IsMonitoring() const {
+  return fMonitoring;
+}
+
+inline const ContainmentRecord& ContainmentMonitor::GetRecord() const {
+  return fRecord;
+}
+
+inline const ContainmentMonitor::Statistics& ContainmentMonitor::GetStatistics() const {
+  return fStatistics;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -7,6 +7,11 @@
 
 #include "G4VUserDetectorConstruction.hh"
 #include "globals.hh"
+#include "G4TwoVector.hh"
+#include "G4ThreeVector.hh"
+#include "ShowerLibraryFormat.hh"
+
+#include <vector>
 
 class G4VPhysicalVolume;
 class G4GlobalMagFieldMessenger;
@@ -35,6 +40,20 @@ class DetectorConstruction : public G4VUserDetectorConstruction
     virtual G4VPhysicalVolume* Construct();
     virtual void ConstructSDandField();
 
+    // Transverse centres of the ECal blocks and HCal towers, indexed
+    // [x id * number per axis + y id]; set by Construct() on the master
+    static const std::vector<G4TwoVector>& GetECalBlockCenters();
+    static const std::vector<G4TwoVector>& GetHCalTowerCenters();
+
+    // Periodic structure of the ECal blocks (fibers) and HCal towers
+    // (layers) the shower libraries are aligned to; set by Construct()
+    static const ShowerLibraryFormat::Lattice& GetShowerLibraryLattice(G4int detector);
+    // Lattice node of a global position in the nearest block or tower of a
+    // detector, in the global frame, and the phase of the position in its
+    // lattice cell; false outside the detector along z
+    static G4bool FindShowerLibraryNode(G4int detector, const G4ThreeVector& position,
+                                        G4ThreeVector& node, G4double phase[3]);
+
   private:
     // methods
     void DefineMaterials();
@@ -42,10 +61,29 @@ class DetectorConstruction : public G4VUserDetectorConstruction
   
     // data members
     static G4ThreadLocal G4GlobalMagFieldMessenger*  fMagFieldMessenger; // magnetic field messenger
+    static std::vector<G4TwoVector> fECalBlockCenters;
+    static std::vector<G4TwoVector> fHCalTowerCenters;
+    static ShowerLibraryFormat::Lattice fShowerLibraryLattices[ShowerLibraryFormat::kNofDetectors];
+    static G4double fECalFiberFraction; // volume fraction of the fibers in a block
     G4bool  fCheckOverlaps; // option to activate checking of volumes overlaps
 };
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
+inline const std::vector<G4TwoVector>& DetectorConstruction::GetECalBlockCenters() {
+  return fECalBlockCenters;
+}
+
+inline const std::vector<G4TwoVector>& DetectorConstruction::GetHCalTowerCenters() {
+  return fHCalTowerCenters;
+}
+
+inline const ShowerLibraryFormat::Lattice&
+DetectorConstruction::GetShowerLibraryLattice(G4int detector) {
+  return fShowerLibraryLattices[detector];
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
 #endif
 
@@ -0,0 +1,74 @@
+/// \file ECalShowerModel.hh
+/// \brief Definition of the ECalShowerModel class
+
+#ifndef ECalShowerModel_h
+#define ECalShowerModel_h 1
+
+#include "G4VFastSimulationModel.hh"
+#include "SpotDepositor.hh"
+#include "globals.hh"
+
+class G4Material;
+class G4Track;
+
+/// GFlash-style parameterisation of the electron, positron and photon
+/// showers in the ECal (see FastSimConfig).
+///
+/// The model is attached to the ECal regions (powder and fibers) of each
+/// worker. An electron, positron or photon above the minimum energy which
+/// enters the ECal in an event selected for the fast simulation is killed
+/// and its energy is deposited as spots:
+/// - longitudinal profile: Gamma distribution in radiation lengths, with
+///   the GFlash homogeneous parameters of the effective ECal material and
+///   their correlated shower-to-shower fluctuations; photon showers start
+///   at an exponentially distributed conversion depth (mean 9/7 X0),
+/// - lateral profile: GFlash core and tail components in Moliere radii,
+///   depending on the depth relative to the shower maximum.
+///
+/// The spots are deposited by a SpotDepositor, so that the ECal blocks,
+/// fibers and the HCal behind are filled as in the full simulation. The
+/// spot energy is
+/// weighted by the density of its material relative to the effective ECal
+/// density, which reproduces the sampling on average, and by the active
+/// scale in the scintillating materials (those with a Birks constant).
+
+class ECalShowerModel : public G4VFastSimulationModel
+{
+  public:
+    ECalShowerModel(const G4String& name, G4Region* envelope);
+    virtual ~ECalShowerModel();
+
+    // Effective material of the ECal: absorber and fibers with the volume
+    // fraction of the fibers
+    void SetMaterials(const G4Material* absorber, const G4Material* fibers,
+                      G4double fiberFraction);
+
+    // methods from base class
+    virtual G4bool IsApplicable(const G4ParticleDefinition& particle);
+    virtual G4bool ModelTrigger(const G4FastTrack& fastTrack);
+    virtual void   DoIt(const G4FastTrack& fastTrack, G4FastStep& fastStep);
+
+  private:
+    G4double GetShowerEnergy(const G4Track& track) const;
+    void Deposit(const G4ThreeVector& position, G4double energy);
+
+    // effective ECal material
+    G4double fDensity;
+    G4double fRadiationLength;
+    G4double fMoliereRadius;
+    G4double fCriticalEnergy;
+    G4double fZ;
+
+    // settings of the current event
+    G4int    fEventID;
+    G4bool   fFastEvent;
+    G4double fMinEnergy;
+    G4double fSpotEnergy;
+    G4double fActiveScale;
+
+    SpotDepositor fDepositor;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
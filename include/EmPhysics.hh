@@ -0,0 +1,42 @@
+/// \file EmPhysics.hh
+/// \brief Definition of the EmPhysics class
+
+#ifndef EmPhysics_h
+#define EmPhysics_h 1
+
+#include "G4VPhysicsConstructor.hh"
+#include "globals.hh"
+
+#include <vector>
+
+/// Electromagnetic physics of the selected option (see PhysicsConfig) with
+/// the photon transport options of PhysicsConfig: the gamma general
+/// process and the Woodcock tracking in a detector region. It replaces the
+/// EM constructor of the reference list and delegates to the Geant4
+/// constructor of the option.
+///
+/// The transport options are passed to the G4EmParameters on the master,
+/// when its processes are constructed at /run/initialize; the workers
+/// construct their processes afterwards with the same parameters.
+
+class EmPhysics : public G4VPhysicsConstructor
+{
+  public:
+    EmPhysics(const G4String& option, G4int verbose = 1);
+    virtual ~EmPhysics();
+
+    virtual void ConstructParticle();
+    virtual void ConstructProcess();
+
+    // EM options: opt0 (standard, default of the reference lists) to opt4,
+    // liv (Livermore) and pen (Penelope)
+    static const std::vector<G4String>& GetOptions();
+    static G4bool IsOption(const G4String& option);
+
+  private:
+    G4VPhysicsConstructor* fEmPhysics;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -1,4 +1,3 @@
-
 /// \file EventAction.hh
 /// \brief Definition of the EventAction class
 
@@ -7,18 +6,31 @@
 
 #include "G4UserEventAction.hh"
 #include "CalorHit.hh"
+#include "EventRecord.hh"
 #include "DetectorConstruction.hh"
+#include "TopoClustering.hh"
+#include "EventOverlay.hh"
 
 #include "globals.hh"
 
+#include <chrono>
+
 /// Event action class
+///
+/// In EndOfEventAction() the hits collections are summarised in an
+/// EventRecord which is passed to the RunAction for output. The library
+/// events of the overlay are added to its cells by an EventOverlay, and the
+/// clusters of the record are computed by a TopoClustering of this thread.
+/// The wall time of the event simulation is measured for the fast
+/// simulation validation.
 
 class DetectorConstruction;
+class RunAction;
 
 class EventAction : public G4UserEventAction
 {
 public:
-  EventAction();
+  EventAction(RunAction* runAction);
   virtual ~EventAction();
 
   virtual void  BeginOfEventAction(const G4Event* event);
@@ -28,8 +40,17 @@ private:
   // methods
   CalorHitsCollection* GetHitsCollection(G4int hcID,
                                             const G4Event* event) const;
+  CalorHitsCollection* GetHitsCollection(const char* hcName,
+                                            const G4Event* event) const;
+  void FillEventRecord(const G4Event* event);
   void PrintEventStatistics(G4double ECalEdep, G4double gapEdep) const;
-  
+
+  // data members
+  RunAction*     fRunAction;
+  EventRecord    fRecord;
+  TopoClustering fClustering;
+  EventOverlay   fOverlay;
+  std::chrono::steady_clock::time_point fEventStart;
 };
                      
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
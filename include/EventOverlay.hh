@@ -0,0 +1,59 @@
+/// \file EventOverlay.hh
+/// \brief Definition of the EventOverlay class
+
+#ifndef EventOverlay_h
+#define EventOverlay_h 1
+
+#include "globals.hh"
+
+#include <vector>
+
+struct EventRecord;
+
+/// Overlay of library events on the cells of an EventRecord (see
+/// OverlayConfig and OverlayLibrary), done by the EventAction of each
+/// thread before the summary and the clusters are computed.
+///
+/// Each event gets one library event per overlaid particle, drawn at
+/// random among the events selected for it, and the pile-up events drawn
+/// from the whole library. The events with a time offset in the readout
+/// gate are summed into one dense array of all cell quantities, added to
+/// the record at the end; the library events hold no time information, so
+/// an offset moves a whole event in or out of the gate. Without simulated
+/// primary, the primary of the record is the one of the first overlaid
+/// particle. The pi0 of the library events are only in the cell counts.
+///
+/// The overlaid events and the time spent are counted in the Statistics of
+/// the thread, merged at the end of the run.
+
+class EventOverlay
+{
+  public:
+    /// Overlaid events of the run, merged over the threads
+    struct Statistics
+    {
+      G4double events = 0.; ///< Events with an overlay
+      G4double drawn  = 0.; ///< Library events drawn
+      G4double added  = 0.; ///< Library events in the gate
+      G4double time   = 0.; ///< Wall time of the overlay [s]
+
+      void Merge(const Statistics& other);
+      void Print() const;
+    };
+
+    EventOverlay();
+    ~EventOverlay();
+
+    // Add the drawn library events to the cells of the record
+    void Process(EventRecord& record);
+
+    // Overlaid events of the current run in this thread
+    static Statistics& GetStatistics();
+
+  private:
+    std::vector<G4double> fSum;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,194 @@
+/// \file EventRecord.hh
+/// \brief Definition of the EventRecord structure
+
+#ifndef EventRecord_h
+#define EventRecord_h 1
+
+#include "globals.hh"
+#include "G4TwoVector.hh"
+#include "GlobalValues.hh"
+
+#include <vector>
+
+class RowSink;
+
+/// Energy deposits of one calorimeter cell (or of a whole detector)
+
+struct CellRecord
+{
+  G4double edepActive      = 0.;
+  G4double edepPi0Active   = 0.;
+  G4double edepAbsorber    = 0.;
+  G4double edepPi0Absorber = 0.;
+  G4int    numPi0Active    = 0;
+  G4int    numPi0Absorber  = 0;
+};
+
+/// Pi0 seen in a calorimeter step; positions in cm, z from the ECal front
+/// face (z = -GlobalValues::ECalThickness/2)
+
+struct Pi0Record
+{
+  G4double energy;
+  G4double posX;
+  G4double posY;
+  G4double posZ;
+};
+
+/// Primary particle of the event; kinetic energy in MeV, vertex in cm
+/// with z from the ECal front as for the pi0
+
+struct PrimaryRecord
+{
+  G4int    pdg    = 0;
+  G4double energy = 0.;
+  G4double posX   = 0.;
+  G4double posY   = 0.;
+  G4double posZ   = 0.;
+  G4double dirX   = 0.;
+  G4double dirY   = 0.;
+  G4double dirZ   = 0.;
+};
+
+/// Energy-weighted centroid and RMS width of the active energy of a
+/// calorimeter in the transverse plane; in cm, 0 without energy
+
+struct TransverseShape
+{
+  G4double centroidX = 0.;
+  G4double centroidY = 0.;
+  G4double widthX    = 0.;
+  G4double widthY    = 0.;
+};
+
+/// Per-event shower summary derived from the cells: the longitudinal
+/// profile of the HCal (active energy per layer, summed over the towers),
+/// the tail catcher (last NumTailCatcherLayers layers, without the smearing
+/// and tile cut of the offline analysis) and the transverse shapes
+
+struct SummaryRecord
+{
+  std::vector<G4double> hcalLayers;
+  G4double              hcalTailCatcher = 0.;
+  TransverseShape       ecal;
+  TransverseShape       hcal;
+};
+
+/// Topological cluster of ECal blocks and HCal towers (see TopoClustering):
+/// active energy, number of cells and transverse shape of each detector
+
+struct ClusterRecord
+{
+  G4double        edepECal      = 0.;
+  G4double        edepHCal      = 0.;
+  G4int           numECalBlocks = 0;
+  G4int           numHCalTowers = 0;
+  TransverseShape ecal;
+  TransverseShape hcal;
+};
+
+/// Containment of the event during the simulation (see ContainmentMonitor):
+/// the status, and the deposits in all calorimeter volumes, in the tail
+/// catcher and in the outer ring of HCal towers when the event was stopped
+/// (or at its end); the deposits are only summed while monitoring
+
+enum class ContainmentStatus : G4int { Contained = 0, Tagged = 1, Aborted = 2 };
+
+struct ContainmentRecord
+{
+  ContainmentStatus status          = ContainmentStatus::Contained;
+  G4double          edepTotal       = 0.; ///< All sensitive volumes, before the Birks correction
+  G4double          edepECalActive  = 0.; ///< Active deposits after the Birks correction,
+  G4double          edepHCalActive  = 0.; ///< as in the EdepTotal table
+  G4double          edepTailCatcher = 0.; ///< HCal active deposit in the last layers
+  G4double          edepEdge        = 0.; ///< Outer HCal towers, before the Birks correction
+};
+
+/// Secondaries killed by the StackingAction: number of tracks, their kinetic
+/// energy and the part of it deposited locally in the sensitive detectors
+
+struct StackingRecord
+{
+  G4int    killedTracks    = 0;
+  G4double killedEnergy    = 0.;
+  G4double depositedEnergy = 0.;
+};
+
+/// Compact per-event record of the calorimeter response.
+///
+/// It is filled once per event from the hits collections in
+/// EventAction::EndOfEventAction() and is the single input of all outputs:
+/// FillRows() writes it as rows of the EdepTotal, ECalBlocks, HCalTowers,
+/// HCalTiles, Pi0, Summary, Clusters and Containment tables (Root ntuples
+/// or columnar files), in the column order of OutputConfig::GetSchema();
+/// the cell tables (ECalBlocks, HCalTowers, HCalTiles) can be left out.
+/// The events stopped by the containment monitor have a Containment row;
+/// of the aborted events only this row is written. The summary
+/// is computed from the cells by ComputeSummary() once they are filled,
+/// the clusters by TopoClustering.
+
+struct EventRecord
+{
+  EventRecord();
+
+  void Reset(G4int id);
+  void FillRows(RowSink& sink, G4bool cells) const;
+  // Centres of the ECal blocks and HCal towers in the cell order
+  void ComputeSummary(const std::vector<G4TwoVector>& ecalCenters,
+                      const std::vector<G4TwoVector>& hcalCenters);
+
+  // cell access; i, j are the x and y ids, k the HCal layer
+  CellRecord&       ECalBlock(G4int i, G4int j);
+  const CellRecord& ECalBlock(G4int i, G4int j) const;
+  CellRecord&       HCalTower(G4int i, G4int j);
+  const CellRecord& HCalTower(G4int i, G4int j) const;
+  CellRecord&       HCalTile(G4int i, G4int j, G4int k);
+  const CellRecord& HCalTile(G4int i, G4int j, G4int k) const;
+
+  G4int                   eventID;
+  PrimaryRecord           primary;
+  CellRecord              ecalTotal;  ///< ECal fibers (active), powder, cladding and glue
+  CellRecord              hcalTotal;  ///< HCal tiles (active), absorbers and plates
+  std::vector<CellRecord> ecalBlocks; ///< NumECalBlocks x NumECalBlocks
+  std::vector<CellRecord> hcalTowers; ///< NumHCalTowers x NumHCalTowers
+  std::vector<CellRecord> hcalTiles;  ///< NumHCalTowers x NumHCalTowers x NumHCalLayers
+  std::vector<Pi0Record>  pi0s;
+  SummaryRecord           summary;
+  std::vector<ClusterRecord> clusters;
+  ContainmentRecord       containment;
+  G4int                   fastShowers; ///< Showers parameterised or taken from a shower library
+  StackingRecord          stacking;
+  G4int                   overlayEvents; ///< Library events added by the EventOverlay
+  G4int                   eventSeeds[2]; ///< Per-event seeds (see RandomConfig), 0 without
+  G4double                simTime;     ///< Wall time of the simulation [s], not written
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+inline CellRecord& EventRecord::ECalBlock(G4int i, G4int j) {
+  return ecalBlocks[i*GlobalValues::NumECalBlocks + j];
+}
+
+inline const CellRecord& EventRecord::ECalBlock(G4int i, G4int j) const {
+  return ecalBlocks[i*GlobalValues::NumECalBlocks + j];
+}
+
+inline CellRecord& EventRecord::HCalTower(G4int i, G4int j) {
+  return hcalTowers[i*GlobalValues::NumHCalTowers + j];
+}
+
+inline const CellRecord& EventRecord::HCalTower(G4int i, G4int j) const {
+  return hcalTowers[i*GlobalValues::NumHCalTowers + j];
+}
+
+inline CellRecord& EventRecord::HCalTile(G4int i, G4int j, G4int k) {
+  return hcalTiles[(i*GlobalValues::NumHCalTowers + j)*GlobalValues::NumHCalLayers + k];
+}
+
+inline const CellRecord& EventRecord::HCalTile(G4int i, G4int j, G4int k) const {
+  return hcalTiles[(i*GlobalValues::NumHCalTowers + j)*GlobalValues::NumHCalLayers + k];
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,92 @@
+/// \file FastSimConfig.hh
+/// \brief Definition of the FastSimConfig class
+
+#ifndef FastSimConfig_h
+#define FastSimConfig_h 1
+
+#include "globals.hh"
+
+class FastSimMessenger;
+
+/// Configuration of the EM shower parameterisation of the ECal (see
+/// ECalShowerModel), shared by the master and worker threads.
+///
+/// The settings are filled on the master via the /ATHENA/fastsim/ commands
+/// (see FastSimMessenger) and are read by the models of the workers at the
+/// beginning of each event:
+/// - mode: off, on (all events) or validate (even events parameterised,
+///   odd events fully simulated, compared at the end of the run by
+///   FastSimValidation),
+/// - minimum energy of the electrons, positrons and photons parameterised,
+/// - energy of the spots the showers are deposited with,
+/// - scale of the energy deposited in the scintillating materials, to tune
+///   the sampling fraction to the full simulation.
+///
+/// The mode also selects the events in which the shower libraries are used
+/// (see ShowerLibraryConfig). The models are only called if the fast
+/// simulation process was registered with the -f on option (see
+/// PhysicsConfig).
+
+class FastSimConfig
+{
+  public:
+    static FastSimConfig* Instance();
+    ~FastSimConfig();
+
+    // set methods
+    void SetMode(const G4String& mode);
+    void SetMinEnergy(G4double energy);
+    void SetSpotEnergy(G4double energy);
+    void SetActiveScale(G4double scale);
+
+    // get methods
+    const G4String& GetMode() const;
+    G4bool   IsEnabled() const;
+    G4bool   IsFastEvent(G4int eventID) const;
+    G4double GetMinEnergy() const;
+    G4double GetSpotEnergy() const;
+    G4double GetActiveScale() const;
+
+    void Print() const;
+
+  private:
+    FastSimConfig();
+
+    static FastSimConfig* fInstance;
+
+    FastSimMessenger* fMessenger;
+    G4String fMode;         ///< off, on or validate
+    G4double fMinEnergy;    ///< Minimum energy of a parameterised shower
+    G4double fSpotEnergy;   ///< Energy per spot
+    G4double fActiveScale;  ///< Scale of the deposits in scintillators
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+inline const G4String& FastSimConfig::GetMode() const {
+  return fMode;
+}
+
+inline G4bool FastSimConfig::IsEnabled() const {
+  return fMode != "off";
+}
+
+inline G4bool FastSimConfig::IsFastEvent(G4int eventID) const {
+  return fMode == "on" || ( fMode == "validate" && eventID % 2 == 0 );
+}
+
+inline G4double FastSimConfig::GetMinEnergy() const {
+  return fMinEnergy;
+}
+
+inline G4double FastSimConfig::GetSpotEnergy() const {
+  return fSpotEnergy;
+}
+
+inline G4double FastSimConfig::GetActiveScale() const {
+  return fActiveScale;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
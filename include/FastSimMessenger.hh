@@ -0,0 +1,44 @@
+/// \file FastSimMessenger.hh
+/// \brief Definition of the FastSimMessenger class
+
+#ifndef FastSimMessenger_h
+#define FastSimMessenger_h 1
+
+#include "G4UImessenger.hh"
+#include "globals.hh"
+
+class FastSimConfig;
+class G4UIdirectory;
+class G4UIcommand;
+class G4UIcmdWithAString;
+class G4UIcmdWithADouble;
+class G4UIcmdWithADoubleAndUnit;
+class G4UIcmdWithoutParameter;
+
+/// Messenger for the FastSimConfig class.
+///
+/// Defines the /ATHENA/fastsim/ commands. The commands are executed on the
+/// master only, the workers read the shared FastSimConfig.
+
+class FastSimMessenger : public G4UImessenger
+{
+  public:
+    FastSimMessenger(FastSimConfig* config);
+    virtual ~FastSimMessenger();
+
+    virtual void SetNewValue(G4UIcommand* command, G4String newValue);
+
+  private:
+    FastSimConfig*             fConfig;
+
+    G4UIdirectory*             fFastSimDir;
+    G4UIcmdWithAString*        fModeCmd;
+    G4UIcmdWithADoubleAndUnit* fMinEnergyCmd;
+    G4UIcmdWithADoubleAndUnit* fSpotEnergyCmd;
+    G4UIcmdWithADouble*        fActiveScaleCmd;
+    G4UIcmdWithoutParameter*   fPrintCmd;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
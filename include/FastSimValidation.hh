@@ -0,0 +1,46 @@
+/// \file FastSimValidation.hh
+/// \brief Definition of the FastSimValidation class
+
+#ifndef FastSimValidation_h
+#define FastSimValidation_h 1
+
+#include "globals.hh"
+#include "Moments.hh"
+
+#include <array>
+
+struct EventRecord;
+
+/// Side-by-side comparison of the fully simulated events and of the events
+/// with showers parameterised by ECalShowerModel or taken from a shower
+/// library by ShowerLibraryModel, accumulated during the run (see
+/// /ATHENA/fastsim/mode validate).
+///
+/// The events are split by their number of fast-simulated showers; for
+/// each group the mean and sigma of the ECal active, absorber and total
+/// energies, of the ECal sampling fraction and transverse widths, of the
+/// HCal active and total energies and of the simulation time per event are
+/// accumulated. Each thread fills its own validation, merged at the end of
+/// the run.
+
+class FastSimValidation
+{
+  public:
+    void Reset();
+    void Fill(const EventRecord& record);
+    void Merge(const FastSimValidation& other);
+
+    void Print() const;
+
+  private:
+    enum Quantity { kECalActive, kECalAbsorber, kECalTotal, kSamplingFraction,
+                    kECalWidthX, kECalWidthY, kHCalActive, kHCalTotal, kTime, kNofQuantities };
+    using Accumulators = std::array<Moments, kNofQuantities>;
+
+    Accumulators fFull;
+    Accumulators fFast;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -13,5 +13,7 @@ namespace GlobalValues
     extern const G4int NumHCalLayers; // Number of total layers in HCal
     extern const G4int NumHCalTowers; // One-dimensional number of towers. Current is 6x6, so this = 6
     extern const G4int NumECalBlocks; // One-dimensional number of blocks. Current is 8x8, so this = 8
+    extern const G4int NumTailCatcherLayers; // Last HCal layers used as tail catcher
+    extern const G4double ECalThickness; // z-dimension of the ECal blocks, centred at z = 0
 }
 #endif
\ No newline at end of file
@@ -0,0 +1,27 @@
+/// \file Moments.hh
+/// \brief Definition of the Moments struct
+
+#ifndef Moments_h
+#define Moments_h 1
+
+#include "globals.hh"
+
+/// Running mean and sum of squared deviations of a quantity, accumulated
+/// with Welford's algorithm; the accumulators of the threads are combined
+/// with Merge() (Chan et al.).
+
+struct Moments
+{
+  G4double n    = 0.;
+  G4double mean = 0.;
+  G4double m2   = 0.;
+
+  void     Add(G4double x);
+  void     Merge(const Moments& other);
+  G4double GetSigma() const;
+  G4double GetResolution() const;  ///< sigma/mean
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,76 @@
+/// \file NpyWriter.hh
+/// \brief Definition of the NpyWriter class
+
+#ifndef NpyWriter_h
+#define NpyWriter_h 1
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+/// Writer of a NumPy .npy file (format version 1.0) filled record by record.
+///
+/// The file holds an array of shape (N, <record shape>) in C order, so it
+/// can be memory-mapped without copy, e.g. numpy.load(name, mmap_mode="r").
+/// The header is written with a fixed width, and the number of records N
+/// is rewritten in place at every Flush() and at Close(): a file whose
+/// writer was killed is readable up to the last flush.
+/// The class does not depend on Geant4.
+
+class NpyWriter
+{
+  public:
+    NpyWriter();
+    ~NpyWriter();
+
+    /// descr is the NumPy type description, e.g. "'<f4'" or a list of
+    /// fields "[('a', '<i4'), ('b', '<f4')]"; recordSize must match it
+    bool Open(const std::string& fileName, const std::string& descr,
+              const std::vector<std::size_t>& recordShape, std::size_t recordSize);
+    bool Append(const void* record);
+    void Flush();
+    void Close();
+
+    // get methods
+    bool               IsOpen() const;
+    const std::string& GetFileName() const;
+    std::uint64_t      GetNumberOfRecords() const;
+    std::uint64_t      GetBytesWritten() const;
+
+    /// IEEE 754 half precision, rounded to nearest even
+    static std::uint16_t ToFloat16(float value);
+
+  private:
+    bool WriteHeader();
+
+    std::FILE*               fFile;
+    std::string              fFileName;
+    std::string              fDescr;
+    std::vector<std::size_t> fRecordShape;
+    std::size_t              fRecordSize;
+    std::size_t              fHeaderSize;
+    std::uint64_t            fNofRecords;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+inline bool NpyWriter::IsOpen() const {
+  return fFile != nullptr;
+}
+
+inline const std::string& NpyWriter::GetFileName() const {
+  return fFileName;
+}
+
+inline std::uint64_t NpyWriter::GetNumberOfRecords() const {
+  return fNofRecords;
+}
+
+inline std::uint64_t NpyWriter::GetBytesWritten() const {
+  return fHeaderSize + fNofRecords*fRecordSize;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
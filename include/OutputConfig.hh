@@ -0,0 +1,241 @@
+/// \file OutputConfig.hh
+/// \brief Definition of the OutputConfig class
+
+#ifndef OutputConfig_h
+#define OutputConfig_h 1
+
+#include "globals.hh"
+#include "G4ThreeVector.hh"
+#include "ColumnarFormat.hh"
+#include "StepFormat.hh"
+
+#include <vector>
+
+class OutputMessenger;
+
+/// Output configuration shared by the master and worker threads.
+///
+/// The settings are filled on the master via the /ATHENA/output/ commands
+/// (see OutputMessenger) before the first run and are only read by the
+/// workers afterwards:
+/// - output format: Root ntuples merged on the master, per-thread columnar
+///   files (see ColumnarWriter), or both; in addition, dense tensor files
+///   for ML training (see TensorWriter) with float32 or float16 values,
+/// - precision (float or double) of the energy columns of each ntuple,
+/// - cell tables: the ECalBlocks, HCalTowers and HCalTiles rows can be
+///   left out, e.g. when the clusters are enough,
+/// - compression algorithm and level of the output file,
+/// - basket size and number of entries per basket (auto-flush),
+/// - streaming: completed events are flushed to the output every N events
+///   and/or every M megabytes instead of being kept until the end of run,
+/// - asynchronous columnar output: the workers queue their events for a
+///   dedicated writer thread (see AsyncWriter), with the queue size,
+/// - event ordering: the writer thread emits the events in eventID order,
+/// - sampled step output of the ECal (see StepRecorder): prescale, volumes,
+///   region, energy threshold, maximum steps per event and grid.
+///
+/// The ntuple precision is applied when the ntuples are booked, i.e. at the
+/// beginning of the first run, as is the ntuple merging which streaming
+/// turns off. GetSchema() describes the tables and columns
+/// shared by both formats.
+
+class OutputConfig
+{
+  public:
+    static OutputConfig* Instance();
+    ~OutputConfig();
+
+    // Ntuples in booking order; the index is the ntuple id
+    static const std::vector<G4String>& GetNtupleNames();
+    static G4int GetNtupleId(const G4String& ntupleName);
+
+    // Tables and columns of the output with the configured precision
+    ColumnarFormat::Schema GetSchema() const;
+
+    // set methods
+    void SetOutputFormat(const G4String& format);
+    void SetFloatPrecision(const G4String& ntupleName, G4bool useFloat);
+    void SetCellTables(G4bool cells);
+    void SetCompressionAlgorithm(const G4String& algorithm);
+    void SetCompressionLevel(G4int level);
+    void SetBasketSize(G4int basketSize);
+    void SetBasketEntries(G4int basketEntries);
+    void SetFlushEvents(G4int nofEvents);
+    void SetFlushSize(G4double megaBytes);
+    void SetTensorOutput(G4bool tensors);
+    void SetTensorFloat16(G4bool float16);
+    void SetAsyncWriter(G4bool async);
+    void SetQueueSize(G4int nofEvents);
+    void SetReorderEvents(G4bool reorder);
+    void SetStepPrescale(G4int prescale);
+    void SetStepVolumes(const G4String& volumes);
+    void SetStepRegion(const G4ThreeVector& min, const G4ThreeVector& max);
+    void SetStepMinEdep(G4double minEdep);
+    void SetStepMaxSteps(G4int maxSteps);
+    void SetStepGrid(const StepFormat::Grid& grid);
+
+    // get methods
+    G4bool   IsRootOutput() const;
+    G4bool   IsColumnarOutput() const;
+    G4bool   IsFloatPrecision(G4int ntupleId) const;
+    G4bool   IsCellTables() const;
+    G4String GetCompressionAlgorithm() const;
+    G4int    GetCompressionLevel() const;
+    G4int    GetBasketSize() const;
+    G4int    GetBasketEntries() const;
+    G4bool   IsStreaming() const;
+    G4int    GetFlushEvents() const;
+    G4double GetFlushSize() const;
+    G4bool   IsTensorOutput() const;
+    G4bool   IsTensorFloat16() const;
+    G4bool   IsAsyncWriter() const;
+    G4int    GetQueueSize() const;
+    G4bool   IsReorderEvents() const;
+    G4bool   IsStepOutput() const;
+    G4int    GetStepPrescale() const;
+    G4String GetStepVolumes() const;
+    G4bool   IsStepRegion() const;
+    G4ThreeVector GetStepRegionMin() const;
+    G4ThreeVector GetStepRegionMax() const;
+    G4double GetStepMinEdep() const;
+    G4int    GetStepMaxSteps() const;
+    StepFormat::Grid GetStepGrid() const;
+
+    void Print() const;
+
+  private:
+    OutputConfig();
+
+    static OutputConfig* fInstance;
+
+    OutputMessenger*    fMessenger;
+    G4String fOutputFormat;               ///< "root", "columnar" or "both"
+    std::vector<G4bool> fFloatPrecision;  ///< Per ntuple: book energies as float
+    G4bool   fCellTables;                 ///< Write the rows of the cell tables
+    G4String fCompressionAlgorithm;       ///< "zlib" or "none"
+    G4int    fCompressionLevel;           ///< zlib level (0-9)
+    G4int    fBasketSize;                 ///< Basket size in bytes, 0 = default
+    G4int    fBasketEntries;              ///< Entries per basket, 0 = default
+    G4int    fFlushEvents;                ///< Flush every N events, 0 = off
+    G4double fFlushSize;                  ///< Flush every M MB buffered, 0 = off
+    G4bool   fTensorOutput;               ///< Write the .npy tensor files
+    G4bool   fTensorFloat16;              ///< Tensor values as float16
+    G4bool   fAsyncWriter;                ///< Columnar output via a writer thread
+    G4int    fQueueSize;                  ///< Events queued for the writer thread
+    G4bool   fReorderEvents;              ///< Writer thread output in eventID order
+    G4int    fStepPrescale;               ///< Record the steps of every N-th event, 0 = off
+    G4String fStepVolumes;                ///< "fibers" or "ecal"
+    G4ThreeVector fStepRegionMin;         ///< Region of the recorded steps;
+    G4ThreeVector fStepRegionMax;         ///< no region if empty
+    G4double fStepMinEdep;                ///< Minimum deposit of a recorded step
+    G4int    fStepMaxSteps;               ///< Steps per event, 0 = no limit
+    StepFormat::Grid fStepGrid;           ///< Quantisation of the steps
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+inline G4bool OutputConfig::IsRootOutput() const {
+  return fOutputFormat != "columnar";
+}
+
+inline G4bool OutputConfig::IsColumnarOutput() const {
+  return fOutputFormat != "root";
+}
+
+inline G4bool OutputConfig::IsFloatPrecision(G4int ntupleId) const {
+  return fFloatPrecision[ntupleId];
+}
+
+inline G4bool OutputConfig::IsCellTables() const {
+  return fCellTables;
+}
+
+inline G4String OutputConfig::GetCompressionAlgorithm() const {
+  return fCompressionAlgorithm;
+}
+
+inline G4int OutputConfig::GetCompressionLevel() const {
+  return ( fCompressionAlgorithm == "none" ) ? 0 : fCompressionLevel;
+}
+
+inline G4int OutputConfig::GetBasketSize() const {
+  return fBasketSize;
+}
+
+inline G4int OutputConfig::GetBasketEntries() const {
+  return fBasketEntries;
+}
+
+inline G4bool OutputConfig::IsStreaming() const {
+  return fFlushEvents > 0 || fFlushSize > 0.;
+}
+
+inline G4int OutputConfig::GetFlushEvents() const {
+  return fFlushEvents;
+}
+
+inline G4double OutputConfig::GetFlushSize() const {
+  return fFlushSize;
+}
+
+inline G4bool OutputConfig::IsTensorOutput() const {
+  return fTensorOutput;
+}
+
+inline G4bool OutputConfig::IsTensorFloat16() const {
+  return fTensorFloat16;
+}
+
+inline G4bool OutputConfig::IsAsyncWriter() const {
+  return fAsyncWriter && ( IsColumnarOutput() || fTensorOutput );
+}
+
+inline G4int OutputConfig::GetQueueSize() const {
+  return fQueueSize;
+}
+
+inline G4bool OutputConfig::IsReorderEvents() const {
+  return fReorderEvents && IsAsyncWriter();
+}
+
+inline G4bool OutputConfig::IsStepOutput() const {
+  return fStepPrescale > 0;
+}
+
+inline G4int OutputConfig::GetStepPrescale() const {
+  return fStepPrescale;
+}
+
+inline G4String OutputConfig::GetStepVolumes() const {
+  return fStepVolumes;
+}
+
+inline G4bool OutputConfig::IsStepRegion() const {
+  return fStepRegionMin.x() < fStepRegionMax.x()
+      || fStepRegionMin.y() < fStepRegionMax.y()
+      || fStepRegionMin.z() < fStepRegionMax.z();
+}
+
+inline G4ThreeVector OutputConfig::GetStepRegionMin() const {
+  return fStepRegionMin;
+}
+
+inline G4ThreeVector OutputConfig::GetStepRegionMax() const {
+  return fStepRegionMax;
+}
+
+inline G4double OutputConfig::GetStepMinEdep() const {
+  return fStepMinEdep;
+}
+
+inline G4int OutputConfig::GetStepMaxSteps() const {
+  return fStepMaxSteps;
+}
+
+inline StepFormat::Grid OutputConfig::GetStepGrid() const {
+  return fStepGrid;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
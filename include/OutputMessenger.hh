@@ -0,0 +1,64 @@
+/// \file OutputMessenger.hh
+/// \brief Definition of the OutputMessenger class
+
+#ifndef OutputMessenger_h
+#define OutputMessenger_h 1
+
+#include "G4UImessenger.hh"
+#include "globals.hh"
+
+class OutputConfig;
+class G4UIdirectory;
+class G4UIcommand;
+class G4UIcmdWithAString;
+class G4UIcmdWithAnInteger;
+class G4UIcmdWithADouble;
+class G4UIcmdWithADoubleAndUnit;
+class G4UIcmdWithABool;
+class G4UIcmdWithoutParameter;
+
+/// Messenger for the OutputConfig class.
+///
+/// Defines the /ATHENA/output/ commands. The commands are executed on the
+/// master only, the workers read the shared OutputConfig.
+
+class OutputMessenger : public G4UImessenger
+{
+  public:
+    OutputMessenger(OutputConfig* config);
+    virtual ~OutputMessenger();
+
+    virtual void SetNewValue(G4UIcommand* command, G4String newValue);
+
+  private:
+    OutputConfig*            fConfig;
+
+    G4UIdirectory*           fOutputDir;
+    G4UIcmdWithAString*      fFormatCmd;
+    G4UIcommand*             fPrecisionCmd;
+    G4UIcmdWithABool*        fCellTablesCmd;
+    G4UIcmdWithAString*      fCompressionAlgorithmCmd;
+    G4UIcmdWithAnInteger*    fCompressionLevelCmd;
+    G4UIcmdWithAnInteger*    fBasketSizeCmd;
+    G4UIcmdWithAnInteger*    fBasketEntriesCmd;
+    G4UIcmdWithAnInteger*    fFlushEventsCmd;
+    G4UIcmdWithADouble*      fFlushSizeCmd;
+    G4UIcmdWithABool*        fTensorsCmd;
+    G4UIcmdWithAString*      fTensorPrecisionCmd;
+    G4UIcmdWithABool*        fAsyncWriterCmd;
+    G4UIcmdWithAnInteger*    fQueueSizeCmd;
+    G4UIcmdWithABool*        fReorderEventsCmd;
+    G4UIcmdWithoutParameter* fPrintCmd;
+
+    G4UIdirectory*           fStepsDir;
+    G4UIcmdWithAnInteger*    fStepPrescaleCmd;
+    G4UIcmdWithAString*      fStepVolumesCmd;
+    G4UIcommand*             fStepRegionCmd;
+    G4UIcmdWithADoubleAndUnit* fStepMinEdepCmd;
+    G4UIcmdWithAnInteger*    fStepMaxStepsCmd;
+    G4UIcommand*             fStepGridCmd;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
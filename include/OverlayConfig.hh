@@ -0,0 +1,132 @@
+/// \file OverlayConfig.hh
+/// \brief Definition of the OverlayConfig class
+
+#ifndef OverlayConfig_h
+#define OverlayConfig_h 1
+
+#include "globals.hh"
+#include "OverlayLibrary.hh"
+
+#include <cstdint>
+#include <vector>
+
+class OverlayMessenger;
+
+/// Configuration of the event overlay (see EventOverlay), shared by the
+/// master and worker threads.
+///
+/// The settings are filled on the master via the /ATHENA/overlay/ commands
+/// (see OverlayMessenger):
+/// - library: columnar datasets of simulated events, loaded when they are
+///   set (see OverlayLibrary),
+/// - overlaid particles: particle, energy, optional transverse position
+///   and time offset; each event gets one library event per particle,
+///   drawn among those with the same particle and an energy (and position)
+///   within the tolerances,
+/// - pile-up: a Poisson number of library events of any particle, with
+///   time offsets uniform in a window,
+/// - readout gate: the library events with a time offset outside the gate
+///   are drawn but not added,
+/// - whether the primaries of the gun are simulated; without them the
+///   events are built from the library only.
+/// The library events of each particle are selected by the master at the
+/// beginning of each run, with Prepare().
+
+class OverlayConfig
+{
+  public:
+    /// Particle overlaid in each event, with its library events
+    struct Particle
+    {
+      G4String name;
+      G4double energy      = 0.;
+      G4bool   anyPosition = true;
+      G4double posX        = 0.;
+      G4double posY        = 0.;
+      G4double time        = 0.;
+      std::vector<std::uint32_t> events;
+    };
+
+    static OverlayConfig* Instance();
+    ~OverlayConfig();
+
+    // set methods
+    // The path none removes all libraries
+    void AddLibrary(const G4String& path);
+    void AddParticle(const Particle& particle);
+    void ClearParticles();
+    void SetTolerances(G4double energyFraction, G4double distance);
+    void SetPileup(G4double mean, G4double minTime, G4double maxTime);
+    void SetGate(G4double minTime, G4double maxTime);
+    void SetSimulatePrimaries(G4bool simulate);
+
+    // Select the library events of the particles
+    void Prepare();
+
+    // get methods
+    const OverlayLibrary&        GetLibrary() const;
+    const std::vector<Particle>& GetParticles() const;
+    G4double GetPileup() const;
+    G4double GetPileupMinTime() const;
+    G4double GetPileupMaxTime() const;
+    G4bool   IsInGate(G4double time) const;
+    G4bool   IsSimulatingPrimaries() const;
+    G4bool   IsEnabled() const;
+
+    void Print() const;
+
+  private:
+    OverlayConfig();
+
+    static OverlayConfig* fInstance;
+
+    OverlayMessenger*     fMessenger;
+    OverlayLibrary        fLibrary;
+    std::vector<Particle> fParticles;
+    G4double fEnergyTolerance;    ///< Relative
+    G4double fPositionTolerance;
+    G4double fPileup;             ///< Mean number of events, 0 = none
+    G4double fPileupMinTime;
+    G4double fPileupMaxTime;
+    G4double fGateMinTime;
+    G4double fGateMaxTime;
+    G4bool   fSimulatePrimaries;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+inline const OverlayLibrary& OverlayConfig::GetLibrary() const {
+  return fLibrary;
+}
+
+inline const std::vector<OverlayConfig::Particle>& OverlayConfig::GetParticles() const {
+  return fParticles;
+}
+
+inline G4double OverlayConfig::GetPileup() const {
+  return fPileup;
+}
+
+inline G4double OverlayConfig::GetPileupMinTime() const {
+  return fPileupMinTime;
+}
+
+inline G4double OverlayConfig::GetPileupMaxTime() const {
+  return fPileupMaxTime;
+}
+
+inline G4bool OverlayConfig::IsInGate(G4double time) const {
+  return time >= fGateMinTime && time <= fGateMaxTime;
+}
+
+inline G4bool OverlayConfig::IsSimulatingPrimaries() const {
+  return fSimulatePrimaries;
+}
+
+inline G4bool OverlayConfig::IsEnabled() const {
+  return fLibrary.GetNumberOfEvents() > 0 && ( ! fParticles.empty() || fPileup > 0. );
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
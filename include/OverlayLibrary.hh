@@ -0,0 +1,104 @@
+/// \file OverlayLibrary.hh
+/// \brief Definition of the OverlayLibrary class
+
+#ifndef OverlayLibrary_h
+#define OverlayLibrary_h 1
+
+#include "globals.hh"
+
+#include <cstdint>
+#include <vector>
+
+struct EventRecord;
+
+/// Library of simulated events for the event overlay (see OverlayConfig
+/// and EventOverlay).
+///
+/// The events are loaded from columnar datasets written with the cell
+/// tables: per event, the primary particle of the Summary table and the
+/// deposits and pi0 counts of all calorimeter cells. The cells are the
+/// ECal and HCal totals, the ECal blocks, the HCal towers and the HCal
+/// tiles, in the cell order of EventRecord. They are stored as one dense
+/// array of floats per event, one row of cells per quantity (the four
+/// energies in MeV and the two pi0 counts), so that summing events is a
+/// single loop over contiguous values. The library is loaded on the master
+/// and read by all threads.
+
+class OverlayLibrary
+{
+  public:
+    /// Quantities of the cells, in the order of CellRecord
+    enum Quantity { kEdepActive, kEdepPi0Active, kEdepAbsorber, kEdepPi0Absorber,
+                    kNumPi0Active, kNumPi0Absorber, kNofQuantities };
+
+    /// Primary of a library event; kinetic energy in MeV, vertex in cm
+    struct Primary
+    {
+      G4int    pdg    = 0;
+      G4double energy = 0.;
+      G4double posX   = 0.;
+      G4double posY   = 0.;
+    };
+
+    OverlayLibrary();
+    ~OverlayLibrary();
+
+    // Append the events of a columnar file or manifest; false (with a
+    // warning) if it cannot be read or lacks the cell tables
+    G4bool Load(const G4String& path);
+    void   Clear();
+
+    // Events of a particle with an energy within a relative tolerance and,
+    // if checkPosition, a vertex within a distance of (posX, posY)
+    void Find(G4int pdg, G4double energy, G4double energyTolerance,
+              G4bool checkPosition, G4double posX, G4double posY,
+              G4double positionTolerance, std::vector<std::uint32_t>& events) const;
+
+    // Values of an event: GetEventSize() floats, quantity after quantity
+    const float* GetCells(std::size_t event) const;
+
+    // Add the values of an event to a sum of GetEventSize() values
+    static void Add(const float* cells, G4double* sum);
+    // Add a sum of events to the cells of a record
+    static void AddTo(const G4double* sum, EventRecord& record);
+
+    // get methods
+    static std::size_t GetNumberOfCells();
+    static std::size_t GetEventSize();
+    std::size_t            GetNumberOfEvents() const;
+    const Primary&         GetPrimary(std::size_t event) const;
+    const std::vector<G4String>& GetPaths() const;
+    std::uint64_t          GetMemorySize() const;
+
+  private:
+    std::vector<G4String>      fPaths;
+    std::vector<Primary>       fPrimaries;
+    std::vector<float>         fCells;
+    std::vector<std::uint32_t> fOrder; ///< Events sorted by particle and energy
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+inline const float* OverlayLibrary::GetCells(std::size_t event) const {
+  return fCells.data() + event*GetEventSize();
+}
+
+inline std::size_t OverlayLibrary::GetNumberOfEvents() const {
+  return fPrimaries.size();
+}
+
+inline const OverlayLibrary::Primary& OverlayLibrary::GetPrimary(std::size_t event) const {
+  return fPrimaries[event];
+}
+
+inline const std::vector<G4String>& OverlayLibrary::GetPaths() const {
+  return fPaths;
+}
+
+inline std::uint64_t OverlayLibrary::GetMemorySize() const {
+  return fCells.size()*sizeof(float) + fPrimaries.size()*sizeof(Primary);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,46 @@
+/// \file OverlayMessenger.hh
+/// \brief Definition of the OverlayMessenger class
+
+#ifndef OverlayMessenger_h
+#define OverlayMessenger_h 1
+
+#include "G4UImessenger.hh"
+#include "globals.hh"
+
+class OverlayConfig;
+class G4UIdirectory;
+class G4UIcommand;
+class G4UIcmdWithAString;
+class G4UIcmdWithABool;
+class G4UIcmdWithoutParameter;
+
+/// Messenger for the OverlayConfig class.
+///
+/// Defines the /ATHENA/overlay/ commands. The commands are executed on the
+/// master only, the workers read the shared OverlayConfig.
+
+class OverlayMessenger : public G4UImessenger
+{
+  public:
+    OverlayMessenger(OverlayConfig* config);
+    virtual ~OverlayMessenger();
+
+    virtual void SetNewValue(G4UIcommand* command, G4String newValue);
+
+  private:
+    OverlayConfig*           fConfig;
+
+    G4UIdirectory*           fOverlayDir;
+    G4UIcmdWithAString*      fLibraryCmd;
+    G4UIcommand*             fAddCmd;
+    G4UIcmdWithoutParameter* fClearCmd;
+    G4UIcommand*             fToleranceCmd;
+    G4UIcommand*             fPileupCmd;
+    G4UIcommand*             fGateCmd;
+    G4UIcmdWithABool*        fSimulateCmd;
+    G4UIcmdWithoutParameter* fPrintCmd;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
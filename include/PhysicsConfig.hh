@@ -0,0 +1,95 @@
+/// \file PhysicsConfig.hh
+/// \brief Definition of the PhysicsConfig class
+
+#ifndef PhysicsConfig_h
+#define PhysicsConfig_h 1
+
+#include "globals.hh"
+
+class PhysicsMessenger;
+
+/// Options of the physics list, shared by the master and worker threads.
+///
+/// The reference list (e.g. QGSP_BERT, FTFP_BERT, FTFP_BERT_HP), its EM
+/// option (see EmPhysics) and the fast simulation process, needed by the
+/// ECal parameterisation and the shower libraries, are given on the command
+/// line (-p, -e and -f), as the list is built before any macro is executed. The other settings are
+/// filled on the master via the /ATHENA/physics/ commands (see
+/// PhysicsMessenger) before /run/initialize, and are applied by EmPhysics
+/// when the processes are constructed:
+/// - gamma general process: the photon processes are combined in one
+///   G4GammaGeneralProcess, with a single cross-section lookup per step,
+/// - Woodcock tracking: the photons cross the region (by default the ECal
+///   blocks, ECalPowder) with the maximum cross-section of its materials,
+///   without stopping at the fiber boundaries; it requires the gamma
+///   general process, which it enables.
+/// The physics table cache directory (see PhysicsTableCache) can also be
+/// changed between runs.
+
+class PhysicsConfig
+{
+  public:
+    static PhysicsConfig* Instance();
+    ~PhysicsConfig();
+
+    // set methods
+    void SetPhysicsList(const G4String& name);
+    void SetEmOption(const G4String& option);
+    void SetFastSimulation(G4bool active);
+    void SetGammaGeneralProcess(G4bool active);
+    void SetWoodcockRegion(const G4String& regionName);
+    void SetTableCache(const G4String& directory);
+
+    // get methods
+    const G4String& GetPhysicsList() const;
+    const G4String& GetEmOption() const;
+    G4bool          IsFastSimulation() const;
+    G4bool          IsGammaGeneralProcess() const;
+    const G4String& GetWoodcockRegion() const;  ///< empty = no Woodcock tracking
+    const G4String& GetTableCache() const;      ///< empty = no physics table cache
+
+    void Print() const;
+
+  private:
+    PhysicsConfig();
+
+    static PhysicsConfig* fInstance;
+
+    PhysicsMessenger* fMessenger;
+    G4String fPhysicsList;
+    G4String fEmOption;
+    G4bool   fFastSimulation;
+    G4bool   fGammaGeneralProcess;
+    G4String fWoodcockRegion;
+    G4String fTableCache;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+inline const G4String& PhysicsConfig::GetPhysicsList() const {
+  return fPhysicsList;
+}
+
+inline const G4String& PhysicsConfig::GetEmOption() const {
+  return fEmOption;
+}
+
+inline G4bool PhysicsConfig::IsFastSimulation() const {
+  return fFastSimulation;
+}
+
+inline G4bool PhysicsConfig::IsGammaGeneralProcess() const {
+  return fGammaGeneralProcess || ! fWoodcockRegion.empty();
+}
+
+inline const G4String& PhysicsConfig::GetWoodcockRegion() const {
+  return fWoodcockRegion;
+}
+
+inline const G4String& PhysicsConfig::GetTableCache() const {
+  return fTableCache;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,41 @@
+/// \file PhysicsMessenger.hh
+/// \brief Definition of the PhysicsMessenger class
+
+#ifndef PhysicsMessenger_h
+#define PhysicsMessenger_h 1
+
+#include "G4UImessenger.hh"
+#include "globals.hh"
+
+class PhysicsConfig;
+class G4UIdirectory;
+class G4UIcmdWithABool;
+class G4UIcmdWithAString;
+class G4UIcmdWithoutParameter;
+
+/// Messenger for the PhysicsConfig class.
+///
+/// Defines the /ATHENA/physics/ commands. The processes are constructed at
+/// /run/initialize, so the process options are only available before it.
+
+class PhysicsMessenger : public G4UImessenger
+{
+  public:
+    PhysicsMessenger(PhysicsConfig* config);
+    virtual ~PhysicsMessenger();
+
+    virtual void SetNewValue(G4UIcommand* command, G4String newValue);
+
+  private:
+    PhysicsConfig*           fConfig;
+
+    G4UIdirectory*           fPhysicsDir;
+    G4UIcmdWithABool*        fGammaGeneralCmd;
+    G4UIcmdWithAString*      fWoodcockCmd;
+    G4UIcmdWithAString*      fTableCacheCmd;
+    G4UIcmdWithoutParameter* fPrintCmd;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,59 @@
+/// \file PhysicsTableCache.hh
+/// \brief Definition of the PhysicsTableCache class
+
+#ifndef PhysicsTableCache_h
+#define PhysicsTableCache_h 1
+
+#include "G4VStateDependent.hh"
+#include "G4Timer.hh"
+#include "globals.hh"
+
+class G4VUserPhysicsList;
+
+/// Cache of the physics tables (see /ATHENA/physics/tableCache), using the
+/// store and retrieve methods of the physics list.
+///
+/// The cache follows the state of the master: before the physics tables
+/// are built at the beginning of a run (Idle to Init), the key of the
+/// current configuration is made of the Geant4 version, the physics list
+/// and its options, the EM parameters, the production cuts of the regions
+/// and the materials. Its entry is the sub-directory named by the hash of
+/// the key, holding the tables and the key itself. If the stored key
+/// matches, the tables are retrieved; Geant4 checks in addition the
+/// materials and cuts of the stored couples and builds any table it cannot
+/// read. Otherwise the tables are built and stored when the state returns
+/// to Idle, and the key is written last so that an interrupted job leaves
+/// no valid entry. The time to build or retrieve the tables is printed at
+/// each build, also without cache.
+///
+/// Only the tables of the processes which support it (mostly EM) are
+/// stored; the hadronic cross sections are still computed at each job.
+
+class PhysicsTableCache : public G4VStateDependent
+{
+  public:
+    // Created on the master, after the physics list; it is deleted by the
+    // state manager
+    PhysicsTableCache(G4VUserPhysicsList* physicsList);
+    virtual ~PhysicsTableCache();
+
+    virtual G4bool Notify(G4ApplicationState requestedState);
+
+  private:
+    void        BeginBuild();
+    void        EndBuild();
+    std::string MakeKey() const;
+
+    G4VUserPhysicsList* fPhysicsList;
+
+    // current build; the key is kept to detect the runs without new tables
+    G4bool      fBuilding;
+    G4bool      fRetrieved;
+    G4String    fDirectory;
+    std::string fKey;
+    G4Timer     fTimer;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,95 @@
+/// \file RandomConfig.hh
+/// \brief Definition of the RandomConfig class
+
+#ifndef RandomConfig_h
+#define RandomConfig_h 1
+
+#include "globals.hh"
+
+class RandomMessenger;
+
+/// Seeding of the random engine, shared by the master and worker threads.
+///
+/// With per-event seeding (/ATHENA/random/eventSeeding true, and always in
+/// the shard runs and replays), the engine of the thread simulating an
+/// event is reseeded at the beginning of the event (in
+/// PrimaryGeneratorAction::GeneratePrimaries(), before the gun) with seeds
+/// derived from the run seed and the eventID only. An event is then the
+/// same whatever the thread, the number of threads and the events
+/// simulated before it, so that a range of eventIDs can be simulated by
+/// another process (see ShardConfig) and a single event can be replayed
+/// (see Replay()). The seeds are written in the Summary table. As the
+/// eventIDs restart at 0 in each run, runs with the same run seed repeat
+/// the same events. By default the engines keep the seeds given by the
+/// run manager (e.g. by /random/setSeeds), which differ between runs.
+///
+/// The settings are filled on the master via the /ATHENA/random/ commands
+/// (see RandomMessenger).
+
+class RandomConfig
+{
+  public:
+    static RandomConfig* Instance();
+    ~RandomConfig();
+
+    // Seeds of an event, in [1, 2^31-1]
+    static void GetEventSeeds(G4long runSeed, G4int eventID, long seeds[2]);
+
+    // set methods
+    void SetSeed(G4long seed);
+    void SetEventSeeding(G4bool eventSeeding);
+
+    // Reseed the engine of the calling thread for an event, with per-event
+    // seeding only
+    void SeedEvent(G4int eventID) const;
+
+    // Simulate again the event of an eventID of a run with the same seed
+    // and settings; on the master, in the Idle state
+    void Replay(G4int eventID);
+
+    // get methods
+    G4long GetSeed() const;
+    G4bool IsEventSeeding() const;
+    // eventID being replayed, -1 outside of a replay
+    G4int  GetReplayEvent() const;
+    // Suffix of the output file names, empty outside of a replay
+    G4String GetOutputSuffix() const;
+
+    void Print() const;
+
+  private:
+    RandomConfig();
+
+    static RandomConfig* fInstance;
+
+    RandomMessenger* fMessenger;
+    G4long           fSeed;
+    G4bool           fEventSeeding;
+    G4int            fReplayEvent;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+inline void RandomConfig::SetSeed(G4long seed) {
+  fSeed = seed;
+}
+
+inline void RandomConfig::SetEventSeeding(G4bool eventSeeding) {
+  fEventSeeding = eventSeeding;
+}
+
+inline G4long RandomConfig::GetSeed() const {
+  return fSeed;
+}
+
+inline G4bool RandomConfig::IsEventSeeding() const {
+  return fEventSeeding;
+}
+
+inline G4int RandomConfig::GetReplayEvent() const {
+  return fReplayEvent;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,42 @@
+/// \file RandomMessenger.hh
+/// \brief Definition of the RandomMessenger class
+
+#ifndef RandomMessenger_h
+#define RandomMessenger_h 1
+
+#include "G4UImessenger.hh"
+#include "globals.hh"
+
+class RandomConfig;
+class G4UIdirectory;
+class G4UIcmdWithAnInteger;
+class G4UIcmdWithABool;
+class G4UIcmdWithoutParameter;
+
+/// Messenger for the RandomConfig class.
+///
+/// Defines the /ATHENA/random/ commands. The commands are executed on the
+/// master only; the workers read the shared configuration.
+/// /ATHENA/random/replay starts the run of the replayed event.
+
+class RandomMessenger : public G4UImessenger
+{
+  public:
+    RandomMessenger(RandomConfig* config);
+    virtual ~RandomMessenger();
+
+    virtual void SetNewValue(G4UIcommand* command, G4String newValue);
+
+  private:
+    RandomConfig*            fConfig;
+
+    G4UIdirectory*           fRandomDir;
+    G4UIcmdWithAnInteger*    fSeedCmd;
+    G4UIcmdWithABool*        fEventSeedingCmd;
+    G4UIcmdWithAnInteger*    fReplayCmd;
+    G4UIcmdWithoutParameter* fPrintCmd;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
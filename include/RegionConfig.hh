@@ -0,0 +1,72 @@
+/// \file RegionConfig.hh
+/// \brief Definition of the RegionConfig class
+
+#ifndef RegionConfig_h
+#define RegionConfig_h 1
+
+#include "globals.hh"
+
+#include <vector>
+
+class RegionMessenger;
+class G4Region;
+class G4UserLimits;
+
+/// Production cuts and step limits of the detector regions.
+///
+/// DetectorConstruction defines one G4Region per material zone:
+/// - ECalFibers: fiber cores and cladding,
+/// - ECalPowder: tungsten powder of the ECal blocks and the glue,
+/// - HCalAbsorber: HCal towers with their steel plates and WLS plates,
+/// - HCalScintillator: HCal scintillating tiles,
+/// - World: the default region of the world volume.
+///
+/// The settings are filled on the master via the /ATHENA/regions/ commands
+/// (see RegionMessenger). They are applied by Apply(), called when the
+/// regions are created and by each command once they exist; Geant4 rebuilds
+/// its cut tables at the next run. A region without a cut keeps the global
+/// cut of /run/setCut; the World cut is the global cut itself, whichever
+/// of the two commands comes last wins. The step limits are G4UserLimits
+/// on the logical volumes of the region, enforced by the step limiter
+/// registered in the physics list; a limit of 0 removes it.
+
+class RegionConfig
+{
+  public:
+    static RegionConfig* Instance();
+    ~RegionConfig();
+
+    // Regions defined by DetectorConstruction; the index is the region id
+    static const std::vector<G4String>& GetRegionNames();
+    static G4int GetRegionId(const G4String& regionName);
+
+    // set methods
+    void SetCut(const G4String& regionName, G4double cut);
+    void SetStepLimit(const G4String& regionName, G4double stepLimit);
+
+    // get methods
+    G4double GetCut(const G4String& regionName) const;        ///< -1 if not set
+    G4double GetStepLimit(const G4String& regionName) const;  ///< 0 if none
+
+    // Apply the settings to the regions which exist
+    void Apply();
+
+    void Print() const;
+
+  private:
+    RegionConfig();
+
+    G4Region* GetRegion(G4int id) const;
+    void ApplyStepLimit(G4int id, G4Region* region);
+
+    static RegionConfig* fInstance;
+
+    RegionMessenger* fMessenger;
+    std::vector<G4double> fCuts;        ///< Per region, -1 = global cut
+    std::vector<G4double> fStepLimits;  ///< Per region, 0 = none
+    std::vector<G4UserLimits*> fUserLimits;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
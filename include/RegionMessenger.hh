@@ -0,0 +1,39 @@
+/// \file RegionMessenger.hh
+/// \brief Definition of the RegionMessenger class
+
+#ifndef RegionMessenger_h
+#define RegionMessenger_h 1
+
+#include "G4UImessenger.hh"
+#include "globals.hh"
+
+class RegionConfig;
+class G4UIdirectory;
+class G4UIcommand;
+class G4UIcmdWithoutParameter;
+
+/// Messenger for the RegionConfig class.
+///
+/// Defines the /ATHENA/regions/ commands. The commands are executed on the
+/// master only, the regions and their settings are shared by the workers.
+
+class RegionMessenger : public G4UImessenger
+{
+  public:
+    RegionMessenger(RegionConfig* config);
+    virtual ~RegionMessenger();
+
+    virtual void SetNewValue(G4UIcommand* command, G4String newValue);
+
+  private:
+    RegionConfig*            fConfig;
+
+    G4UIdirectory*           fRegionsDir;
+    G4UIcommand*             fCutCmd;
+    G4UIcommand*             fStepLimitCmd;
+    G4UIcmdWithoutParameter* fPrintCmd;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,75 @@
+/// \file ResolutionScan.hh
+/// \brief Definition of the ResolutionScan class
+
+#ifndef ResolutionScan_h
+#define ResolutionScan_h 1
+
+#include "globals.hh"
+#include "ColumnarFormat.hh"
+#include "Moments.hh"
+
+#include <vector>
+
+struct EventRecord;
+
+/// Energy resolution and ECal weight scan accumulated during the run, as
+/// done offline by Resolution.cpp.
+///
+/// For each event the total active energy ECal/w + HCal is computed for
+/// every weight w of the grid, with the HCal summed over the tiles above
+/// the tile cut (no smearing). Events with more than the veto fraction of
+/// this energy in the tail catcher (last NumTailCatcherLayers layers) are
+/// vetoed. For the unweighted energy and for every weight the mean and
+/// variance are accumulated with Welford's algorithm, before and after the
+/// veto, and the vetoed energies are histogrammed.
+///
+/// Each thread fills its own scan without locking; the scans of the
+/// threads are merged at the end of the run with Merge(). The resolution
+/// is sigma/mean of the accumulated energies. The histograms
+/// (GetHistograms()) have the binning { nofBins, 0, maxEnergy [MeV] } and
+/// nofBins + 2 contents: underflow, the bins, overflow.
+
+class ResolutionScan
+{
+  public:
+    ResolutionScan();
+
+    // Take the settings of AnalysisConfig and clear the accumulators
+    void Configure();
+    void Fill(const EventRecord& record);
+    // Returns false if the other scan has different settings
+    G4bool Merge(const ResolutionScan& other);
+
+    // get methods
+    G4double GetNumberOfEvents() const;
+    G4int    GetOptimalWeightIndex() const;
+    std::vector<ColumnarFormat::Histogram> GetHistograms() const;
+
+    void Print() const;
+
+  private:
+    void FillHistogram(std::vector<G4double>& histogram, G4double energy) const;
+
+    std::vector<G4double> fWeights;
+    G4double              fTailVeto;
+    G4double              fTileCut;
+    G4int                 fNofBins;
+    G4double              fMaxEnergy;
+
+    Moments               fTotal;        ///< ECal + HCal, all events
+    Moments               fTotalVetoed;  ///< ECal + HCal, after the veto
+    std::vector<Moments>  fWeighted;     ///< Per weight, all events
+    std::vector<Moments>  fVetoed;       ///< Per weight, after the veto
+    std::vector<G4double> fTotalHistogram;
+    std::vector<std::vector<G4double>> fHistograms; ///< Per weight, after the veto
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+inline G4double ResolutionScan::GetNumberOfEvents() const {
+  return fTotal.n;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,28 @@
+/// \file RowSink.hh
+/// \brief Definition of the RowSink interface
+
+#ifndef RowSink_h
+#define RowSink_h 1
+
+/// Interface of an ntuple-like output filled column by column.
+///
+/// It mirrors the Fill*Column()/AddNtupleRow() calls of the Geant4 analysis
+/// manager, so that the same code (EventRecord::FillRows()) fills the Root
+/// ntuples and the columnar files. Energy columns are converted to the
+/// precision the table was booked with; position columns are always
+/// double. EndEvent() closes the rows of one event, which lets a sink
+/// index them.
+
+class RowSink
+{
+  public:
+    virtual ~RowSink() {}
+
+    virtual void FillEnergyColumn(int tableId, int columnId, double value) = 0;
+    virtual void FillPositionColumn(int tableId, int columnId, double value) = 0;
+    virtual void FillIntColumn(int tableId, int columnId, int value) = 0;
+    virtual void AddRow(int tableId) = 0;
+    virtual void EndEvent(int /*eventID*/) {}
+};
+
+#endif
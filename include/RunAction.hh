@@ -1,4 +1,3 @@
-
 /// \file RunAction.hh
 /// \brief Definition of the RunAction class
 
@@ -6,11 +5,22 @@
 #define RunAction_h 1
 
 #include "G4UserRunAction.hh"
+#include "G4Timer.hh"
 #include "globals.hh"
 
 class G4Run;
+class ColumnarWriter;
+class TensorWriter;
+class ResolutionScan;
+class ShowerMaps;
+class FastSimValidation;
+struct EventRecord;
 
 /// Run action class
+///
+/// Books the output at the first run, opens and closes the event writers
+/// of each thread (see OutputConfig) and merges the per-thread analysis
+/// results on the master at the end of each run.
 
 class RunAction : public G4UserRunAction
 {
@@ -20,6 +30,36 @@ class RunAction : public G4UserRunAction
 
     virtual void BeginOfRunAction(const G4Run*);
     virtual void   EndOfRunAction(const G4Run*);
+
+    // Write one event to the configured outputs of this thread;
+    // with the writer thread the record is handed over and replaced
+    // by an empty one
+    void WriteEvent(EventRecord& record);
+
+  private:
+    // methods
+    void     BookNtuples();
+    G4String GetOutputName() const;
+    G4String GetColumnarFileName(G4int threadId) const;
+    void     OpenEventWriters();
+    void     CloseEventWriters();
+    void     FlushEventWriters();
+    void     OpenStepRecorder();
+    void     WriteColumnarManifest(const G4Run* run, G4double writeTime);
+    void     PrintOutputStatistics(const G4Run* run, const G4String& fileName,
+                                   G4double fileSize, G4double writeTime) const;
+    void     PrintPerformance(const G4Run* run) const;
+
+    // data members
+    G4bool          fNtuplesBooked;
+    G4Timer         fRunTimer;
+    ColumnarWriter* fColumnarWriter;
+    TensorWriter*   fTensorWriter;
+    G4int           fNofEventsSinceFlush;
+    G4int           fNofFlushes;
+    ResolutionScan* fResolutionScan;
+    ShowerMaps*     fShowerMaps;
+    FastSimValidation* fFastSimValidation;
 };
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
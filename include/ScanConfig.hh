@@ -0,0 +1,86 @@
+/// \file ScanConfig.hh
+/// \brief Definition of the ScanConfig class
+
+#ifndef ScanConfig_h
+#define ScanConfig_h 1
+
+#include "globals.hh"
+#include "G4ThreeVector.hh"
+
+#include <utility>
+#include <vector>
+
+class ScanMessenger;
+
+/// Parameter scan run in one process: a list of points (particle, energy,
+/// angle, number of events and output file) simulated back-to-back by the
+/// same initialised run manager and worker threads.
+///
+/// The points are filled on the master via the /ATHENA/scan/ commands (see
+/// ScanMessenger) and run by Run(), one run per point. Before each run the
+/// gun (G4GeneralParticleSource) is set with the /gps/ commands: the
+/// particle, a mono-energetic spectrum and the direction at the angle to
+/// the z axis in the y-z plane, as in mymac_WScFi.mac; if a gun centre was
+/// given for the angle, it is set as well, otherwise the centre of the
+/// macro is kept. The RunAction of each thread takes the output file name
+/// of the current point (GetCurrentPoint()) instead of the one of
+/// /analysis/setFileName. The time and events/s of each point are printed
+/// at the end of the scan.
+
+class ScanConfig
+{
+  public:
+    /// Point of the scan
+    struct Point
+    {
+      G4String particle;
+      G4double energy    = 0.;
+      G4double angle     = 0.;
+      G4int    nofEvents = 0;
+      G4String output;
+    };
+
+    static ScanConfig* Instance();
+    ~ScanConfig();
+
+    // set methods
+    void AddPoint(const Point& point);
+    void SetCentre(G4double angle, const G4ThreeVector& centre);
+    void Clear();
+
+    // Run all points; on the master, in the Idle state
+    void Run();
+
+    // get methods
+    const std::vector<Point>& GetPoints() const;
+    // Point being run, nullptr outside of a scan
+    const Point* GetCurrentPoint() const;
+
+    void Print() const;
+
+  private:
+    ScanConfig();
+
+    const G4ThreeVector* FindCentre(G4double angle) const;
+
+    static ScanConfig* fInstance;
+
+    ScanMessenger*      fMessenger;
+    std::vector<Point>  fPoints;
+    std::vector<std::pair<G4double, G4ThreeVector>> fCentres; ///< Gun centre per angle
+    G4int               fCurrentPoint;  ///< -1 outside of a scan
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+inline const std::vector<ScanConfig::Point>& ScanConfig::GetPoints() const {
+  return fPoints;
+}
+
+inline const ScanConfig::Point* ScanConfig::GetCurrentPoint() const {
+  return ( fCurrentPoint >= 0 ) ? &fPoints[fCurrentPoint] : nullptr;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,41 @@
+/// \file ScanMessenger.hh
+/// \brief Definition of the ScanMessenger class
+
+#ifndef ScanMessenger_h
+#define ScanMessenger_h 1
+
+#include "G4UImessenger.hh"
+#include "globals.hh"
+
+class ScanConfig;
+class G4UIdirectory;
+class G4UIcommand;
+class G4UIcmdWithoutParameter;
+
+/// Messenger for the ScanConfig class.
+///
+/// Defines the /ATHENA/scan/ commands. The commands are executed on the
+/// master only; /ATHENA/scan/run starts the runs of the points.
+
+class ScanMessenger : public G4UImessenger
+{
+  public:
+    ScanMessenger(ScanConfig* config);
+    virtual ~ScanMessenger();
+
+    virtual void SetNewValue(G4UIcommand* command, G4String newValue);
+
+  private:
+    ScanConfig*              fConfig;
+
+    G4UIdirectory*           fScanDir;
+    G4UIcommand*             fAddPointCmd;
+    G4UIcommand*             fCentreCmd;
+    G4UIcmdWithoutParameter* fClearCmd;
+    G4UIcmdWithoutParameter* fRunCmd;
+    G4UIcmdWithoutParameter* fPrintCmd;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,86 @@
+/// \file ShardConfig.hh
+/// \brief Definition of the ShardConfig class
+
+#ifndef ShardConfig_h
+#define ShardConfig_h 1
+
+#include "globals.hh"
+
+class ShardMessenger;
+
+/// Job sharding: a production of a total number of events is split into
+/// shards simulated by independent processes, e.g. on the nodes of a
+/// farm. Shard i of N simulates the eventIDs [T*i/N, T*(i+1)/N) of the T
+/// events, with per-event seeding (see RandomConfig), so that the union
+/// of the shards is the same as the run of the T events in one process,
+/// whatever N and the number of threads of each process.
+///
+/// The shard is selected on the master via the /ATHENA/shard/select
+/// command (see ShardMessenger) or the -s index/count option of the
+/// executable, and run by BeamOn(), which replaces /run/beamOn. During
+/// the run, the eventIDs are offset by the first eventID of the shard in
+/// PrimaryGeneratorAction::GeneratePrimaries(), the output files get the
+/// _shard<index> suffix and the columnar manifest records the shard (see
+/// GetDescription()).
+
+class ShardConfig
+{
+  public:
+    static ShardConfig* Instance();
+    ~ShardConfig();
+
+    // set methods; return false if the index is not below the count
+    G4bool SetShard(G4int index, G4int count);
+
+    // Run the events of the shard; on the master, in the Idle state
+    void BeamOn(G4int totalEvents);
+
+    // get methods
+    G4int  GetIndex() const;
+    G4int  GetCount() const;
+    // Shard being run
+    G4bool IsRunning() const;
+    // Offset of the eventIDs, 0 outside of a shard run
+    G4int  GetFirstEvent() const;
+    // Suffix of the output file names, empty outside of a shard run
+    G4String GetOutputSuffix() const;
+    // One line description of the shard run, empty outside of a shard run
+    G4String GetDescription() const;
+
+    void Print() const;
+
+  private:
+    ShardConfig();
+
+    static ShardConfig* fInstance;
+
+    ShardMessenger* fMessenger;
+    G4int           fIndex;
+    G4int           fCount;
+    G4bool          fRunning;
+    G4int           fTotalEvents;
+    G4int           fFirstEvent;
+    G4int           fNofEvents;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+inline G4int ShardConfig::GetIndex() const {
+  return fIndex;
+}
+
+inline G4int ShardConfig::GetCount() const {
+  return fCount;
+}
+
+inline G4bool ShardConfig::IsRunning() const {
+  return fRunning;
+}
+
+inline G4int ShardConfig::GetFirstEvent() const {
+  return fRunning ? fFirstEvent : 0;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,40 @@
+/// \file ShardMessenger.hh
+/// \brief Definition of the ShardMessenger class
+
+#ifndef ShardMessenger_h
+#define ShardMessenger_h 1
+
+#include "G4UImessenger.hh"
+#include "globals.hh"
+
+class ShardConfig;
+class G4UIdirectory;
+class G4UIcommand;
+class G4UIcmdWithAnInteger;
+class G4UIcmdWithoutParameter;
+
+/// Messenger for the ShardConfig class.
+///
+/// Defines the /ATHENA/shard/ commands. The commands are executed on the
+/// master only; /ATHENA/shard/beamOn starts the run of the shard.
+
+class ShardMessenger : public G4UImessenger
+{
+  public:
+    ShardMessenger(ShardConfig* config);
+    virtual ~ShardMessenger();
+
+    virtual void SetNewValue(G4UIcommand* command, G4String newValue);
+
+  private:
+    ShardConfig*             fConfig;
+
+    G4UIdirectory*           fShardDir;
+    G4UIcommand*             fSelectCmd;
+    G4UIcmdWithAnInteger*    fBeamOnCmd;
+    G4UIcmdWithoutParameter* fPrintCmd;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
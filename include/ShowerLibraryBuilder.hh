@@ -0,0 +1,110 @@
+/// \file ShowerLibraryBuilder.hh
+/// \brief Definition of the ShowerLibraryBuilder class
+
+#ifndef ShowerLibraryBuilder_h
+#define ShowerLibraryBuilder_h 1
+
+#include "globals.hh"
+#include "G4ThreeVector.hh"
+#include "ShowerLibraryFormat.hh"
+
+#include <map>
+#include <tuple>
+#include <vector>
+
+class G4Event;
+class G4Step;
+class G4VPhysicalVolume;
+
+/// Generation of a frozen shower library (see /ATHENA/showerlib/generate).
+///
+/// Each event of the generation has a single primary particle started
+/// inside the detector of the library. Its bin is found from its energy,
+/// direction and phase in the lattice of the detector; if the bin is not
+/// full, the builder of the thread (Instance()) records the deposits of
+/// the event passed by the sensitive detectors while IsRecording(). The
+/// deposits after the Birks correction are merged per voxel and volume,
+/// at the position of their first step; the spots are stored relative to
+/// the lattice node of the start point.
+///
+/// The builders of the threads are merged at the end of each run into one
+/// builder, which keeps the showers of the following runs as long as the
+/// settings are unchanged. The master writes the library file at the end
+/// of each run and prints its accuracy report: per particle and energy
+/// bin, the number of showers and filled bins, the spots per shower and
+/// the mean and RMS of the active and total deposits relative to the
+/// particle energy.
+
+class ShowerLibraryBuilder
+{
+  public:
+    ShowerLibraryBuilder();
+    ~ShowerLibraryBuilder();
+
+    // Builder of this thread
+    static ShowerLibraryBuilder* Instance();
+
+    // Take the settings of ShowerLibraryConfig; the showers are kept if
+    // they are unchanged
+    void Configure();
+    void Clear();
+
+    void BeginEvent(const G4Event* event);
+    void Record(const G4Step* step, G4double edep, G4bool active);
+    void EndEvent();
+
+    // Add the showers of another builder, up to the maximum per bin;
+    // false if the settings differ
+    G4bool Merge(const ShowerLibraryBuilder& other);
+    // Write the library file and print the report
+    void Write() const;
+
+    // get methods
+    G4bool        IsRecording() const;
+    std::uint64_t GetNumberOfShowers() const;
+
+  private:
+    using VoxelKey = std::tuple<G4int, G4int, G4int, const G4VPhysicalVolume*, G4int, G4int>;
+    using ShowerBins = std::vector<std::vector<ShowerLibraryFormat::Shower>>;
+
+    G4bool HasSameSettings(const ShowerLibraryBuilder& other) const;
+    std::size_t GetParticleIndex(G4int pdg);
+    void PrintReport() const;
+
+    static G4ThreadLocal ShowerLibraryBuilder* fInstance;
+
+    // settings
+    G4int    fDetector;  ///< -1 = no generation
+    G4String fFileName;
+    ShowerLibraryFormat::Lattice fLattice;
+    ShowerLibraryFormat::Binning fBinning;
+    G4int    fMaxShowers;
+    G4double fVoxelSize;
+
+    // showers per particle and bin
+    std::vector<std::int32_t> fPDGCodes;
+    std::vector<ShowerBins>   fBins;
+    std::uint64_t             fNofShowers;
+
+    // current event
+    G4bool        fRecording;
+    std::size_t   fParticle;
+    std::size_t   fCell;
+    G4ThreeVector fNode;
+    ShowerLibraryFormat::Shower fShower;
+    std::map<VoxelKey, std::size_t> fVoxels;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+inline G4bool ShowerLibraryBuilder::IsRecording() const {
+  return fRecording;
+}
+
+inline std::uint64_t ShowerLibraryBuilder::GetNumberOfShowers() const {
+  return fNofShowers;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
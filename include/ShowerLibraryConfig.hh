@@ -0,0 +1,114 @@
+/// \file ShowerLibraryConfig.hh
+/// \brief Definition of the ShowerLibraryConfig class
+
+#ifndef ShowerLibraryConfig_h
+#define ShowerLibraryConfig_h 1
+
+#include "globals.hh"
+#include "ShowerLibraryFormat.hh"
+
+class ShowerLibraryMessenger;
+
+/// Configuration of the frozen shower libraries of the ECal and HCal (see
+/// ShowerLibraryModel and ShowerLibraryBuilder), shared by the master and
+/// worker threads.
+///
+/// The settings are filled on the master via the /ATHENA/showerlib/
+/// commands (see ShowerLibraryMessenger):
+/// - library file of each detector; the file is memory-mapped when it is
+///   set and the mapping is read by the models of all workers,
+/// - maximum energy of the particles replaced by library showers (0: up to
+///   the upper edge of the library),
+/// - generation of a library: detector and file, binning (energy, cos theta,
+///   phi and phase bins per structured lattice axis), maximum number of
+///   showers per bin and size of the voxels the deposits are merged in.
+///
+/// The libraries are used in the events selected by /ATHENA/fastsim/mode.
+
+class ShowerLibraryConfig
+{
+  public:
+    static ShowerLibraryConfig* Instance();
+    ~ShowerLibraryConfig();
+
+    // Detector of a name (ecal or hcal), -1 if unknown
+    static G4int GetDetector(const G4String& name);
+
+    // set methods
+    void SetLibrary(G4int detector, const G4String& fileName);
+    void SetMaxEnergy(G4double energy);
+    void SetGeneration(G4int detector, const G4String& fileName);
+    void SetEnergyBins(G4int nofBins, G4double minEnergy, G4double maxEnergy);
+    void SetAngleBins(G4int nofCosTheta, G4int nofPhi);
+    void SetPhaseBins(G4int nofBins);
+    void SetMaxShowers(G4int nofShowers);
+    void SetVoxelSize(G4double size);
+
+    // get methods
+    // Mapped library of a detector, nullptr if none
+    const ShowerLibraryFormat::MappedLibrary* GetLibrary(G4int detector) const;
+    G4bool   IsLibraryLoaded() const;
+    G4double GetMaxEnergy() const;
+    G4bool   IsGenerating() const;
+    G4int    GetGenerationDetector() const;
+    const G4String& GetGenerationFile() const;
+    const ShowerLibraryFormat::Binning& GetBinning() const;
+    G4int    GetPhaseBins() const;
+    G4int    GetMaxShowers() const;
+    G4double GetVoxelSize() const;
+
+    void Print() const;
+
+  private:
+    ShowerLibraryConfig();
+
+    static ShowerLibraryConfig* fInstance;
+
+    ShowerLibraryMessenger* fMessenger;
+    ShowerLibraryFormat::MappedLibrary fLibraries[ShowerLibraryFormat::kNofDetectors];
+    G4double fMaxEnergy;
+    G4int    fGenerationDetector;  ///< -1 = no generation
+    G4String fGenerationFile;
+    ShowerLibraryFormat::Binning fBinning;
+    G4int    fPhaseBins;           ///< Per lattice axis with a structure
+    G4int    fMaxShowers;          ///< Per bin
+    G4double fVoxelSize;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+inline G4double ShowerLibraryConfig::GetMaxEnergy() const {
+  return fMaxEnergy;
+}
+
+inline G4bool ShowerLibraryConfig::IsGenerating() const {
+  return fGenerationDetector >= 0;
+}
+
+inline G4int ShowerLibraryConfig::GetGenerationDetector() const {
+  return fGenerationDetector;
+}
+
+inline const G4String& ShowerLibraryConfig::GetGenerationFile() const {
+  return fGenerationFile;
+}
+
+inline const ShowerLibraryFormat::Binning& ShowerLibraryConfig::GetBinning() const {
+  return fBinning;
+}
+
+inline G4int ShowerLibraryConfig::GetPhaseBins() const {
+  return fPhaseBins;
+}
+
+inline G4int ShowerLibraryConfig::GetMaxShowers() const {
+  return fMaxShowers;
+}
+
+inline G4double ShowerLibraryConfig::GetVoxelSize() const {
+  return fVoxelSize;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
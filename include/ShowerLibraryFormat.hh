@@ -0,0 +1,229 @@
+/// \file ShowerLibraryFormat.hh
+/// \brief Definition of the shower library file format
+///
+/// A shower library holds the energy deposits of pre-simulated showers of
+/// one detector (ECal or HCal), binned by particle, kinetic energy (log
+/// bins), direction (cos theta to the z axis and phi) and position of the
+/// start point in the periodic structure of the detector (see Lattice).
+/// The file is laid out so that it can be memory-mapped and read in place:
+///
+///   file header : magic "ATHSLB01", format version, detector, lattice,
+///                 binning, numbers of bins, showers and spots
+///   particles   : PDG codes of the particle axis (int32, padded to 8 bytes)
+///   bin index   : per bin, first shower and number of showers
+///   showers     : per shower, first spot, number of spots, energy and the
+///                 summed active and total deposits
+///   spots       : per spot, position relative to the lattice node of the
+///                 start point [mm] and energy deposit [MeV] (float32)
+///
+/// The bins are ordered by particle, energy, cos theta, phi and phase; the
+/// showers of a bin and the spots of a shower are contiguous. Numbers are
+/// stored in the byte order of the host (little endian on all supported
+/// platforms).
+///
+/// This header and ShowerLibraryFormat.cc do not depend on Geant4 so that
+/// they can be used by the stand-alone tools.
+
+#ifndef ShowerLibraryFormat_h
+#define ShowerLibraryFormat_h 1
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ShowerLibraryFormat
+{
+  const char          kFileMagic[8] = { 'A', 'T', 'H', 'S', 'L', 'B', '0', '1' };
+  const std::uint32_t kVersion      = 1;
+
+  const std::string kFileExtension = ".aslib";
+
+  enum Detector : std::uint32_t { kECal = 0, kHCal = 1, kNofDetectors = 2 };
+  const char* GetDetectorName(std::uint32_t detector);
+
+  /// Periodic structure of a detector: transverse lattice vectors (the
+  /// fibers of an ECal block) and longitudinal period (the layers of an HCal
+  /// tower). The transverse node is relative to the centre of the block or
+  /// tower, the longitudinal one in the global frame; a null vector or
+  /// period means no structure along that axis. Lengths in mm.
+  struct Lattice
+  {
+    double a1[2];
+    double a2[2];
+    double origin[2];
+    double pitchZ;
+    double originZ;
+    double zMin;   ///< Extent of the detector along z
+    double zMax;
+  };
+
+  /// Node of the lattice cell of a point (x, y relative to the cell centre,
+  /// global z), and the phase of the point in the lattice cell, in [0, 1)
+  /// along a1, a2 and z (0 along the axes without structure)
+  void FindNode(const Lattice& lattice, const double point[3],
+                double node[3], double phase[3]);
+  bool HasTransverseStructure(const Lattice& lattice);
+
+  /// Kinematic binning of the showers of each particle
+  struct Binning
+  {
+    std::uint32_t nofEnergies = 0;
+    double        minEnergy   = 0.;  ///< [MeV], bins uniform in log
+    double        maxEnergy   = 0.;
+    std::uint32_t nofCosTheta = 1;   ///< Bins of [-1, 1]
+    std::uint32_t nofPhi      = 1;   ///< Bins of [-pi, pi)
+    std::uint32_t nofPhases[3] = { 1, 1, 1 };
+
+    std::size_t GetNumberOfCells() const;
+    /// Index of the kinematic cell, -1 outside the energy range
+    std::int64_t FindCell(double energy, const double direction[3],
+                          const double phase[3]) const;
+    std::uint32_t GetEnergyBin(std::size_t cell) const;
+    double GetEnergyLowEdge(std::uint32_t energyBin) const;
+  };
+
+  struct FileHeader
+  {
+    char          magic[8];
+    std::uint32_t version;
+    std::uint32_t detector;
+    Lattice       lattice;
+    double        minEnergy;
+    double        maxEnergy;
+    std::uint32_t nofParticles;
+    std::uint32_t nofEnergies;
+    std::uint32_t nofCosTheta;
+    std::uint32_t nofPhi;
+    std::uint32_t nofPhases[3];
+    std::uint32_t reserved;
+    std::uint64_t nofBins;
+    std::uint64_t nofShowers;
+    std::uint64_t nofSpots;
+  };
+
+  struct BinEntry
+  {
+    std::uint64_t firstShower;
+    std::uint64_t nofShowers;
+  };
+
+  struct ShowerEntry
+  {
+    std::uint64_t firstSpot;
+    std::uint32_t nofSpots;
+    float         energy;      ///< Kinetic energy of the particle [MeV]
+    float         edepActive;  ///< Sum of the deposits in the active materials
+    float         edepTotal;
+  };
+
+  struct Spot
+  {
+    float x;
+    float y;
+    float z;
+    float edep;
+  };
+
+  static_assert(sizeof(FileHeader) == 168, "unexpected shower library header size");
+  static_assert(sizeof(ShowerEntry) == 24, "unexpected shower library entry size");
+
+  /// A shower being collected for a library
+  struct Shower
+  {
+    float             energy     = 0.f;
+    float             edepActive = 0.f;
+    float             edepTotal  = 0.f;
+    std::vector<Spot> spots;
+  };
+
+  /// Write a library; bins[particle][cell] holds the showers of each bin
+  /// in the order of the PDG codes. Returns the number of bytes written,
+  /// 0 on failure
+  std::uint64_t WriteLibrary(const std::string& fileName, std::uint32_t detector,
+                             const Lattice& lattice, const Binning& binning,
+                             const std::vector<std::int32_t>& pdgCodes,
+                             const std::vector<std::vector<std::vector<Shower>>>& bins);
+
+  /// Read-only memory mapping of a library file
+  class MappedLibrary
+  {
+    public:
+      MappedLibrary();
+      ~MappedLibrary();
+      MappedLibrary(const MappedLibrary&) = delete;
+      MappedLibrary& operator=(const MappedLibrary&) = delete;
+
+      /// Map the file and check its layout; false if it is not a library
+      bool Open(const std::string& fileName);
+      void Close();
+
+      bool               IsOpen() const;
+      const std::string& GetFileName() const;
+      std::size_t        GetFileSize() const;
+      const FileHeader&  GetHeader() const;
+      const Binning&     GetBinning() const;
+
+      /// Index of a particle, -1 if the library has no showers of it
+      int          GetParticleIndex(std::int32_t pdg) const;
+      std::int32_t GetPDGCode(std::uint32_t particle) const;
+
+      const BinEntry&    GetBin(std::uint64_t bin) const;
+      const ShowerEntry& GetShower(std::uint64_t shower) const;
+      const Spot*        GetSpots(const ShowerEntry& shower) const;
+
+    private:
+      std::string        fFileName;
+      void*              fData;
+      std::size_t        fSize;
+      const FileHeader*  fHeader;
+      const std::int32_t* fPDGCodes;
+      const BinEntry*    fBins;
+      const ShowerEntry* fShowers;
+      const Spot*        fSpots;
+      Binning            fBinning;
+  };
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+inline bool MappedLibrary::IsOpen() const {
+  return fData != nullptr;
+}
+
+inline const std::string& MappedLibrary::GetFileName() const {
+  return fFileName;
+}
+
+inline std::size_t MappedLibrary::GetFileSize() const {
+  return fSize;
+}
+
+inline const FileHeader& MappedLibrary::GetHeader() const {
+  return *fHeader;
+}
+
+inline const Binning& MappedLibrary::GetBinning() const {
+  return fBinning;
+}
+
+inline std::int32_t MappedLibrary::GetPDGCode(std::uint32_t particle) const {
+  return fPDGCodes[particle];
+}
+
+inline const BinEntry& MappedLibrary::GetBin(std::uint64_t bin) const {
+  return fBins[bin];
+}
+
+inline const ShowerEntry& MappedLibrary::GetShower(std::uint64_t shower) const {
+  return fShowers[shower];
+}
+
+inline const Spot* MappedLibrary::GetSpots(const ShowerEntry& shower) const {
+  return fSpots + shower.firstSpot;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+}
+
+#endif
@@ -0,0 +1,47 @@
+/// \file ShowerLibraryMessenger.hh
+/// \brief Definition of the ShowerLibraryMessenger class
+
+#ifndef ShowerLibraryMessenger_h
+#define ShowerLibraryMessenger_h 1
+
+#include "G4UImessenger.hh"
+#include "globals.hh"
+
+class ShowerLibraryConfig;
+class G4UIdirectory;
+class G4UIcommand;
+class G4UIcmdWithAnInteger;
+class G4UIcmdWithADoubleAndUnit;
+class G4UIcmdWithoutParameter;
+
+/// Messenger for the ShowerLibraryConfig class.
+///
+/// Defines the /ATHENA/showerlib/ commands. The commands are executed on
+/// the master only, the workers read the shared ShowerLibraryConfig.
+
+class ShowerLibraryMessenger : public G4UImessenger
+{
+  public:
+    ShowerLibraryMessenger(ShowerLibraryConfig* config);
+    virtual ~ShowerLibraryMessenger();
+
+    virtual void SetNewValue(G4UIcommand* command, G4String newValue);
+
+  private:
+    ShowerLibraryConfig*       fConfig;
+
+    G4UIdirectory*             fShowerLibDir;
+    G4UIcommand*               fUseCmd;
+    G4UIcmdWithADoubleAndUnit* fMaxEnergyCmd;
+    G4UIcommand*               fGenerateCmd;
+    G4UIcommand*               fEnergyBinsCmd;
+    G4UIcommand*               fAngleBinsCmd;
+    G4UIcmdWithAnInteger*      fPhaseBinsCmd;
+    G4UIcmdWithAnInteger*      fMaxShowersCmd;
+    G4UIcmdWithADoubleAndUnit* fVoxelSizeCmd;
+    G4UIcmdWithoutParameter*   fPrintCmd;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,73 @@
+/// \file ShowerLibraryModel.hh
+/// \brief Definition of the ShowerLibraryModel class
+
+#ifndef ShowerLibraryModel_h
+#define ShowerLibraryModel_h 1
+
+#include "G4VFastSimulationModel.hh"
+#include "ShowerLibraryFormat.hh"
+#include "SpotDepositor.hh"
+#include "globals.hh"
+
+/// Substitution of the low-energy secondaries in the ECal or HCal by
+/// showers of a frozen shower library (see ShowerLibraryConfig).
+///
+/// The model of a detector is attached to its regions (ECal powder and
+/// fibers, HCal absorber and scintillator) of each worker, after the
+/// ECalShowerModel. In an event selected for the fast simulation, a
+/// secondary particle below the maximum energy which has showers in the
+/// library of the detector is looked up by its energy, direction and phase
+/// in the lattice of the detector (see DetectorConstruction::
+/// FindShowerLibraryNode()). It is killed and one shower of its bin, drawn
+/// at random and scaled to its energy, is deposited by a SpotDepositor at
+/// the lattice node of its position. As the spots are stored relative to
+/// the node, they fall in the same fibers or layers as in the generation.
+///
+/// The particles in an empty bin or outside the energy range of the
+/// library are fully simulated. The substituted and missed particles are
+/// counted in the Statistics of the thread, merged at the end of the run.
+
+class ShowerLibraryModel : public G4VFastSimulationModel
+{
+  public:
+    /// Substitutions of the run, merged over the threads
+    struct Statistics
+    {
+      G4double nofSubstituted[ShowerLibraryFormat::kNofDetectors] = { 0., 0. };
+      G4double nofMissed[ShowerLibraryFormat::kNofDetectors]      = { 0., 0. };
+      G4double energy[ShowerLibraryFormat::kNofDetectors]         = { 0., 0. };
+
+      void Merge(const Statistics& other);
+      void Print() const;
+    };
+
+    ShowerLibraryModel(const G4String& name, G4int detector, G4Region* envelope);
+    virtual ~ShowerLibraryModel();
+
+    // methods from base class
+    virtual G4bool IsApplicable(const G4ParticleDefinition& particle);
+    virtual G4bool ModelTrigger(const G4FastTrack& fastTrack);
+    virtual void   DoIt(const G4FastTrack& fastTrack, G4FastStep& fastStep);
+
+    // Substitutions of the current run in this thread
+    static Statistics& GetStatistics();
+
+  private:
+    G4int fDetector;
+
+    // settings of the current event
+    G4int    fEventID;
+    const ShowerLibraryFormat::MappedLibrary* fLibrary;
+    G4double fMaxEnergy;
+
+    // bin and lattice node of the triggered track
+    G4int         fLastMissedTrackID;
+    std::uint64_t fBin;
+    G4ThreeVector fNode;
+
+    SpotDepositor fDepositor;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,81 @@
+/// \file ShowerMaps.hh
+/// \brief Definition of the ShowerMaps class
+
+#ifndef ShowerMaps_h
+#define ShowerMaps_h 1
+
+#include "globals.hh"
+#include "ColumnarFormat.hh"
+
+#include <vector>
+
+struct EventRecord;
+
+/// Run-averaged shower maps accumulated during the run.
+///
+/// For every HCal tile (tower x, tower y, layer) and ECal block the sums of
+/// the active energy, of its square and of its pi0 part are accumulated in
+/// dense arrays, in the cell order of EventRecord, so that the mean, the
+/// variance and the pi0 fraction of each cell can be computed at the end of
+/// the run. The containment is accumulated as well: the fraction of the
+/// primary energy deposited (active and absorber) up to a given depth,
+/// after the ECal (depth 0) and after each HCal layer (depth 1 to
+/// NumHCalLayers); the steel and WLS plates of the HCal towers are not
+/// part of the layers and not counted.
+///
+/// Each thread fills its own maps without locking. At the end of the run
+/// the maps of the threads are combined with Reduce(), a pairwise (tree)
+/// reduction. All contents are sums, so the histograms (GetHistograms())
+/// of several threads, files or jobs are merged by summing them; their
+/// binning holds the dimensions of the map, e.g. { NumHCalTowers,
+/// NumHCalTowers, NumHCalLayers } for the HCal tiles.
+
+class ShowerMaps
+{
+  public:
+    ShowerMaps();
+
+    // Clear the accumulators
+    void Reset();
+    void Fill(const EventRecord& record);
+    void Merge(const ShowerMaps& other);
+    // Merge the maps pairwise into the first one; the others are left
+    // partially merged
+    static void Reduce(std::vector<ShowerMaps>& maps);
+
+    // get methods
+    G4double GetNumberOfEvents() const;
+    std::vector<ColumnarFormat::Histogram> GetHistograms() const;
+
+    void Print() const;
+
+  private:
+    /// Sums of a map over the events
+    struct Map
+    {
+      std::vector<G4double> sum;
+      std::vector<G4double> sum2;
+      std::vector<G4double> sumPi0;
+
+      void Reset(std::size_t size);
+      void Merge(const Map& other);
+    };
+
+    G4double Mean(const std::vector<G4double>& sum, std::size_t i, G4double n) const;
+
+    G4double fNofEvents;
+    G4double fNofContainmentEvents; ///< Events with a primary energy
+    Map      fHCalTiles;
+    Map      fECalBlocks;
+    Map      fContainment;          ///< No pi0 part
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+inline G4double ShowerMaps::GetNumberOfEvents() const {
+  return fNofEvents;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,55 @@
+/// \file SpotDepositor.hh
+/// \brief Definition of the SpotDepositor class
+
+#ifndef SpotDepositor_h
+#define SpotDepositor_h 1
+
+#include "G4ThreeVector.hh"
+#include "G4TouchableHandle.hh"
+#include "globals.hh"
+
+class G4LogicalVolume;
+class G4Navigator;
+class G4Step;
+class G4Track;
+class G4VSensitiveDetector;
+
+/// Deposits the energy of a fast-simulated shower (see ECalShowerModel and
+/// ShowerLibraryModel) or of a killed track (see StackingAction) as spots
+/// in the sensitive detectors.
+///
+/// Each spot is located in the geometry with a navigator of its own and
+/// passed as a step without length to the sensitive detector of its volume,
+/// so that the calorimeter cells are filled as in the full simulation.
+/// Consecutive spots of a shower are close to each other, so the search
+/// starts from the previous one.
+
+class SpotDepositor
+{
+  public:
+    SpotDepositor();
+    ~SpotDepositor();
+
+    // Start the spots of a track; a shower replacing the track is counted
+    // in the fast-simulated showers of the event
+    void Begin(const G4Track* track);
+    void BeginShower(const G4Track* track);
+    // Locate a spot; returns its volume if it has a sensitive detector
+    G4LogicalVolume* Locate(const G4ThreeVector& position);
+    // Deposit energy at the last located spot
+    void Deposit(G4double edep);
+
+    // Showers fast-simulated in the current event in this thread
+    static G4int& GetNumberOfShowers();
+
+  private:
+    G4Navigator*          fNavigator;
+    G4TouchableHandle     fTouchable;
+    G4Step*               fStep;
+    G4bool                fFirst;
+    G4VSensitiveDetector* fDetector;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
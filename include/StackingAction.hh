@@ -0,0 +1,77 @@
+/// \file StackingAction.hh
+/// \brief Definition of the StackingAction class
+
+#ifndef StackingAction_h
+#define StackingAction_h 1
+
+#include "G4UserStackingAction.hh"
+#include "EventRecord.hh"
+#include "SpotDepositor.hh"
+#include "globals.hh"
+
+#include <map>
+#include <set>
+#include <utility>
+#include <vector>
+
+class G4ParticleDefinition;
+
+/// Stacking action class: kills the secondaries below the kinetic energy
+/// threshold of their particle or created after the time cut (see
+/// StackingConfig).
+///
+/// The cuts are read at the beginning of each event. The kinetic energy of
+/// a killed track is deposited by a SpotDepositor at its creation point if
+/// the local deposition is enabled; the deposit has no Birks correction.
+/// The killed tracks of the event are counted in the StackingRecord of the
+/// thread, written with the event summary, and per particle (or time cut)
+/// in the Statistics of the thread, merged at the end of the run. Together
+/// with the run time and the response of the resolution scan, they measure
+/// what the cuts save and what they cost.
+
+class StackingAction : public G4UserStackingAction
+{
+  public:
+    /// Killed tracks of the run per particle name, or "time cut", merged
+    /// over the threads
+    struct Statistics
+    {
+      struct Counts
+      {
+        G4double tracks    = 0.;
+        G4double energy    = 0.;
+        G4double deposited = 0.;
+      };
+      std::map<G4String, Counts> killed;
+
+      void Merge(const Statistics& other);
+      void Print(G4int nofEvents) const;
+    };
+
+    StackingAction();
+    virtual ~StackingAction();
+
+    // methods from base class
+    virtual G4ClassificationOfNewTrack ClassifyNewTrack(const G4Track* track);
+    virtual void PrepareNewEvent();
+
+    // Killed tracks of the current event in this thread
+    static StackingRecord& GetRecord();
+    // Killed tracks of the current run in this thread
+    static Statistics& GetStatistics();
+
+  private:
+    void Kill(const G4Track* track, const G4String& cut);
+
+    // settings of the current event
+    std::vector<std::pair<const G4ParticleDefinition*, G4double>> fThresholds;
+    G4double fTimeCut;
+    G4bool   fDepositKilled;
+    std::set<G4String> fUnknownParticles;  ///< Warned about once
+
+    SpotDepositor fDepositor;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
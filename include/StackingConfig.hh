@@ -0,0 +1,79 @@
+/// \file StackingConfig.hh
+/// \brief Definition of the StackingConfig class
+
+#ifndef StackingConfig_h
+#define StackingConfig_h 1
+
+#include "globals.hh"
+
+#include <map>
+
+class StackingMessenger;
+
+/// Track cuts applied by the StackingAction when the secondaries are
+/// stacked, shared by the master and worker threads.
+///
+/// The settings are filled on the master via the /ATHENA/stacking/ commands
+/// (see StackingMessenger) and are read by the stacking action of each
+/// worker at the beginning of each event:
+/// - per-particle kinetic energy thresholds: the secondaries of a particle
+///   below its threshold are killed (e.g. the slow neutrons of the hadron
+///   showers in the HCal steel),
+/// - time cut: the secondaries created later than the cut are killed,
+/// - local deposition: the kinetic energy of a killed track is deposited at
+///   its creation point in the sensitive detector of its volume, if any.
+/// The primaries are never killed.
+
+class StackingConfig
+{
+  public:
+    static StackingConfig* Instance();
+    ~StackingConfig();
+
+    // set methods
+    // A threshold of 0 removes the cut of the particle
+    void SetThreshold(const G4String& particleName, G4double energy);
+    void ClearThresholds();
+    void SetTimeCut(G4double time);
+    void SetDepositKilled(G4bool deposit);
+
+    // get methods
+    const std::map<G4String, G4double>& GetThresholds() const;
+    G4double GetTimeCut() const;       ///< 0 = no time cut
+    G4bool   IsDepositKilled() const;
+    G4bool   IsEnabled() const;
+
+    void Print() const;
+
+  private:
+    StackingConfig();
+
+    static StackingConfig* fInstance;
+
+    StackingMessenger* fMessenger;
+    std::map<G4String, G4double> fThresholds;  ///< Per particle name
+    G4double fTimeCut;
+    G4bool   fDepositKilled;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+inline const std::map<G4String, G4double>& StackingConfig::GetThresholds() const {
+  return fThresholds;
+}
+
+inline G4double StackingConfig::GetTimeCut() const {
+  return fTimeCut;
+}
+
+inline G4bool StackingConfig::IsDepositKilled() const {
+  return fDepositKilled;
+}
+
+inline G4bool StackingConfig::IsEnabled() const {
+  return ! fThresholds.empty() || fTimeCut > 0.;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
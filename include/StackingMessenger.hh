@@ -0,0 +1,43 @@
+/// \file StackingMessenger.hh
+/// \brief Definition of the StackingMessenger class
+
+#ifndef StackingMessenger_h
+#define StackingMessenger_h 1
+
+#include "G4UImessenger.hh"
+#include "globals.hh"
+
+class StackingConfig;
+class G4UIdirectory;
+class G4UIcommand;
+class G4UIcmdWithABool;
+class G4UIcmdWithADoubleAndUnit;
+class G4UIcmdWithoutParameter;
+
+/// Messenger for the StackingConfig class.
+///
+/// Defines the /ATHENA/stacking/ commands. The commands are executed on the
+/// master only, the workers read the shared StackingConfig.
+
+class StackingMessenger : public G4UImessenger
+{
+  public:
+    StackingMessenger(StackingConfig* config);
+    virtual ~StackingMessenger();
+
+    virtual void SetNewValue(G4UIcommand* command, G4String newValue);
+
+  private:
+    StackingConfig*            fConfig;
+
+    G4UIdirectory*             fStackingDir;
+    G4UIcommand*               fKillBelowCmd;
+    G4UIcmdWithoutParameter*   fClearCmd;
+    G4UIcmdWithADoubleAndUnit* fTimeCutCmd;
+    G4UIcmdWithABool*          fDepositKilledCmd;
+    G4UIcmdWithoutParameter*   fPrintCmd;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
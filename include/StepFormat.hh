@@ -0,0 +1,99 @@
+/// \file StepFormat.hh
+/// \brief Definition of the compressed step file format
+///
+/// The step files written by StepRecorder are laid out as
+///
+///   file header : magic "ATHSTP01", format version, grid
+///   block       : block header, then the (compressed) payload
+///   block       : ...
+///
+/// The payload of a block is the concatenation of complete events. An event
+/// is stored as varints: eventID, number of steps, number of steps dropped
+/// by the per-event limit, then for every step the differences to the
+/// previous step of the event (zigzag encoded) of x, y, z, time, PDG code,
+/// volume code and trackID, and the energy deposit. Positions, time and
+/// energy are integers in units of the grid given in the file header, so
+/// consecutive steps of a shower cost a few bytes each before compression.
+///
+/// Each block is self-contained, so a file can be read up to its last
+/// complete block even if the writer was killed. Numbers of the headers
+/// are stored in the byte order of the host (little endian on all
+/// supported platforms).
+///
+/// This header and StepFormat.cc do not depend on Geant4 so that they
+/// can be used by the stand-alone tools.
+
+#ifndef StepFormat_h
+#define StepFormat_h 1
+
+#include "ColumnarFormat.hh"
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace StepFormat
+{
+  const char          kFileMagic[8] = { 'A', 'T', 'H', 'S', 'T', 'P', '0', '1' };
+  const std::uint32_t kVersion      = 1;
+  const std::uint32_t kBlockMagic   = 0x4b4c4253; // "SBLK"
+
+  const std::string kFileExtension = ".asteps";
+
+  /// Quantisation of the step values: the size of one grid unit
+  struct Grid
+  {
+    double transverse;   ///< x and y [mm]
+    double longitudinal; ///< z [mm]
+    double time;         ///< [ns]
+    double energy;       ///< [MeV]
+  };
+
+  /// One quantised step; the position is the middle of the step in the
+  /// global coordinates
+  struct Step
+  {
+    std::int64_t x;
+    std::int64_t y;
+    std::int64_t z;
+    std::int64_t time;
+    std::int64_t edep;
+    std::int32_t pdg;
+    std::int32_t volume;
+    std::int32_t trackID;
+  };
+
+  struct Event
+  {
+    std::int32_t      eventID;
+    std::uint32_t     nofDropped; ///< Steps beyond the per-event limit
+    std::vector<Step> steps;
+  };
+
+  /// Volume codes of the ECal: block x and y ids (< 32) and whether the
+  /// step is in the absorber (tungsten powder, cladding) or a fiber core
+  int  VolumeCode(int blockX, int blockY, bool absorber);
+  int  VolumeBlockX(int code);
+  int  VolumeBlockY(int code);
+  bool IsAbsorberVolume(int code);
+
+  // Serialisation; the functions return false on a short read or write
+  bool WriteFileHeader(std::FILE* file, const Grid& grid);
+  bool ReadFileHeader(std::FILE* file, Grid& grid);
+
+  /// Append one encoded event to a block payload
+  void EncodeEvent(const Event& event, std::vector<char>& payload);
+  /// Decode the event at data and advance data past it
+  bool DecodeEvent(const char*& data, const char* end, Event& event);
+
+  /// Write a block of nofEvents encoded events; returns the number of
+  /// bytes written, 0 on failure
+  std::size_t WriteBlock(std::FILE* file, std::uint32_t nofEvents,
+                         const std::vector<char>& payload,
+                         ColumnarFormat::Codec codec, int level);
+  /// Read the next block and decode its payload
+  bool ReadBlock(std::FILE* file, std::uint32_t& nofEvents, std::vector<char>& payload);
+}
+
+#endif
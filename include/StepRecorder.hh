@@ -0,0 +1,122 @@
+/// \file StepRecorder.hh
+/// \brief Definition of the StepRecorder class
+
+#ifndef StepRecorder_h
+#define StepRecorder_h 1
+
+#include "globals.hh"
+#include "G4ThreeVector.hh"
+#include "StepFormat.hh"
+
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+class G4Step;
+
+/// Sampled recorder of the individual ECal steps, for shower microstructure
+/// studies (see /ATHENA/output/steps/).
+///
+/// Each thread processing events owns one recorder (Instance()) and writes
+/// its own file <name>_steps_t<thread>.asteps (see StepFormat.hh). Only
+/// every N-th event (eventID % N == 0) is recorded, and within it only the
+/// steps with a deposit in the selected ECal volumes, inside the optional
+/// region and above the energy threshold, up to a maximum number of steps.
+/// The sensitive detectors call Record() only while IsRecording(), so the
+/// events which are not sampled cost one test per step.
+///
+/// The steps of an event are quantised to the grid, delta encoded and
+/// appended to a block buffer, which is compressed and written when it
+/// exceeds the block size and at Close().
+
+class StepRecorder
+{
+  public:
+    static StepRecorder* Instance();
+    ~StepRecorder();
+
+    // Open the file with the settings of OutputConfig
+    bool Open(const G4String& fileName);
+    void Close();
+
+    void BeginEvent(G4int eventID);
+    void Record(const G4Step* step, G4double edep, G4int volume);
+    void EndEvent();
+
+    // get methods
+    G4bool          IsOpen() const;
+    G4bool          IsRecording() const;
+    const G4String& GetFileName() const;
+    std::uint64_t   GetNumberOfEvents() const;
+    std::uint64_t   GetNumberOfSteps() const;
+    std::uint64_t   GetBytesWritten() const;
+
+    void PrintStatistics() const;
+
+  private:
+    StepRecorder();
+
+    void WriteBlock();
+
+    static G4ThreadLocal StepRecorder* fInstance;
+
+    std::FILE*            fFile;
+    G4String              fFileName;
+
+    // settings of the current run
+    StepFormat::Grid      fGrid;
+    G4int                 fPrescale;
+    G4bool                fFibersOnly;
+    G4bool                fUseRegion;
+    G4ThreeVector         fRegionMin;
+    G4ThreeVector         fRegionMax;
+    G4double              fMinEdep;
+    std::size_t           fMaxSteps;
+    ColumnarFormat::Codec fCodec;
+    G4int                 fLevel;
+
+    // current event and block
+    G4bool                fRecording;
+    StepFormat::Event     fEvent;
+    std::vector<char>     fPayload;       ///< Encoded events of the block
+    std::uint32_t         fNofEventsInBlock;
+
+    // statistics of the run
+    std::uint64_t         fNofEvents;
+    std::uint64_t         fNofSteps;
+    std::uint64_t         fNofDropped;    ///< Steps beyond the per-event limit
+    std::uint64_t         fNofTruncatedEvents;
+    std::uint64_t         fNofBlocks;
+    std::uint64_t         fRawBytes;      ///< Encoded size before compression
+    std::uint64_t         fBytesWritten;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+inline G4bool StepRecorder::IsOpen() const {
+  return fFile != nullptr;
+}
+
+inline G4bool StepRecorder::IsRecording() const {
+  return fRecording;
+}
+
+inline const G4String& StepRecorder::GetFileName() const {
+  return fFileName;
+}
+
+inline std::uint64_t StepRecorder::GetNumberOfEvents() const {
+  return fNofEvents;
+}
+
+inline std::uint64_t StepRecorder::GetNumberOfSteps() const {
+  return fNofSteps;
+}
+
+inline std::uint64_t StepRecorder::GetBytesWritten() const {
+  return fBytesWritten;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
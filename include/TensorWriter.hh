@@ -0,0 +1,76 @@
+/// \file TensorWriter.hh
+/// \brief Definition of the TensorWriter class
+
+#ifndef TensorWriter_h
+#define TensorWriter_h 1
+
+#include "globals.hh"
+#include "NpyWriter.hh"
+
+#include <cstdint>
+#include <vector>
+
+struct EventRecord;
+
+/// Writer of the calorimeter response as dense tensors for ML training.
+///
+/// Each event is appended as one fixed-shape record to three .npy files
+/// which can be memory-mapped without copy (see NpyWriter):
+/// - <name>_ecal.npy   : (N, 8, 8) active energy of the ECal blocks,
+/// - <name>_hcal.npy   : (N, 6, 6, 51) active energy of the HCal tiles,
+/// - <name>_labels.npy : (N,) eventID, primary PDG code, kinetic energy,
+///                       vertex (cm) and direction.
+/// The cells are indexed [x id][y id][layer] as in the ntuples. Energies
+/// are in GeV, stored as float32 or float16 (labels always float32).
+
+class TensorWriter
+{
+  public:
+    TensorWriter();
+    ~TensorWriter();
+
+    bool Open(const G4String& baseName, G4bool float16);
+    void Write(const EventRecord& record);
+    void Flush();
+    void Close();
+
+    // get methods
+    G4bool        IsOpen() const;
+    G4String      GetBaseName() const;
+    std::uint64_t GetNumberOfEvents() const;
+    std::uint64_t GetBytesWritten() const;
+
+  private:
+    void AppendEnergies(NpyWriter& writer, const std::vector<G4double>& energies);
+
+    NpyWriter             fECalWriter;
+    NpyWriter             fHCalWriter;
+    NpyWriter             fLabelsWriter;
+    G4String              fBaseName;
+    G4bool                fFloat16;
+    std::vector<G4double> fEnergies; ///< Cell energies of the current tensor
+    std::vector<char>     fBuffer;   ///< Converted record
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+inline G4bool TensorWriter::IsOpen() const {
+  return fLabelsWriter.IsOpen();
+}
+
+inline G4String TensorWriter::GetBaseName() const {
+  return fBaseName;
+}
+
+inline std::uint64_t TensorWriter::GetNumberOfEvents() const {
+  return fLabelsWriter.GetNumberOfRecords();
+}
+
+inline std::uint64_t TensorWriter::GetBytesWritten() const {
+  return fECalWriter.GetBytesWritten() + fHCalWriter.GetBytesWritten()
+       + fLabelsWriter.GetBytesWritten();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,86 @@
+/// \file TopoClustering.hh
+/// \brief Definition of the TopoClustering class
+
+#ifndef TopoClustering_h
+#define TopoClustering_h 1
+
+#include "globals.hh"
+#include "G4TwoVector.hh"
+
+#include <vector>
+
+struct EventRecord;
+
+/// Topological clustering of the ECal blocks and HCal towers, done in the
+/// event loop on the active energies of the EventRecord.
+///
+/// The cells are the NumECalBlocks x NumECalBlocks ECal blocks followed by
+/// the NumHCalTowers x NumHCalTowers HCal towers, in the cell order of
+/// EventRecord. The neighbour tables are computed once by Initialize():
+/// within a grid the eight surrounding cells are neighbours, and each ECal
+/// block is a neighbour of the HCal tower behind it (nearest centre). They
+/// are stored as flat offset and index arrays.
+///
+/// The cells above the seed threshold of their detector are the seeds;
+/// starting from the most energetic one, a cluster grows over the
+/// neighbours above the neighbour threshold of their detector, which grow
+/// in turn. A seed already in a cluster does not start a new one, so the
+/// clusters are the connected groups of cells above the neighbour
+/// thresholds with at least one seed, ordered by their seed energy.
+
+class TopoClustering
+{
+  public:
+    TopoClustering();
+
+    // Build the neighbour tables from the transverse cell centres
+    void Initialize(const std::vector<G4TwoVector>& ecalCenters,
+                    const std::vector<G4TwoVector>& hcalCenters);
+    // The seed thresholds are raised to the neighbour thresholds if lower
+    void SetThresholds(G4double ecalSeed, G4double ecalNeighbour,
+                       G4double hcalSeed, G4double hcalNeighbour);
+
+    // Fill the clusters of the record from its cells
+    void Process(EventRecord& record);
+
+    // get methods
+    G4bool IsInitialized() const;
+    G4int  GetNumberOfCells() const;
+    std::vector<G4int> GetNeighbours(G4int cell) const;
+
+  private:
+    G4bool IsECal(G4int cell) const;
+
+    G4int                    fNofECalCells;
+    std::vector<G4TwoVector> fCenters;
+    std::vector<G4int>       fNeighbourOffsets; ///< Per cell, into fNeighbours
+    std::vector<G4int>       fNeighbours;
+    G4double fECalSeed;
+    G4double fECalNeighbour;
+    G4double fHCalSeed;
+    G4double fHCalNeighbour;
+
+    // per event work arrays, kept to avoid allocations
+    std::vector<G4double> fEnergies;
+    std::vector<G4int>    fLabels;  ///< Cluster of each cell, -1 if none
+    std::vector<G4int>    fSeeds;
+    std::vector<G4int>    fQueue;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+inline G4bool TopoClustering::IsInitialized() const {
+  return ! fNeighbourOffsets.empty();
+}
+
+inline G4int TopoClustering::GetNumberOfCells() const {
+  return G4int(fCenters.size());
+}
+
+inline G4bool TopoClustering::IsECal(G4int cell) const {
+  return cell < fNofECalCells;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
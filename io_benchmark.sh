@@ -0,0 +1,64 @@
+#!/bin/bash
+# Output I/O benchmark: runs the same beam configuration with different
+# output precision, compression and basket settings and reports the
+# bytes per event and write throughput printed by RunAction.
+# Run from the build directory: ./io_benchmark.sh [num_events] [num_threads]
+set -e
+
+num_events=${1:-500}
+num_threads=${2:-4}
+particle="pi+"
+energy=10
+
+precisions=(double float)
+compressions=("none 0" "zlib 1" "zlib 4" "zlib 9")
+basket_sizes=(0 256000)
+
+macro="io_benchmark.mac"
+report="io_benchmark.txt"
+echo "precision compression level basket bytes/event MB/s(end-of-run) MB/s(run) run_time(s)" > $report
+
+for precision in "${precisions[@]}"
+do
+	for compression in "${compressions[@]}"
+	do
+		set -- $compression
+		algorithm=$1
+		level=$2
+		for basket in "${basket_sizes[@]}"
+		do
+			output="io_benchmark_${precision}_${algorithm}${level}_${basket}"
+			cat > $macro <<MAC
+/ATHENA/output/precision all ${precision}
+/ATHENA/output/compressionAlgorithm ${algorithm}
+/ATHENA/output/compressionLevel ${level}
+/ATHENA/output/basketSize ${basket}
+/analysis/setFileName ${output}
+/run/initialize
+/run/setCut .01 mm
+/gps/particle ${particle}
+/gps/ene/type Mono
+/gps/ene/mono ${energy} GeV
+/gps/pos/type Plane
+/gps/pos/shape Square
+/gps/pos/rot1 1 0 0
+/gps/pos/rot2 0 1 0
+/gps/pos/halfx 0.25 cm
+/gps/pos/halfy 0.25 cm
+/gps/pos/centre 2.5025 2.4747 -8.5 cm
+/gps/direction 0 .08715574275 .9961946981
+/run/beamOn ${num_events}
+MAC
+			echo "Running ${precision} ${algorithm} ${level} basket ${basket}"
+			log="${output}.log"
+			./ATHENA_Geometry -m $macro -t ${num_threads} > $log 2>&1
+			bytes=$(grep "bytes/event" $log | sed 's/.*MB, \([0-9.e+]*\) bytes\/event/\1/')
+			rates=$(grep "write throughput" $log | sed 's/.*throughput: \([0-9.e+]*\) MB\/s (end of run), \([0-9.e+]*\) MB\/s.*/\1 \2/')
+			run_time=$(grep "run time" $log | sed 's/.*run time: \([0-9.e+]*\) s/\1/')
+			echo "${precision} ${algorithm} ${level} ${basket} ${bytes} ${rates} ${run_time}" >> $report
+			rm -f ${output}.root
+		done
+	done
+done
+
+column -t $report
@@ -0,0 +1,97 @@
+#!/bin/bash
+# Event overlay: simulates a library of single pions at 5 and 10 GeV with
+# the columnar output, then builds two-pion and pile-up events by full
+# simulation and by overlaying library events, and reports the events/s
+# and the response (mean and resolution of the total energy) printed by
+# RunAction.
+# Run from the build directory: ./overlay_benchmark.sh [num_library] [num_events] [num_threads]
+set -e
+
+num_library=${1:-2000}
+num_events=${2:-500}
+num_threads=${3:-4}
+particle="pi+"
+
+beam() {
+	cat <<MAC
+/gps/particle ${particle}
+/gps/ene/type Mono
+/gps/pos/type Plane
+/gps/pos/shape Square
+/gps/pos/rot1 1 0 0
+/gps/pos/rot2 0 1 0
+/gps/pos/halfx 0.25 cm
+/gps/pos/halfy 0.25 cm
+/gps/pos/centre 2.5025 2.4747 -8.5 cm
+/gps/direction 0 .08715574275 .9961946981
+MAC
+}
+
+# Library: one dataset per energy, with the cell tables
+macro="overlay_library.mac"
+{
+	echo "/ATHENA/output/format columnar"
+	echo "/run/initialize"
+	beam
+	for energy in 5 10
+	do
+		echo "/analysis/setFileName overlay_library_${energy}GeV"
+		echo "/gps/ene/mono ${energy} GeV"
+		echo "/run/beamOn ${num_library}"
+	done
+} > $macro
+echo "Simulating the library"
+./ATHENA_Geometry -m $macro -t ${num_threads} > overlay_library.log 2>&1
+
+# name:number of simulated pions:energy (GeV):overlay settings, one
+# command argument list per ';'
+configurations=(
+	"full_2x5GeV:2:5:"
+	"overlay_2x5GeV:0:5:add ${particle} 5 GeV;add ${particle} 5 GeV"
+	"full_5GeV_overlay_5GeV:1:5:add ${particle} 5 GeV"
+	"full_10GeV:1:10:"
+	"full_10GeV_pileup_1:1:10:pileup 1"
+	"overlay_10GeV_pileup_1:0:10:add ${particle} 10 GeV;pileup 1"
+)
+
+macro="overlay_benchmark.mac"
+report="overlay_benchmark.txt"
+echo "configuration run_time(s) events/s overlaid/event mean(MeV) sigma(MeV) resolution" > $report
+
+for configuration in "${configurations[@]}"
+do
+	IFS=':' read -r name nof_pions energy settings <<< "$configuration"
+	output="overlay_benchmark_${name}"
+	{
+		echo "/ATHENA/analysis/resolutionScan true"
+		echo "/analysis/setFileName ${output}"
+		if [ -n "$settings" ]; then
+			echo "/ATHENA/overlay/library overlay_library_5GeV.acolset"
+			echo "/ATHENA/overlay/library overlay_library_10GeV.acolset"
+		fi
+		IFS=';' read -ra commands <<< "$settings"
+		for command in "${commands[@]}"
+		do
+			echo "/ATHENA/overlay/${command}"
+		done
+		if [ "$nof_pions" -eq 0 ]; then
+			echo "/ATHENA/overlay/simulate false"
+		fi
+		echo "/run/initialize"
+		beam
+		echo "/gps/number $(( nof_pions > 0 ? nof_pions : 1 ))"
+		echo "/gps/ene/mono ${energy} GeV"
+		echo "/run/beamOn ${num_events}"
+	} > $macro
+	echo "Running ${name}"
+	log="${output}.log"
+	./ATHENA_Geometry -m $macro -t ${num_threads} > $log 2>&1
+	run_time=$(grep "run time" $log | sed 's/.*run time: \([0-9.e+]*\) s/\1/')
+	rate=$(echo "${num_events} ${run_time}" | awk '{ if ($2 > 0) print $1/$2; else print "-" }')
+	overlaid=$(grep "in the gate per event" $log | sed 's/.* and \([0-9.e+-]*\) in the gate.*/\1/')
+	response=$(grep "unweighted: mean" $log | sed 's/.*mean \([0-9.e+-]*\) MeV, sigma \([0-9.e+-]*\) MeV, resolution \([0-9.e+-]*\).*/\1 \2 \3/')
+	echo "${name} ${run_time} ${rate} ${overlaid:-0} ${response}" >> $report
+	rm -f ${output}.root
+done
+
+column -t $report
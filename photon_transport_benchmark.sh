@@ -0,0 +1,73 @@
+#!/bin/bash
+# Photon transport benchmark: runs electrons and photons at several
+# energies with the standard gamma processes, with the gamma general
+# process and with Woodcock tracking in the ECal blocks, and reports the
+# events/s and the response (mean and resolution of the total energy)
+# printed by RunAction.
+# Run from the build directory: ./photon_transport_benchmark.sh [num_events] [num_threads]
+set -e
+
+num_events=${1:-1000}
+num_threads=${2:-4}
+
+particles=(e- gamma)
+energies=(1 10)
+
+# name:physics settings, one command argument list per ';'
+configurations=(
+	"standard:"
+	"general:gammaGeneral true"
+	"woodcock:woodcock ECalPowder"
+)
+
+macro="photon_transport_benchmark.mac"
+report="photon_transport_benchmark.txt"
+echo "particle energy(GeV) configuration run_time(s) events/s mean(MeV) sigma(MeV) resolution" > $report
+
+for particle in "${particles[@]}"
+do
+	for energy in "${energies[@]}"
+	do
+		for configuration in "${configurations[@]}"
+		do
+			name=${configuration%%:*}
+			settings=${configuration#*:}
+			output="photon_transport_${particle}_${energy}GeV_${name}"
+			{
+				IFS=';' read -ra commands <<< "$settings"
+				for command in "${commands[@]}"
+				do
+					echo "/ATHENA/physics/${command}"
+				done
+				cat <<MAC
+/ATHENA/analysis/resolutionScan true
+/analysis/setFileName ${output}
+/run/initialize
+/run/setCut .01 mm
+/gps/particle ${particle}
+/gps/ene/type Mono
+/gps/ene/mono ${energy} GeV
+/gps/pos/type Plane
+/gps/pos/shape Square
+/gps/pos/rot1 1 0 0
+/gps/pos/rot2 0 1 0
+/gps/pos/halfx 0.25 cm
+/gps/pos/halfy 0.25 cm
+/gps/pos/centre 2.5025 2.4747 -8.5 cm
+/gps/direction 0 .08715574275 .9961946981
+/run/beamOn ${num_events}
+MAC
+			} > $macro
+			echo "Running ${particle} ${energy} GeV ${name}"
+			log="${output}.log"
+			./ATHENA_Geometry -m $macro -t ${num_threads} > $log 2>&1
+			run_time=$(grep "run time" $log | sed 's/.*run time: \([0-9.e+]*\) s/\1/')
+			rate=$(echo "${num_events} ${run_time}" | awk '{ if ($2 > 0) print $1/$2; else print "-" }')
+			response=$(grep "unweighted: mean" $log | sed 's/.*mean \([0-9.e+-]*\) MeV, sigma \([0-9.e+-]*\) MeV, resolution \([0-9.e+-]*\).*/\1 \2 \3/')
+			echo "${particle} ${energy} ${name} ${run_time} ${rate} ${response}" >> $report
+			rm -f ${output}.root
+		done
+	done
+done
+
+column -t $report
@@ -0,0 +1,60 @@
+#!/bin/bash
+# Physics list benchmark: runs the same pion beam through several reference
+# physics lists and EM options, and reports the events/s and peak memory
+# printed by RunAction with the response of the resolution scan (mean and
+# resolution of the total energy).
+# Run from the build directory: ./physics_benchmark.sh [num_events] [num_threads] [particle] [energy_GeV]
+set -e
+
+num_events=${1:-500}
+num_threads=${2:-4}
+particle=${3:-pi+}
+energy=${4:-10}
+
+# physics list:EM option
+configurations=(
+	"QGSP_BERT:opt0"
+	"FTFP_BERT:opt0"
+	"FTFP_BERT:opt4"
+	"QGSP_BERT:opt4"
+	"FTFP_BERT_HP:opt0"
+	"QGSP_BERT_HP:opt0"
+)
+
+macro="physics_benchmark.mac"
+report="physics_benchmark.txt"
+echo "physics_list em_option run_time(s) events/s peak_memory(MB) mean(MeV) sigma(MeV) resolution" > $report
+
+for configuration in "${configurations[@]}"
+do
+	physics_list=${configuration%%:*}
+	em_option=${configuration#*:}
+	output="physics_benchmark_${physics_list}_${em_option}"
+	cat > $macro <<MAC
+/ATHENA/analysis/resolutionScan true
+/analysis/setFileName ${output}
+/run/initialize
+/run/setCut .01 mm
+/gps/particle ${particle}
+/gps/ene/type Mono
+/gps/ene/mono ${energy} GeV
+/gps/pos/type Plane
+/gps/pos/shape Square
+/gps/pos/rot1 1 0 0
+/gps/pos/rot2 0 1 0
+/gps/pos/halfx 0.25 cm
+/gps/pos/halfy 0.25 cm
+/gps/pos/centre 2.5025 2.4747 -8.5 cm
+/gps/direction 0 .08715574275 .9961946981
+/run/beamOn ${num_events}
+MAC
+	echo "Running ${physics_list} ${em_option}"
+	log="${output}.log"
+	./ATHENA_Geometry -m $macro -t ${num_threads} -p ${physics_list} -e ${em_option} > $log 2>&1
+	performance=$(grep "Performance:" $log | tail -1 | sed 's/.* events in \([0-9.e+-]*\) s, \([0-9.e+-]*\) events\/s, peak memory \([0-9.e+-]*\) MB/\1 \2 \3/')
+	response=$(grep "unweighted: mean" $log | sed 's/.*mean \([0-9.e+-]*\) MeV, sigma \([0-9.e+-]*\) MeV, resolution \([0-9.e+-]*\).*/\1 \2 \3/')
+	echo "${physics_list} ${em_option} ${performance} ${response}" >> $report
+	rm -f ${output}.root
+done
+
+column -t $report
@@ -0,0 +1,45 @@
+#!/bin/bash
+# Physics table cache benchmark: runs a short job without the cache, with
+# an empty cache (the tables are built and stored) and with the filled
+# cache (the tables are retrieved), and reports the time to build or
+# retrieve the tables printed by PhysicsTableCache with the wall time of
+# the whole job.
+# Run from the build directory: ./physics_table_cache.sh [num_threads] [physics_list]
+set -e
+
+num_threads=${1:-4}
+physics_list=${2:-QGSP_BERT}
+cache="physics_table_cache"
+
+macro="physics_table_cache.mac"
+report="physics_table_cache.txt"
+echo "configuration tables(s) job(s)" > $report
+rm -rf $cache
+
+for name in none cold warm
+do
+	output="physics_table_cache_${name}"
+	{
+		if [ $name != none ]; then echo "/ATHENA/physics/tableCache ${cache}"; fi
+		cat <<MAC
+/analysis/setFileName ${output}
+/run/initialize
+/run/setCut .01 mm
+/gps/particle pi+
+/gps/ene/type Mono
+/gps/ene/mono 1 GeV
+/run/beamOn 10
+MAC
+	} > $macro
+	echo "Running ${name}"
+	log="${output}.log"
+	start=$(date +%s.%N)
+	./ATHENA_Geometry -m $macro -t ${num_threads} -p ${physics_list} > $log 2>&1
+	end=$(date +%s.%N)
+	tables=$(grep "Physics tables:" $log | head -1 | sed 's/.* in \([0-9.e+-]*\) s.*/\1/')
+	job=$(echo "${start} ${end}" | awk '{ print $2 - $1 }')
+	echo "${name} ${tables:--} ${job}" >> $report
+	rm -f ${output}.root
+done
+
+column -t $report
@@ -0,0 +1,66 @@
+#!/bin/bash
+# Region benchmark: runs the same beam configuration with the global
+# production cut of mymac_WScFi.mac and with per-region cuts and step
+# limits, and reports the events/s and the response (mean and resolution of
+# the total energy) printed by RunAction.
+# Run from the build directory: ./region_benchmark.sh [num_events] [num_threads]
+set -e
+
+num_events=${1:-500}
+num_threads=${2:-4}
+particle="pi+"
+energy=10
+
+# name:region settings, one command argument list per ';'
+configurations=(
+	"global:"
+	"recommended:cut ECalPowder 0.1 mm;cut HCalAbsorber 1 mm;cut HCalScintillator 0.1 mm;cut World 1 m"
+	"coarse:cut ECalPowder 0.7 mm;cut HCalAbsorber 2 mm;cut HCalScintillator 0.7 mm;cut World 1 m"
+	"recommended_steps:cut ECalPowder 0.1 mm;cut HCalAbsorber 1 mm;cut HCalScintillator 0.1 mm;cut World 1 m;stepLimit ECalFibers 0.1 mm"
+)
+
+macro="region_benchmark.mac"
+report="region_benchmark.txt"
+echo "configuration run_time(s) events/s mean(MeV) sigma(MeV) resolution" > $report
+
+for configuration in "${configurations[@]}"
+do
+	name=${configuration%%:*}
+	settings=${configuration#*:}
+	output="region_benchmark_${name}"
+	{
+		echo "/ATHENA/analysis/resolutionScan true"
+		echo "/analysis/setFileName ${output}"
+		echo "/run/initialize"
+		echo "/run/setCut .01 mm"
+		IFS=';' read -ra commands <<< "$settings"
+		for command in "${commands[@]}"
+		do
+			echo "/ATHENA/regions/${command}"
+		done
+		cat <<MAC
+/gps/particle ${particle}
+/gps/ene/type Mono
+/gps/ene/mono ${energy} GeV
+/gps/pos/type Plane
+/gps/pos/shape Square
+/gps/pos/rot1 1 0 0
+/gps/pos/rot2 0 1 0
+/gps/pos/halfx 0.25 cm
+/gps/pos/halfy 0.25 cm
+/gps/pos/centre 2.5025 2.4747 -8.5 cm
+/gps/direction 0 .08715574275 .9961946981
+/run/beamOn ${num_events}
+MAC
+	} > $macro
+	echo "Running ${name}"
+	log="${output}.log"
+	./ATHENA_Geometry -m $macro -t ${num_threads} > $log 2>&1
+	run_time=$(grep "run time" $log | sed 's/.*run time: \([0-9.e+]*\) s/\1/')
+	rate=$(echo "${num_events} ${run_time}" | awk '{ if ($2 > 0) print $1/$2; else print "-" }')
+	response=$(grep "unweighted: mean" $log | sed 's/.*mean \([0-9.e+-]*\) MeV, sigma \([0-9.e+-]*\) MeV, resolution \([0-9.e+-]*\).*/\1 \2 \3/')
+	echo "${name} ${run_time} ${rate} ${response}" >> $report
+	rm -f ${output}.root
+done
+
+column -t $report
@@ -0,0 +1,33 @@
+#!/bin/bash
+# Event replay: simulates again a single event of a run of a macro (by
+# default mymac_WScFi.mac), from its eventID and the run seed, with the step
+# output, and prints its seeds, its time and its steps. The macro must run
+# with per-event seeding (/ATHENA/random/eventSeeding true or
+# /ATHENA/shard/beamOn).
+# Run from the build directory: ./replay_event.sh <eventID> [macro] [seed]
+set -e
+
+if [ $# -lt 1 ]; then
+	echo "Usage: $0 <eventID> [macro] [seed]"
+	exit 1
+fi
+event_id=$1
+run_macro=${2:-mymac_WScFi.mac}
+seed=${3:-1}
+
+# The settings of the macro without its runs, then the replay with one
+# thread, so that the steps are written to a single file
+macro="replay_event.mac"
+{
+	echo "/ATHENA/random/seed ${seed}"
+	grep -v -e "^/run/beamOn" -e "^/ATHENA/shard/beamOn" -e "^/analysis/setFileName" $run_macro
+	echo
+	echo "/analysis/setFileName replay"
+	echo "/ATHENA/output/steps/prescale 1"
+	echo "/ATHENA/random/replay ${event_id}"
+} > $macro
+
+log="replay_event_${event_id}.log"
+./ATHENA_Geometry -m $macro -t 1 > $log 2>&1
+grep -e "---> Replay" $log
+./asteps_dump replay_event${event_id}_steps_t0.asteps ${event_id} | head -40
@@ -0,0 +1,75 @@
+#!/bin/bash
+# Job sharding: simulates a production in one process, then split into
+# shards run by independent processes (as on the nodes of a farm, here in
+# parallel on this machine, with different numbers of threads), merges
+# the columnar outputs of the shards and compares them with the single
+# process run: the events and the sums of the energy deposits must be the
+# same.
+# Run from the build directory: ./shard_farm.sh [num_events] [num_shards] [num_threads]
+set -e
+
+num_events=${1:-1000}
+num_shards=${2:-4}
+num_threads=${3:-4}
+particle="pi+"
+energy=10
+seed=4711
+
+macro="shard_farm.mac"
+cat > $macro <<MAC
+/ATHENA/output/format columnar
+/ATHENA/random/seed ${seed}
+/analysis/setFileName shard_farm
+/run/initialize
+/gps/particle ${particle}
+/gps/ene/type Mono
+/gps/ene/mono ${energy} GeV
+/gps/pos/type Plane
+/gps/pos/shape Square
+/gps/pos/rot1 1 0 0
+/gps/pos/rot2 0 1 0
+/gps/pos/halfx 0.25 cm
+/gps/pos/halfy 0.25 cm
+/gps/pos/centre 2.5025 2.4747 -8.5 cm
+/gps/direction 0 .08715574275 .9961946981
+/ATHENA/shard/beamOn ${num_events}
+MAC
+
+report="shard_farm.txt"
+echo "configuration run_time(s) events ECal_Edep_Active_Total(MeV) HCal_Edep_Active_Total(MeV)" > $report
+
+summarise() {
+	local name=$1 dataset=$2 run_time=$3
+	events=$(./acol_info $dataset | grep "^Events:" | sed 's/Events: \([0-9]*\).*/\1/')
+	ecal=$(./acol_info $dataset EdepTotal ECal_Edep_Active_Total | sed 's/.*sum \([0-9.e+-]*\),.*/\1/')
+	hcal=$(./acol_info $dataset EdepTotal HCal_Edep_Active_Total | sed 's/.*sum \([0-9.e+-]*\),.*/\1/')
+	echo "${name} ${run_time} ${events} ${ecal} ${hcal}" >> $report
+}
+
+echo "Running the single process"
+start=$(date +%s.%N)
+./ATHENA_Geometry -m $macro -t ${num_threads} > shard_farm.log 2>&1
+run_time=$(echo "$start $(date +%s.%N)" | awk '{ print $2 - $1 }')
+summarise single shard_farm.acolset ${run_time}
+
+echo "Running ${num_shards} shards"
+start=$(date +%s.%N)
+pids=()
+for (( i=0; i<num_shards; i++ ))
+do
+	# Each node has its own number of threads
+	threads=$(( i % 2 == 0 ? num_threads : (num_threads + 1)/2 ))
+	./ATHENA_Geometry -m $macro -t ${threads} -s ${i}/${num_shards} > shard_farm_shard${i}.log 2>&1 &
+	pids+=($!)
+done
+for pid in "${pids[@]}"
+do
+	wait $pid
+done
+run_time=$(echo "$start $(date +%s.%N)" | awk '{ print $2 - $1 }')
+
+# The eventIDs of the shards are disjoint: duplicates are an error
+./acol_merge --eventids keep -o shard_farm_merged.acol shard_farm_shard*.acolset > /dev/null
+summarise "${num_shards}_shards" shard_farm_merged.acol ${run_time}
+
+column -t $report
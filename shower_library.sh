@@ -0,0 +1,93 @@
+#!/bin/bash
+# Frozen shower libraries: generates the ECal and HCal libraries from single
+# particles started inside the detectors, then runs pions at several energies
+# in validation mode with the libraries substituting the low-energy
+# secondaries, and reports the fast/full ratios of the calorimeter energies
+# with the speed-up printed by RunAction.
+# Run from the build directory: ./shower_library.sh [num_showers] [num_events] [num_threads]
+set -e
+
+num_showers=${1:-20000}
+num_events=${2:-1000}
+num_threads=${3:-4}
+
+ecal_library="ecal_showers.aslib"
+hcal_library="hcal_showers.aslib"
+
+# Generation: isotropic particles with a 1/E spectrum over the library
+# range, started uniformly in the middle of one ECal block or HCal tower
+generate() {
+	local detector=$1 library=$2 centre=$3 half=$4
+	shift 4
+	local macro="shower_library_${detector}.mac"
+	cat > $macro <<MAC
+/ATHENA/showerlib/generate ${detector} ${library}
+/analysis/setFileName shower_library_${detector}
+/run/initialize
+/gps/pos/type Volume
+/gps/pos/shape Para
+/gps/pos/centre ${centre} cm
+/gps/pos/halfx $(echo $half | cut -d' ' -f1) cm
+/gps/pos/halfy $(echo $half | cut -d' ' -f2) cm
+/gps/pos/halfz $(echo $half | cut -d' ' -f3) cm
+/gps/ang/type iso
+/gps/ene/type Pow
+/gps/ene/alpha -1
+/gps/ene/min 10 MeV
+/gps/ene/max 1 GeV
+MAC
+	for particle in "$@"
+	do
+		echo "/gps/particle ${particle}" >> $macro
+		echo "/run/beamOn ${num_showers}" >> $macro
+	done
+	echo "Generating the ${detector} library"
+	./ATHENA_Geometry -m $macro -t ${num_threads} > shower_library_${detector}.log 2>&1
+	rm -f shower_library_${detector}.root
+	./aslib_info ${library}
+}
+
+generate ecal ${ecal_library} "2.5025 2.4747 0" "1.5 1.5 5" e- e+ gamma
+generate hcal ${hcal_library} "5 4.94 60" "3 3 30" e- gamma pi+ pi- proton neutron
+
+# Validation: even events with the libraries, odd events fully simulated
+particle="pi+"
+energies=(5 10 20)
+
+macro="shower_library_validation.mac"
+report="shower_library.txt"
+echo "energy(GeV) ecal_active ecal_total hcal_active hcal_total speed-up" > $report
+
+for energy in "${energies[@]}"
+do
+	output="shower_library_${energy}GeV"
+	cat > $macro <<MAC
+/ATHENA/fastsim/mode validate
+/ATHENA/fastsim/minEnergy 100 TeV
+/ATHENA/showerlib/use ecal ${ecal_library}
+/ATHENA/showerlib/use hcal ${hcal_library}
+/analysis/setFileName ${output}
+/run/initialize
+/gps/particle ${particle}
+/gps/ene/type Mono
+/gps/ene/mono ${energy} GeV
+/gps/pos/type Plane
+/gps/pos/shape Square
+/gps/pos/rot1 1 0 0
+/gps/pos/rot2 0 1 0
+/gps/pos/halfx 0.25 cm
+/gps/pos/halfy 0.25 cm
+/gps/pos/centre 2.5025 2.4747 -8.5 cm
+/gps/direction 0 .08715574275 .9961946981
+/run/beamOn ${num_events}
+MAC
+	echo "Running ${energy} GeV"
+	log="${output}.log"
+	./ATHENA_Geometry -m $macro -t ${num_threads} -f on > $log 2>&1
+	ratio() { grep "$1" $log | tail -1 | awk '{ print $NF }'; }
+	speedup=$(grep "speed-up:" $log | sed 's/.*speed-up: \([0-9.e+-]*\)/\1/')
+	echo "${energy} $(ratio 'ECal active') $(ratio 'ECal total') $(ratio 'HCal active') $(ratio 'HCal total') ${speedup:--}" >> $report
+	rm -f ${output}.root
+done
+
+column -t $report
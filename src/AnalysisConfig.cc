@@ -0,0 +1,180 @@
+/// \file AnalysisConfig.cc
+/// \brief Implementation of the AnalysisConfig class
+
+#include "AnalysisConfig.hh"
+#include "AnalysisMessenger.hh"
+
+#include "G4ios.hh"
+#include "G4UnitsTable.hh"
+#include "G4SystemOfUnits.hh"
+
+AnalysisConfig* AnalysisConfig::fInstance = nullptr;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+AnalysisConfig* AnalysisConfig::Instance()
+{
+  // The instance is created on the master when the RunAction is built,
+  // before any worker thread is started
+  if ( ! fInstance ) {
+    fInstance = new AnalysisConfig();
+  }
+  return fInstance;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+AnalysisConfig::AnalysisConfig()
+ : fMessenger(nullptr),
+   fResolutionScan(false),
+   fFirstWeight(0.6),
+   fWeightStep(0.05),
+   fNofWeights(20),
+   fTailVeto(0.01),
+   fTileCut(0.5*MeV),
+   fNofEnergyBins(3000),
+   fMaxEnergy(4.5*GeV),
+   fShowerMaps(false),
+   fClustering(false),
+   fECalSeed(2.*MeV),
+   fECalNeighbour(0.5*MeV),
+   fHCalSeed(2.*MeV),
+   fHCalNeighbour(0.5*MeV),
+   fContainmentMode("off"),
+   fContainmentTail(0.01),
+   fContainmentEdge(0.)
+{
+  fMessenger = new AnalysisMessenger(this);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+AnalysisConfig::~AnalysisConfig()
+{
+  delete fMessenger;
+  fInstance = nullptr;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void AnalysisConfig::SetResolutionScan(G4bool scan)
+{
+  fResolutionScan = scan;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void AnalysisConfig::SetWeights(G4double first, G4double step, G4int nofWeights)
+{
+  fFirstWeight = first;
+  fWeightStep = step;
+  fNofWeights = nofWeights;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void AnalysisConfig::SetTailVeto(G4double fraction)
+{
+  fTailVeto = fraction;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void AnalysisConfig::SetTileCut(G4double energy)
+{
+  fTileCut = energy;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void AnalysisConfig::SetEnergyHistogram(G4int nofBins, G4double maxEnergy)
+{
+  fNofEnergyBins = nofBins;
+  fMaxEnergy = maxEnergy;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void AnalysisConfig::SetShowerMaps(G4bool maps)
+{
+  fShowerMaps = maps;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void AnalysisConfig::SetClustering(G4bool clustering)
+{
+  fClustering = clustering;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void AnalysisConfig::SetClusterThresholds(G4double ecalSeed, G4double ecalNeighbour,
+                                          G4double hcalSeed, G4double hcalNeighbour)
+{
+  fECalSeed = ecalSeed;
+  fECalNeighbour = ecalNeighbour;
+  fHCalSeed = hcalSeed;
+  fHCalNeighbour = hcalNeighbour;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void AnalysisConfig::SetContainmentMode(const G4String& mode)
+{
+  fContainmentMode = mode;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void AnalysisConfig::SetContainmentCut(G4double tailFraction, G4double edgeFraction)
+{
+  fContainmentTail = tailFraction;
+  fContainmentEdge = edgeFraction;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+std::vector<G4double> AnalysisConfig::GetWeights() const
+{
+  std::vector<G4double> weights;
+  for ( G4int i=0; i<fNofWeights; ++i ) weights.push_back(fFirstWeight + i*fWeightStep);
+  return weights;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void AnalysisConfig::Print() const
+{
+  G4cout << "---> Analysis configuration:" << G4endl;
+  if ( fResolutionScan ) {
+    G4cout << "       resolution scan: " << fNofWeights << " ECal weights from "
+           << fFirstWeight << " by " << fWeightStep
+           << ", tail-catcher veto " << fTailVeto
+           << ", tile cut " << G4BestUnit(fTileCut, "Energy") << G4endl
+           << "       energy histograms: " << fNofEnergyBins << " bins up to "
+           << G4BestUnit(fMaxEnergy, "Energy") << G4endl;
+  }
+  else {
+    G4cout << "       resolution scan: off" << G4endl;
+  }
+  G4cout << "       shower maps: " << ( fShowerMaps ? "on" : "off" ) << G4endl;
+  if ( fClustering ) {
+    G4cout << "       clustering: seed/neighbour thresholds ECal "
+           << G4BestUnit(fECalSeed, "Energy") << "/" << G4BestUnit(fECalNeighbour, "Energy")
+           << ", HCal "
+           << G4BestUnit(fHCalSeed, "Energy") << "/" << G4BestUnit(fHCalNeighbour, "Energy")
+           << G4endl;
+  }
+  else {
+    G4cout << "       clustering: off" << G4endl;
+  }
+  G4cout << "       containment: " << fContainmentMode;
+  if ( fContainmentMode != "off" ) {
+    G4cout << ", tail-catcher ratio limit " << fContainmentTail
+           << ", edge limit " << fContainmentEdge << " of the primary energy";
+  }
+  G4cout << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
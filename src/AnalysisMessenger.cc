@@ -0,0 +1,221 @@
+/// \file AnalysisMessenger.cc
+/// \brief Implementation of the AnalysisMessenger class
+
+#include "AnalysisMessenger.hh"
+#include "AnalysisConfig.hh"
+
+#include "G4UIdirectory.hh"
+#include "G4UIcommand.hh"
+#include "G4UIparameter.hh"
+#include "G4UIcmdWithABool.hh"
+#include "G4UIcmdWithAString.hh"
+#include "G4UIcmdWithADouble.hh"
+#include "G4UIcmdWithADoubleAndUnit.hh"
+#include "G4UIcmdWithoutParameter.hh"
+
+#include <sstream>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+AnalysisMessenger::AnalysisMessenger(AnalysisConfig* config)
+ : G4UImessenger(),
+   fConfig(config)
+{
+  fAnalysisDir = new G4UIdirectory("/ATHENA/analysis/");
+  fAnalysisDir->SetGuidance("Analysis accumulated during the run.");
+
+  // Resolution scan
+  fResolutionScanCmd = new G4UIcmdWithABool("/ATHENA/analysis/resolutionScan", this);
+  fResolutionScanCmd->SetGuidance("Accumulate the total energy per event for a grid of ECal");
+  fResolutionScanCmd->SetGuidance("weights and print the resolution and the optimal weight");
+  fResolutionScanCmd->SetGuidance("at the end of the run (default false).");
+  fResolutionScanCmd->SetParameterName("scan", false);
+  fResolutionScanCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fResolutionScanCmd->SetToBeBroadcasted(false);
+
+  fWeightsCmd = new G4UIcommand("/ATHENA/analysis/weights", this);
+  fWeightsCmd->SetGuidance("Grid of the ECal weights: first weight, step, number of weights.");
+  fWeightsCmd->SetGuidance("The ECal energy is divided by the weight. Default: 0.6 0.05 20");
+  auto firstParam = new G4UIparameter("first", 'd', false);
+  firstParam->SetParameterRange("first>0.");
+  fWeightsCmd->SetParameter(firstParam);
+  auto stepParam = new G4UIparameter("step", 'd', false);
+  stepParam->SetParameterRange("step>=0.");
+  fWeightsCmd->SetParameter(stepParam);
+  auto nofWeightsParam = new G4UIparameter("weights", 'i', false);
+  nofWeightsParam->SetParameterRange("weights>=1");
+  fWeightsCmd->SetParameter(nofWeightsParam);
+  fWeightsCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fWeightsCmd->SetToBeBroadcasted(false);
+
+  fTailVetoCmd = new G4UIcmdWithADouble("/ATHENA/analysis/tailVeto", this);
+  fTailVetoCmd->SetGuidance("Veto the events with a larger fraction of their energy in the");
+  fTailVetoCmd->SetGuidance("tail catcher (last HCal layers). 1 disables the veto.");
+  fTailVetoCmd->SetParameterName("fraction", false);
+  fTailVetoCmd->SetRange("fraction>0. && fraction<=1.");
+  fTailVetoCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fTailVetoCmd->SetToBeBroadcasted(false);
+
+  fTileCutCmd = new G4UIcmdWithADoubleAndUnit("/ATHENA/analysis/tileCut", this);
+  fTileCutCmd->SetGuidance("Minimum energy of an HCal tile in the resolution scan.");
+  fTileCutCmd->SetParameterName("energy", false);
+  fTileCutCmd->SetRange("energy>=0.");
+  fTileCutCmd->SetUnitCategory("Energy");
+  fTileCutCmd->SetDefaultUnit("MeV");
+  fTileCutCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fTileCutCmd->SetToBeBroadcasted(false);
+
+  fEnergyHistogramCmd = new G4UIcommand("/ATHENA/analysis/energyHistogram", this);
+  fEnergyHistogramCmd->SetGuidance("Number of bins and upper edge of the energy histograms.");
+  auto nofBinsParam = new G4UIparameter("bins", 'i', false);
+  nofBinsParam->SetParameterRange("bins>=1");
+  fEnergyHistogramCmd->SetParameter(nofBinsParam);
+  auto maxParam = new G4UIparameter("max", 'd', false);
+  maxParam->SetParameterRange("max>0.");
+  fEnergyHistogramCmd->SetParameter(maxParam);
+  auto unitParam = new G4UIparameter("unit", 's', true);
+  unitParam->SetDefaultUnit("MeV");
+  fEnergyHistogramCmd->SetParameter(unitParam);
+  fEnergyHistogramCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fEnergyHistogramCmd->SetToBeBroadcasted(false);
+
+  // Shower maps
+  fShowerMapsCmd = new G4UIcmdWithABool("/ATHENA/analysis/showerMaps", this);
+  fShowerMapsCmd->SetGuidance("Accumulate the run-averaged energy maps of the HCal tiles and");
+  fShowerMapsCmd->SetGuidance("ECal blocks, their pi0 fractions and the containment versus");
+  fShowerMapsCmd->SetGuidance("depth (default false).");
+  fShowerMapsCmd->SetParameterName("maps", false);
+  fShowerMapsCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fShowerMapsCmd->SetToBeBroadcasted(false);
+
+  // Clustering
+  fClusteringCmd = new G4UIcmdWithABool("/ATHENA/analysis/clustering", this);
+  fClusteringCmd->SetGuidance("Cluster the ECal blocks and HCal towers of each event and");
+  fClusteringCmd->SetGuidance("write the clusters to the Clusters table (default false).");
+  fClusteringCmd->SetParameterName("clustering", false);
+  fClusteringCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fClusteringCmd->SetToBeBroadcasted(false);
+
+  fClusterThresholdsCmd = new G4UIcommand("/ATHENA/analysis/clusterThresholds", this);
+  fClusterThresholdsCmd->SetGuidance("Seed and neighbour thresholds on the active energy of the");
+  fClusterThresholdsCmd->SetGuidance("ECal blocks and HCal towers. Default: 2 0.5 2 0.5 MeV");
+  for ( auto name : { "ecalSeed", "ecalNeighbour", "hcalSeed", "hcalNeighbour" } ) {
+    auto thresholdParam = new G4UIparameter(name, 'd', false);
+    thresholdParam->SetParameterRange((G4String(name) + ">=0.").c_str());
+    fClusterThresholdsCmd->SetParameter(thresholdParam);
+  }
+  auto thresholdUnitParam = new G4UIparameter("unit", 's', true);
+  thresholdUnitParam->SetDefaultUnit("MeV");
+  fClusterThresholdsCmd->SetParameter(thresholdUnitParam);
+  fClusterThresholdsCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fClusterThresholdsCmd->SetToBeBroadcasted(false);
+
+  // Containment monitor
+  fContainmentCmd = new G4UIcmdWithAString("/ATHENA/analysis/containment", this);
+  fContainmentCmd->SetGuidance("Stop the events above the containment limits during the");
+  fContainmentCmd->SetGuidance("simulation: off, tag (kill the remaining tracks and write the");
+  fContainmentCmd->SetGuidance("event) or abort (abort the event and only record it in the");
+  fContainmentCmd->SetGuidance("Containment table). The tiles of Resolution.cpp are smeared,");
+  fContainmentCmd->SetGuidance("so that abort can drop events close to the cut that it keeps;");
+  fContainmentCmd->SetGuidance("tag keeps them for the analysis to decide. Default: off");
+  fContainmentCmd->SetParameterName("mode", false);
+  fContainmentCmd->SetCandidates("off tag abort");
+  fContainmentCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fContainmentCmd->SetToBeBroadcasted(false);
+
+  fContainmentCutCmd = new G4UIcommand("/ATHENA/analysis/containmentCut", this);
+  fContainmentCutCmd->SetGuidance("Containment limits: tail-catcher cut of the analysis on");
+  fContainmentCutCmd->SetGuidance("tail/(ECal/weight + HCal) with the active energies, reached");
+  fContainmentCutCmd->SetGuidance("at every weight of the scan whatever the rest of the event");
+  fContainmentCutCmd->SetGuidance("deposits, and energy in the outer HCal towers as a fraction");
+  fContainmentCutCmd->SetGuidance("of the primary energy; 0 disables a limit. Default: 0.01 0");
+  auto tailParam = new G4UIparameter("tail", 'd', false);
+  tailParam->SetParameterRange("tail>=0. && tail<=1.");
+  fContainmentCutCmd->SetParameter(tailParam);
+  auto edgeParam = new G4UIparameter("edge", 'd', false);
+  edgeParam->SetParameterRange("edge>=0. && edge<=1.");
+  fContainmentCutCmd->SetParameter(edgeParam);
+  fContainmentCutCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fContainmentCutCmd->SetToBeBroadcasted(false);
+
+  fPrintCmd = new G4UIcmdWithoutParameter("/ATHENA/analysis/print", this);
+  fPrintCmd->SetGuidance("Print the analysis configuration.");
+  fPrintCmd->SetToBeBroadcasted(false);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+AnalysisMessenger::~AnalysisMessenger()
+{
+  delete fResolutionScanCmd;
+  delete fWeightsCmd;
+  delete fTailVetoCmd;
+  delete fTileCutCmd;
+  delete fEnergyHistogramCmd;
+  delete fShowerMapsCmd;
+  delete fClusteringCmd;
+  delete fClusterThresholdsCmd;
+  delete fContainmentCmd;
+  delete fContainmentCutCmd;
+  delete fPrintCmd;
+  delete fAnalysisDir;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void AnalysisMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
+{
+  if ( command == fResolutionScanCmd ) {
+    fConfig->SetResolutionScan(fResolutionScanCmd->GetNewBoolValue(newValue));
+  }
+  else if ( command == fWeightsCmd ) {
+    std::istringstream is(newValue);
+    G4double first, step;
+    G4int nofWeights;
+    is >> first >> step >> nofWeights;
+    fConfig->SetWeights(first, step, nofWeights);
+  }
+  else if ( command == fTailVetoCmd ) {
+    fConfig->SetTailVeto(fTailVetoCmd->GetNewDoubleValue(newValue));
+  }
+  else if ( command == fTileCutCmd ) {
+    fConfig->SetTileCut(fTileCutCmd->GetNewDoubleValue(newValue));
+  }
+  else if ( command == fEnergyHistogramCmd ) {
+    std::istringstream is(newValue);
+    G4int nofBins;
+    G4double maxEnergy;
+    G4String unit;
+    is >> nofBins >> maxEnergy >> unit;
+    fConfig->SetEnergyHistogram(nofBins, maxEnergy*G4UIcommand::ValueOf(unit));
+  }
+  else if ( command == fShowerMapsCmd ) {
+    fConfig->SetShowerMaps(fShowerMapsCmd->GetNewBoolValue(newValue));
+  }
+  else if ( command == fClusteringCmd ) {
+    fConfig->SetClustering(fClusteringCmd->GetNewBoolValue(newValue));
+  }
+  else if ( command == fClusterThresholdsCmd ) {
+    std::istringstream is(newValue);
+    G4double ecalSeed, ecalNeighbour, hcalSeed, hcalNeighbour;
+    G4String unit;
+    is >> ecalSeed >> ecalNeighbour >> hcalSeed >> hcalNeighbour >> unit;
+    auto value = G4UIcommand::ValueOf(unit);
+    fConfig->SetClusterThresholds(ecalSeed*value, ecalNeighbour*value,
+                                  hcalSeed*value, hcalNeighbour*value);
+  }
+  else if ( command == fContainmentCmd ) {
+    fConfig->SetContainmentMode(newValue);
+  }
+  else if ( command == fContainmentCutCmd ) {
+    std::istringstream is(newValue);
+    G4double tailFraction, edgeFraction;
+    is >> tailFraction >> edgeFraction;
+    fConfig->SetContainmentCut(tailFraction, edgeFraction);
+  }
+  else if ( command == fPrintCmd ) {
+    fConfig->Print();
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,352 @@
+/// \file AsyncWriter.cc
+/// \brief Implementation of the AsyncWriter class
+
+#include "AsyncWriter.hh"
+#include "ColumnarWriter.hh"
+#include "TensorWriter.hh"
+#include "EventRecord.hh"
+#include "OutputConfig.hh"
+
+#include "G4ios.hh"
+
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+#include <utility>
+
+AsyncWriter* AsyncWriter::fInstance = nullptr;
+
+namespace
+{
+  using Clock = std::chrono::steady_clock;
+
+  G4double Seconds(Clock::duration duration)
+  {
+    return std::chrono::duration<G4double>(duration).count();
+  }
+
+  // Wait for the other side of the queue: spin briefly, then sleep
+  void Backoff(G4int& nofTries)
+  {
+    if ( ++nofTries < 64 ) {
+      std::this_thread::yield();
+    }
+    else {
+      std::this_thread::sleep_for(std::chrono::microseconds(50));
+    }
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+AsyncWriter* AsyncWriter::Instance()
+{
+  // The instance is created on the master before the workers start
+  if ( ! fInstance ) {
+    fInstance = new AsyncWriter();
+  }
+  return fInstance;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+AsyncWriter::AsyncWriter()
+ : fColumnarWriter(nullptr),
+   fTensorWriter(nullptr),
+   fQueue(nullptr),
+   fFreeRecords(nullptr),
+   fRunning(false),
+   fStopRequested(false),
+   fQueueSize(0),
+   fFlushEvents(0),
+   fFlushSize(0.),
+   fReorder(false),
+   fCellTables(true),
+   fError(),
+   fFailed(false),
+   fNextEventID(0),
+   fNofEventsSinceFlush(0),
+   fNofPushed(0),
+   fNofStalls(0),
+   fStallTime(0),
+   fDepthSum(0),
+   fMaxDepth(0),
+   fNofWritten(0),
+   fNofFlushes(0),
+   fNofHeld(0),
+   fMaxHeld(0),
+   fNofOutOfOrder(0),
+   fBusyTime(0.),
+   fRunTime(0.)
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+AsyncWriter::~AsyncWriter()
+{
+  Stop();
+  delete fColumnarWriter;
+  delete fTensorWriter;
+
+  EventRecord* record = nullptr;
+  if ( fFreeRecords ) {
+    while ( fFreeRecords->TryPop(record) ) delete record;
+  }
+  delete fFreeRecords;
+  delete fQueue;
+  fInstance = nullptr;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void AsyncWriter::Start(ColumnarWriter* columnarWriter, TensorWriter* tensorWriter,
+                        G4int firstEventID)
+{
+  Stop();
+
+  auto outputConfig = OutputConfig::Instance();
+  std::size_t queueSize = outputConfig->GetQueueSize();
+  // The queue capacity is rounded up and kept when a run asks for less
+  fQueueSize = queueSize;
+  if ( ! fQueue || fQueue->Capacity() < queueSize ) {
+    delete fQueue;
+    fQueue = new BoundedQueue<EventRecord*>(queueSize);
+    // The pool also holds the records in flight in the workers
+    delete fFreeRecords;
+    fFreeRecords = new BoundedQueue<EventRecord*>(2*queueSize);
+  }
+  fFlushEvents = outputConfig->GetFlushEvents();
+  fFlushSize = outputConfig->GetFlushSize();
+  fReorder = outputConfig->IsReorderEvents();
+  fCellTables = outputConfig->IsCellTables();
+  fNextEventID = firstEventID;
+  fNofEventsSinceFlush = 0;
+  fError.clear();
+  fFailed = false;
+
+  fNofPushed = 0;
+  fNofStalls = 0;
+  fStallTime = 0;
+  fDepthSum = 0;
+  fMaxDepth = 0;
+  fNofWritten = 0;
+  fNofFlushes = 0;
+  fNofHeld = 0;
+  fMaxHeld = 0;
+  fNofOutOfOrder = 0;
+  fBusyTime = 0.;
+  fRunTime = 0.;
+
+  delete fColumnarWriter;
+  delete fTensorWriter;
+  fColumnarWriter = columnarWriter;
+  fTensorWriter = tensorWriter;
+  fRunning = true;
+  fStopRequested = false;
+  fThread = std::thread(&AsyncWriter::Run, this);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void AsyncWriter::Stop(const std::vector<ColumnarFormat::Histogram>& histograms)
+{
+  if ( ! fRunning ) return;
+
+  // All workers have pushed their last event when the master stops the
+  // writer; the thread drains the queue before it exits
+  fStopRequested.store(true, std::memory_order_release);
+  fThread.join();
+
+  // The files are closed also after an error, keeping the first one
+  try {
+    if ( fColumnarWriter ) {
+      if ( ! fFailed ) {
+        for ( const auto& histogram : histograms ) fColumnarWriter->WriteHistogram(histogram);
+      }
+      fColumnarWriter->Close();
+    }
+  }
+  catch ( const std::exception& e ) {
+    if ( ! fFailed ) fError = e.what();
+    fFailed = true;
+  }
+  try {
+    if ( fTensorWriter ) fTensorWriter->Close();
+  }
+  catch ( const std::exception& e ) {
+    if ( ! fFailed ) fError = e.what();
+    fFailed = true;
+  }
+  fRunning = false;
+
+  if ( fFailed ) {
+    G4ExceptionDescription msg;
+    msg << fError << G4endl << fNofWritten << " events were written before the error.";
+    G4Exception("AsyncWriter::Stop()", "MyCode0008", FatalException, msg);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void AsyncWriter::Push(EventRecord& record)
+{
+  // The output is lost after a write error, reported at the end of the run
+  if ( fFailed.load(std::memory_order_acquire) ) return;
+
+  // Take a written record from the pool; new records are only allocated
+  // until the pool holds as many records as are in flight
+  EventRecord* queued = nullptr;
+  if ( ! fFreeRecords->TryPop(queued) ) queued = new EventRecord();
+  std::swap(*queued, record);
+
+  auto depth = fQueue->Size();
+  fDepthSum.fetch_add(depth, std::memory_order_relaxed);
+  UpdateMaxDepth(std::min(depth + 1, fQueue->Capacity()));
+
+  if ( ! fQueue->TryPush(queued) ) {
+    // Back-pressure: the writer cannot keep up with the workers
+    auto start = Clock::now();
+    G4int nofTries = 0;
+    do { Backoff(nofTries); } while ( ! fQueue->TryPush(queued) );
+    fNofStalls.fetch_add(1, std::memory_order_relaxed);
+    fStallTime.fetch_add(std::uint64_t(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count()),
+      std::memory_order_relaxed);
+  }
+  fNofPushed.fetch_add(1, std::memory_order_relaxed);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void AsyncWriter::UpdateMaxDepth(std::size_t depth)
+{
+  auto maxDepth = fMaxDepth.load(std::memory_order_relaxed);
+  while ( depth > maxDepth
+          && ! fMaxDepth.compare_exchange_weak(maxDepth, depth,
+                                               std::memory_order_relaxed) ) {}
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void AsyncWriter::Run()
+{
+  auto runStart = Clock::now();
+  G4int nofTries = 0;
+  EventRecord* record = nullptr;
+
+  for ( ;; ) {
+    // Read the flag first: once it is set no record is pushed any more,
+    // so an empty queue afterwards means that everything was written
+    auto stop = fStopRequested.load(std::memory_order_acquire);
+
+    if ( ! fQueue->TryPop(record) ) {
+      if ( stop ) break;
+      Backoff(nofTries);
+      continue;
+    }
+    nofTries = 0;
+
+    if ( fReorder ) {
+      Reorder(record);
+    }
+    else {
+      Write(record);
+    }
+  }
+
+  // The events which never arrived leave gaps in the order
+  for ( auto& held : fHeldRecords ) Write(held.second);
+  fHeldRecords.clear();
+
+  fRunTime = Seconds(Clock::now() - runStart);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void AsyncWriter::Reorder(EventRecord* record)
+{
+  if ( record->eventID < fNextEventID ) {
+    // Its successors were written already, the buffer was full
+    ++fNofOutOfOrder;
+    Write(record);
+    return;
+  }
+
+  if ( record->eventID != fNextEventID ) ++fNofHeld;
+  fHeldRecords.emplace(record->eventID, record);
+  fMaxHeld = std::max(fMaxHeld, fHeldRecords.size());
+
+  // Write the records which are next in order; if too many records are
+  // held, give up waiting for the missing ones
+  while ( ! fHeldRecords.empty()
+          && ( fHeldRecords.begin()->first == fNextEventID
+               || fHeldRecords.size() > fQueueSize ) ) {
+    auto first = fHeldRecords.begin();
+    fNextEventID = first->first + 1;
+    Write(first->second);
+    fHeldRecords.erase(first);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void AsyncWriter::Write(EventRecord* record)
+{
+  // The records still queued after an error are only recycled
+  if ( fFailed.load(std::memory_order_relaxed) ) {
+    if ( ! fFreeRecords->TryPush(record) ) delete record;
+    return;
+  }
+
+  auto start = Clock::now();
+  try {
+    if ( fColumnarWriter ) record->FillRows(*fColumnarWriter, fCellTables);
+    if ( fTensorWriter ) fTensorWriter->Write(*record);
+    ++fNofWritten;
+
+    ++fNofEventsSinceFlush;
+    if ( ( fFlushEvents > 0 && fNofEventsSinceFlush >= fFlushEvents )
+      || ( fFlushSize > 0. && fColumnarWriter
+           && fColumnarWriter->GetBufferedBytes() >= fFlushSize*1.e6 ) ) {
+      if ( fColumnarWriter ) fColumnarWriter->Flush();
+      if ( fTensorWriter ) fTensorWriter->Flush();
+      fNofEventsSinceFlush = 0;
+      ++fNofFlushes;
+    }
+  }
+  catch ( const std::exception& e ) {
+    // Raised by Stop() on the master
+    fError = e.what();
+    fFailed.store(true, std::memory_order_release);
+  }
+  fBusyTime += Seconds(Clock::now() - start);
+
+  if ( ! fFreeRecords->TryPush(record) ) delete record;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void AsyncWriter::PrintMetrics() const
+{
+  auto nofPushed = fNofPushed.load();
+  if ( nofPushed == 0 ) return;
+
+  G4cout
+    << "---> Async writer: " << fNofWritten << " events written, "
+    << fNofFlushes << " flushes" << G4endl
+    << "       queue capacity: " << fQueue->Capacity()
+    << ", mean depth: " << G4double(fDepthSum.load())/nofPushed
+    << ", max depth: " << fMaxDepth.load() << G4endl
+    << "       back-pressure: " << fNofStalls.load() << " pushes waited ("
+    << 100.*fNofStalls.load()/nofPushed << " %), "
+    << fStallTime.load()*1.e-9 << " s waited by the workers" << G4endl
+    << "       writer thread busy: " << fBusyTime << " s of " << fRunTime << " s"
+    << G4endl;
+  if ( fReorder ) {
+    G4cout
+      << "       reordering: " << fNofHeld << " events held back, max held: "
+      << fMaxHeld << ", " << fNofOutOfOrder << " written out of order" << G4endl;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -3,14 +3,23 @@
 /// \brief Implementation of the CalorimeterSD class
 
 #include "CalorimeterSD.hh"
+#include "StepRecorder.hh"
+#include "ContainmentMonitor.hh"
+#include "ShowerLibraryBuilder.hh"
+#include "GlobalValues.hh"
 #include "G4HCofThisEvent.hh"
 #include "G4Step.hh"
 #include "G4ThreeVector.hh"
 #include "G4SDManager.hh"
 #include "G4ios.hh"
 #include "G4SystemOfUnits.hh"
-#include "Analysis.hh"
-#include "G4RunManager.hh"
+#include "G4LogicalVolume.hh"
+#include "G4Material.hh"
+
+namespace
+{
+  G4ThreadLocal std::vector<Pi0Record>* pi0Records = nullptr;
+}
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
@@ -20,7 +29,11 @@ CalorimeterSD::CalorimeterSD(
                             G4int nofCells)
  : G4VSensitiveDetector(name),
    fHitsCollection(nullptr),
-   fNofCells(nofCells)
+   fNofCells(nofCells),
+   fStepVolume(-1),
+   fContainmentTailLayer(-1),
+   fContainmentEdge(false),
+   fContainmentSignal(ContainmentMonitor::Signal::None)
 {
   collectionName.insert(hitsCollectionName);
 }
@@ -33,6 +46,16 @@ CalorimeterSD::~CalorimeterSD()
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
+std::vector<Pi0Record>& CalorimeterSD::GetPi0Records()
+{
+  if ( ! pi0Records ) {
+    pi0Records = new std::vector<Pi0Record>;
+  }
+  return *pi0Records;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
 void CalorimeterSD::Initialize(G4HCofThisEvent* hce)
 {
   // Create hits collection
@@ -99,17 +122,33 @@ G4bool CalorimeterSD::ProcessHits(G4Step* step,
   if (step->GetTrack()->GetDefinition()->GetParticleName() == "pi0")
   {
     energyPi0 = step->GetTrack()->GetTotalEnergy();
-    auto analysisManager = G4AnalysisManager::Instance();
-    G4int event_number = G4RunManager::GetRunManager()->GetCurrentEvent()->GetEventID();
-    analysisManager->FillNtupleDColumn(4, 0, energyPi0);
-    analysisManager->FillNtupleDColumn(4, 1, step->GetPreStepPoint()->GetPosition().x()/cm);
-    analysisManager->FillNtupleDColumn(4, 2, step->GetPreStepPoint()->GetPosition().y()/cm);
-    analysisManager->FillNtupleDColumn(4, 3, step->GetPreStepPoint()->GetPosition().z()/cm + 8.5);
-    analysisManager->FillNtupleIColumn(4, 4, event_number);
-    analysisManager->AddNtupleRow(4);
+    // Written to the Pi0 ntuple with the rest of the event
+    const auto& position = step->GetPreStepPoint()->GetPosition();
+    GetPi0Records().push_back(
+      { energyPi0, position.x()/cm, position.y()/cm,
+        ( position.z() + GlobalValues::ECalThickness/2. )/cm });
     numPi0++;
   }
 
+  // Sampled events of the step output
+  if ( fStepVolume >= 0 ) {
+    auto stepRecorder = StepRecorder::Instance();
+    if ( stepRecorder->IsRecording() ) stepRecorder->Record(step, edep, fStepVolume);
+  }
+
+  // Generation of a shower library, on the deposit after the Birks
+  // correction as it is replayed without it
+  auto showerLibraryBuilder = ShowerLibraryBuilder::Instance();
+  if ( showerLibraryBuilder->IsRecording() ) showerLibraryBuilder->Record(step, edep, birk > 0.);
+
+  // Containment of the event, on the deposits before and after the Birks
+  // correction
+  auto containmentMonitor = ContainmentMonitor::Instance();
+  if ( containmentMonitor->IsMonitoring() ) {
+    auto tail = ( fContainmentTailLayer >= 0 && layerNumber >= fContainmentTailLayer );
+    containmentMonitor->Add(step, step->GetTotalEnergyDeposit(), edep, fContainmentSignal,
+                            tail, fContainmentEdge);
+  }
 
   // Add values
   hit->Add(edep, stepLength, energyPi0, numPi0);
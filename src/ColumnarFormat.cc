@@ -0,0 +1,330 @@
+/// \file ColumnarFormat.cc
+/// \brief Implementation of the columnar file format helpers
+
+#include "ColumnarFormat.hh"
+
+#include <cstring>
+#include <fstream>
+
+#include "zlib.h"
+
+namespace
+{
+  template <typename T>
+  bool WriteValue(std::FILE* file, T value)
+  {
+    return std::fwrite(&value, sizeof(T), 1, file) == 1;
+  }
+
+  template <typename T>
+  void AppendValue(std::vector<char>& out, T value)
+  {
+    auto data = reinterpret_cast<const char*>(&value);
+    out.insert(out.end(), data, data + sizeof(T));
+  }
+
+  template <typename T>
+  bool ReadValue(std::FILE* file, T& value)
+  {
+    return std::fread(&value, sizeof(T), 1, file) == 1;
+  }
+
+  bool WriteString(std::FILE* file, const std::string& value)
+  {
+    auto size = std::uint16_t(value.size());
+    return WriteValue(file, size)
+        && std::fwrite(value.data(), 1, size, file) == size;
+  }
+
+  bool ReadString(std::FILE* file, std::string& value)
+  {
+    std::uint16_t size = 0;
+    if ( ! ReadValue(file, size) ) return false;
+    value.resize(size);
+    return std::fread(&value[0], 1, size, file) == size;
+  }
+}
+
+namespace ColumnarFormat
+{
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+std::size_t TypeSize(ColumnType type)
+{
+  switch ( type ) {
+    case ColumnType::Int32:   return 4;
+    case ColumnType::Float32: return 4;
+    case ColumnType::Float64: return 8;
+  }
+  return 0;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+bool SameSchema(const Schema& left, const Schema& right)
+{
+  if ( left.size() != right.size() ) return false;
+  for ( std::size_t i=0; i<left.size(); ++i ) {
+    if ( left[i].name != right[i].name ) return false;
+    if ( left[i].columns.size() != right[i].columns.size() ) return false;
+    for ( std::size_t j=0; j<left[i].columns.size(); ++j ) {
+      if ( left[i].columns[j].name != right[i].columns[j].name ) return false;
+      if ( left[i].columns[j].type != right[i].columns[j].type ) return false;
+    }
+  }
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+int FindTable(const Schema& schema, const std::string& name)
+{
+  for ( std::size_t i=0; i<schema.size(); ++i ) {
+    if ( schema[i].name == name ) return int(i);
+  }
+  return -1;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+int FindColumn(const Table& table, const std::string& name)
+{
+  for ( std::size_t i=0; i<table.columns.size(); ++i ) {
+    if ( table.columns[i].name == name ) return int(i);
+  }
+  return -1;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+bool WriteFileHeader(std::FILE* file, const Schema& schema)
+{
+  if ( std::fwrite(kFileMagic, 1, sizeof(kFileMagic), file) != sizeof(kFileMagic) ) {
+    return false;
+  }
+  bool ok = WriteValue(file, kVersion)
+         && WriteValue(file, std::uint32_t(schema.size()));
+  for ( const auto& table : schema ) {
+    ok = ok && WriteString(file, table.name)
+            && WriteValue(file, std::uint32_t(table.columns.size()));
+    for ( const auto& column : table.columns ) {
+      ok = ok && WriteString(file, column.name)
+              && WriteValue(file, std::uint8_t(column.type));
+    }
+  }
+  return ok;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+bool ReadFileHeader(std::FILE* file, Schema& schema)
+{
+  char magic[sizeof(kFileMagic)];
+  if ( std::fread(magic, 1, sizeof(magic), file) != sizeof(magic) ) return false;
+  if ( std::memcmp(magic, kFileMagic, sizeof(magic)) != 0 ) return false;
+
+  std::uint32_t version = 0;
+  std::uint32_t nofTables = 0;
+  if ( ! ReadValue(file, version) || version != kVersion ) return false;
+  if ( ! ReadValue(file, nofTables) ) return false;
+
+  schema.assign(nofTables, Table());
+  for ( auto& table : schema ) {
+    std::uint32_t nofColumns = 0;
+    if ( ! ReadString(file, table.name) || ! ReadValue(file, nofColumns) ) {
+      return false;
+    }
+    table.columns.assign(nofColumns, Column());
+    for ( auto& column : table.columns ) {
+      std::uint8_t type = 0;
+      if ( ! ReadString(file, column.name) || ! ReadValue(file, type) ) {
+        return false;
+      }
+      column.type = ColumnType(type);
+    }
+  }
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+bool WriteBlockHeader(std::FILE* file, const BlockHeader& header)
+{
+  std::vector<char> data;
+  EncodeBlockHeader(header, data);
+  return std::fwrite(data.data(), 1, data.size(), file) == data.size();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EncodeBlockHeader(const BlockHeader& header, std::vector<char>& out)
+{
+  AppendValue(out, kBlockMagic);
+  AppendValue(out, std::uint32_t(header.kind));
+  AppendValue(out, header.table);
+  AppendValue(out, header.nofRows);
+  AppendValue(out, std::uint32_t(header.chunks.size()));
+  for ( const auto& chunk : header.chunks ) {
+    AppendValue(out, std::uint8_t(chunk.codec));
+    AppendValue(out, chunk.rawSize);
+    AppendValue(out, chunk.storedSize);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+bool ReadBlockHeader(std::FILE* file, BlockHeader& header)
+{
+  std::uint32_t magic = 0;
+  std::uint32_t kind = 0;
+  std::uint32_t nofChunks = 0;
+  if ( ! ReadValue(file, magic) || magic != kBlockMagic ) return false;
+  if ( ! ReadValue(file, kind)
+    || ! ReadValue(file, header.table)
+    || ! ReadValue(file, header.nofRows)
+    || ! ReadValue(file, nofChunks) ) return false;
+  header.kind = BlockKind(kind);
+
+  header.chunks.assign(nofChunks, Chunk());
+  for ( auto& chunk : header.chunks ) {
+    std::uint8_t codec = 0;
+    if ( ! ReadValue(file, codec)
+      || ! ReadValue(file, chunk.rawSize)
+      || ! ReadValue(file, chunk.storedSize) ) return false;
+    chunk.codec = Codec(codec);
+  }
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+Codec Encode(Codec codec, int level,
+             const char* data, std::size_t size, std::vector<char>& out)
+{
+  if ( codec == Codec::Zlib && level > 0 && size > 0 ) {
+    auto bound = compressBound(uLong(size));
+    out.resize(bound);
+    auto compressedSize = bound;
+    auto status = compress2(reinterpret_cast<Bytef*>(out.data()), &compressedSize,
+                            reinterpret_cast<const Bytef*>(data), uLong(size), level);
+    if ( status == Z_OK && compressedSize < size ) {
+      out.resize(compressedSize);
+      return Codec::Zlib;
+    }
+  }
+  out.assign(data, data + size);
+  return Codec::None;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+bool Decode(const Chunk& chunk, const char* payload, char* out)
+{
+  if ( chunk.codec == Codec::None ) {
+    if ( chunk.storedSize != chunk.rawSize ) return false;
+    std::memcpy(out, payload, chunk.rawSize);
+    return true;
+  }
+  if ( chunk.codec == Codec::Zlib ) {
+    auto rawSize = uLongf(chunk.rawSize);
+    auto status = uncompress(reinterpret_cast<Bytef*>(out), &rawSize,
+                             reinterpret_cast<const Bytef*>(payload),
+                             uLong(chunk.storedSize));
+    return status == Z_OK && rawSize == chunk.rawSize;
+  }
+  return false;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EncodeBlock(BlockHeader& header, const std::vector<std::vector<char>>& columns,
+                 Codec codec, int level, std::vector<char>& out)
+{
+  header.chunks.resize(columns.size());
+
+  // Encode all columns first, the header needs the stored sizes
+  std::vector<std::vector<char>> payloads(columns.size());
+  for ( std::size_t i=0; i<columns.size(); ++i ) {
+    const auto& raw = columns[i];
+    auto& chunk = header.chunks[i];
+    chunk.rawSize = raw.size();
+    if ( codec == Codec::None || level == 0 ) {
+      chunk.codec = Codec::None;
+    }
+    else {
+      chunk.codec = Encode(codec, level, raw.data(), raw.size(), payloads[i]);
+    }
+    chunk.storedSize = ( chunk.codec == Codec::None ) ? raw.size() : payloads[i].size();
+  }
+
+  EncodeBlockHeader(header, out);
+  for ( std::size_t i=0; i<columns.size(); ++i ) {
+    const auto& data = ( header.chunks[i].codec == Codec::None ) ? columns[i] : payloads[i];
+    out.insert(out.end(), data.begin(), data.end());
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+bool MergeHistograms(std::vector<Histogram>& merged,
+                     const std::vector<Histogram>& histograms)
+{
+  for ( const auto& histogram : histograms ) {
+    auto found = merged.begin();
+    while ( found != merged.end() && found->name != histogram.name ) ++found;
+
+    if ( found == merged.end() ) {
+      merged.push_back(histogram);
+      continue;
+    }
+    if ( found->binning != histogram.binning
+         || found->contents.size() != histogram.contents.size() ) return false;
+    for ( std::size_t i=0; i<histogram.contents.size(); ++i ) {
+      found->contents[i] += histogram.contents[i];
+    }
+  }
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+bool WriteManifest(const std::string& path, const std::vector<std::string>& files,
+                   const std::string& comment)
+{
+  std::ofstream manifest(path);
+  if ( ! manifest ) return false;
+
+  manifest << "# ATHENA columnar dataset" << std::endl;
+  if ( ! comment.empty() ) manifest << "# " << comment << std::endl;
+  for ( const auto& file : files ) {
+    // Store the names relative to the manifest directory
+    auto slash = file.find_last_of('/');
+    manifest << ( slash == std::string::npos ? file : file.substr(slash+1) )
+             << std::endl;
+  }
+  return bool(manifest);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+bool ReadManifest(const std::string& path, std::vector<std::string>& files)
+{
+  std::ifstream manifest(path);
+  if ( ! manifest ) return false;
+
+  auto slash = path.find_last_of('/');
+  auto directory = ( slash == std::string::npos ) ? std::string() : path.substr(0, slash+1);
+
+  files.clear();
+  std::string line;
+  while ( std::getline(manifest, line) ) {
+    if ( line.empty() || line[0] == '#' ) continue;
+    files.push_back(line[0] == '/' ? line : directory + line);
+  }
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+}
@@ -0,0 +1,573 @@
+/// \file ColumnarReader.cc
+/// \brief Implementation of the ColumnarReader and ColumnarDataset classes
+
+#include "ColumnarReader.hh"
+
+#include <algorithm>
+#include <cstring>
+#include <thread>
+#include <type_traits>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace
+{
+  // Convert the values [begin, end) of a decoded chunk
+  template <typename T>
+  void AppendValues(ColumnarFormat::ColumnType type, const std::vector<char>& data,
+                    std::uint64_t begin, std::uint64_t end, std::vector<T>& values)
+  {
+    for ( auto i=begin; i<end; ++i ) {
+      switch ( type ) {
+        case ColumnarFormat::ColumnType::Int32: {
+          std::int32_t value;
+          std::memcpy(&value, data.data() + 4*i, 4);
+          values.push_back(T(value));
+          break;
+        }
+        case ColumnarFormat::ColumnType::Float32: {
+          float value;
+          std::memcpy(&value, data.data() + 4*i, 4);
+          values.push_back(T(value));
+          break;
+        }
+        case ColumnarFormat::ColumnType::Float64: {
+          double value;
+          std::memcpy(&value, data.data() + 8*i, 8);
+          values.push_back(T(value));
+          break;
+        }
+      }
+    }
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+ColumnarReader::ColumnarReader()
+ : fDescriptor(-1),
+   fTruncated(false),
+   fIndexRebuilt(false)
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+ColumnarReader::~ColumnarReader()
+{
+  Close();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+bool ColumnarReader::Open(const std::string& fileName)
+{
+  Close();
+
+  auto file = std::fopen(fileName.c_str(), "rb");
+  if ( ! file ) return false;
+
+  std::fseek(file, 0, SEEK_END);
+  auto fileSize = std::uint64_t(std::ftell(file));
+  std::fseek(file, 0, SEEK_SET);
+
+  if ( ! ColumnarFormat::ReadFileHeader(file, fSchema) ) {
+    std::fclose(file);
+    return false;
+  }
+  fFileName = fileName;
+  fNofRows.assign(fSchema.size(), 0);
+  fTableBlocks.assign(fSchema.size(), std::vector<std::size_t>());
+
+  // Scan the block headers
+  while ( true ) {
+    auto position = std::uint64_t(std::ftell(file));
+    if ( position == fileSize ) break;
+
+    Block block;
+    if ( ! ColumnarFormat::ReadBlockHeader(file, block.header) ) {
+      fTruncated = true;
+      break;
+    }
+    auto offset = std::uint64_t(std::ftell(file));
+    for ( const auto& chunk : block.header.chunks ) {
+      block.offsets.push_back(offset);
+      offset += chunk.storedSize;
+    }
+    if ( offset > fileSize ) {
+      fTruncated = true;
+      break;
+    }
+
+    if ( block.header.kind == ColumnarFormat::BlockKind::Rows ) {
+      if ( block.header.table >= fSchema.size() ) {
+        fTruncated = true;
+        break;
+      }
+      block.firstRow = fNofRows[block.header.table];
+      fNofRows[block.header.table] += block.header.nofRows;
+      fTableBlocks[block.header.table].push_back(fBlocks.size());
+    }
+    else {
+      block.firstRow = 0;
+    }
+    fBlocks.push_back(block);
+    std::fseek(file, long(offset), SEEK_SET);
+  }
+  std::fclose(file);
+
+  fDescriptor = ::open(fileName.c_str(), O_RDONLY);
+  if ( fDescriptor < 0 ) return false;
+
+  ReadHistograms();
+  if ( ! ReadIndex() ) {
+    fIndexRebuilt = true;
+    if ( ! BuildIndex() ) {
+      fEventIDs.clear();
+      fEventRows.clear();
+    }
+  }
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ColumnarReader::ReadHistograms()
+{
+  std::vector<char> name, binning, contents;
+  for ( const auto& block : fBlocks ) {
+    if ( block.header.kind != ColumnarFormat::BlockKind::Histogram ) continue;
+    if ( block.header.chunks.size() != 3
+         || ! ReadChunk(block, 0, name)
+         || ! ReadChunk(block, 1, binning)
+         || ! ReadChunk(block, 2, contents)
+         || contents.size() != block.header.nofRows*sizeof(double) ) continue;
+
+    ColumnarFormat::Histogram histogram;
+    histogram.name.assign(name.begin(), name.end());
+    histogram.binning.resize(binning.size()/sizeof(double));
+    std::memcpy(histogram.binning.data(), binning.data(),
+                histogram.binning.size()*sizeof(double));
+    histogram.contents.resize(block.header.nofRows);
+    std::memcpy(histogram.contents.data(), contents.data(), contents.size());
+    fHistograms.push_back(histogram);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+bool ColumnarReader::ReadIndex()
+{
+  auto nofTables = fSchema.size();
+  bool found = false;
+  std::vector<char> eventIDs, firstRows, nofRows;
+
+  for ( const auto& block : fBlocks ) {
+    if ( block.header.kind != ColumnarFormat::BlockKind::Index ) continue;
+
+    found = true;
+    auto nofEvents = block.header.nofRows;
+    if ( block.header.chunks.size() != 1 + 2*nofTables ) return false;
+    if ( ! ReadChunk(block, 0, eventIDs)
+         || eventIDs.size() != nofEvents*sizeof(std::int32_t) ) return false;
+
+    auto entry = fEventIDs.size();
+    for ( std::uint32_t i=0; i<nofEvents; ++i ) {
+      std::int32_t eventID;
+      std::memcpy(&eventID, eventIDs.data() + 4*i, 4);
+      fEventIDs.push_back(eventID);
+    }
+    fEventRows.resize(fEventIDs.size()*nofTables);
+
+    for ( std::size_t t=0; t<nofTables; ++t ) {
+      if ( ! ReadChunk(block, int(1 + 2*t), firstRows)
+           || firstRows.size() != nofEvents*sizeof(std::uint64_t)
+           || ! ReadChunk(block, int(2 + 2*t), nofRows)
+           || nofRows.size() != nofEvents*sizeof(std::uint32_t) ) return false;
+
+      for ( std::uint32_t i=0; i<nofEvents; ++i ) {
+        std::uint64_t first;
+        std::uint32_t count;
+        std::memcpy(&first, firstRows.data() + 8*i, 8);
+        std::memcpy(&count, nofRows.data() + 4*i, 4);
+        if ( first + count > fNofRows[t] ) return false;
+        fEventRows[(entry + i)*nofTables + t] = { first, count };
+      }
+    }
+  }
+
+  // Rows after the last index block belong to events which were not
+  // completely written (job killed before its next flush)
+  return found || fBlocks.empty();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+bool ColumnarReader::BuildIndex()
+{
+  // The rows of one event are contiguous in each table; the events are
+  // entered in the order of their first appearance
+  auto nofTables = fSchema.size();
+  fEventIDs.clear();
+  fEventRows.clear();
+  std::unordered_map<int, std::size_t> entries;
+
+  for ( std::size_t t=0; t<nofTables; ++t ) {
+    auto columnId = ColumnarFormat::FindColumn(fSchema[t], "eventID");
+    if ( columnId < 0 ) return false;
+
+    auto eventIDs = ReadColumnAsInt(int(t), columnId);
+    if ( eventIDs.size() != fNofRows[t] ) return false;
+
+    for ( std::uint64_t row=0; row<eventIDs.size(); ++row ) {
+      auto found = entries.find(eventIDs[row]);
+      if ( found == entries.end() ) {
+        found = entries.emplace(eventIDs[row], fEventIDs.size()).first;
+        fEventIDs.push_back(eventIDs[row]);
+        fEventRows.resize(fEventIDs.size()*nofTables, RowRange{ 0, 0 });
+      }
+      auto& range = fEventRows[found->second*nofTables + t];
+      if ( range.nofRows == 0 ) {
+        range.firstRow = row;
+      }
+      else if ( range.firstRow + range.nofRows != row ) {
+        return false;
+      }
+      ++range.nofRows;
+    }
+  }
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ColumnarReader::Close()
+{
+  if ( fDescriptor >= 0 ) ::close(fDescriptor);
+  fDescriptor = -1;
+  fFileName.clear();
+  fSchema.clear();
+  fBlocks.clear();
+  fTableBlocks.clear();
+  fNofRows.clear();
+  fTruncated = false;
+  fEventIDs.clear();
+  fEventRows.clear();
+  fIndexRebuilt = false;
+  fHistograms.clear();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+bool ColumnarReader::ReadStored(std::uint64_t offset, std::uint64_t size,
+                                char* data) const
+{
+  std::uint64_t done = 0;
+  while ( done < size ) {
+    auto nofBytes = ::pread(fDescriptor, data + done, size - done, off_t(offset + done));
+    if ( nofBytes <= 0 ) return false;
+    done += std::uint64_t(nofBytes);
+  }
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+bool ColumnarReader::ReadStoredChunk(const Block& block, int columnId,
+                                     std::vector<char>& data) const
+{
+  const auto& chunk = block.header.chunks[columnId];
+  data.resize(chunk.storedSize);
+  return ReadStored(block.offsets[columnId], chunk.storedSize, data.data());
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+bool ColumnarReader::ReadStoredBlock(const Block& block, std::vector<char>& data) const
+{
+  // The payloads follow each other
+  std::uint64_t size = 0;
+  for ( const auto& chunk : block.header.chunks ) size += chunk.storedSize;
+  data.resize(size);
+  if ( size == 0 ) return true;
+  return ReadStored(block.offsets[0], size, data.data());
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+bool ColumnarReader::ReadChunk(const Block& block, int columnId,
+                               std::vector<char>& data) const
+{
+  const auto& chunk = block.header.chunks[columnId];
+  if ( chunk.codec == ColumnarFormat::Codec::None ) {
+    return ReadStoredChunk(block, columnId, data);
+  }
+
+  std::vector<char> stored;
+  if ( ! ReadStoredChunk(block, columnId, stored) ) return false;
+  data.resize(chunk.rawSize);
+  return ColumnarFormat::Decode(chunk, stored.data(), data.data());
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+template <typename T>
+std::vector<T> ColumnarReader::ReadColumn(int tableId, int columnId) const
+{
+  std::vector<T> values;
+  values.reserve(fNofRows[tableId]);
+
+  auto type = fSchema[tableId].columns[columnId].type;
+  std::vector<char> data;
+  for ( const auto& block : fBlocks ) {
+    if ( block.header.kind != ColumnarFormat::BlockKind::Rows ) continue;
+    if ( int(block.header.table) != tableId ) continue;
+    if ( ! ReadChunk(block, columnId, data) ) break;
+    AppendValues(type, data, 0, block.header.nofRows, values);
+  }
+  return values;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+template <typename T>
+std::vector<T> ColumnarReader::ReadRows(int tableId, int columnId, RowRange rows) const
+{
+  std::vector<T> values;
+  values.reserve(rows.nofRows);
+  if ( rows.nofRows == 0 ) return values;
+
+  // First block holding the range
+  const auto& blocks = fTableBlocks[tableId];
+  auto next = std::upper_bound(blocks.begin(), blocks.end(), rows.firstRow,
+    [this](std::uint64_t row, std::size_t index) { return row < fBlocks[index].firstRow; });
+  if ( next == blocks.begin() ) return values;
+
+  auto type = fSchema[tableId].columns[columnId].type;
+  auto lastRow = rows.firstRow + rows.nofRows;
+  std::vector<char> data;
+  for ( auto it = next - 1; it != blocks.end(); ++it ) {
+    const auto& block = fBlocks[*it];
+    if ( block.firstRow >= lastRow ) break;
+    if ( ! ReadChunk(block, columnId, data) ) break;
+
+    auto begin = std::max(rows.firstRow, block.firstRow) - block.firstRow;
+    auto end = std::min(lastRow, block.firstRow + block.header.nofRows) - block.firstRow;
+    AppendValues(type, data, begin, end, values);
+  }
+  return values;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+std::vector<double> ColumnarReader::ReadColumnAsDouble(int tableId, int columnId) const
+{
+  return ReadColumn<double>(tableId, columnId);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+std::vector<int> ColumnarReader::ReadColumnAsInt(int tableId, int columnId) const
+{
+  return ReadColumn<int>(tableId, columnId);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+std::vector<double> ColumnarReader::ReadRowsAsDouble(int tableId, int columnId,
+                                                     RowRange rows) const
+{
+  return ReadRows<double>(tableId, columnId, rows);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+std::vector<int> ColumnarReader::ReadRowsAsInt(int tableId, int columnId,
+                                               RowRange rows) const
+{
+  return ReadRows<int>(tableId, columnId, rows);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+ColumnarDataset::ColumnarDataset()
+ : fNofDuplicateEvents(0)
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+ColumnarDataset::~ColumnarDataset()
+{
+  for ( auto file : fFiles ) delete file;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+bool ColumnarDataset::Open(const std::string& path)
+{
+  const auto& extension = ColumnarFormat::kManifestExtension;
+  if ( path.size() > extension.size() 
+       && path.compare(path.size() - extension.size(), extension.size(), extension) == 0 ) {
+    std::vector<std::string> fileNames;
+    if ( ! ColumnarFormat::ReadManifest(path, fileNames) ) return false;
+    return Open(fileNames);
+  }
+  return Open(std::vector<std::string>(1, path));
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+bool ColumnarDataset::Open(const std::vector<std::string>& fileNames)
+{
+  for ( auto file : fFiles ) delete file;
+  fFiles.clear();
+  fEvents.clear();
+  fNofDuplicateEvents = 0;
+  if ( fileNames.empty() ) return false;
+
+  // Scan the files in parallel
+  std::vector<ColumnarReader*> files(fileNames.size(), nullptr);
+  std::vector<char> opened(fileNames.size(), 0);
+  std::vector<std::thread> threads;
+  for ( std::size_t i=0; i<fileNames.size(); ++i ) {
+    files[i] = new ColumnarReader();
+    threads.emplace_back([&files, &opened, &fileNames, i]() {
+      opened[i] = files[i]->Open(fileNames[i]);
+    });
+  }
+  for ( auto& thread : threads ) thread.join();
+  fFiles = files;
+
+  for ( std::size_t i=0; i<fFiles.size(); ++i ) {
+    if ( ! opened[i] ) return false;
+    if ( ! ColumnarFormat::SameSchema(fFiles[i]->GetSchema(), fFiles[0]->GetSchema()) ) {
+      return false;
+    }
+  }
+
+  // Merge the event indices; an eventID found in several files (e.g. two
+  // runs of the same job) keeps its first location
+  std::size_t nofEvents = 0;
+  for ( auto file : fFiles ) nofEvents += file->GetNumberOfEvents();
+  fEvents.reserve(nofEvents);
+  for ( std::size_t i=0; i<fFiles.size(); ++i ) {
+    for ( std::size_t entry=0; entry<fFiles[i]->GetNumberOfEvents(); ++entry ) {
+      if ( ! fEvents.emplace(fFiles[i]->GetEventID(entry), EventLocation{ i, entry }).second ) {
+        ++fNofDuplicateEvents;
+      }
+    }
+  }
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+const ColumnarFormat::Schema& ColumnarDataset::GetSchema() const
+{
+  return fFiles[0]->GetSchema();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+std::uint64_t ColumnarDataset::GetNumberOfRows(int tableId) const
+{
+  std::uint64_t nofRows = 0;
+  for ( auto file : fFiles ) nofRows += file->GetNumberOfRows(tableId);
+  return nofRows;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+template <typename T>
+std::vector<T> ColumnarDataset::ReadColumn(int tableId, int columnId) const
+{
+  // Each file is read and decoded by its own thread
+  std::vector<std::vector<T>> parts(fFiles.size());
+  std::vector<std::thread> threads;
+  for ( std::size_t i=0; i<fFiles.size(); ++i ) {
+    threads.emplace_back([this, &parts, tableId, columnId, i]() {
+      if ( std::is_same<T, int>::value ) {
+        auto values = fFiles[i]->ReadColumnAsInt(tableId, columnId);
+        parts[i].assign(values.begin(), values.end());
+      }
+      else {
+        auto values = fFiles[i]->ReadColumnAsDouble(tableId, columnId);
+        parts[i].assign(values.begin(), values.end());
+      }
+    });
+  }
+  for ( auto& thread : threads ) thread.join();
+
+  std::vector<T> values;
+  values.reserve(GetNumberOfRows(tableId));
+  for ( const auto& part : parts ) values.insert(values.end(), part.begin(), part.end());
+  return values;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+std::vector<double> ColumnarDataset::ReadColumnAsDouble(int tableId, int columnId) const
+{
+  return ReadColumn<double>(tableId, columnId);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+std::vector<int> ColumnarDataset::ReadColumnAsInt(int tableId, int columnId) const
+{
+  return ReadColumn<int>(tableId, columnId);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+bool ColumnarDataset::GetHistograms(std::vector<ColumnarFormat::Histogram>& histograms) const
+{
+  histograms.clear();
+  for ( auto file : fFiles ) {
+    if ( ! ColumnarFormat::MergeHistograms(histograms, file->GetHistograms()) ) return false;
+  }
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+const ColumnarDataset::EventLocation* ColumnarDataset::FindEvent(int eventID) const
+{
+  auto found = fEvents.find(eventID);
+  return ( found != fEvents.end() ) ? &found->second : nullptr;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+std::vector<int> ColumnarDataset::GetEventIDs() const
+{
+  std::vector<int> eventIDs;
+  eventIDs.reserve(fEvents.size());
+  for ( const auto& event : fEvents ) eventIDs.push_back(event.first);
+  std::sort(eventIDs.begin(), eventIDs.end());
+  return eventIDs;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+std::vector<double> ColumnarDataset::ReadEventAsDouble(int eventID, int tableId,
+                                                       int columnId) const
+{
+  auto location = FindEvent(eventID);
+  if ( ! location ) return std::vector<double>();
+  const auto& file = *fFiles[location->file];
+  return file.ReadRowsAsDouble(tableId, columnId, file.GetEventRows(location->entry, tableId));
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+std::vector<int> ColumnarDataset::ReadEventAsInt(int eventID, int tableId,
+                                                 int columnId) const
+{
+  auto location = FindEvent(eventID);
+  if ( ! location ) return std::vector<int>();
+  const auto& file = *fFiles[location->file];
+  return file.ReadRowsAsInt(tableId, columnId, file.GetEventRows(location->entry, tableId));
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
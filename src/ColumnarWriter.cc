@@ -0,0 +1,278 @@
+/// \file ColumnarWriter.cc
+/// \brief Implementation of the ColumnarWriter class
+
+#include "ColumnarWriter.hh"
+
+#include <cstring>
+#include <stdexcept>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+ColumnarWriter::ColumnarWriter(const ColumnarFormat::Schema& schema)
+ : RowSink(),
+   fSchema(schema),
+   fTables(schema.size()),
+   fFile(nullptr),
+   fCodec(ColumnarFormat::Codec::Zlib),
+   fCompressionLevel(1),
+   fBlockSize(1 << 20),
+   fBytesWritten(0),
+   fNofEventsIndexed(0)
+{
+  for ( std::size_t i=0; i<fSchema.size(); ++i ) {
+    fTables[i].columns.resize(fSchema[i].columns.size());
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+ColumnarWriter::~ColumnarWriter()
+{
+  // A write error was already reported by the owner
+  try {
+    Close();
+  }
+  catch ( const std::exception& ) {}
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+bool ColumnarWriter::Open(const std::string& fileName)
+{
+  Close();
+
+  fFile = std::fopen(fileName.c_str(), "wb");
+  if ( ! fFile ) return false;
+
+  fFileName = fileName;
+  fBytesWritten = 0;
+  for ( auto& table : fTables ) {
+    for ( auto& column : table.columns ) column.clear();
+    table.nofRows = 0;
+    table.nofBytes = 0;
+    table.nofRowsWritten = 0;
+    table.eventFirstRow = 0;
+    table.indexFirstRows.clear();
+    table.indexNofRows.clear();
+  }
+  fIndexEventIDs.clear();
+  fNofEventsIndexed = 0;
+
+  if ( ! ColumnarFormat::WriteFileHeader(fFile, fSchema) ) {
+    std::fclose(fFile);
+    fFile = nullptr;
+    return false;
+  }
+  fBytesWritten = std::uint64_t(std::ftell(fFile));
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ColumnarWriter::Close()
+{
+  if ( ! fFile ) return;
+
+  // The file is closed even if the last rows cannot be written
+  try {
+    Flush();
+  }
+  catch ( const std::exception& ) {
+    std::fclose(fFile);
+    fFile = nullptr;
+    throw;
+  }
+  std::fclose(fFile);
+  fFile = nullptr;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ColumnarWriter::Flush()
+{
+  if ( ! fFile ) return;
+
+  for ( std::size_t i=0; i<fTables.size(); ++i ) {
+    if ( fTables[i].nofRows > 0 ) WriteBlock(int(i));
+  }
+  // The index follows the rows it refers to
+  if ( ! fIndexEventIDs.empty() ) WriteIndexBlock();
+  std::fflush(fFile);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ColumnarWriter::SetCompression(ColumnarFormat::Codec codec, int level)
+{
+  fCodec = codec;
+  fCompressionLevel = level;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ColumnarWriter::SetBlockSize(std::size_t blockSize)
+{
+  fBlockSize = blockSize;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ColumnarWriter::Append(int tableId, int columnId,
+                            const void* value, std::size_t size)
+{
+  auto& buffer = fTables[tableId].columns[columnId];
+  auto offset = buffer.size();
+  buffer.resize(offset + size);
+  std::memcpy(buffer.data() + offset, value, size);
+  fTables[tableId].nofBytes += size;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ColumnarWriter::FillEnergyColumn(int tableId, int columnId, double value)
+{
+  if ( fSchema[tableId].columns[columnId].type == ColumnarFormat::ColumnType::Float32 ) {
+    auto floatValue = float(value);
+    Append(tableId, columnId, &floatValue, sizeof(floatValue));
+  }
+  else {
+    Append(tableId, columnId, &value, sizeof(value));
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ColumnarWriter::FillPositionColumn(int tableId, int columnId, double value)
+{
+  Append(tableId, columnId, &value, sizeof(value));
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ColumnarWriter::FillIntColumn(int tableId, int columnId, int value)
+{
+  auto intValue = std::int32_t(value);
+  Append(tableId, columnId, &intValue, sizeof(intValue));
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ColumnarWriter::AddRow(int tableId)
+{
+  auto& table = fTables[tableId];
+  table.nofRows++;
+
+  // Every column must have been filled exactly once for this row
+  const auto& columns = fSchema[tableId].columns;
+  for ( std::size_t i=0; i<columns.size(); ++i ) {
+    if ( table.columns[i].size() 
+         != table.nofRows * ColumnarFormat::TypeSize(columns[i].type) ) {
+      throw std::runtime_error("ColumnarWriter: column " + columns[i].name
+                               + " of " + fSchema[tableId].name + " not filled");
+    }
+  }
+
+  if ( table.nofBytes >= fBlockSize ) WriteBlock(tableId);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ColumnarWriter::EndEvent(int eventID)
+{
+  // The rows filled since the previous event belong to this one
+  for ( auto& table : fTables ) {
+    auto nofRows = table.nofRowsWritten + table.nofRows;
+    table.indexFirstRows.push_back(table.eventFirstRow);
+    table.indexNofRows.push_back(std::uint32_t(nofRows - table.eventFirstRow));
+    table.eventFirstRow = nofRows;
+  }
+  fIndexEventIDs.push_back(std::int32_t(eventID));
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ColumnarWriter::WriteBlock(int tableId)
+{
+  auto& table = fTables[tableId];
+
+  ColumnarFormat::BlockHeader header;
+  header.kind = ColumnarFormat::BlockKind::Rows;
+  header.table = std::uint32_t(tableId);
+  header.nofRows = table.nofRows;
+  WriteChunks(header, table.columns);
+
+  table.nofRowsWritten += table.nofRows;
+  table.nofRows = 0;
+  table.nofBytes = 0;
+  for ( auto& column : table.columns ) column.clear();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ColumnarWriter::WriteIndexBlock()
+{
+  // One chunk of eventIDs, then the first row and number of rows per table
+  auto nofEvents = fIndexEventIDs.size();
+  std::vector<std::vector<char>> columns;
+  auto addColumn = [&columns](const void* data, std::size_t size) {
+    auto begin = static_cast<const char*>(data);
+    columns.emplace_back(begin, begin + size);
+  };
+  addColumn(fIndexEventIDs.data(), nofEvents*sizeof(std::int32_t));
+  for ( const auto& table : fTables ) {
+    addColumn(table.indexFirstRows.data(), nofEvents*sizeof(std::uint64_t));
+    addColumn(table.indexNofRows.data(), nofEvents*sizeof(std::uint32_t));
+  }
+
+  ColumnarFormat::BlockHeader header;
+  header.kind = ColumnarFormat::BlockKind::Index;
+  header.table = std::uint32_t(fTables.size());
+  header.nofRows = std::uint32_t(nofEvents);
+  WriteChunks(header, columns);
+
+  fNofEventsIndexed += nofEvents;
+  fIndexEventIDs.clear();
+  for ( auto& table : fTables ) {
+    table.indexFirstRows.clear();
+    table.indexNofRows.clear();
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ColumnarWriter::WriteHistogram(const ColumnarFormat::Histogram& histogram)
+{
+  if ( ! fFile ) return;
+
+  auto addColumn = [](std::vector<std::vector<char>>& columns,
+                      const void* data, std::size_t size) {
+    auto begin = static_cast<const char*>(data);
+    columns.emplace_back(begin, begin + size);
+  };
+  std::vector<std::vector<char>> columns;
+  addColumn(columns, histogram.name.data(), histogram.name.size());
+  addColumn(columns, histogram.binning.data(), histogram.binning.size()*sizeof(double));
+  addColumn(columns, histogram.contents.data(), histogram.contents.size()*sizeof(double));
+
+  ColumnarFormat::BlockHeader header;
+  header.kind = ColumnarFormat::BlockKind::Histogram;
+  header.table = 0;
+  header.nofRows = std::uint32_t(histogram.contents.size());
+  WriteChunks(header, columns);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ColumnarWriter::WriteChunks(ColumnarFormat::BlockHeader& header,
+                                 const std::vector<std::vector<char>>& columns)
+{
+  fBlockBuffer.clear();
+  ColumnarFormat::EncodeBlock(header, columns, fCodec, fCompressionLevel, fBlockBuffer);
+  if ( std::fwrite(fBlockBuffer.data(), 1, fBlockBuffer.size(), fFile)
+       != fBlockBuffer.size() ) {
+    throw std::runtime_error("ColumnarWriter: cannot write to " + fFileName);
+  }
+  fBytesWritten = std::uint64_t(std::ftell(fFile));
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,175 @@
+/// \file ContainmentMonitor.cc
+/// \brief Implementation of the ContainmentMonitor class
+
+#include "ContainmentMonitor.hh"
+#include "AnalysisConfig.hh"
+
+#include "G4RunManager.hh"
+#include "G4EventManager.hh"
+#include "G4StackManager.hh"
+#include "G4Step.hh"
+#include "G4Track.hh"
+#include "G4ios.hh"
+
+#include <algorithm>
+#include <limits>
+
+G4ThreadLocal ContainmentMonitor* ContainmentMonitor::fInstance = nullptr;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ContainmentMonitor::Statistics::Merge(const Statistics& other)
+{
+  nofComplete += other.nofComplete;
+  nofStopped += other.nofStopped;
+  completeTime += other.completeTime;
+  stoppedTime += other.stoppedTime;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ContainmentMonitor::Statistics::Print() const
+{
+  auto nofEvents = nofComplete + nofStopped;
+  if ( nofEvents == 0. ) return;
+
+  auto completeMean = ( nofComplete > 0. ) ? completeTime/nofComplete : 0.;
+  G4cout << "---> Containment: " << nofStopped << " of " << nofEvents
+         << " events stopped" << G4endl
+         << "       complete events: " << completeMean*1.e3 << " ms/event";
+  if ( nofStopped > 0. ) {
+    G4cout << ", stopped events: " << stoppedTime/nofStopped*1.e3 << " ms/event";
+  }
+  G4cout << G4endl;
+
+  if ( nofStopped > 0. && nofComplete > 0. ) {
+    // The stopped events would have taken the mean time of the complete ones
+    auto saved = std::max(nofStopped*completeMean - stoppedTime, 0.);
+    auto total = completeTime + stoppedTime;
+    G4cout << "       estimated time saved: " << saved << " s, "
+           << 100.*saved/(total + saved) << "% of the event processing time" << G4endl;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+ContainmentMonitor* ContainmentMonitor::Instance()
+{
+  if ( ! fInstance ) {
+    fInstance = new ContainmentMonitor();
+  }
+  return fInstance;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+ContainmentMonitor::ContainmentMonitor()
+ : fMode(Mode::Off),
+   fTailCut(0.),
+   fEdgeFraction(0.),
+   fMinWeight(1.),
+   fMonitoring(false),
+   fPrimaryEnergy(0.),
+   fEdgeLimit(0.)
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+ContainmentMonitor::~ContainmentMonitor()
+{
+  fInstance = nullptr;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ContainmentMonitor::Configure()
+{
+  auto config = AnalysisConfig::Instance();
+  auto mode = config->GetContainmentMode();
+  fMode = ( mode == "tag" ) ? Mode::Tag : ( mode == "abort" ) ? Mode::Abort : Mode::Off;
+  fTailCut = config->GetContainmentTailFraction();
+  fEdgeFraction = config->GetContainmentEdgeFraction();
+  auto weights = config->GetWeights();
+  fMinWeight = weights.empty() ? 1. : *std::min_element(weights.begin(), weights.end());
+  fStatistics = Statistics();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ContainmentMonitor::BeginEvent(G4double primaryEnergy)
+{
+  // A fraction of 0 disables the limit
+  fPrimaryEnergy = primaryEnergy;
+  fEdgeLimit = ( fEdgeFraction > 0. ) ? fEdgeFraction*primaryEnergy
+                                      : std::numeric_limits<G4double>::max();
+  fRecord = ContainmentRecord();
+  fMonitoring = ( fMode != Mode::Off && primaryEnergy > 0. );
+  fStart = std::chrono::steady_clock::now();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ContainmentMonitor::Add(const G4Step* step, G4double edep, G4double birksEdep,
+                             Signal signal, G4bool tail, G4bool edge)
+{
+  fRecord.edepTotal += edep;
+  if ( edge ) fRecord.edepEdge += edep;
+  if ( signal == Signal::ECal ) fRecord.edepECalActive += birksEdep;
+  if ( signal == Signal::HCal ) {
+    fRecord.edepHCalActive += birksEdep;
+    if ( tail ) fRecord.edepTailCatcher += birksEdep;
+  }
+
+  if ( fRecord.edepEdge >= fEdgeLimit ) {
+    Stop(step);
+    return;
+  }
+
+  // Largest denominator of the cut at the end of the event: the energy
+  // not yet deposited can at most all be active, in the ECal
+  if ( fTailCut <= 0. || fRecord.edepTailCatcher <= 0. ) return;
+  auto remaining = std::max(fPrimaryEnergy - fRecord.edepTotal, 0.);
+  auto maxTotal = fRecord.edepECalActive/fMinWeight + fRecord.edepHCalActive
+                  + remaining*std::max(1., 1./fMinWeight);
+  if ( fRecord.edepTailCatcher >= fTailCut*maxTotal ) {
+    Stop(step);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ContainmentMonitor::Stop(const G4Step* step)
+{
+  fMonitoring = false;
+
+  if ( fMode == Mode::Abort ) {
+    fRecord.status = ContainmentStatus::Aborted;
+    G4RunManager::GetRunManager()->AbortEvent();
+    return;
+  }
+
+  // Kill the current track with its secondaries and all stacked tracks;
+  // the event ends after this step
+  fRecord.status = ContainmentStatus::Tagged;
+  step->GetTrack()->SetTrackStatus(fKillTrackAndSecondaries);
+  G4EventManager::GetEventManager()->GetStackManager()->clear();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ContainmentMonitor::EndEvent()
+{
+  fMonitoring = false;
+  std::chrono::duration<G4double> time = std::chrono::steady_clock::now() - fStart;
+
+  if ( fRecord.status == ContainmentStatus::Contained ) {
+    fStatistics.nofComplete += 1.;
+    fStatistics.completeTime += time.count();
+  }
+  else {
+    fStatistics.nofStopped += 1.;
+    fStatistics.stoppedTime += time.count();
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -4,6 +4,12 @@
 
 #include "DetectorConstruction.hh"
 #include "CalorimeterSD.hh"
+#include "StepFormat.hh"
+#include "RegionConfig.hh"
+#include "FastSimConfig.hh"
+#include "ECalShowerModel.hh"
+#include "ShowerLibraryConfig.hh"
+#include "ShowerLibraryModel.hh"
 #include "G4Material.hh"
 #include "G4NistManager.hh"
 
@@ -12,6 +18,9 @@
 #include "G4LogicalVolume.hh"
 #include "G4PVPlacement.hh"
 #include "G4PVReplica.hh"
+#include "G4Region.hh"
+#include "G4RegionStore.hh"
+#include "G4FastSimulationManager.hh"
 #include "G4GlobalMagFieldMessenger.hh"
 #include "G4AutoDelete.hh"
 
@@ -30,6 +39,11 @@ using namespace GlobalValues;
 
 G4ThreadLocal 
 G4GlobalMagFieldMessenger* DetectorConstruction::fMagFieldMessenger = nullptr; 
+std::vector<G4TwoVector> DetectorConstruction::fECalBlockCenters;
+std::vector<G4TwoVector> DetectorConstruction::fHCalTowerCenters;
+ShowerLibraryFormat::Lattice
+DetectorConstruction::fShowerLibraryLattices[ShowerLibraryFormat::kNofDetectors] = {};
+G4double DetectorConstruction::fECalFiberFraction = 0.;
  //
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
@@ -37,6 +51,11 @@ DetectorConstruction::DetectorConstruction()
  : G4VUserDetectorConstruction(),
    fCheckOverlaps(false)
 {
+  // Create the region, fast simulation and shower library configurations
+  // and their messengers before the macro
+  RegionConfig::Instance();
+  FastSimConfig::Instance();
+  ShowerLibraryConfig::Instance();
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -89,7 +108,7 @@ G4VPhysicalVolume* DetectorConstruction::DefineVolumes()
   // ECal Block Geometry Paramters
   G4double ECal_X = 49.85*mm; // x-dimension of each ECal block
   G4double ECal_Y = 49.30*mm; // y-dimension of each ECal block
-  G4double ECal_Thickness = 170*mm; // z-dimension of each ECal block
+  G4double ECal_Thickness = ECalThickness; // z-dimension of each ECal block
   G4double ECal_Glue_XY = 0.1*mm; // Glue connecting ECal blocks -- see design specs
   G4double Clearance_Gap = 0.1*mm; // Gap between each set of 4 blocks -- see design specs
   G4double ECal_Fiber_r = 0.235*mm; // Radius of each fiber in ECal
@@ -150,6 +169,7 @@ G4VPhysicalVolume* DetectorConstruction::DefineVolumes()
   G4LogicalVolume* HCalLV[NumHCalTowers][NumHCalTowers];
   G4VSolid* HCalS = new G4Box("HCalSolid", 
                               HCal_X/2., HCal_Y/2., HCal_Thickness/2.);
+  fHCalTowerCenters.assign(NumHCalTowers*NumHCalTowers, G4TwoVector());
 
   for(G4int i = 0; i < NumHCalTowers; i++)
   {
@@ -167,6 +187,8 @@ G4VPhysicalVolume* DetectorConstruction::DefineVolumes()
         false, 
         0, 
         fCheckOverlaps);
+      fHCalTowerCenters[i*NumHCalTowers + j]
+        = G4TwoVector((-2.5 + i)*HCal_X, (2.5 - j)*HCal_Y);
     }
   }
                                                      
@@ -370,6 +392,7 @@ G4VPhysicalVolume* DetectorConstruction::DefineVolumes()
     ECal_X/2., 
     ECal_Y/2., 
     ECal_Thickness/2.);
+  fECalBlockCenters.assign(NumECalBlocks*NumECalBlocks, G4TwoVector());
 
   for(G4int i = 0; i < NumECalBlocks; i++)
   {
@@ -395,6 +418,8 @@ G4VPhysicalVolume* DetectorConstruction::DefineVolumes()
         false, 
         0, 
         fCheckOverlaps);
+      fECalBlockCenters[i*NumECalBlocks + j]
+        = G4TwoVector(x0 + i_factor*HCal_X, y0 - j_factor*HCal_Y);
       G4cout<<"ECal block ("<<i<<", "<<j<<") position: "<<"("<<x0 + i_factor*HCal_X<<", "<<y0 - j_factor*HCal_Y<<")"<<G4endl;
 
     }
@@ -553,10 +578,61 @@ G4VPhysicalVolume* DetectorConstruction::DefineVolumes()
         }
       }
       G4cout<<"Number of fibers in ECal block ("<<i<<", "<<j<<"): "<<num_fibers_block<<G4endl;
+      fECalFiberFraction = num_fibers_block*pi*ECal_Fiber_r*ECal_Fiber_r/(ECal_X*ECal_Y);
     }
   }
 
   G4cout<<"Finished Geometry construction."<<G4endl;
+
+  // Periodic structures the shower libraries are aligned to (see
+  // ShowerLibraryFormat::Lattice): the fiber lattice of an ECal block, with
+  // the odd rows shifted by half a spacing, and the layers of an HCal tower
+  auto& ECalLattice = fShowerLibraryLattices[ShowerLibraryFormat::kECal];
+  ECalLattice = ShowerLibraryFormat::Lattice();
+  ECalLattice.a1[0] = 0.95865*mm;
+  ECalLattice.a2[0] = 0.95865*mm/2.;
+  ECalLattice.a2[1] = 0.820*mm;
+  ECalLattice.origin[0] = ECal_X/2. - 0.23966*mm;
+  ECalLattice.origin[1] = ECal_Y/2. - 0.46*mm;
+  ECalLattice.zMin = -ECal_Thickness/2.;
+  ECalLattice.zMax = ECal_Thickness/2.;
+
+  auto& HCalLattice = fShowerLibraryLattices[ShowerLibraryFormat::kHCal];
+  HCalLattice = ShowerLibraryFormat::Lattice();
+  HCalLattice.pitchZ = HCal_LayerThickness;
+  HCalLattice.originZ = ECal_Thickness/2.;
+  HCalLattice.zMin = ECal_Thickness/2.;
+  HCalLattice.zMax = ECal_Thickness/2. + HCal_Thickness;
+
+  // Regions for the production cuts and step limits (see RegionConfig).
+  // The daughters of a root volume belong to its region unless they are
+  // roots themselves; the world is in the default region
+  auto ECalFibersRegion = new G4Region("ECalFibers");
+  auto ECalPowderRegion = new G4Region("ECalPowder");
+  auto HCalAbsorberRegion = new G4Region("HCalAbsorber");
+  auto HCalScintillatorRegion = new G4Region("HCalScintillator");
+  for(G4int i = 0; i < NumECalBlocks; i++)
+  {
+    for(G4int j = 0; j < NumECalBlocks; j++)
+    {
+      ECalFibersRegion->AddRootLogicalVolume(ECal_FiberCladdingLV[i][j]);
+      ECalFibersRegion->AddRootLogicalVolume(ECal_FiberLV[i][j]);
+      ECalPowderRegion->AddRootLogicalVolume(ECalLV[i][j]);
+      if(j < NumECalBlocks/2) ECalPowderRegion->AddRootLogicalVolume(ECal_HorizGlueLV[i][j]);
+      if(i < NumECalBlocks/2 && j < NumECalBlocks/2)
+        ECalPowderRegion->AddRootLogicalVolume(ECal_VertGlueLV[i][j]);
+    }
+  }
+  for(G4int i = 0; i < NumHCalTowers; i++)
+  {
+    for(G4int j = 0; j < NumHCalTowers; j++)
+    {
+      // The towers hold the absorber plates, steel plates and WLS plates
+      HCalAbsorberRegion->AddRootLogicalVolume(HCalLV[i][j]);
+      HCalScintillatorRegion->AddRootLogicalVolume(HCalActiveLV[i][j]);
+    }
+  }
+  RegionConfig::Instance()->Apply();
             
   // Visualization attributes
   G4VisAttributes invis=G4VisAttributes::Invisible;
@@ -622,6 +698,34 @@ G4VPhysicalVolume* DetectorConstruction::DefineVolumes()
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+G4bool DetectorConstruction::FindShowerLibraryNode(G4int detector,
+                                                   const G4ThreeVector& position,
+                                                   G4ThreeVector& node, G4double phase[3])
+{
+  const auto& lattice = fShowerLibraryLattices[detector];
+  if ( position.z() < lattice.zMin || position.z() >= lattice.zMax ) return false;
+
+  // The transverse lattice is the same in all blocks: take the position
+  // relative to the nearest centre
+  const auto& centers = ( detector == ShowerLibraryFormat::kECal )
+                      ? fECalBlockCenters : fHCalTowerCenters;
+  if ( centers.empty() ) return false;
+  G4TwoVector transverse(position.x(), position.y());
+  auto center = centers.front();
+  for ( const auto& candidate : centers ) {
+    if ( (transverse - candidate).mag2() < (transverse - center).mag2() ) center = candidate;
+  }
+
+  G4double point[3] = { (position.x() - center.x())/mm, (position.y() - center.y())/mm,
+                        position.z()/mm };
+  G4double localNode[3];
+  ShowerLibraryFormat::FindNode(lattice, point, localNode, phase);
+  node.set(localNode[0]*mm + center.x(), localNode[1]*mm + center.y(), localNode[2]*mm);
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
 void DetectorConstruction::ConstructSDandField()
 {
   G4SDManager::GetSDMpointer()->SetVerboseLevel(0);
@@ -670,6 +774,13 @@ void DetectorConstruction::ConstructSDandField()
       G4SDManager::GetSDMpointer()->AddNewDetector(HCal_AbsorberSD[i][j]);
       SetSensitiveDetector(DetectorNameHolder, HCal_AbsorberSD[i][j]);
 
+      // Containment zone: the last layers are the tail catcher and the
+      // outer ring of towers is the lateral edge
+      G4bool edge = (i == 0 || i == NumHCalTowers - 1 || j == 0 || j == NumHCalTowers - 1);
+      HCal_ActiveSD[i][j]->SetContainmentZone(NumHCalLayers - NumTailCatcherLayers, edge);
+      HCal_AbsorberSD[i][j]->SetContainmentZone(NumHCalLayers - NumTailCatcherLayers, edge);
+      HCal_ActiveSD[i][j]->SetContainmentSignal(ContainmentMonitor::Signal::HCal);
+
       // Steel plates and WLS plates 
       if(i != NumHCalTowers - 1) // WLS plates aren't in rightmost column of towers
       {
@@ -708,6 +819,8 @@ void DetectorConstruction::ConstructSDandField()
       ECal_FiberSD[i][j] = new CalorimeterSD(SDNameHolder, HitsNameHolder, 1);
       G4SDManager::GetSDMpointer()->AddNewDetector(ECal_FiberSD[i][j]);
       SetSensitiveDetector(DetectorNameHolder, ECal_FiberSD[i][j]);
+      ECal_FiberSD[i][j]->SetStepVolume(StepFormat::VolumeCode(i, j, false));
+      ECal_FiberSD[i][j]->SetContainmentSignal(ContainmentMonitor::Signal::ECal);
 
       // Tungsten powder and fiber cladding
       sprintf(SDNameHolder, "ECal_AbsorberSD%d%d", i, j);
@@ -717,6 +830,7 @@ void DetectorConstruction::ConstructSDandField()
       ECal_AbsorberSD[i][j] = new CalorimeterSD(SDNameHolder, HitsNameHolder, 1);
       G4SDManager::GetSDMpointer()->AddNewDetector(ECal_AbsorberSD[i][j]);
       SetSensitiveDetector(DetectorNameHolder, ECal_AbsorberSD[i][j]);
+      ECal_AbsorberSD[i][j]->SetStepVolume(StepFormat::VolumeCode(i, j, true));
 
       sprintf(DetectorNameHolder, "ECal_FiberCladdingLogical%d%d", i, j);
       SetSensitiveDetector(DetectorNameHolder, ECal_AbsorberSD[i][j]);    
@@ -735,6 +849,37 @@ void DetectorConstruction::ConstructSDandField()
     }
   }
 
+  // EM shower parameterisation, attached to the ECal powder and fiber
+  // regions; it is triggered according to FastSimConfig
+  auto regionStore = G4RegionStore::GetInstance();
+  auto ECalShower = new ECalShowerModel("ECalShowerModel", regionStore->GetRegion("ECalPowder"));
+  auto ECalFibersRegion = regionStore->GetRegion("ECalFibers");
+  auto ECalFibersManager = ECalFibersRegion->GetFastSimulationManager();
+  if ( ! ECalFibersManager ) ECalFibersManager = new G4FastSimulationManager(ECalFibersRegion);
+  ECalFibersManager->AddFastSimulationModel(ECalShower);
+  ECalShower->SetMaterials(G4Material::GetMaterial("ECalAbsorberMaterial"),
+                           G4Material::GetMaterial("G4_POLYSTYRENE"),
+                           fECalFiberFraction);
+  G4AutoDelete::Register(ECalShower);
+
+  // Frozen shower libraries of the ECal and HCal, attached to the regions of
+  // each detector after the parameterisation; they are triggered according
+  // to FastSimConfig and ShowerLibraryConfig
+  auto ECalLibrary = new ShowerLibraryModel("ECalShowerLibrary", ShowerLibraryFormat::kECal,
+                                            regionStore->GetRegion("ECalPowder"));
+  ECalFibersManager->AddFastSimulationModel(ECalLibrary);
+  G4AutoDelete::Register(ECalLibrary);
+
+  auto HCalLibrary = new ShowerLibraryModel("HCalShowerLibrary", ShowerLibraryFormat::kHCal,
+                                            regionStore->GetRegion("HCalAbsorber"));
+  auto HCalScintillatorRegion = regionStore->GetRegion("HCalScintillator");
+  auto HCalScintillatorManager = HCalScintillatorRegion->GetFastSimulationManager();
+  if ( ! HCalScintillatorManager ) {
+    HCalScintillatorManager = new G4FastSimulationManager(HCalScintillatorRegion);
+  }
+  HCalScintillatorManager->AddFastSimulationModel(HCalLibrary);
+  G4AutoDelete::Register(HCalLibrary);
+
   // Magnetic field
   //
   // Create global magnetic field messenger.
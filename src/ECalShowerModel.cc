@@ -0,0 +1,198 @@
+/// \file ECalShowerModel.cc
+/// \brief Implementation of the ECalShowerModel class
+
+#include "ECalShowerModel.hh"
+#include "FastSimConfig.hh"
+
+#include "G4Electron.hh"
+#include "G4Positron.hh"
+#include "G4Gamma.hh"
+#include "G4Material.hh"
+#include "G4EventManager.hh"
+#include "G4Event.hh"
+#include "G4Track.hh"
+#include "G4LogicalVolume.hh"
+#include "G4PhysicalConstants.hh"
+#include "G4SystemOfUnits.hh"
+#include "Randomize.hh"
+
+#include <cmath>
+
+ECalShowerModel::ECalShowerModel(const G4String& name, G4Region* envelope)
+ : G4VFastSimulationModel(name, envelope),
+   fDensity(0.),
+   fRadiationLength(0.),
+   fMoliereRadius(0.),
+   fCriticalEnergy(0.),
+   fZ(0.),
+   fEventID(-1),
+   fFastEvent(false),
+   fMinEnergy(0.),
+   fSpotEnergy(0.),
+   fActiveScale(1.),
+   fDepositor()
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+ECalShowerModel::~ECalShowerModel()
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ECalShowerModel::SetMaterials(const G4Material* absorber, const G4Material* fibers,
+                                   G4double fiberFraction)
+{
+  // Mass fractions of the two materials in the ECal
+  const G4Material* materials[2] = { absorber, fibers };
+  G4double masses[2] = { (1. - fiberFraction)*absorber->GetDensity(),
+                         fiberFraction*fibers->GetDensity() };
+  fDensity = masses[0] + masses[1];
+
+  // Radiation length additive in mass thickness, Z averaged by mass
+  G4double inverseX0 = 0.;
+  fZ = 0.;
+  for ( G4int m=0; m<2; ++m ) {
+    auto fraction = masses[m]/fDensity;
+    inverseX0 += fraction/(materials[m]->GetRadlen()*materials[m]->GetDensity());
+    const auto elements = materials[m]->GetElementVector();
+    const auto elementFractions = materials[m]->GetFractionVector();
+    for ( std::size_t e=0; e<elements->size(); ++e ) {
+      fZ += fraction*elementFractions[e]*(*elements)[e]->GetZ();
+    }
+  }
+  fRadiationLength = 1./(inverseX0*fDensity);
+  fCriticalEnergy = 610.*MeV/(fZ + 1.24);
+  fMoliereRadius = 21.2052*MeV*fRadiationLength/fCriticalEnergy;
+
+  G4cout << "---> ECal shower model: X0 " << fRadiationLength/mm << " mm, R_M "
+         << fMoliereRadius/mm << " mm, E_c " << fCriticalEnergy/MeV << " MeV, Z "
+         << fZ << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool ECalShowerModel::IsApplicable(const G4ParticleDefinition& particle)
+{
+  return &particle == G4Electron::ElectronDefinition()
+      || &particle == G4Positron::PositronDefinition()
+      || &particle == G4Gamma::GammaDefinition();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double ECalShowerModel::GetShowerEnergy(const G4Track& track) const
+{
+  // A positron also deposits the energy of its annihilation
+  auto energy = track.GetKineticEnergy();
+  if ( track.GetDefinition() == G4Positron::PositronDefinition() ) {
+    energy += 2.*electron_mass_c2;
+  }
+  return energy;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool ECalShowerModel::ModelTrigger(const G4FastTrack& fastTrack)
+{
+  // The settings are taken once per event
+  auto eventID = G4EventManager::GetEventManager()->GetConstCurrentEvent()->GetEventID();
+  if ( eventID != fEventID ) {
+    auto config = FastSimConfig::Instance();
+    fEventID = eventID;
+    fFastEvent = config->IsFastEvent(eventID) && fRadiationLength > 0.;
+    fMinEnergy = config->GetMinEnergy();
+    fSpotEnergy = config->GetSpotEnergy();
+    fActiveScale = config->GetActiveScale();
+  }
+  return fFastEvent && GetShowerEnergy(*fastTrack.GetPrimaryTrack()) >= fMinEnergy;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ECalShowerModel::DoIt(const G4FastTrack& fastTrack, G4FastStep& fastStep)
+{
+  auto track = fastTrack.GetPrimaryTrack();
+  auto energy = GetShowerEnergy(*track);
+  fastStep.KillPrimaryTrack();
+  fastStep.ProposePrimaryTrackPathLength(0.);
+  fDepositor.BeginShower(track);
+
+  // Longitudinal profile: depth of the maximum and shape, with the
+  // correlated fluctuations of their logarithms
+  auto lnY = std::log(energy/fCriticalEnergy);
+  auto meanT = std::max(lnY - 0.858, 0.5);
+  auto meanAlpha = std::max(0.21 + (0.492 + 2.38/fZ)*lnY, 1.1);
+  auto lnT = std::log(meanT);
+  auto lnAlpha = std::log(meanAlpha);
+  auto sigmaLnT = -1.4 + 1.26*lnY;
+  auto sigmaLnAlpha = -0.58 + 0.86*lnY;
+  if ( sigmaLnT > 0. && sigmaLnAlpha > 0. ) {
+    auto rho = 0.705 - 0.023*lnY;
+    auto z1 = G4RandGauss::shoot();
+    auto z2 = G4RandGauss::shoot();
+    lnT += z1/sigmaLnT;
+    lnAlpha += (rho*z1 + std::sqrt(1. - rho*rho)*z2)/sigmaLnAlpha;
+  }
+  auto tmax = std::exp(lnT);
+  auto alpha = std::max(std::exp(lnAlpha), 1.1);
+  auto beta = (alpha - 1.)/tmax;
+
+  // Lateral profile parameters
+  auto lnE = std::log(energy/GeV);
+  auto z1 = 0.0251 + 0.00319*lnE;
+  auto z2 = 0.1162 - 0.000381*fZ;
+  auto k1 = 0.659 - 0.00309*fZ;
+  auto k2 = 0.645;
+  auto k3 = -2.59;
+  auto k4 = 0.3585 + 0.0421*lnE;
+  auto p1 = 0.2632 + 0.00114*fZ;
+  auto p2 = 0.401 + 0.00187*fZ;
+  auto p3 = 1.313 - 0.0686*lnE;
+
+  // Shower axis and transverse directions
+  auto origin = track->GetPosition();
+  auto direction = track->GetMomentumDirection();
+  auto u = direction.orthogonal().unit();
+  auto v = direction.cross(u);
+  if ( track->GetDefinition() == G4Gamma::GammaDefinition() ) {
+    origin += direction*G4RandExponential::shoot(9./7.)*fRadiationLength;
+  }
+
+  auto nofSpots = std::max(G4int(std::ceil(energy/fSpotEnergy)), 1);
+  auto spotEnergy = energy/nofSpots;
+  for ( G4int i=0; i<nofSpots; ++i ) {
+    auto t = G4RandGamma::shoot(alpha, beta);
+    auto tau = t/tmax;
+    auto core = z1 + z2*tau;
+    auto tail = k1*(std::exp(k3*(tau - k2)) + std::exp(k4*(tau - k2)));
+    auto x = (p2 - tau)/p3;
+    auto p = std::min(p1*std::exp(x - std::exp(x)), 1.);
+
+    // Radial density 2 r R^2/(r^2 + R^2)^2 of the core or tail
+    auto radius = ( G4UniformRand() < p ) ? core : tail;
+    auto w = std::min(G4UniformRand(), 0.9999);
+    auto r = radius*std::sqrt(w/(1. - w))*fMoliereRadius;
+    auto phi = twopi*G4UniformRand();
+
+    auto position = origin + direction*t*fRadiationLength
+                  + r*(std::cos(phi)*u + std::sin(phi)*v);
+    Deposit(position, spotEnergy);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ECalShowerModel::Deposit(const G4ThreeVector& position, G4double energy)
+{
+  auto logicalVolume = fDepositor.Locate(position);
+  if ( ! logicalVolume ) return;
+
+  // Energy density following the mass density
+  auto material = logicalVolume->GetMaterial();
+  auto edep = energy*material->GetDensity()/fDensity;
+  if ( material->GetIonisation()->GetBirksConstant() > 0. ) edep *= fActiveScale;
+  fDepositor.Deposit(edep);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,116 @@
+/// \file EmPhysics.cc
+/// \brief Implementation of the EmPhysics class
+
+#include "EmPhysics.hh"
+#include "PhysicsConfig.hh"
+
+#include "G4EmStandardPhysics.hh"
+#include "G4EmStandardPhysics_option1.hh"
+#include "G4EmStandardPhysics_option2.hh"
+#include "G4EmStandardPhysics_option3.hh"
+#include "G4EmStandardPhysics_option4.hh"
+#include "G4EmLivermorePhysics.hh"
+#include "G4EmPenelopePhysics.hh"
+#include "G4BuilderType.hh"
+#include "G4EmParameters.hh"
+#include "G4RegionStore.hh"
+#include "G4Threading.hh"
+#include "G4Version.hh"
+
+#include <algorithm>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EmPhysics::EmPhysics(const G4String& option, G4int verbose)
+ : G4VPhysicsConstructor("EmPhysics_" + option, bElectromagnetic),
+   fEmPhysics(nullptr)
+{
+  // Create the physics options and their messenger
+  // (the physics list is built on the master)
+  PhysicsConfig::Instance();
+
+  if      ( option == "opt1" ) fEmPhysics = new G4EmStandardPhysics_option1(verbose);
+  else if ( option == "opt2" ) fEmPhysics = new G4EmStandardPhysics_option2(verbose);
+  else if ( option == "opt3" ) fEmPhysics = new G4EmStandardPhysics_option3(verbose);
+  else if ( option == "opt4" ) fEmPhysics = new G4EmStandardPhysics_option4(verbose);
+  else if ( option == "liv" )  fEmPhysics = new G4EmLivermorePhysics(verbose);
+  else if ( option == "pen" )  fEmPhysics = new G4EmPenelopePhysics(verbose);
+  else {
+    if ( option != "opt0" ) {
+      G4ExceptionDescription msg;
+      msg << "Unknown EM option " << option << "; opt0 is used";
+      G4Exception("EmPhysics::EmPhysics()",
+        "MyCode0013", JustWarning, msg);
+    }
+    fEmPhysics = new G4EmStandardPhysics(verbose);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EmPhysics::~EmPhysics()
+{
+  delete fEmPhysics;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+const std::vector<G4String>& EmPhysics::GetOptions()
+{
+  static const std::vector<G4String> options
+    = { "opt0", "opt1", "opt2", "opt3", "opt4", "liv", "pen" };
+  return options;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool EmPhysics::IsOption(const G4String& option)
+{
+  const auto& options = GetOptions();
+  return std::find(options.begin(), options.end(), option) != options.end();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EmPhysics::ConstructParticle()
+{
+  fEmPhysics->ConstructParticle();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EmPhysics::ConstructProcess()
+{
+  // The parameters are locked on the workers
+  if ( G4Threading::IsMasterThread() ) {
+    auto config = PhysicsConfig::Instance();
+    auto parameters = G4EmParameters::Instance();
+    if ( config->IsGammaGeneralProcess() ) {
+      parameters->SetGeneralProcessActive(true);
+    }
+
+    const auto& region = config->GetWoodcockRegion();
+    if ( ! region.empty() ) {
+      // The geometry and its regions are constructed before the physics
+      if ( ! G4RegionStore::GetInstance()->GetRegion(region, false) ) {
+        G4ExceptionDescription msg;
+        msg << "Unknown region " << region << "; no Woodcock tracking";
+        G4Exception("EmPhysics::ConstructProcess()",
+          "MyCode0013", JustWarning, msg);
+      }
+      else {
+#if G4VERSION_NUMBER >= 1120
+        parameters->SetWoodcockActiveRegion(region);
+#else
+        G4Exception("EmPhysics::ConstructProcess()",
+          "MyCode0013", JustWarning,
+          "Woodcock tracking needs Geant4 11.2 or later; only the gamma general process is used");
+#endif
+      }
+    }
+  }
+
+  fEmPhysics->ConstructProcess();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -1,24 +1,55 @@
-
 /// \file EventAction.cc
 /// \brief Implementation of the EventAction class
 
 #include "EventAction.hh"
+#include "RunAction.hh"
+#include "OutputConfig.hh"
+#include "AnalysisConfig.hh"
+#include "AsyncWriter.hh"
 #include "CalorimeterSD.hh"
+#include "StepRecorder.hh"
+#include "ContainmentMonitor.hh"
+#include "SpotDepositor.hh"
+#include "ShowerLibraryBuilder.hh"
+#include "StackingAction.hh"
+#include "RandomConfig.hh"
 #include "CalorHit.hh"
-#include "Analysis.hh"
 #include "G4RunManager.hh"
 #include "G4Event.hh"
 #include "G4SDManager.hh"
 #include "G4HCofThisEvent.hh"
 #include "G4UnitsTable.hh"
+#include "G4PrimaryVertex.hh"
+#include "G4PrimaryParticle.hh"
+#include "G4SystemOfUnits.hh"
 #include "GlobalValues.hh"
 
 using namespace GlobalValues;
 
+namespace
+{
+  // Add the deposits of an active and an absorber hit to a cell record
+  void AddHits(CellRecord& cell, const CalorHit* activeHit, const CalorHit* absorberHit)
+  {
+    if ( activeHit ) {
+      cell.edepActive    += activeHit->GetEdep();
+      cell.edepPi0Active += activeHit->GetEdepPi0();
+      cell.numPi0Active  += activeHit->GetNumPi0();
+    }
+    if ( absorberHit ) {
+      cell.edepAbsorber    += absorberHit->GetEdep();
+      cell.edepPi0Absorber += absorberHit->GetEdepPi0();
+      cell.numPi0Absorber  += absorberHit->GetNumPi0();
+    }
+  }
+}
+
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
-EventAction::EventAction()
- : G4UserEventAction()
+EventAction::EventAction(RunAction* runAction)
+ : G4UserEventAction(),
+   fRunAction(runAction),
+   fRecord()
 {}
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -48,6 +79,16 @@ EventAction::GetHitsCollection(G4int hcID,
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
+CalorHitsCollection* 
+EventAction::GetHitsCollection(const char* hcName,
+                                  const G4Event* event) const
+{
+  auto hcID = G4SDManager::GetSDMpointer()->GetCollectionID(hcName);
+  return GetHitsCollection(hcID, event);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
 void EventAction::PrintEventStatistics(
                               G4double ECalEdep, G4double HCalEdep) const
 {
@@ -63,186 +104,180 @@ void EventAction::PrintEventStatistics(
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
-void EventAction::BeginOfEventAction(const G4Event* /*event*/)
+void EventAction::BeginOfEventAction(const G4Event* event)
 {
+  // Pi0 are collected by the sensitive detectors during the event
+  CalorimeterSD::GetPi0Records().clear();
+  SpotDepositor::GetNumberOfShowers() = 0;
+
+  // Decide whether the steps of this event are recorded
+  StepRecorder::Instance()->BeginEvent(event->GetEventID());
+  // and whether it is a shower of the library being generated
+  ShowerLibraryBuilder::Instance()->BeginEvent(event);
+
+  // Bound of the energy the event can deposit for the containment monitor;
+  // the total energy, as a captured or annihilating primary deposits more
+  // than its kinetic energy
+  G4double primaryEnergy = 0.;
+  for ( G4int i=0; i<event->GetNumberOfPrimaryVertex(); ++i ) {
+    auto vertex = event->GetPrimaryVertex(i);
+    for ( G4int j=0; j<vertex->GetNumberOfParticle(); ++j ) {
+      primaryEnergy += vertex->GetPrimary(j)->GetTotalEnergy();
+    }
+  }
+  ContainmentMonitor::Instance()->BeginEvent(primaryEnergy);
+
+  fEventStart = std::chrono::steady_clock::now();
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
-void EventAction::EndOfEventAction(const G4Event* event)
-{  
-  auto eventID = event->GetEventID();
-
-  char nameHolder[200];
-  // get analysis manager
-  auto analysisManager = G4AnalysisManager::Instance();
+void EventAction::FillEventRecord(const G4Event* event)
+{
+  fRecord.Reset(event->GetEventID());
+
+  // Primary particle, used as label of the event
+  auto vertex = event->GetPrimaryVertex(0);
+  if ( vertex && vertex->GetPrimary(0) ) {
+    auto primary = vertex->GetPrimary(0);
+    auto direction = primary->GetMomentumDirection();
+    fRecord.primary.pdg    = primary->GetPDGcode();
+    fRecord.primary.energy = primary->GetKineticEnergy();
+    fRecord.primary.posX   = vertex->GetX0()/cm;
+    fRecord.primary.posY   = vertex->GetY0()/cm;
+    fRecord.primary.posZ   = ( vertex->GetZ0() + ECalThickness/2. )/cm;
+    fRecord.primary.dirX   = direction.x();
+    fRecord.primary.dirY   = direction.y();
+    fRecord.primary.dirZ   = direction.z();
+  }
 
-  // Getting and reading out HCal event data
+  // Seeds of the event, which replay it with the same run seed
+  auto randomConfig = RandomConfig::Instance();
+  if ( randomConfig->IsEventSeeding() ) {
+    long seeds[2];
+    RandomConfig::GetEventSeeds(randomConfig->GetSeed(), event->GetEventID(), seeds);
+    fRecord.eventSeeds[0] = G4int(seeds[0]);
+    fRecord.eventSeeds[1] = G4int(seeds[1]);
+  }
 
-  G4double hcal_active_edep = 0.; // Total Edep in HCal scintillators
-  G4double hcal_active_edepPi0 = 0.; // Total Edep from pi0 in HCal scint.
-  G4int hcal_active_num_Pi0 = 0; // Number of pi0 in HCal scint.
+  // Only the containment record of the aborted events is written
+  fRecord.containment = ContainmentMonitor::Instance()->GetRecord();
+  if ( fRecord.containment.status == ContainmentStatus::Aborted ) return;
 
-  G4double hcal_absorber_edep = 0.; // Total Edep in HCal absorbers (including WLS plates and steel plates)
-  G4double hcal_absorber_edepPi0 = 0.; // Total Edep from pi0 in HCal absorbers
-  G4int hcal_absorber_num_Pi0 = 0; // Number of pi0 in HCal absorbers
+  char nameHolder[200];
 
   // Getting HCal information.
-
+  // entries()-1 kept track of information for whole tower segmentation
   for(G4int i = 0; i < NumHCalTowers; i++)
   {
     for(G4int j = 0; j < NumHCalTowers; j++)
     {
-      G4double hcal_active_tower_edep = 0.;
-      G4double hcal_active_tower_edepPi0 = 0.;
-      G4double hcal_absorber_tower_edep = 0.;
-      G4double hcal_absorber_tower_edepPi0 = 0.;
-      G4int layer_tracker = 0; // Tracks which layer the tiles are in
-      G4int hcal_active_tower_numPi0 = 0;
-      G4int hcal_absorber_tower_numPi0 = 0;
-
-      // Getting scintillator info
+      // Scintillating tiles
       sprintf(nameHolder, "HCal_ActiveHitsCollection%d%d", i, j);
-      G4int HCal_ActiveHCID = G4SDManager::GetSDMpointer()->GetCollectionID(nameHolder);
-      auto HCal_ActiveHC = GetHitsCollection(HCal_ActiveHCID, event);
-      auto HCal_ActiveHit = (*HCal_ActiveHC)[HCal_ActiveHC->entries()-1]; // entries()-1 kept track of information for whole tower segmentation
-      hcal_active_edep += HCal_ActiveHit->GetEdep();
-      hcal_active_edepPi0 += HCal_ActiveHit->GetEdepPi0();
-      hcal_active_num_Pi0 += HCal_ActiveHit->GetNumPi0();
-      hcal_active_tower_edep += HCal_ActiveHit->GetEdep();
-      hcal_active_tower_edepPi0 += HCal_ActiveHit->GetEdepPi0();
-      hcal_active_tower_numPi0 += HCal_ActiveHit->GetNumPi0();
-      
-      // Getting absorber info (just absorbers in towers here)
+      auto HCal_ActiveHC = GetHitsCollection(nameHolder, event);
+
+      // Absorbers (just absorbers in towers here)
       sprintf(nameHolder, "HCal_AbsorberHitsCollection%d%d", i, j);
-      G4int HCal_AbsorberHCID = G4SDManager::GetSDMpointer()->GetCollectionID(nameHolder);
-      auto HCal_AbsorberHC = GetHitsCollection(HCal_AbsorberHCID, event);
-      auto HCal_AbsorberHit = (*HCal_AbsorberHC)[HCal_AbsorberHC->entries()-1]; // entries()-1 kept track of information for whole tower segmentation
-      hcal_absorber_edep += HCal_AbsorberHit->GetEdep();
-      hcal_absorber_edepPi0 += HCal_AbsorberHit->GetEdepPi0();
-      hcal_absorber_num_Pi0 += HCal_AbsorberHit->GetNumPi0();
-      hcal_absorber_tower_edep += HCal_AbsorberHit->GetEdep();
-      hcal_absorber_tower_edepPi0 += HCal_AbsorberHit->GetEdepPi0();
-      hcal_absorber_tower_numPi0 += HCal_AbsorberHit->GetNumPi0();
-
-      // Looping over HCal layers. Getting individual tile information
+      auto HCal_AbsorberHC = GetHitsCollection(nameHolder, event);
+
+      AddHits(fRecord.HCalTower(i, j), 
+              (*HCal_ActiveHC)[HCal_ActiveHC->entries()-1],
+              (*HCal_AbsorberHC)[HCal_AbsorberHC->entries()-1]);
+
+      // Individual tile information. Tile is each of scintillating plates 
+      // in the HCal towers, with the absorber in front of it
       for(G4int k = 0; k < NumHCalLayers; k++)
-      { 
-        // Ntuple with id 3 holds HCal tile information
-        auto HCal_ActiveTileHit = (*HCal_ActiveHC)[k]; // Tile is each of scintillating plates in the HCal towers
-        auto HCal_AbsorberTileHit = (*HCal_AbsorberHC)[k]; // Individual absorber in the HCal towers
-
-        analysisManager->FillNtupleDColumn(3, 0,  HCal_ActiveTileHit->GetEdep());
-        analysisManager->FillNtupleDColumn(3, 1,  HCal_ActiveTileHit->GetEdepPi0());
-        analysisManager->FillNtupleDColumn(3, 2,  HCal_AbsorberTileHit->GetEdep());
-        analysisManager->FillNtupleDColumn(3, 3,  HCal_AbsorberTileHit->GetEdepPi0());
-        analysisManager->FillNtupleIColumn(3, 4, layer_tracker);
-        analysisManager->FillNtupleIColumn(3, 5,  HCal_ActiveTileHit->GetNumPi0()); 
-        analysisManager->FillNtupleIColumn(3, 6,  HCal_AbsorberTileHit->GetNumPi0()); 
-        analysisManager->FillNtupleIColumn(3, 7, i);
-        analysisManager->FillNtupleIColumn(3, 8, j);
-        analysisManager->FillNtupleIColumn(3, 9, eventID);
-        analysisManager->AddNtupleRow(3);
-        layer_tracker++;
+      {
+        AddHits(fRecord.HCalTile(i, j, k), (*HCal_ActiveHC)[k], (*HCal_AbsorberHC)[k]);
       }
-      
-      // Ntuple with id 2 holds HCal tower information
-      analysisManager->FillNtupleDColumn(2, 0, hcal_active_tower_edep);
-      analysisManager->FillNtupleDColumn(2, 1, hcal_active_tower_edepPi0);
-      analysisManager->FillNtupleDColumn(2, 2, hcal_absorber_tower_edep);
-      analysisManager->FillNtupleDColumn(2, 3, hcal_absorber_tower_edepPi0);
-      analysisManager->FillNtupleIColumn(2, 4, i);
-      analysisManager->FillNtupleIColumn(2, 5, j);
-      analysisManager->FillNtupleIColumn(2, 6, hcal_active_tower_numPi0); 
-      analysisManager->FillNtupleIColumn(2, 7, hcal_absorber_tower_numPi0); 
-      analysisManager->FillNtupleIColumn(2, 8, eventID);
-      analysisManager->AddNtupleRow(2);
+
+      AddHits(fRecord.hcalTotal, 
+              (*HCal_ActiveHC)[HCal_ActiveHC->entries()-1],
+              (*HCal_AbsorberHC)[HCal_AbsorberHC->entries()-1]);
     }
   }
   // Info from the steel plates and WLS plates in the HCal
   // Combining this info with absorber info (i.e. non-scintillating materials)
-  G4int HCal_PlatesHCID = G4SDManager::GetSDMpointer()->GetCollectionID("HCal_PlatesHitCollection");
-  auto HCal_PlatesHC = GetHitsCollection(HCal_PlatesHCID, event);
-  auto HCal_PlatesHit = (*HCal_PlatesHC)[HCal_PlatesHC->entries()-1]; // entries()-1 kept track of information for whole tower segmentation
-  hcal_absorber_edep += HCal_PlatesHit->GetEdep();
-  hcal_absorber_edepPi0 += HCal_PlatesHit->GetEdepPi0();
-  hcal_absorber_num_Pi0 += HCal_PlatesHit->GetNumPi0();
-
-
-  // Getting and reading out ECal event data
-
-  G4double ecal_fiber_active_edep = 0.; // Total Edep for ECal fiber cores
-  G4double ecal_fiber_active_edepPi0 = 0.; // Total pi0 edep for ECal fiber cores
-  G4int ecal_fiber_active_num_Pi0 = 0; // Total number pi0 hits for ECal fiber cores
-
-  G4double ecal_absorber_edep = 0.; // Total Edep for ECal Absorber (including cladding & glue)
-  G4double ecal_absorber_edepPi0 = 0.; // Total pi0 edep for ECal absorber
-  G4int ecal_absorber_num_Pi0 = 0; // Total number pi0 hits for ECal fiber cores
+  auto HCal_PlatesHC = GetHitsCollection("HCal_PlatesHitCollection", event);
+  AddHits(fRecord.hcalTotal, nullptr, (*HCal_PlatesHC)[HCal_PlatesHC->entries()-1]);
 
+  // Getting ECal information.
+  // entries()-1 kept track of information for whole block
   for(G4int i = 0; i < NumECalBlocks; i++)
   {
     for(G4int j = 0; j < NumECalBlocks; j++)
     {
-      // Fiber core info
+      // Fiber cores
       sprintf(nameHolder, "ECal_FiberHitsCollection%d%d", i, j);
-      G4int ECal_FiberHCID = G4SDManager::GetSDMpointer()->GetCollectionID(nameHolder);
-      auto ECal_FiberHC = GetHitsCollection(ECal_FiberHCID, event);
-      auto ECal_FiberHit = (*ECal_FiberHC)[ECal_FiberHC->entries()-1]; // entries()-1 kept track of information for whole block
-      ecal_fiber_active_edep += ECal_FiberHit->GetEdep();
-      ecal_fiber_active_edepPi0 += ECal_FiberHit->GetEdepPi0();
-      ecal_fiber_active_num_Pi0 += ECal_FiberHit->GetNumPi0();
-
-      // Absorber info (only tungsten powder and cladding here)
+      auto ECal_FiberHC = GetHitsCollection(nameHolder, event);
+
+      // Absorber (only tungsten powder and cladding here)
       sprintf(nameHolder, "ECal_AbsorberHitsCollection%d%d", i, j);
-      G4int ECal_AbsHCID = G4SDManager::GetSDMpointer()->GetCollectionID(nameHolder);
-      auto ECal_AbsHC = GetHitsCollection(ECal_AbsHCID, event);
-      auto ECal_AbsHit = (*ECal_AbsHC)[ECal_AbsHC->entries()-1]; // entries()-1 kept track of information for whole block
-      ecal_absorber_edep += ECal_AbsHit->GetEdep();
-      ecal_absorber_edepPi0 += ECal_AbsHit->GetEdepPi0();
-      ecal_absorber_num_Pi0 += ECal_AbsHit->GetNumPi0();
-
-      // Ntuple with id 1 holds ECal information
-      analysisManager->FillNtupleDColumn(1, 0, ECal_FiberHit->GetEdep());
-      analysisManager->FillNtupleDColumn(1, 1, ECal_FiberHit->GetEdepPi0());
-      analysisManager->FillNtupleDColumn(1, 2, ECal_AbsHit->GetEdep());
-      analysisManager->FillNtupleDColumn(1, 3, ECal_AbsHit->GetEdepPi0());
-      analysisManager->FillNtupleIColumn(1, 4, ECal_FiberHit->GetNumPi0());
-      analysisManager->FillNtupleIColumn(1, 5, ECal_AbsHit->GetNumPi0());
-      analysisManager->FillNtupleIColumn(1, 6, i);
-      analysisManager->FillNtupleIColumn(1, 7, j);
-      analysisManager->FillNtupleIColumn(1, 8, eventID);
-      analysisManager->AddNtupleRow(1);
+      auto ECal_AbsHC = GetHitsCollection(nameHolder, event);
+
+      auto ECal_FiberHit = (*ECal_FiberHC)[ECal_FiberHC->entries()-1];
+      auto ECal_AbsHit = (*ECal_AbsHC)[ECal_AbsHC->entries()-1];
+      AddHits(fRecord.ECalBlock(i, j), ECal_FiberHit, ECal_AbsHit);
+      AddHits(fRecord.ecalTotal, ECal_FiberHit, ECal_AbsHit);
     }
   }
 
-  // Info from the glue in the HCal
+  // Info from the glue in the ECal
   // Combining this info with absorber info (i.e. non-scintillating materials) 
-  G4int ECal_GlueHCID = G4SDManager::GetSDMpointer()->GetCollectionID("ECal_GlueHitCollection");
-  auto ECal_GlueHC = GetHitsCollection(ECal_GlueHCID, event);
-  auto ECal_GlueHit = (*ECal_GlueHC)[ECal_GlueHC->entries()-1]; // entries()-1 kept track of information for whole tower segmentation
-  ecal_absorber_edep += ECal_GlueHit->GetEdep();
-  ecal_absorber_edepPi0 += ECal_GlueHit->GetEdepPi0();
-  ecal_absorber_num_Pi0 += ECal_GlueHit->GetNumPi0();
-
-
-  // Ntuple with id 0 holds info for entire detector
-  analysisManager->FillNtupleDColumn(0, 0, ecal_fiber_active_edep);
-  analysisManager->FillNtupleDColumn(0, 1, ecal_fiber_active_edepPi0);
-  analysisManager->FillNtupleDColumn(0, 2, hcal_active_edep);
-  analysisManager->FillNtupleDColumn(0, 3, hcal_active_edepPi0);
-  analysisManager->FillNtupleDColumn(0, 4, ecal_absorber_edep);
-  analysisManager->FillNtupleDColumn(0, 5, ecal_absorber_edepPi0);
-  analysisManager->FillNtupleDColumn(0, 6, hcal_absorber_edep);
-  analysisManager->FillNtupleDColumn(0, 7, hcal_absorber_edepPi0);
-  analysisManager->FillNtupleIColumn(0, 8, ecal_fiber_active_num_Pi0);
-  analysisManager->FillNtupleIColumn(0, 9, hcal_active_num_Pi0);
-  analysisManager->FillNtupleIColumn(0, 10, ecal_absorber_num_Pi0);
-  analysisManager->FillNtupleIColumn(0, 11, hcal_absorber_num_Pi0);
-  analysisManager->FillNtupleIColumn(0, 12, eventID);
-  analysisManager->AddNtupleRow(0); 
+  auto ECal_GlueHC = GetHitsCollection("ECal_GlueHitCollection", event);
+  AddHits(fRecord.ecalTotal, nullptr, (*ECal_GlueHC)[ECal_GlueHC->entries()-1]);
+
+  fRecord.pi0s.swap(CalorimeterSD::GetPi0Records());
+  fRecord.fastShowers = SpotDepositor::GetNumberOfShowers();
+  fRecord.stacking = StackingAction::GetRecord();
+
+  // Library events summed on the cells of the simulated event
+  fOverlay.Process(fRecord);
+
+  // Profiles and transverse shapes of the summary table
+  fRecord.ComputeSummary(DetectorConstruction::GetECalBlockCenters(),
+                         DetectorConstruction::GetHCalTowerCenters());
+
+  // Clusters of blocks and towers; the neighbour tables are built at the
+  // first event, once the geometry is constructed
+  auto analysisConfig = AnalysisConfig::Instance();
+  if ( analysisConfig->IsClustering() ) {
+    if ( ! fClustering.IsInitialized() ) {
+      fClustering.Initialize(DetectorConstruction::GetECalBlockCenters(),
+                             DetectorConstruction::GetHCalTowerCenters());
+    }
+    fClustering.SetThresholds(analysisConfig->GetECalSeedThreshold(),
+                              analysisConfig->GetECalNeighbourThreshold(),
+                              analysisConfig->GetHCalSeedThreshold(),
+                              analysisConfig->GetHCalNeighbourThreshold());
+    fClustering.Process(fRecord);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EventAction::EndOfEventAction(const G4Event* event)
+{  
+  auto eventID = event->GetEventID();
 
+  // The event processing time excludes the output
+  ContainmentMonitor::Instance()->EndEvent();
+  std::chrono::duration<G4double> simTime = std::chrono::steady_clock::now() - fEventStart;
+
+  FillEventRecord(event);
+  fRecord.simTime = simTime.count();
+  fRunAction->WriteEvent(fRecord);
+  StepRecorder::Instance()->EndEvent();
+  // An aborted event is not a complete shower
+  if ( ! event->IsAborted() ) ShowerLibraryBuilder::Instance()->EndEvent();
   
-  if(eventID % 1000 == 0) G4cout << "---> End of event: " << eventID << G4endl; 
+  if(eventID % 1000 == 0) {
+    G4cout << "---> End of event: " << eventID;
+    if ( OutputConfig::Instance()->IsAsyncWriter() ) {
+      G4cout << ", writer queue depth: " << AsyncWriter::Instance()->GetQueueDepth();
+    }
+    G4cout << G4endl;
+  }
 }  
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,120 @@
+/// \file EventOverlay.cc
+/// \brief Implementation of the EventOverlay class
+
+#include "EventOverlay.hh"
+#include "OverlayConfig.hh"
+#include "EventRecord.hh"
+
+#include "G4Poisson.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4ios.hh"
+#include "Randomize.hh"
+
+#include <algorithm>
+#include <chrono>
+
+namespace
+{
+  G4ThreadLocal EventOverlay::Statistics* statistics = nullptr;
+
+  // Random index in [0, size)
+  std::size_t Draw(std::size_t size)
+  {
+    return std::min(std::size_t(G4UniformRand()*size), size - 1);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EventOverlay::Statistics::Merge(const Statistics& other)
+{
+  events += other.events;
+  drawn += other.drawn;
+  added += other.added;
+  time += other.time;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EventOverlay::Statistics::Print() const
+{
+  if ( events == 0. ) return;
+  G4cout << "---> Overlay: " << events << " events, " << drawn/events
+         << " library events drawn and " << added/events << " in the gate per event, "
+         << time/events*1.e6 << " us per event" << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EventOverlay::EventOverlay()
+ : fSum()
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EventOverlay::~EventOverlay()
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EventOverlay::Statistics& EventOverlay::GetStatistics()
+{
+  if ( ! statistics ) {
+    statistics = new Statistics();
+  }
+  return *statistics;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EventOverlay::Process(EventRecord& record)
+{
+  auto config = OverlayConfig::Instance();
+  if ( ! config->IsEnabled() ) return;
+
+  auto start = std::chrono::steady_clock::now();
+  const auto& library = config->GetLibrary();
+  fSum.assign(OverlayLibrary::GetEventSize(), 0.);
+  auto& counts = GetStatistics();
+
+  G4int added = 0;
+  auto overlay = [&](std::size_t event, G4double time) {
+    counts.drawn += 1.;
+    if ( ! config->IsInGate(time) ) return;
+    OverlayLibrary::Add(library.GetCells(event), fSum.data());
+    ++added;
+  };
+
+  for ( const auto& particle : config->GetParticles() ) {
+    if ( particle.events.empty() ) continue;
+    auto event = particle.events[Draw(particle.events.size())];
+    // Label of the events built from the library only
+    if ( record.primary.pdg == 0 ) {
+      const auto& primary = library.GetPrimary(event);
+      record.primary.pdg    = primary.pdg;
+      record.primary.energy = primary.energy*MeV;
+      record.primary.posX   = primary.posX;
+      record.primary.posY   = primary.posY;
+    }
+    overlay(event, particle.time);
+  }
+
+  if ( config->GetPileup() > 0. ) {
+    auto nofEvents = G4Poisson(config->GetPileup());
+    auto minTime = config->GetPileupMinTime();
+    auto window = config->GetPileupMaxTime() - minTime;
+    for ( G4long i=0; i<nofEvents; ++i ) {
+      overlay(Draw(library.GetNumberOfEvents()), minTime + G4UniformRand()*window);
+    }
+  }
+
+  if ( added > 0 ) OverlayLibrary::AddTo(fSum.data(), record);
+  record.overlayEvents = added;
+
+  std::chrono::duration<G4double> time = std::chrono::steady_clock::now() - start;
+  counts.events += 1.;
+  counts.added += added;
+  counts.time += time.count();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,258 @@
+/// \file EventRecord.cc
+/// \brief Implementation of the EventRecord structure
+
+#include "EventRecord.hh"
+#include "RowSink.hh"
+
+#include "G4SystemOfUnits.hh"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace GlobalValues;
+
+namespace
+{
+  // Centroid and width of the active energy of the cells
+  TransverseShape ComputeShape(const std::vector<CellRecord>& cells,
+                               const std::vector<G4TwoVector>& centers)
+  {
+    G4double sum = 0., sumX = 0., sumY = 0., sumX2 = 0., sumY2 = 0.;
+    for ( std::size_t i=0; i<cells.size() && i<centers.size(); ++i ) {
+      auto edep = cells[i].edepActive;
+      if ( edep <= 0. ) continue;
+      auto x = centers[i].x()/cm;
+      auto y = centers[i].y()/cm;
+      sum   += edep;
+      sumX  += edep*x;
+      sumY  += edep*y;
+      sumX2 += edep*x*x;
+      sumY2 += edep*y*y;
+    }
+
+    TransverseShape shape;
+    if ( sum <= 0. ) return shape;
+    shape.centroidX = sumX/sum;
+    shape.centroidY = sumY/sum;
+    shape.widthX = std::sqrt(std::max(sumX2/sum - shape.centroidX*shape.centroidX, 0.));
+    shape.widthY = std::sqrt(std::max(sumY2/sum - shape.centroidY*shape.centroidY, 0.));
+    return shape;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EventRecord::EventRecord()
+ : eventID(-1),
+   ecalBlocks(NumECalBlocks*NumECalBlocks),
+   hcalTowers(NumHCalTowers*NumHCalTowers),
+   hcalTiles(NumHCalTowers*NumHCalTowers*NumHCalLayers),
+   fastShowers(0),
+   overlayEvents(0),
+   eventSeeds{0, 0},
+   simTime(0.)
+{
+  summary.hcalLayers.resize(NumHCalLayers);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EventRecord::Reset(G4int id)
+{
+  eventID = id;
+  primary = PrimaryRecord();
+  ecalTotal = CellRecord();
+  hcalTotal = CellRecord();
+  ecalBlocks.assign(ecalBlocks.size(), CellRecord());
+  hcalTowers.assign(hcalTowers.size(), CellRecord());
+  hcalTiles.assign(hcalTiles.size(), CellRecord());
+  pi0s.clear();
+  summary.hcalLayers.assign(summary.hcalLayers.size(), 0.);
+  summary.hcalTailCatcher = 0.;
+  summary.ecal = TransverseShape();
+  summary.hcal = TransverseShape();
+  clusters.clear();
+  containment = ContainmentRecord();
+  fastShowers = 0;
+  stacking = StackingRecord();
+  overlayEvents = 0;
+  eventSeeds[0] = eventSeeds[1] = 0;
+  simTime = 0.;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EventRecord::ComputeSummary(const std::vector<G4TwoVector>& ecalCenters,
+                                 const std::vector<G4TwoVector>& hcalCenters)
+{
+  auto& layers = summary.hcalLayers;
+  layers.assign(NumHCalLayers, 0.);
+  for ( std::size_t tower=0; tower<hcalTowers.size(); ++tower ) {
+    for ( G4int k=0; k<NumHCalLayers; ++k ) {
+      layers[k] += hcalTiles[tower*NumHCalLayers + k].edepActive;
+    }
+  }
+  summary.hcalTailCatcher = 0.;
+  for ( G4int k=NumHCalLayers-NumTailCatcherLayers; k<NumHCalLayers; ++k ) {
+    summary.hcalTailCatcher += layers[k];
+  }
+
+  summary.ecal = ComputeShape(ecalBlocks, ecalCenters);
+  summary.hcal = ComputeShape(hcalTowers, hcalCenters);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EventRecord::FillRows(RowSink& sink, G4bool cells) const
+{
+  // Table with id 7 holds the events stopped by the containment monitor
+  if ( containment.status != ContainmentStatus::Contained ) {
+    sink.FillIntColumn(7, 0, G4int(containment.status));
+    sink.FillEnergyColumn(7, 1, containment.edepTotal);
+    sink.FillEnergyColumn(7, 2, containment.edepECalActive);
+    sink.FillEnergyColumn(7, 3, containment.edepHCalActive);
+    sink.FillEnergyColumn(7, 4, containment.edepTailCatcher);
+    sink.FillEnergyColumn(7, 5, containment.edepEdge);
+    sink.FillEnergyColumn(7, 6, primary.energy);
+    sink.FillIntColumn(7, 7, eventID);
+    sink.AddRow(7);
+  }
+  // The aborted events are only recorded
+  if ( containment.status == ContainmentStatus::Aborted ) {
+    sink.EndEvent(eventID);
+    return;
+  }
+
+  // The cell tables are left out when only the clusters are kept
+  if ( cells ) {
+    // Table with id 3 holds HCal tile information
+    for(G4int i = 0; i < NumHCalTowers; i++)
+    {
+      for(G4int j = 0; j < NumHCalTowers; j++)
+      {
+        for(G4int k = 0; k < NumHCalLayers; k++)
+        {
+          const auto& tile = HCalTile(i, j, k);
+          sink.FillEnergyColumn(3, 0, tile.edepActive);
+          sink.FillEnergyColumn(3, 1, tile.edepPi0Active);
+          sink.FillEnergyColumn(3, 2, tile.edepAbsorber);
+          sink.FillEnergyColumn(3, 3, tile.edepPi0Absorber);
+          sink.FillIntColumn(3, 4, k);
+          sink.FillIntColumn(3, 5, tile.numPi0Active);
+          sink.FillIntColumn(3, 6, tile.numPi0Absorber);
+          sink.FillIntColumn(3, 7, i);
+          sink.FillIntColumn(3, 8, j);
+          sink.FillIntColumn(3, 9, eventID);
+          sink.AddRow(3);
+        }
+
+        // Table with id 2 holds HCal tower information
+        const auto& tower = HCalTower(i, j);
+        sink.FillEnergyColumn(2, 0, tower.edepActive);
+        sink.FillEnergyColumn(2, 1, tower.edepPi0Active);
+        sink.FillEnergyColumn(2, 2, tower.edepAbsorber);
+        sink.FillEnergyColumn(2, 3, tower.edepPi0Absorber);
+        sink.FillIntColumn(2, 4, i);
+        sink.FillIntColumn(2, 5, j);
+        sink.FillIntColumn(2, 6, tower.numPi0Active);
+        sink.FillIntColumn(2, 7, tower.numPi0Absorber);
+        sink.FillIntColumn(2, 8, eventID);
+        sink.AddRow(2);
+      }
+    }
+
+    // Table with id 1 holds ECal information
+    for(G4int i = 0; i < NumECalBlocks; i++)
+    {
+      for(G4int j = 0; j < NumECalBlocks; j++)
+      {
+        const auto& block = ECalBlock(i, j);
+        sink.FillEnergyColumn(1, 0, block.edepActive);
+        sink.FillEnergyColumn(1, 1, block.edepPi0Active);
+        sink.FillEnergyColumn(1, 2, block.edepAbsorber);
+        sink.FillEnergyColumn(1, 3, block.edepPi0Absorber);
+        sink.FillIntColumn(1, 4, block.numPi0Active);
+        sink.FillIntColumn(1, 5, block.numPi0Absorber);
+        sink.FillIntColumn(1, 6, i);
+        sink.FillIntColumn(1, 7, j);
+        sink.FillIntColumn(1, 8, eventID);
+        sink.AddRow(1);
+      }
+    }
+  }
+
+  // Table with id 0 holds info for entire detector
+  sink.FillEnergyColumn(0, 0, ecalTotal.edepActive);
+  sink.FillEnergyColumn(0, 1, ecalTotal.edepPi0Active);
+  sink.FillEnergyColumn(0, 2, hcalTotal.edepActive);
+  sink.FillEnergyColumn(0, 3, hcalTotal.edepPi0Active);
+  sink.FillEnergyColumn(0, 4, ecalTotal.edepAbsorber);
+  sink.FillEnergyColumn(0, 5, ecalTotal.edepPi0Absorber);
+  sink.FillEnergyColumn(0, 6, hcalTotal.edepAbsorber);
+  sink.FillEnergyColumn(0, 7, hcalTotal.edepPi0Absorber);
+  sink.FillIntColumn(0, 8, ecalTotal.numPi0Active);
+  sink.FillIntColumn(0, 9, hcalTotal.numPi0Active);
+  sink.FillIntColumn(0, 10, ecalTotal.numPi0Absorber);
+  sink.FillIntColumn(0, 11, hcalTotal.numPi0Absorber);
+  sink.FillIntColumn(0, 12, eventID);
+  sink.AddRow(0);
+
+  // Table with id 4 holds the pi0 seen in the calorimeter steps
+  for ( const auto& pi0 : pi0s ) {
+    sink.FillEnergyColumn(4, 0, pi0.energy);
+    sink.FillPositionColumn(4, 1, pi0.posX);
+    sink.FillPositionColumn(4, 2, pi0.posY);
+    sink.FillPositionColumn(4, 3, pi0.posZ);
+    sink.FillIntColumn(4, 4, eventID);
+    sink.AddRow(4);
+  }
+
+  // Table with id 5 holds the shower summary
+  G4int column = 0;
+  for ( auto layer : summary.hcalLayers ) {
+    sink.FillEnergyColumn(5, column++, layer);
+  }
+  sink.FillEnergyColumn(5, column++, summary.hcalTailCatcher);
+  for ( const auto& shape : { summary.ecal, summary.hcal } ) {
+    sink.FillPositionColumn(5, column++, shape.centroidX);
+    sink.FillPositionColumn(5, column++, shape.centroidY);
+    sink.FillPositionColumn(5, column++, shape.widthX);
+    sink.FillPositionColumn(5, column++, shape.widthY);
+  }
+  sink.FillIntColumn(5, column++, fastShowers);
+  sink.FillIntColumn(5, column++, stacking.killedTracks);
+  sink.FillEnergyColumn(5, column++, stacking.killedEnergy);
+  sink.FillEnergyColumn(5, column++, stacking.depositedEnergy);
+  sink.FillIntColumn(5, column++, primary.pdg);
+  sink.FillEnergyColumn(5, column++, primary.energy);
+  sink.FillPositionColumn(5, column++, primary.posX);
+  sink.FillPositionColumn(5, column++, primary.posY);
+  sink.FillIntColumn(5, column++, overlayEvents);
+  sink.FillIntColumn(5, column++, eventSeeds[0]);
+  sink.FillIntColumn(5, column++, eventSeeds[1]);
+  sink.FillIntColumn(5, column, eventID);
+  sink.AddRow(5);
+
+  // Table with id 6 holds the clusters
+  for ( std::size_t id=0; id<clusters.size(); ++id ) {
+    const auto& cluster = clusters[id];
+    column = 0;
+    sink.FillEnergyColumn(6, column++, cluster.edepECal);
+    sink.FillEnergyColumn(6, column++, cluster.edepHCal);
+    for ( const auto& shape : { cluster.ecal, cluster.hcal } ) {
+      sink.FillPositionColumn(6, column++, shape.centroidX);
+      sink.FillPositionColumn(6, column++, shape.centroidY);
+      sink.FillPositionColumn(6, column++, shape.widthX);
+      sink.FillPositionColumn(6, column++, shape.widthY);
+    }
+    sink.FillIntColumn(6, column++, cluster.numECalBlocks);
+    sink.FillIntColumn(6, column++, cluster.numHCalTowers);
+    sink.FillIntColumn(6, column++, G4int(id));
+    sink.FillIntColumn(6, column, eventID);
+    sink.AddRow(6);
+  }
+
+  sink.EndEvent(eventID);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
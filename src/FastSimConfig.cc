@@ -0,0 +1,96 @@
+/// \file FastSimConfig.cc
+/// \brief Implementation of the FastSimConfig class
+
+#include "FastSimConfig.hh"
+#include "FastSimMessenger.hh"
+#include "PhysicsConfig.hh"
+
+#include "G4ios.hh"
+#include "G4UnitsTable.hh"
+#include "G4SystemOfUnits.hh"
+
+FastSimConfig* FastSimConfig::fInstance = nullptr;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+FastSimConfig* FastSimConfig::Instance()
+{
+  // The instance is created on the master with the DetectorConstruction,
+  // before any worker thread is started
+  if ( ! fInstance ) {
+    fInstance = new FastSimConfig();
+  }
+  return fInstance;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+FastSimConfig::FastSimConfig()
+ : fMessenger(nullptr),
+   fMode("off"),
+   fMinEnergy(200.*MeV),
+   fSpotEnergy(1.*MeV),
+   fActiveScale(1.)
+{
+  fMessenger = new FastSimMessenger(this);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+FastSimConfig::~FastSimConfig()
+{
+  delete fMessenger;
+  fInstance = nullptr;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void FastSimConfig::SetMode(const G4String& mode)
+{
+  fMode = mode;
+
+  if ( fMode != "off" && ! PhysicsConfig::Instance()->IsFastSimulation() ) {
+    G4ExceptionDescription msg;
+    msg << "Fast simulation mode " << fMode << " without the fast simulation process:"
+        << G4endl << "the ECal parameterisation and the shower libraries are not used;"
+        << " start with -f on.";
+    G4Exception("FastSimConfig::SetMode()",
+      "MyCode0018", JustWarning, msg);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void FastSimConfig::SetMinEnergy(G4double energy)
+{
+  fMinEnergy = energy;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void FastSimConfig::SetSpotEnergy(G4double energy)
+{
+  fSpotEnergy = energy;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void FastSimConfig::SetActiveScale(G4double scale)
+{
+  fActiveScale = scale;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void FastSimConfig::Print() const
+{
+  G4cout << "---> ECal fast simulation: " << fMode;
+  if ( IsEnabled() ) {
+    G4cout << ", above " << G4BestUnit(fMinEnergy, "Energy")
+           << ", spots of " << G4BestUnit(fSpotEnergy, "Energy")
+           << ", active scale " << fActiveScale;
+  }
+  G4cout << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
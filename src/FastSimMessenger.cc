@@ -0,0 +1,98 @@
+/// \file FastSimMessenger.cc
+/// \brief Implementation of the FastSimMessenger class
+
+#include "FastSimMessenger.hh"
+#include "FastSimConfig.hh"
+
+#include "G4UIdirectory.hh"
+#include "G4UIcmdWithAString.hh"
+#include "G4UIcmdWithADouble.hh"
+#include "G4UIcmdWithADoubleAndUnit.hh"
+#include "G4UIcmdWithoutParameter.hh"
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+FastSimMessenger::FastSimMessenger(FastSimConfig* config)
+ : G4UImessenger(),
+   fConfig(config)
+{
+  fFastSimDir = new G4UIdirectory("/ATHENA/fastsim/");
+  fFastSimDir->SetGuidance("EM shower parameterisation of the ECal.");
+
+  fModeCmd = new G4UIcmdWithAString("/ATHENA/fastsim/mode", this);
+  fModeCmd->SetGuidance("Parameterise the electron, positron and photon showers in the");
+  fModeCmd->SetGuidance("ECal: off, on, or validate (even events parameterised, odd");
+  fModeCmd->SetGuidance("events fully simulated and compared at the end of the run).");
+  fModeCmd->SetGuidance("Default: off");
+  fModeCmd->SetParameterName("mode", false);
+  fModeCmd->SetCandidates("off on validate");
+  fModeCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fModeCmd->SetToBeBroadcasted(false);
+
+  fMinEnergyCmd = new G4UIcmdWithADoubleAndUnit("/ATHENA/fastsim/minEnergy", this);
+  fMinEnergyCmd->SetGuidance("Minimum energy of a parameterised shower; the particles below");
+  fMinEnergyCmd->SetGuidance("are fully simulated. Default: 200 MeV");
+  fMinEnergyCmd->SetParameterName("energy", false);
+  fMinEnergyCmd->SetRange("energy>0.");
+  fMinEnergyCmd->SetUnitCategory("Energy");
+  fMinEnergyCmd->SetDefaultUnit("MeV");
+  fMinEnergyCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fMinEnergyCmd->SetToBeBroadcasted(false);
+
+  fSpotEnergyCmd = new G4UIcmdWithADoubleAndUnit("/ATHENA/fastsim/spotEnergy", this);
+  fSpotEnergyCmd->SetGuidance("Energy of the spots a shower is deposited with. Default: 1 MeV");
+  fSpotEnergyCmd->SetParameterName("energy", false);
+  fSpotEnergyCmd->SetRange("energy>0.");
+  fSpotEnergyCmd->SetUnitCategory("Energy");
+  fSpotEnergyCmd->SetDefaultUnit("MeV");
+  fSpotEnergyCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fSpotEnergyCmd->SetToBeBroadcasted(false);
+
+  fActiveScaleCmd = new G4UIcmdWithADouble("/ATHENA/fastsim/activeScale", this);
+  fActiveScaleCmd->SetGuidance("Scale of the energy deposited in the scintillating materials,");
+  fActiveScaleCmd->SetGuidance("to match the sampling fraction of the full simulation");
+  fActiveScaleCmd->SetGuidance("(see the validation mode). Default: 1");
+  fActiveScaleCmd->SetParameterName("scale", false);
+  fActiveScaleCmd->SetRange("scale>0.");
+  fActiveScaleCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fActiveScaleCmd->SetToBeBroadcasted(false);
+
+  fPrintCmd = new G4UIcmdWithoutParameter("/ATHENA/fastsim/print", this);
+  fPrintCmd->SetGuidance("Print the fast simulation configuration.");
+  fPrintCmd->SetToBeBroadcasted(false);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+FastSimMessenger::~FastSimMessenger()
+{
+  delete fModeCmd;
+  delete fMinEnergyCmd;
+  delete fSpotEnergyCmd;
+  delete fActiveScaleCmd;
+  delete fPrintCmd;
+  delete fFastSimDir;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void FastSimMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
+{
+  if ( command == fModeCmd ) {
+    fConfig->SetMode(newValue);
+  }
+  else if ( command == fMinEnergyCmd ) {
+    fConfig->SetMinEnergy(fMinEnergyCmd->GetNewDoubleValue(newValue));
+  }
+  else if ( command == fSpotEnergyCmd ) {
+    fConfig->SetSpotEnergy(fSpotEnergyCmd->GetNewDoubleValue(newValue));
+  }
+  else if ( command == fActiveScaleCmd ) {
+    fConfig->SetActiveScale(fActiveScaleCmd->GetNewDoubleValue(newValue));
+  }
+  else if ( command == fPrintCmd ) {
+    fConfig->Print();
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
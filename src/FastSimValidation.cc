@@ -0,0 +1,78 @@
+/// \file FastSimValidation.cc
+/// \brief Implementation of the FastSimValidation class
+
+#include "FastSimValidation.hh"
+#include "EventRecord.hh"
+
+#include "G4SystemOfUnits.hh"
+#include "G4ios.hh"
+
+#include <cstdio>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void FastSimValidation::Reset()
+{
+  fFull = Accumulators();
+  fFast = Accumulators();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void FastSimValidation::Fill(const EventRecord& record)
+{
+  auto& accumulators = ( record.fastShowers > 0 ) ? fFast : fFull;
+  const auto& ecal = record.ecalTotal;
+  auto ecalTotal = ecal.edepActive + ecal.edepAbsorber;
+
+  accumulators[kECalActive].Add(ecal.edepActive/MeV);
+  accumulators[kECalAbsorber].Add(ecal.edepAbsorber/MeV);
+  accumulators[kECalTotal].Add(ecalTotal/MeV);
+  if ( ecalTotal > 0. ) accumulators[kSamplingFraction].Add(ecal.edepActive/ecalTotal);
+  accumulators[kECalWidthX].Add(record.summary.ecal.widthX);
+  accumulators[kECalWidthY].Add(record.summary.ecal.widthY);
+  accumulators[kHCalActive].Add(record.hcalTotal.edepActive/MeV);
+  accumulators[kHCalTotal].Add((record.hcalTotal.edepActive + record.hcalTotal.edepAbsorber)/MeV);
+  accumulators[kTime].Add(record.simTime*1.e3);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void FastSimValidation::Merge(const FastSimValidation& other)
+{
+  for ( G4int q=0; q<kNofQuantities; ++q ) {
+    fFull[q].Merge(other.fFull[q]);
+    fFast[q].Merge(other.fFast[q]);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void FastSimValidation::Print() const
+{
+  if ( fFull[kTime].n == 0. && fFast[kTime].n == 0. ) return;
+
+  G4cout << "---> Fast simulation validation: " << fFull[kTime].n << " full, "
+         << fFast[kTime].n << " fast-simulated events" << G4endl
+         << "       quantity            full mean   full sigma    fast mean   fast sigma"
+         << "   fast/full" << G4endl;
+
+  const char* names[kNofQuantities]
+    = { "ECal active [MeV]", "ECal absorber [MeV]", "ECal total [MeV]",
+        "ECal sampling frac", "ECal width X [cm]", "ECal width Y [cm]",
+        "HCal active [MeV]", "HCal total [MeV]", "time [ms/event]" };
+  for ( G4int q=0; q<kNofQuantities; ++q ) {
+    char line[160];
+    std::snprintf(line, sizeof(line),
+                  "       %-18s %12.5g %12.5g %12.5g %12.5g %11.4f",
+                  names[q], fFull[q].mean, fFull[q].GetSigma(),
+                  fFast[q].mean, fFast[q].GetSigma(),
+                  ( fFull[q].mean != 0. ) ? fFast[q].mean/fFull[q].mean : 0.);
+    G4cout << line << G4endl;
+  }
+  if ( fFast[kTime].mean > 0. && fFull[kTime].n > 0. ) {
+    G4cout << "       speed-up: " << fFull[kTime].mean/fFast[kTime].mean << G4endl;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
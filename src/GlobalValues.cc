@@ -1,8 +1,11 @@
 #include "GlobalValues.hh"
+#include "G4SystemOfUnits.hh"
 
 namespace GlobalValues
 {
     extern const G4int NumHCalLayers = 51;
     extern const G4int NumHCalTowers = 6;
     extern const G4int NumECalBlocks = 8;
+    extern const G4int NumTailCatcherLayers = 3;
+    extern const G4double ECalThickness = 170*mm;
 }
\ No newline at end of file
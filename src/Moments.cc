@@ -0,0 +1,49 @@
+/// \file Moments.cc
+/// \brief Implementation of the Moments struct
+
+#include "Moments.hh"
+
+#include <cmath>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void Moments::Add(G4double x)
+{
+  n += 1.;
+  auto delta = x - mean;
+  mean += delta/n;
+  m2 += delta*(x - mean);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void Moments::Merge(const Moments& other)
+{
+  if ( other.n == 0. ) return;
+  if ( n == 0. ) {
+    *this = other;
+    return;
+  }
+  // Chan et al. pairwise combination
+  auto total = n + other.n;
+  auto delta = other.mean - mean;
+  mean += delta*other.n/total;
+  m2 += other.m2 + delta*delta*n*other.n/total;
+  n = total;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double Moments::GetSigma() const
+{
+  return ( n > 1. ) ? std::sqrt(m2/(n - 1.)) : 0.;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double Moments::GetResolution() const
+{
+  return ( mean != 0. ) ? GetSigma()/mean : 0.;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,172 @@
+/// \file NpyWriter.cc
+/// \brief Implementation of the NpyWriter class
+
+#include "NpyWriter.hh"
+
+#include <cstring>
+#include <stdexcept>
+
+namespace
+{
+  const char kNpyMagic[6] = { '\x93', 'N', 'U', 'M', 'P', 'Y' };
+
+  // Width reserved for the number of records in the header
+  const std::size_t kCountWidth = 20;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+NpyWriter::NpyWriter()
+ : fFile(nullptr),
+   fRecordSize(0),
+   fHeaderSize(0),
+   fNofRecords(0)
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+NpyWriter::~NpyWriter()
+{
+  Close();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+bool NpyWriter::Open(const std::string& fileName, const std::string& descr,
+                     const std::vector<std::size_t>& recordShape,
+                     std::size_t recordSize)
+{
+  Close();
+
+  fFile = std::fopen(fileName.c_str(), "wb");
+  if ( ! fFile ) return false;
+
+  fFileName = fileName;
+  fDescr = descr;
+  fRecordShape = recordShape;
+  fRecordSize = recordSize;
+  fNofRecords = 0;
+
+  if ( ! WriteHeader() ) {
+    std::fclose(fFile);
+    fFile = nullptr;
+    return false;
+  }
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+bool NpyWriter::WriteHeader()
+{
+  // e.g. {'descr': '<f2', 'fortran_order': False, 'shape': (N, 6, 6, 51), }
+  // with N padded to a fixed width so that it can be rewritten in place
+  auto count = std::to_string(fNofRecords);
+  count.resize(kCountWidth, ' ');
+  std::string shape = "(" + count + ",";
+  for ( std::size_t i=0; i<fRecordShape.size(); ++i ) {
+    shape += ( i > 0 ? ", " : " " ) + std::to_string(fRecordShape[i]);
+  }
+  shape += ")";
+
+  std::string header = "{'descr': " + fDescr + ", 'fortran_order': False, 'shape': "
+                     + shape + ", }";
+  // The data start on a 64 byte boundary; the header ends with a newline
+  auto prefixSize = sizeof(kNpyMagic) + 2 + 2;
+  auto totalSize = ( prefixSize + header.size() + 1 + 63 ) / 64 * 64;
+  header.resize(totalSize - prefixSize - 1, ' ');
+  header += '\n';
+
+  const unsigned char version[2] = { 1, 0 };
+  auto headerSize = std::uint16_t(header.size());
+  const unsigned char length[2]
+    = { static_cast<unsigned char>(headerSize & 0xff),
+        static_cast<unsigned char>(headerSize >> 8) };
+
+  std::fseek(fFile, 0, SEEK_SET);
+  bool ok = std::fwrite(kNpyMagic, 1, sizeof(kNpyMagic), fFile) == sizeof(kNpyMagic)
+         && std::fwrite(version, 1, 2, fFile) == 2
+         && std::fwrite(length, 1, 2, fFile) == 2
+         && std::fwrite(header.data(), 1, header.size(), fFile) == header.size();
+  std::fseek(fFile, 0, SEEK_END);
+  fHeaderSize = totalSize;
+  return ok;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+bool NpyWriter::Append(const void* record)
+{
+  if ( std::fwrite(record, 1, fRecordSize, fFile) != fRecordSize ) {
+    throw std::runtime_error("NpyWriter: cannot write to " + fFileName);
+  }
+  ++fNofRecords;
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void NpyWriter::Flush()
+{
+  if ( ! fFile ) return;
+
+  // Make the records written so far visible in the header
+  std::fflush(fFile);
+  WriteHeader();
+  std::fflush(fFile);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void NpyWriter::Close()
+{
+  if ( ! fFile ) return;
+
+  Flush();
+  std::fclose(fFile);
+  fFile = nullptr;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+std::uint16_t NpyWriter::ToFloat16(float value)
+{
+  std::uint32_t bits = 0;
+  std::memcpy(&bits, &value, sizeof(bits));
+
+  std::uint32_t sign     = ( bits >> 16 ) & 0x8000;
+  std::uint32_t exponent = ( bits >> 23 ) & 0xff;
+  std::uint32_t mantissa = bits & 0x7fffff;
+
+  // Infinity and NaN
+  if ( exponent == 0xff ) {
+    return std::uint16_t(sign | 0x7c00 | ( mantissa ? 0x200 : 0 ));
+  }
+
+  int halfExponent = int(exponent) - 127 + 15;
+  if ( halfExponent >= 31 ) {
+    // Too large: infinity
+    return std::uint16_t(sign | 0x7c00);
+  }
+
+  if ( halfExponent <= 0 ) {
+    // Subnormal half, or zero if below half of the smallest one
+    if ( halfExponent < -10 ) return std::uint16_t(sign);
+    mantissa |= 0x800000;
+    auto shift = std::uint32_t(14 - halfExponent);
+    auto half = mantissa >> shift;
+    auto remainder = mantissa & ( ( 1u << shift ) - 1 );
+    auto halfway = 1u << ( shift - 1 );
+    if ( remainder > halfway || ( remainder == halfway && ( half & 1 ) ) ) ++half;
+    return std::uint16_t(sign | half);
+  }
+
+  // A carry of the rounding into the exponent gives the right result,
+  // up to infinity
+  auto half = ( std::uint32_t(halfExponent) << 10 ) | ( mantissa >> 13 );
+  auto remainder = mantissa & 0x1fff;
+  if ( remainder > 0x1000 || ( remainder == 0x1000 && ( half & 1 ) ) ) ++half;
+  return std::uint16_t(sign | half);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
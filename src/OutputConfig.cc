@@ -0,0 +1,426 @@
+/// \file OutputConfig.cc
+/// \brief Implementation of the OutputConfig class
+
+#include "OutputConfig.hh"
+#include "OutputMessenger.hh"
+#include "GlobalValues.hh"
+
+#include "G4ios.hh"
+#include "G4UnitsTable.hh"
+#include "G4SystemOfUnits.hh"
+
+OutputConfig* OutputConfig::fInstance = nullptr;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+OutputConfig* OutputConfig::Instance()
+{
+  // The instance is created on the master when the RunAction is built,
+  // before any worker thread is started
+  if ( ! fInstance ) {
+    fInstance = new OutputConfig();
+  }
+  return fInstance;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+OutputConfig::OutputConfig()
+ : fMessenger(nullptr),
+   fOutputFormat("root"),
+   fFloatPrecision(GetNtupleNames().size(), false),
+   fCellTables(true),
+   fCompressionAlgorithm("zlib"),
+   fCompressionLevel(1),
+   fBasketSize(0),
+   fBasketEntries(0),
+   fFlushEvents(0),
+   fFlushSize(0.),
+   fTensorOutput(false),
+   fTensorFloat16(false),
+   fAsyncWriter(false),
+   fQueueSize(256),
+   fReorderEvents(false),
+   fStepPrescale(0),
+   fStepVolumes("fibers"),
+   fStepRegionMin(),
+   fStepRegionMax(),
+   fStepMinEdep(0.),
+   fStepMaxSteps(100000),
+   fStepGrid({ 0.05, 0.5, 0.01, 1.e-6 })
+{
+  fMessenger = new OutputMessenger(this);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+OutputConfig::~OutputConfig()
+{
+  delete fMessenger;
+  fInstance = nullptr;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+const std::vector<G4String>& OutputConfig::GetNtupleNames()
+{
+  static const std::vector<G4String> names
+    = { "EdepTotal", "ECalBlocks", "HCalTowers", "HCalTiles", "Pi0", "Summary",
+        "Clusters", "Containment" };
+  return names;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4int OutputConfig::GetNtupleId(const G4String& ntupleName)
+{
+  const auto& names = GetNtupleNames();
+  for ( std::size_t i=0; i<names.size(); ++i ) {
+    if ( names[i] == ntupleName ) return G4int(i);
+  }
+  return -1;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+ColumnarFormat::Schema OutputConfig::GetSchema() const
+{
+  using ColumnarFormat::ColumnType;
+  const auto& names = GetNtupleNames();
+
+  // Energy columns follow the precision of their ntuple
+  auto energy = [this](G4int ntupleId) {
+    return fFloatPrecision[ntupleId] ? ColumnType::Float32 : ColumnType::Float64;
+  };
+  // Positions and widths are not affected by the energy precision
+  auto position = ColumnType::Float64;
+  auto integer = ColumnType::Int32;
+
+  ColumnarFormat::Schema schema(names.size());
+  for ( std::size_t i=0; i<names.size(); ++i ) schema[i].name = names[i];
+
+  schema[0].columns = {
+    { "ECal_Edep_Active_Total",      energy(0) },
+    { "ECal_EdepPi0_Active_Total",   energy(0) },
+    { "HCal_Edep_Active_Total",      energy(0) },
+    { "HCal_EdepPi0_Active_Total",   energy(0) },
+    { "ECal_Edep_Absorber_Total",    energy(0) },
+    { "ECal_EdepPi0_Absorber_Total", energy(0) },
+    { "HCal_Edep_Absorber_Total",    energy(0) },
+    { "HCal_EdepPi0_Absorber_Total", energy(0) },
+    { "ECal_Num_Active_Pi0",         integer },
+    { "HCal_Num_Active_Pi0",         integer },
+    { "ECal_Num_Absorber_Pi0",       integer },
+    { "HCal_Num_Absorber_Pi0",       integer },
+    { "eventID",                     integer } };
+
+  schema[1].columns = {
+    { "ECal_Edep_Active_Block",      energy(1) },
+    { "ECal_EdepPi0_Active_Block",   energy(1) },
+    { "ECal_Edep_Absorber_Block",    energy(1) },
+    { "ECal_EdepPi0_Absorber_Block", energy(1) },
+    { "ECal_Num_Active_Pi0",         integer },
+    { "ECal_Num_Absorber_Pi0",       integer },
+    { "ECal_BlockXid",               integer },
+    { "ECal_BlockYid",               integer },
+    { "eventID",                     integer } };
+
+  schema[2].columns = {
+    { "HCal_Edep_Active_Tower",      energy(2) },
+    { "HCal_EdepPi0_Active_Tower",   energy(2) },
+    { "HCal_Edep_Absorber_Tower",    energy(2) },
+    { "HCal_EdepPi0_Absorber_Tower", energy(2) },
+    { "HCal_TowerXid",               integer },
+    { "HCal_TowerYid",               integer },
+    { "HCal_Num_Active_Pi0",         integer },
+    { "HCal_Num_Absorber_Pi0",       integer },
+    { "eventID",                     integer } };
+
+  schema[3].columns = {
+    { "HCal_Edep_Active_Tile",       energy(3) },
+    { "HCal_EdepPi0_Active_Tile",    energy(3) },
+    { "HCal_Edep_Absorber_Tile",     energy(3) },
+    { "HCal_EdepPi0_Absorber_Tile",  energy(3) },
+    { "HCal_Layerid",                integer },
+    { "HCal_NumPi0_Active_Tile",     integer },
+    { "HCal_NumPi0_Absorber_Tile",   integer },
+    { "HCal_TowerXid",               integer },
+    { "HCal_TowerYid",               integer },
+    { "eventID",                     integer } };
+
+  schema[4].columns = {
+    { "Energy",                      energy(4) },
+    { "PosX",                        position },
+    { "PosY",                        position },
+    { "PosZ",                        position },
+    { "eventID",                     integer } };
+
+  // HCal profile per layer, then the tail catcher and transverse shapes
+  for ( G4int k=0; k<GlobalValues::NumHCalLayers; ++k ) {
+    schema[5].columns.push_back({ "HCal_Edep_Layer" + std::to_string(k), energy(5) });
+  }
+  schema[5].columns.insert(schema[5].columns.end(), {
+    { "HCal_Edep_TailCatcher",       energy(5) },
+    { "ECal_CentroidX",              position },
+    { "ECal_CentroidY",              position },
+    { "ECal_WidthX",                 position },
+    { "ECal_WidthY",                 position },
+    { "HCal_CentroidX",              position },
+    { "HCal_CentroidY",              position },
+    { "HCal_WidthX",                 position },
+    { "HCal_WidthY",                 position },
+    { "FastShowers",                 integer },
+    { "KilledTracks",                integer },
+    { "KilledEnergy",                energy(5) },
+    { "KilledDeposited",             energy(5) },
+    { "PrimaryPDG",                  integer },
+    { "PrimaryEnergy",               energy(5) },
+    { "PrimaryPosX",                 position },
+    { "PrimaryPosY",                 position },
+    { "OverlayEvents",               integer },
+    { "EventSeed1",                  integer },
+    { "EventSeed2",                  integer },
+    { "eventID",                     integer } });
+
+  schema[6].columns = {
+    { "ECal_Edep_Active",            energy(6) },
+    { "HCal_Edep_Active",            energy(6) },
+    { "ECal_CentroidX",              position },
+    { "ECal_CentroidY",              position },
+    { "ECal_WidthX",                 position },
+    { "ECal_WidthY",                 position },
+    { "HCal_CentroidX",              position },
+    { "HCal_CentroidY",              position },
+    { "HCal_WidthX",                 position },
+    { "HCal_WidthY",                 position },
+    { "ECal_NumBlocks",              integer },
+    { "HCal_NumTowers",              integer },
+    { "Clusterid",                   integer },
+    { "eventID",                     integer } };
+
+  schema[7].columns = {
+    { "Status",                      integer },
+    { "Edep_Total",                  energy(7) },
+    { "Edep_ECal_Active",            energy(7) },
+    { "Edep_HCal_Active",            energy(7) },
+    { "Edep_TailCatcher",            energy(7) },
+    { "Edep_Edge",                   energy(7) },
+    { "Energy_Primary",              energy(7) },
+    { "eventID",                     integer } };
+
+  return schema;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void OutputConfig::SetOutputFormat(const G4String& format)
+{
+  fOutputFormat = format;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void OutputConfig::SetFloatPrecision(const G4String& ntupleName, G4bool useFloat)
+{
+  if ( ntupleName == "all" ) {
+    for ( std::size_t i=0; i<fFloatPrecision.size(); ++i ) {
+      fFloatPrecision[i] = useFloat;
+    }
+    return;
+  }
+
+  auto ntupleId = GetNtupleId(ntupleName);
+  if ( ntupleId < 0 ) {
+    G4ExceptionDescription msg;
+    msg << "Unknown ntuple " << ntupleName << ", precision not changed.";
+    G4Exception("OutputConfig::SetFloatPrecision()",
+      "MyCode0005", JustWarning, msg);
+    return;
+  }
+  fFloatPrecision[ntupleId] = useFloat;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void OutputConfig::SetCellTables(G4bool cells)
+{
+  fCellTables = cells;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void OutputConfig::SetCompressionAlgorithm(const G4String& algorithm)
+{
+  // The Geant4 (g4tools) Root writer only implements zlib compression
+  fCompressionAlgorithm = algorithm;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void OutputConfig::SetCompressionLevel(G4int level)
+{
+  fCompressionLevel = level;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void OutputConfig::SetBasketSize(G4int basketSize)
+{
+  fBasketSize = basketSize;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void OutputConfig::SetBasketEntries(G4int basketEntries)
+{
+  fBasketEntries = basketEntries;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void OutputConfig::SetFlushEvents(G4int nofEvents)
+{
+  fFlushEvents = nofEvents;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void OutputConfig::SetFlushSize(G4double megaBytes)
+{
+  fFlushSize = megaBytes;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void OutputConfig::SetTensorOutput(G4bool tensors)
+{
+  fTensorOutput = tensors;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void OutputConfig::SetTensorFloat16(G4bool float16)
+{
+  fTensorFloat16 = float16;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void OutputConfig::SetAsyncWriter(G4bool async)
+{
+  fAsyncWriter = async;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void OutputConfig::SetQueueSize(G4int nofEvents)
+{
+  fQueueSize = nofEvents;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void OutputConfig::SetReorderEvents(G4bool reorder)
+{
+  fReorderEvents = reorder;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void OutputConfig::SetStepPrescale(G4int prescale)
+{
+  fStepPrescale = prescale;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void OutputConfig::SetStepVolumes(const G4String& volumes)
+{
+  fStepVolumes = volumes;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void OutputConfig::SetStepRegion(const G4ThreeVector& min, const G4ThreeVector& max)
+{
+  fStepRegionMin = min;
+  fStepRegionMax = max;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void OutputConfig::SetStepMinEdep(G4double minEdep)
+{
+  fStepMinEdep = minEdep;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void OutputConfig::SetStepMaxSteps(G4int maxSteps)
+{
+  fStepMaxSteps = maxSteps;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void OutputConfig::SetStepGrid(const StepFormat::Grid& grid)
+{
+  fStepGrid = grid;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void OutputConfig::Print() const
+{
+  G4cout << "---> Output configuration:" << G4endl
+         << "       format: " << fOutputFormat;
+  if ( fTensorOutput ) {
+    G4cout << ", tensors (" << ( fTensorFloat16 ? "float16" : "float32" ) << ")";
+  }
+  G4cout << G4endl;
+  const auto& names = GetNtupleNames();
+  for ( std::size_t i=0; i<names.size(); ++i ) {
+    G4cout << "       " << names[i] << ": "
+           << ( fFloatPrecision[i] ? "float" : "double" ) << G4endl;
+  }
+  if ( ! fCellTables ) {
+    G4cout << "       cell tables: off (no ECalBlocks, HCalTowers, HCalTiles rows)" << G4endl;
+  }
+  G4cout << "       compression: " << fCompressionAlgorithm
+         << " level " << GetCompressionLevel() << G4endl
+         << "       basket size: "
+         << ( fBasketSize > 0 ? std::to_string(fBasketSize) : "default" )
+         << ", basket entries: "
+         << ( fBasketEntries > 0 ? std::to_string(fBasketEntries) : "default" )
+         << G4endl;
+  if ( IsStreaming() ) {
+    G4cout << "       streaming: flush every "
+           << ( fFlushEvents > 0 ? std::to_string(fFlushEvents) + " events" : "-" )
+           << " / "
+           << ( fFlushSize > 0. ? std::to_string(fFlushSize) + " MB" : "-" )
+           << G4endl;
+  }
+  else {
+    G4cout << "       streaming: off (written at end of run)" << G4endl;
+  }
+  if ( IsAsyncWriter() ) {
+    G4cout << "       columnar/tensor output via writer thread, queue size " 
+           << fQueueSize << " events"
+           << ( IsReorderEvents() ? ", in eventID order" : "" ) << G4endl;
+  }
+  if ( IsStepOutput() ) {
+    G4cout << "       steps: every " << fStepPrescale << " events, " << fStepVolumes
+           << ", above " << G4BestUnit(fStepMinEdep, "Energy")
+           << ", at most " << fStepMaxSteps << " per event";
+    if ( IsStepRegion() ) {
+      G4cout << ", in " << G4BestUnit(fStepRegionMin, "Length")
+             << " - " << G4BestUnit(fStepRegionMax, "Length");
+    }
+    G4cout << G4endl
+           << "       step grid: " << fStepGrid.transverse << " mm (x, y), "
+           << fStepGrid.longitudinal << " mm (z), " << fStepGrid.time << " ns, "
+           << fStepGrid.energy/eV << " eV" << G4endl;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
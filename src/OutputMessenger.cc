@@ -0,0 +1,346 @@
+/// \file OutputMessenger.cc
+/// \brief Implementation of the OutputMessenger class
+
+#include "OutputMessenger.hh"
+#include "OutputConfig.hh"
+
+#include "G4UIdirectory.hh"
+#include "G4UIcommand.hh"
+#include "G4UIparameter.hh"
+#include "G4UIcmdWithAString.hh"
+#include "G4UIcmdWithAnInteger.hh"
+#include "G4UIcmdWithADouble.hh"
+#include "G4UIcmdWithADoubleAndUnit.hh"
+#include "G4UIcmdWithABool.hh"
+#include "G4UIcmdWithoutParameter.hh"
+#include "G4UnitsTable.hh"
+#include "G4SystemOfUnits.hh"
+
+#include <sstream>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+OutputMessenger::OutputMessenger(OutputConfig* config)
+ : G4UImessenger(),
+   fConfig(config)
+{
+  fOutputDir = new G4UIdirectory("/ATHENA/output/");
+  fOutputDir->SetGuidance("Output format, compression and basket settings.");
+
+  // Output format
+  fFormatCmd = new G4UIcmdWithAString("/ATHENA/output/format", this);
+  fFormatCmd->SetGuidance("Output format:");
+  fFormatCmd->SetGuidance("  root     : Root ntuples merged on the master (default)");
+  fFormatCmd->SetGuidance("  columnar : one append-only columnar file per thread");
+  fFormatCmd->SetGuidance("             and a manifest listing them (.acolset)");
+  fFormatCmd->SetGuidance("  both     : both of the above");
+  fFormatCmd->SetParameterName("format", false);
+  fFormatCmd->SetCandidates("root columnar both");
+  fFormatCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fFormatCmd->SetToBeBroadcasted(false);
+
+  // Tensor output
+  fTensorsCmd = new G4UIcmdWithABool("/ATHENA/output/tensors", this);
+  fTensorsCmd->SetGuidance("Write also the calorimeter response as dense tensors:");
+  fTensorsCmd->SetGuidance("<name>_ecal.npy (N,8,8), <name>_hcal.npy (N,6,6,51)");
+  fTensorsCmd->SetGuidance("and the primary labels in <name>_labels.npy.");
+  fTensorsCmd->SetParameterName("tensors", false);
+  fTensorsCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fTensorsCmd->SetToBeBroadcasted(false);
+
+  fTensorPrecisionCmd = new G4UIcmdWithAString("/ATHENA/output/tensorPrecision", this);
+  fTensorPrecisionCmd->SetGuidance("Precision of the tensor values (energies in GeV).");
+  fTensorPrecisionCmd->SetParameterName("precision", false);
+  fTensorPrecisionCmd->SetCandidates("float32 float16");
+  fTensorPrecisionCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fTensorPrecisionCmd->SetToBeBroadcasted(false);
+
+  // Precision of the energy columns
+  fPrecisionCmd = new G4UIcommand("/ATHENA/output/precision", this);
+  fPrecisionCmd->SetGuidance("Book the energy columns of an ntuple as float or double.");
+  fPrecisionCmd->SetGuidance("The position and width columns stay double. Applied when the");
+  fPrecisionCmd->SetGuidance("ntuples are booked (first run).");
+  auto ntupleParam = new G4UIparameter("ntuple", 's', false);
+  G4String candidates = "all";
+  for ( const auto& name : OutputConfig::GetNtupleNames() ) candidates += " " + name;
+  ntupleParam->SetParameterCandidates(candidates);
+  fPrecisionCmd->SetParameter(ntupleParam);
+  auto precisionParam = new G4UIparameter("precision", 's', false);
+  precisionParam->SetParameterCandidates("float double");
+  fPrecisionCmd->SetParameter(precisionParam);
+  fPrecisionCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fPrecisionCmd->SetToBeBroadcasted(false);
+
+  fCellTablesCmd = new G4UIcmdWithABool("/ATHENA/output/cellTables", this);
+  fCellTablesCmd->SetGuidance("Write the rows of the ECalBlocks, HCalTowers and HCalTiles");
+  fCellTablesCmd->SetGuidance("tables (default true). The tables stay booked, but empty.");
+  fCellTablesCmd->SetParameterName("cells", false);
+  fCellTablesCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fCellTablesCmd->SetToBeBroadcasted(false);
+
+  // Compression
+  fCompressionAlgorithmCmd 
+    = new G4UIcmdWithAString("/ATHENA/output/compressionAlgorithm", this);
+  fCompressionAlgorithmCmd->SetGuidance("Compression algorithm of the output files.");
+  fCompressionAlgorithmCmd->SetGuidance("Only zlib is implemented by the Geant4 Root writer.");
+  fCompressionAlgorithmCmd->SetParameterName("algorithm", false);
+  fCompressionAlgorithmCmd->SetCandidates("zlib none");
+  fCompressionAlgorithmCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fCompressionAlgorithmCmd->SetToBeBroadcasted(false);
+
+  fCompressionLevelCmd 
+    = new G4UIcmdWithAnInteger("/ATHENA/output/compressionLevel", this);
+  fCompressionLevelCmd->SetGuidance("Compression level of the output file (0-9).");
+  fCompressionLevelCmd->SetParameterName("level", false);
+  fCompressionLevelCmd->SetRange("level>=0 && level<=9");
+  fCompressionLevelCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fCompressionLevelCmd->SetToBeBroadcasted(false);
+
+  // Baskets
+  fBasketSizeCmd = new G4UIcmdWithAnInteger("/ATHENA/output/basketSize", this);
+  fBasketSizeCmd->SetGuidance("Basket size of the ntuple branches in bytes.");
+  fBasketSizeCmd->SetGuidance("0 keeps the Geant4 default.");
+  fBasketSizeCmd->SetParameterName("bytes", false);
+  fBasketSizeCmd->SetRange("bytes>=0");
+  fBasketSizeCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fBasketSizeCmd->SetToBeBroadcasted(false);
+
+  fBasketEntriesCmd = new G4UIcmdWithAnInteger("/ATHENA/output/basketEntries", this);
+  fBasketEntriesCmd->SetGuidance("Number of entries per basket (auto-flush size).");
+  fBasketEntriesCmd->SetGuidance("0 keeps the Geant4 default.");
+  fBasketEntriesCmd->SetParameterName("entries", false);
+  fBasketEntriesCmd->SetRange("entries>=0");
+  fBasketEntriesCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fBasketEntriesCmd->SetToBeBroadcasted(false);
+
+  // Streaming
+  fFlushEventsCmd = new G4UIcmdWithAnInteger("/ATHENA/output/flushEvents", this);
+  fFlushEventsCmd->SetGuidance("Flush the completed events to the output every N events.");
+  fFlushEventsCmd->SetGuidance("Streaming (N or flushSize > 0) turns off the Root ntuple");
+  fFlushEventsCmd->SetGuidance("merging: each thread writes its own Root file.");
+  fFlushEventsCmd->SetGuidance("0 writes the events at the end of the run (default).");
+  fFlushEventsCmd->SetParameterName("events", false);
+  fFlushEventsCmd->SetRange("events>=0");
+  fFlushEventsCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fFlushEventsCmd->SetToBeBroadcasted(false);
+
+  fFlushSizeCmd = new G4UIcmdWithADouble("/ATHENA/output/flushSize", this);
+  fFlushSizeCmd->SetGuidance("Flush the completed events to the output when the");
+  fFlushSizeCmd->SetGuidance("buffered data of a thread exceeds the given size in MB.");
+  fFlushSizeCmd->SetGuidance("0 disables the size limit (default).");
+  fFlushSizeCmd->SetParameterName("MB", false);
+  fFlushSizeCmd->SetRange("MB>=0.");
+  fFlushSizeCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fFlushSizeCmd->SetToBeBroadcasted(false);
+
+  // Writer thread
+  fAsyncWriterCmd = new G4UIcmdWithABool("/ATHENA/output/asyncWriter", this);
+  fAsyncWriterCmd->SetGuidance("Write the columnar and tensor output from a dedicated thread.");
+  fAsyncWriterCmd->SetGuidance("The workers queue their events and all events are");
+  fAsyncWriterCmd->SetGuidance("written to a single file <name>.acol (<name>_*.npy).");
+  fAsyncWriterCmd->SetGuidance("The Root ntuples are still filled by the workers.");
+  fAsyncWriterCmd->SetParameterName("async", false);
+  fAsyncWriterCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fAsyncWriterCmd->SetToBeBroadcasted(false);
+
+  fQueueSizeCmd = new G4UIcmdWithAnInteger("/ATHENA/output/queueSize", this);
+  fQueueSizeCmd->SetGuidance("Number of events queued for the writer thread.");
+  fQueueSizeCmd->SetGuidance("The workers wait when the queue is full.");
+  fQueueSizeCmd->SetParameterName("events", false);
+  fQueueSizeCmd->SetRange("events>=1");
+  fQueueSizeCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fQueueSizeCmd->SetToBeBroadcasted(false);
+
+  fReorderEventsCmd = new G4UIcmdWithABool("/ATHENA/output/reorderEvents", this);
+  fReorderEventsCmd->SetGuidance("Write the events of the writer thread in eventID order.");
+  fReorderEventsCmd->SetGuidance("Events arriving early are held back, at most queueSize of them;");
+  fReorderEventsCmd->SetGuidance("beyond that the lowest held eventID is written and the");
+  fReorderEventsCmd->SetGuidance("missing events are written out of order when they arrive.");
+  fReorderEventsCmd->SetGuidance("Only used with /ATHENA/output/asyncWriter true.");
+  fReorderEventsCmd->SetParameterName("reorder", false);
+  fReorderEventsCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fReorderEventsCmd->SetToBeBroadcasted(false);
+
+  fPrintCmd = new G4UIcmdWithoutParameter("/ATHENA/output/print", this);
+  fPrintCmd->SetGuidance("Print the output configuration.");
+  fPrintCmd->SetToBeBroadcasted(false);
+
+  // Sampled step output
+  fStepsDir = new G4UIdirectory("/ATHENA/output/steps/");
+  fStepsDir->SetGuidance("Sampled output of the individual ECal steps.");
+  fStepsDir->SetGuidance("Each thread writes <name>_steps_t<thread>.asteps.");
+
+  fStepPrescaleCmd = new G4UIcmdWithAnInteger("/ATHENA/output/steps/prescale", this);
+  fStepPrescaleCmd->SetGuidance("Record the steps of the events with eventID % N == 0.");
+  fStepPrescaleCmd->SetGuidance("0 disables the step output (default).");
+  fStepPrescaleCmd->SetParameterName("N", false);
+  fStepPrescaleCmd->SetRange("N>=0");
+  fStepPrescaleCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fStepPrescaleCmd->SetToBeBroadcasted(false);
+
+  fStepVolumesCmd = new G4UIcmdWithAString("/ATHENA/output/steps/volumes", this);
+  fStepVolumesCmd->SetGuidance("Volumes of the recorded steps:");
+  fStepVolumesCmd->SetGuidance("  fibers : ECal fiber cores (default)");
+  fStepVolumesCmd->SetGuidance("  ecal   : ECal fiber cores, cladding and tungsten powder");
+  fStepVolumesCmd->SetParameterName("volumes", false);
+  fStepVolumesCmd->SetCandidates("fibers ecal");
+  fStepVolumesCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fStepVolumesCmd->SetToBeBroadcasted(false);
+
+  fStepRegionCmd = new G4UIcommand("/ATHENA/output/steps/region", this);
+  fStepRegionCmd->SetGuidance("Record only the steps inside a box of the global coordinates.");
+  fStepRegionCmd->SetGuidance("The ECal front face is at z = -8.5 cm.");
+  fStepRegionCmd->SetGuidance("An empty box (e.g. all zeros) removes the region.");
+  for ( auto name : { "xmin", "xmax", "ymin", "ymax", "zmin", "zmax" } ) {
+    fStepRegionCmd->SetParameter(new G4UIparameter(name, 'd', false));
+  }
+  auto regionUnitParam = new G4UIparameter("unit", 's', true);
+  regionUnitParam->SetDefaultUnit("cm");
+  fStepRegionCmd->SetParameter(regionUnitParam);
+  fStepRegionCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fStepRegionCmd->SetToBeBroadcasted(false);
+
+  fStepMinEdepCmd
+    = new G4UIcmdWithADoubleAndUnit("/ATHENA/output/steps/minEdep", this);
+  fStepMinEdepCmd->SetGuidance("Minimum energy deposit of a recorded step (default 0).");
+  fStepMinEdepCmd->SetParameterName("minEdep", false);
+  fStepMinEdepCmd->SetRange("minEdep>=0.");
+  fStepMinEdepCmd->SetUnitCategory("Energy");
+  fStepMinEdepCmd->SetDefaultUnit("keV");
+  fStepMinEdepCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fStepMinEdepCmd->SetToBeBroadcasted(false);
+
+  fStepMaxStepsCmd = new G4UIcmdWithAnInteger("/ATHENA/output/steps/maxSteps", this);
+  fStepMaxStepsCmd->SetGuidance("Maximum number of steps recorded per event (default 100000);");
+  fStepMaxStepsCmd->SetGuidance("the steps beyond are counted. 0 removes the limit.");
+  fStepMaxStepsCmd->SetParameterName("steps", false);
+  fStepMaxStepsCmd->SetRange("steps>=0");
+  fStepMaxStepsCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fStepMaxStepsCmd->SetToBeBroadcasted(false);
+
+  fStepGridCmd = new G4UIcommand("/ATHENA/output/steps/grid", this);
+  fStepGridCmd->SetGuidance("Quantisation of the recorded steps: grid unit of the");
+  fStepGridCmd->SetGuidance("x and y positions [mm], z position [mm], time [ns] and");
+  fStepGridCmd->SetGuidance("energy deposit [eV]. Default: 0.05 0.5 0.01 1");
+  for ( auto name : { "transverse", "longitudinal", "time", "energy" } ) {
+    auto param = new G4UIparameter(name, 'd', false);
+    param->SetParameterRange((G4String(name) + ">0.").c_str());
+    fStepGridCmd->SetParameter(param);
+  }
+  fStepGridCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fStepGridCmd->SetToBeBroadcasted(false);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+OutputMessenger::~OutputMessenger()
+{
+  delete fFormatCmd;
+  delete fPrecisionCmd;
+  delete fCellTablesCmd;
+  delete fCompressionAlgorithmCmd;
+  delete fCompressionLevelCmd;
+  delete fBasketSizeCmd;
+  delete fBasketEntriesCmd;
+  delete fFlushEventsCmd;
+  delete fFlushSizeCmd;
+  delete fTensorsCmd;
+  delete fTensorPrecisionCmd;
+  delete fAsyncWriterCmd;
+  delete fQueueSizeCmd;
+  delete fReorderEventsCmd;
+  delete fPrintCmd;
+  delete fStepPrescaleCmd;
+  delete fStepVolumesCmd;
+  delete fStepRegionCmd;
+  delete fStepMinEdepCmd;
+  delete fStepMaxStepsCmd;
+  delete fStepGridCmd;
+  delete fStepsDir;
+  delete fOutputDir;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void OutputMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
+{
+  if ( command == fFormatCmd ) {
+    fConfig->SetOutputFormat(newValue);
+  }
+  else if ( command == fPrecisionCmd ) {
+    std::istringstream is(newValue);
+    G4String ntupleName, precision;
+    is >> ntupleName >> precision;
+    fConfig->SetFloatPrecision(ntupleName, precision == "float");
+  }
+  else if ( command == fCellTablesCmd ) {
+    fConfig->SetCellTables(fCellTablesCmd->GetNewBoolValue(newValue));
+  }
+  else if ( command == fCompressionAlgorithmCmd ) {
+    fConfig->SetCompressionAlgorithm(newValue);
+  }
+  else if ( command == fCompressionLevelCmd ) {
+    fConfig->SetCompressionLevel(fCompressionLevelCmd->GetNewIntValue(newValue));
+  }
+  else if ( command == fBasketSizeCmd ) {
+    fConfig->SetBasketSize(fBasketSizeCmd->GetNewIntValue(newValue));
+  }
+  else if ( command == fBasketEntriesCmd ) {
+    fConfig->SetBasketEntries(fBasketEntriesCmd->GetNewIntValue(newValue));
+  }
+  else if ( command == fFlushEventsCmd ) {
+    fConfig->SetFlushEvents(fFlushEventsCmd->GetNewIntValue(newValue));
+  }
+  else if ( command == fFlushSizeCmd ) {
+    fConfig->SetFlushSize(fFlushSizeCmd->GetNewDoubleValue(newValue));
+  }
+  else if ( command == fTensorsCmd ) {
+    fConfig->SetTensorOutput(fTensorsCmd->GetNewBoolValue(newValue));
+  }
+  else if ( command == fTensorPrecisionCmd ) {
+    fConfig->SetTensorFloat16(newValue == "float16");
+  }
+  else if ( command == fAsyncWriterCmd ) {
+    fConfig->SetAsyncWriter(fAsyncWriterCmd->GetNewBoolValue(newValue));
+  }
+  else if ( command == fQueueSizeCmd ) {
+    fConfig->SetQueueSize(fQueueSizeCmd->GetNewIntValue(newValue));
+  }
+  else if ( command == fReorderEventsCmd ) {
+    fConfig->SetReorderEvents(fReorderEventsCmd->GetNewBoolValue(newValue));
+  }
+  else if ( command == fStepPrescaleCmd ) {
+    fConfig->SetStepPrescale(fStepPrescaleCmd->GetNewIntValue(newValue));
+  }
+  else if ( command == fStepVolumesCmd ) {
+    fConfig->SetStepVolumes(newValue);
+  }
+  else if ( command == fStepRegionCmd ) {
+    std::istringstream is(newValue);
+    G4double xmin, xmax, ymin, ymax, zmin, zmax;
+    G4String unit;
+    is >> xmin >> xmax >> ymin >> ymax >> zmin >> zmax >> unit;
+    auto value = G4UIcommand::ValueOf(unit);
+    fConfig->SetStepRegion(G4ThreeVector(xmin, ymin, zmin)*value,
+                           G4ThreeVector(xmax, ymax, zmax)*value);
+  }
+  else if ( command == fStepMinEdepCmd ) {
+    fConfig->SetStepMinEdep(fStepMinEdepCmd->GetNewDoubleValue(newValue));
+  }
+  else if ( command == fStepMaxStepsCmd ) {
+    fConfig->SetStepMaxSteps(fStepMaxStepsCmd->GetNewIntValue(newValue));
+  }
+  else if ( command == fStepGridCmd ) {
+    std::istringstream is(newValue);
+    StepFormat::Grid grid;
+    G4double energy;
+    is >> grid.transverse >> grid.longitudinal >> grid.time >> energy;
+    grid.energy = energy*eV/MeV;
+    fConfig->SetStepGrid(grid);
+  }
+  else if ( command == fPrintCmd ) {
+    fConfig->Print();
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,172 @@
+/// \file OverlayConfig.cc
+/// \brief Implementation of the OverlayConfig class
+
+#include "OverlayConfig.hh"
+#include "OverlayMessenger.hh"
+
+#include "G4ParticleTable.hh"
+#include "G4ParticleDefinition.hh"
+#include "G4ios.hh"
+#include "G4UnitsTable.hh"
+#include "G4SystemOfUnits.hh"
+
+OverlayConfig* OverlayConfig::fInstance = nullptr;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+OverlayConfig* OverlayConfig::Instance()
+{
+  // The instance is created on the master with the RunAction,
+  // before any worker thread is started
+  if ( ! fInstance ) {
+    fInstance = new OverlayConfig();
+  }
+  return fInstance;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+OverlayConfig::OverlayConfig()
+ : fMessenger(nullptr),
+   fLibrary(),
+   fParticles(),
+   fEnergyTolerance(0.01),
+   fPositionTolerance(0.5*cm),
+   fPileup(0.),
+   fPileupMinTime(-100.*ns),
+   fPileupMaxTime(100.*ns),
+   fGateMinTime(-50.*ns),
+   fGateMaxTime(50.*ns),
+   fSimulatePrimaries(true)
+{
+  fMessenger = new OverlayMessenger(this);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+OverlayConfig::~OverlayConfig()
+{
+  delete fMessenger;
+  fInstance = nullptr;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void OverlayConfig::AddLibrary(const G4String& path)
+{
+  if ( path.empty() || path == "none" ) {
+    fLibrary.Clear();
+    return;
+  }
+  fLibrary.Load(path);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void OverlayConfig::AddParticle(const Particle& particle)
+{
+  fParticles.push_back(particle);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void OverlayConfig::ClearParticles()
+{
+  fParticles.clear();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void OverlayConfig::SetTolerances(G4double energyFraction, G4double distance)
+{
+  fEnergyTolerance = energyFraction;
+  fPositionTolerance = distance;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void OverlayConfig::SetPileup(G4double mean, G4double minTime, G4double maxTime)
+{
+  fPileup = mean;
+  fPileupMinTime = minTime;
+  fPileupMaxTime = maxTime;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void OverlayConfig::SetGate(G4double minTime, G4double maxTime)
+{
+  fGateMinTime = minTime;
+  fGateMaxTime = maxTime;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void OverlayConfig::SetSimulatePrimaries(G4bool simulate)
+{
+  fSimulatePrimaries = simulate;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void OverlayConfig::Prepare()
+{
+  auto particleTable = G4ParticleTable::GetParticleTable();
+  for ( auto& particle : fParticles ) {
+    particle.events.clear();
+    auto definition = particleTable->FindParticle(particle.name);
+    if ( ! definition ) {
+      G4ExceptionDescription msg;
+      msg << "Unknown particle " << particle.name << "; it is not overlaid";
+      G4Exception("OverlayConfig::Prepare()",
+        "MyCode0015", JustWarning, msg);
+      continue;
+    }
+    fLibrary.Find(definition->GetPDGEncoding(), particle.energy, fEnergyTolerance,
+                  ! particle.anyPosition, particle.posX, particle.posY,
+                  fPositionTolerance, particle.events);
+    if ( particle.events.empty() && fLibrary.GetNumberOfEvents() > 0 ) {
+      G4ExceptionDescription msg;
+      msg << "No library event of " << particle.name << " at "
+          << G4BestUnit(particle.energy, "Energy") << "; it is not overlaid";
+      G4Exception("OverlayConfig::Prepare()",
+        "MyCode0015", JustWarning, msg);
+    }
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void OverlayConfig::Print() const
+{
+  G4cout << "---> Event overlay:";
+  if ( ! IsEnabled() ) {
+    G4cout << " none";
+    if ( ! fSimulatePrimaries ) G4cout << ", primaries not simulated (empty events)";
+    G4cout << G4endl;
+    return;
+  }
+  G4cout << " " << fLibrary.GetNumberOfEvents() << " library events ("
+         << fLibrary.GetMemorySize()/1.e6 << " MB) from";
+  for ( const auto& path : fLibrary.GetPaths() ) G4cout << " " << path;
+  G4cout << ", primaries " << ( fSimulatePrimaries ? "simulated" : "not simulated" ) << G4endl;
+  for ( const auto& particle : fParticles ) {
+    G4cout << "       " << particle.name << " " << G4BestUnit(particle.energy, "Energy");
+    if ( ! particle.anyPosition ) {
+      G4cout << " at (" << particle.posX/cm << ", " << particle.posY/cm << ") cm";
+    }
+    G4cout << ", offset " << G4BestUnit(particle.time, "Time") << ": "
+           << particle.events.size() << " library events" << G4endl;
+  }
+  if ( fPileup > 0. ) {
+    G4cout << "       pile-up: " << fPileup << " events on average from "
+           << G4BestUnit(fPileupMinTime, "Time") << " to "
+           << G4BestUnit(fPileupMaxTime, "Time") << G4endl;
+  }
+  G4cout << "       tolerances: " << fEnergyTolerance*100. << "% in energy, "
+         << G4BestUnit(fPositionTolerance, "Length") << " in position; gate from "
+         << G4BestUnit(fGateMinTime, "Time") << " to "
+         << G4BestUnit(fGateMaxTime, "Time") << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,273 @@
+/// \file OverlayLibrary.cc
+/// \brief Implementation of the OverlayLibrary class
+
+#include "OverlayLibrary.hh"
+#include "EventRecord.hh"
+#include "ColumnarReader.hh"
+#include "GlobalValues.hh"
+
+#include "G4SystemOfUnits.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+using namespace GlobalValues;
+
+namespace
+{
+  // Cells of one table in the cell order: the table, its columns of the
+  // quantities, the first cell and the number of cells (rows per event)
+  struct CellGroup
+  {
+    const char*  table;
+    const char*  columns[OverlayLibrary::kNofQuantities];
+    std::size_t  firstCell;
+    std::size_t  nofCells;
+  };
+
+  std::vector<CellGroup> GetCellGroups()
+  {
+    std::size_t nofBlocks = NumECalBlocks*NumECalBlocks;
+    std::size_t nofTowers = NumHCalTowers*NumHCalTowers;
+    std::size_t nofTiles = nofTowers*NumHCalLayers;
+    return {
+      { "EdepTotal",
+        { "ECal_Edep_Active_Total", "ECal_EdepPi0_Active_Total", "ECal_Edep_Absorber_Total",
+          "ECal_EdepPi0_Absorber_Total", "ECal_Num_Active_Pi0", "ECal_Num_Absorber_Pi0" },
+        0, 1 },
+      { "EdepTotal",
+        { "HCal_Edep_Active_Total", "HCal_EdepPi0_Active_Total", "HCal_Edep_Absorber_Total",
+          "HCal_EdepPi0_Absorber_Total", "HCal_Num_Active_Pi0", "HCal_Num_Absorber_Pi0" },
+        1, 1 },
+      { "ECalBlocks",
+        { "ECal_Edep_Active_Block", "ECal_EdepPi0_Active_Block", "ECal_Edep_Absorber_Block",
+          "ECal_EdepPi0_Absorber_Block", "ECal_Num_Active_Pi0", "ECal_Num_Absorber_Pi0" },
+        2, nofBlocks },
+      { "HCalTowers",
+        { "HCal_Edep_Active_Tower", "HCal_EdepPi0_Active_Tower", "HCal_Edep_Absorber_Tower",
+          "HCal_EdepPi0_Absorber_Tower", "HCal_Num_Active_Pi0", "HCal_Num_Absorber_Pi0" },
+        2 + nofBlocks, nofTowers },
+      { "HCalTiles",
+        { "HCal_Edep_Active_Tile", "HCal_EdepPi0_Active_Tile", "HCal_Edep_Absorber_Tile",
+          "HCal_EdepPi0_Absorber_Tile", "HCal_NumPi0_Active_Tile", "HCal_NumPi0_Absorber_Tile" },
+        2 + nofBlocks + nofTowers, nofTiles } };
+  }
+
+  G4bool Fail(const G4String& path, const G4String& reason)
+  {
+    G4ExceptionDescription msg;
+    msg << "Cannot load overlay library " << path << ": " << reason;
+    G4Exception("OverlayLibrary::Load()",
+      "MyCode0015", JustWarning, msg);
+    return false;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+OverlayLibrary::OverlayLibrary()
+ : fPaths(),
+   fPrimaries(),
+   fCells(),
+   fOrder()
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+OverlayLibrary::~OverlayLibrary()
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+std::size_t OverlayLibrary::GetNumberOfCells()
+{
+  std::size_t nofTowers = NumHCalTowers*NumHCalTowers;
+  return 2 + NumECalBlocks*NumECalBlocks + nofTowers + nofTowers*NumHCalLayers;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+std::size_t OverlayLibrary::GetEventSize()
+{
+  return kNofQuantities*GetNumberOfCells();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool OverlayLibrary::Load(const G4String& path)
+{
+  ColumnarDataset dataset;
+  if ( ! dataset.Open(path) ) return Fail(path, "not a columnar file or manifest");
+  const auto& schema = dataset.GetSchema();
+
+  // The events are the rows of the EdepTotal table; the aborted events
+  // have none and are left out
+  auto totalTable = ColumnarFormat::FindTable(schema, "EdepTotal");
+  auto summaryTable = ColumnarFormat::FindTable(schema, "Summary");
+  if ( totalTable < 0 || summaryTable < 0 ) return Fail(path, "no EdepTotal or Summary table");
+  auto nofEvents = dataset.GetNumberOfRows(totalTable);
+  if ( nofEvents == 0 ) return Fail(path, "no events");
+  if ( dataset.GetNumberOfRows(summaryTable) != nofEvents ) {
+    return Fail(path, "the EdepTotal and Summary tables differ in rows");
+  }
+
+  const char* primaryNames[] = { "PrimaryPDG", "PrimaryEnergy", "PrimaryPosX", "PrimaryPosY" };
+  G4int primaryColumns[4];
+  for ( G4int i=0; i<4; ++i ) {
+    primaryColumns[i] = ColumnarFormat::FindColumn(schema[summaryTable], primaryNames[i]);
+    if ( primaryColumns[i] < 0 ) return Fail(path, "written without the primary columns");
+  }
+
+  // All cells of all events must be there, in the same event order
+  auto eventIDs = dataset.ReadColumnAsInt(
+    totalTable, ColumnarFormat::FindColumn(schema[totalTable], "eventID"));
+  if ( eventIDs.size() != nofEvents ) return Fail(path, "cannot read the eventIDs");
+  auto groups = GetCellGroups();
+  std::vector<G4int> tables;
+  for ( const auto& group : groups ) {
+    auto table = ColumnarFormat::FindTable(schema, group.table);
+    if ( table < 0 || dataset.GetNumberOfRows(table) != nofEvents*group.nofCells ) {
+      return Fail(path, "written without the cell tables");
+    }
+    for ( auto column : group.columns ) {
+      if ( ColumnarFormat::FindColumn(schema[table], column) < 0 ) {
+        return Fail(path, G4String("no column ") + column);
+      }
+    }
+    tables.push_back(table);
+  }
+  for ( auto table : { summaryTable, tables[2], tables[3], tables[4] } ) {
+    auto ids = dataset.ReadColumnAsInt(
+      table, ColumnarFormat::FindColumn(schema[table], "eventID"));
+    auto rowsPerEvent = ids.size()/nofEvents;
+    for ( std::size_t row=0; row<ids.size(); ++row ) {
+      if ( ids[row] != eventIDs[row/rowsPerEvent] ) {
+        return Fail(path, "the events of the tables are not in the same order");
+      }
+    }
+  }
+
+  // Cells, column after column; the values are kept as floats
+  auto firstEvent = fPrimaries.size();
+  auto nofCells = GetNumberOfCells();
+  auto eventSize = GetEventSize();
+  fCells.resize((firstEvent + nofEvents)*eventSize, 0.f);
+  for ( std::size_t g=0; g<groups.size(); ++g ) {
+    const auto& group = groups[g];
+    const auto& table = schema[tables[g]];
+    for ( std::size_t q=0; q<kNofQuantities; ++q ) {
+      auto values = dataset.ReadColumnAsDouble(
+        tables[g], ColumnarFormat::FindColumn(table, group.columns[q]));
+      if ( values.size() != nofEvents*group.nofCells ) {
+        fCells.resize(firstEvent*eventSize);
+        return Fail(path, G4String("cannot read column ") + group.columns[q]);
+      }
+      for ( std::size_t event=0; event<nofEvents; ++event ) {
+        auto cells = &fCells[(firstEvent + event)*eventSize + q*nofCells + group.firstCell];
+        auto rows = &values[event*group.nofCells];
+        for ( std::size_t c=0; c<group.nofCells; ++c ) cells[c] = float(rows[c]);
+      }
+    }
+  }
+
+  auto pdgs = dataset.ReadColumnAsInt(summaryTable, primaryColumns[0]);
+  auto energies = dataset.ReadColumnAsDouble(summaryTable, primaryColumns[1]);
+  auto posX = dataset.ReadColumnAsDouble(summaryTable, primaryColumns[2]);
+  auto posY = dataset.ReadColumnAsDouble(summaryTable, primaryColumns[3]);
+  if ( pdgs.size() != nofEvents || energies.size() != nofEvents
+       || posX.size() != nofEvents || posY.size() != nofEvents ) {
+    fCells.resize(firstEvent*eventSize);
+    return Fail(path, "cannot read the primary columns");
+  }
+  for ( std::size_t event=0; event<nofEvents; ++event ) {
+    Primary primary;
+    primary.pdg = pdgs[event];
+    primary.energy = energies[event];
+    primary.posX = posX[event];
+    primary.posY = posY[event];
+    fPrimaries.push_back(primary);
+  }
+  fPaths.push_back(path);
+
+  fOrder.resize(fPrimaries.size());
+  std::iota(fOrder.begin(), fOrder.end(), std::uint32_t(0));
+  std::sort(fOrder.begin(), fOrder.end(), [this](std::uint32_t a, std::uint32_t b) {
+    const auto& first = fPrimaries[a];
+    const auto& second = fPrimaries[b];
+    return first.pdg < second.pdg || ( first.pdg == second.pdg && first.energy < second.energy );
+  });
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void OverlayLibrary::Clear()
+{
+  fPaths.clear();
+  fPrimaries.clear();
+  fCells.clear();
+  fCells.shrink_to_fit();
+  fOrder.clear();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void OverlayLibrary::Find(G4int pdg, G4double energy, G4double energyTolerance,
+                          G4bool checkPosition, G4double posX, G4double posY,
+                          G4double positionTolerance,
+                          std::vector<std::uint32_t>& events) const
+{
+  events.clear();
+  auto minEnergy = (1. - energyTolerance)*energy/MeV;
+  auto maxEnergy = (1. + energyTolerance)*energy/MeV;
+  auto it = std::lower_bound(fOrder.begin(), fOrder.end(), minEnergy,
+    [this, pdg](std::uint32_t event, G4double value) {
+      const auto& primary = fPrimaries[event];
+      return primary.pdg < pdg || ( primary.pdg == pdg && primary.energy < value );
+    });
+  for ( ; it != fOrder.end(); ++it ) {
+    const auto& primary = fPrimaries[*it];
+    if ( primary.pdg != pdg || primary.energy > maxEnergy ) break;
+    if ( checkPosition
+         && std::hypot(primary.posX*cm - posX, primary.posY*cm - posY) > positionTolerance ) {
+      continue;
+    }
+    events.push_back(*it);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void OverlayLibrary::Add(const float* cells, G4double* sum)
+{
+  // One loop over the contiguous values of all cells and quantities, which
+  // the compiler vectorises
+  auto size = GetEventSize();
+  for ( std::size_t i=0; i<size; ++i ) sum[i] += cells[i];
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void OverlayLibrary::AddTo(const G4double* sum, EventRecord& record)
+{
+  auto nofCells = GetNumberOfCells();
+  auto add = [sum, nofCells](CellRecord& cell, std::size_t c) {
+    cell.edepActive      += sum[kEdepActive*nofCells + c];
+    cell.edepPi0Active   += sum[kEdepPi0Active*nofCells + c];
+    cell.edepAbsorber    += sum[kEdepAbsorber*nofCells + c];
+    cell.edepPi0Absorber += sum[kEdepPi0Absorber*nofCells + c];
+    cell.numPi0Active    += G4int(std::lround(sum[kNumPi0Active*nofCells + c]));
+    cell.numPi0Absorber  += G4int(std::lround(sum[kNumPi0Absorber*nofCells + c]));
+  };
+
+  // Same cell order as GetCellGroups()
+  std::size_t c = 0;
+  add(record.ecalTotal, c++);
+  add(record.hcalTotal, c++);
+  for ( auto& block : record.ecalBlocks ) add(block, c++);
+  for ( auto& tower : record.hcalTowers ) add(tower, c++);
+  for ( auto& tile : record.hcalTiles ) add(tile, c++);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,210 @@
+/// \file OverlayMessenger.cc
+/// \brief Implementation of the OverlayMessenger class
+
+#include "OverlayMessenger.hh"
+#include "OverlayConfig.hh"
+
+#include "G4UIdirectory.hh"
+#include "G4UIcommand.hh"
+#include "G4UIparameter.hh"
+#include "G4UIcmdWithAString.hh"
+#include "G4UIcmdWithABool.hh"
+#include "G4UIcmdWithoutParameter.hh"
+
+#include <sstream>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+OverlayMessenger::OverlayMessenger(OverlayConfig* config)
+ : G4UImessenger(),
+   fConfig(config)
+{
+  fOverlayDir = new G4UIdirectory("/ATHENA/overlay/");
+  fOverlayDir->SetGuidance("Overlay of simulated events from a library.");
+
+  fLibraryCmd = new G4UIcmdWithAString("/ATHENA/overlay/library", this);
+  fLibraryCmd->SetGuidance("Add the events of a columnar file or manifest (.acolset) to the");
+  fLibraryCmd->SetGuidance("library; it must be written with the cell tables. none removes");
+  fLibraryCmd->SetGuidance("all libraries.");
+  fLibraryCmd->SetParameterName("path", false);
+  fLibraryCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fLibraryCmd->SetToBeBroadcasted(false);
+
+  fAddCmd = new G4UIcommand("/ATHENA/overlay/add", this);
+  fAddCmd->SetGuidance("Overlay a library event of a particle in each event, e.g. pi+ 10 GeV;");
+  fAddCmd->SetGuidance("optionally at a transverse vertex position (* is any position) and");
+  fAddCmd->SetGuidance("with a time offset.");
+  auto particleParam = new G4UIparameter("particle", 's', false);
+  fAddCmd->SetParameter(particleParam);
+  auto energyParam = new G4UIparameter("energy", 'd', false);
+  energyParam->SetParameterRange("energy>0.");
+  fAddCmd->SetParameter(energyParam);
+  auto energyUnitParam = new G4UIparameter("energyUnit", 's', true);
+  energyUnitParam->SetDefaultUnit("GeV");
+  fAddCmd->SetParameter(energyUnitParam);
+  auto xParam = new G4UIparameter("x", 's', true);
+  xParam->SetDefaultValue("*");
+  fAddCmd->SetParameter(xParam);
+  auto yParam = new G4UIparameter("y", 's', true);
+  yParam->SetDefaultValue("*");
+  fAddCmd->SetParameter(yParam);
+  auto positionUnitParam = new G4UIparameter("positionUnit", 's', true);
+  positionUnitParam->SetDefaultUnit("cm");
+  fAddCmd->SetParameter(positionUnitParam);
+  auto timeParam = new G4UIparameter("time", 'd', true);
+  timeParam->SetDefaultValue(0.);
+  fAddCmd->SetParameter(timeParam);
+  auto timeUnitParam = new G4UIparameter("timeUnit", 's', true);
+  timeUnitParam->SetDefaultUnit("ns");
+  fAddCmd->SetParameter(timeUnitParam);
+  fAddCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fAddCmd->SetToBeBroadcasted(false);
+
+  fClearCmd = new G4UIcmdWithoutParameter("/ATHENA/overlay/clear", this);
+  fClearCmd->SetGuidance("Remove all overlaid particles.");
+  fClearCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fClearCmd->SetToBeBroadcasted(false);
+
+  fToleranceCmd = new G4UIcommand("/ATHENA/overlay/tolerance", this);
+  fToleranceCmd->SetGuidance("Relative energy and transverse distance within which the library");
+  fToleranceCmd->SetGuidance("events match an overlaid particle. Default: 0.01 0.5 cm");
+  auto energyFractionParam = new G4UIparameter("energyFraction", 'd', false);
+  energyFractionParam->SetParameterRange("energyFraction>=0. && energyFraction<1.");
+  fToleranceCmd->SetParameter(energyFractionParam);
+  auto distanceParam = new G4UIparameter("distance", 'd', false);
+  distanceParam->SetParameterRange("distance>=0.");
+  fToleranceCmd->SetParameter(distanceParam);
+  auto distanceUnitParam = new G4UIparameter("unit", 's', true);
+  distanceUnitParam->SetDefaultUnit("cm");
+  fToleranceCmd->SetParameter(distanceUnitParam);
+  fToleranceCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fToleranceCmd->SetToBeBroadcasted(false);
+
+  fPileupCmd = new G4UIcommand("/ATHENA/overlay/pileup", this);
+  fPileupCmd->SetGuidance("Mean number of pile-up events per event, drawn from the whole");
+  fPileupCmd->SetGuidance("library with a Poisson distribution, and the window of their time");
+  fPileupCmd->SetGuidance("offsets. 0 disables the pile-up (default). Default window: -100 100 ns");
+  auto meanParam = new G4UIparameter("mean", 'd', false);
+  meanParam->SetParameterRange("mean>=0.");
+  fPileupCmd->SetParameter(meanParam);
+  auto pileupMinParam = new G4UIparameter("min", 'd', true);
+  pileupMinParam->SetDefaultValue(-100.);
+  fPileupCmd->SetParameter(pileupMinParam);
+  auto pileupMaxParam = new G4UIparameter("max", 'd', true);
+  pileupMaxParam->SetDefaultValue(100.);
+  fPileupCmd->SetParameter(pileupMaxParam);
+  auto pileupUnitParam = new G4UIparameter("unit", 's', true);
+  pileupUnitParam->SetDefaultUnit("ns");
+  fPileupCmd->SetParameter(pileupUnitParam);
+  fPileupCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fPileupCmd->SetToBeBroadcasted(false);
+
+  fGateCmd = new G4UIcommand("/ATHENA/overlay/gate", this);
+  fGateCmd->SetGuidance("Readout gate: the library events with a time offset outside it");
+  fGateCmd->SetGuidance("are not added. Default: -50 50 ns");
+  auto gateMinParam = new G4UIparameter("min", 'd', false);
+  fGateCmd->SetParameter(gateMinParam);
+  auto gateMaxParam = new G4UIparameter("max", 'd', false);
+  fGateCmd->SetParameter(gateMaxParam);
+  auto gateUnitParam = new G4UIparameter("unit", 's', true);
+  gateUnitParam->SetDefaultUnit("ns");
+  fGateCmd->SetParameter(gateUnitParam);
+  fGateCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fGateCmd->SetToBeBroadcasted(false);
+
+  fSimulateCmd = new G4UIcmdWithABool("/ATHENA/overlay/simulate", this);
+  fSimulateCmd->SetGuidance("Simulate the primaries of the gun; with false the events are");
+  fSimulateCmd->SetGuidance("built from the library only. Default: true");
+  fSimulateCmd->SetParameterName("simulate", false);
+  fSimulateCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fSimulateCmd->SetToBeBroadcasted(false);
+
+  fPrintCmd = new G4UIcmdWithoutParameter("/ATHENA/overlay/print", this);
+  fPrintCmd->SetGuidance("Print the overlay configuration.");
+  fPrintCmd->SetToBeBroadcasted(false);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+OverlayMessenger::~OverlayMessenger()
+{
+  delete fLibraryCmd;
+  delete fAddCmd;
+  delete fClearCmd;
+  delete fToleranceCmd;
+  delete fPileupCmd;
+  delete fGateCmd;
+  delete fSimulateCmd;
+  delete fPrintCmd;
+  delete fOverlayDir;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void OverlayMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
+{
+  std::istringstream is(newValue);
+  if ( command == fLibraryCmd ) {
+    fConfig->AddLibrary(newValue);
+  }
+  else if ( command == fAddCmd ) {
+    OverlayConfig::Particle particle;
+    G4String energyUnit, x, y, positionUnit, timeUnit;
+    is >> particle.name >> particle.energy >> energyUnit >> x >> y >> positionUnit
+       >> particle.time >> timeUnit;
+    particle.energy *= G4UIcommand::ValueOf(energyUnit);
+    particle.time *= G4UIcommand::ValueOf(timeUnit);
+    particle.anyPosition = ( x == "*" || y == "*" );
+    if ( ! particle.anyPosition ) {
+      auto scale = G4UIcommand::ValueOf(positionUnit);
+      particle.posX = G4UIcommand::ConvertToDouble(x)*scale;
+      particle.posY = G4UIcommand::ConvertToDouble(y)*scale;
+    }
+    fConfig->AddParticle(particle);
+  }
+  else if ( command == fClearCmd ) {
+    fConfig->ClearParticles();
+  }
+  else if ( command == fToleranceCmd ) {
+    G4double energyFraction, distance;
+    G4String unit;
+    is >> energyFraction >> distance >> unit;
+    fConfig->SetTolerances(energyFraction, distance*G4UIcommand::ValueOf(unit));
+  }
+  else if ( command == fPileupCmd ) {
+    G4double mean, minTime, maxTime;
+    G4String unit;
+    is >> mean >> minTime >> maxTime >> unit;
+    auto scale = G4UIcommand::ValueOf(unit);
+    if ( maxTime < minTime ) {
+      G4ExceptionDescription msg;
+      msg << "The end of the pile-up window must not be before its start";
+      G4Exception("OverlayMessenger::SetNewValue()",
+        "MyCode0015", JustWarning, msg);
+      return;
+    }
+    fConfig->SetPileup(mean, minTime*scale, maxTime*scale);
+  }
+  else if ( command == fGateCmd ) {
+    G4double minTime, maxTime;
+    G4String unit;
+    is >> minTime >> maxTime >> unit;
+    auto scale = G4UIcommand::ValueOf(unit);
+    if ( maxTime < minTime ) {
+      G4ExceptionDescription msg;
+      msg << "The end of the readout gate must not be before its start";
+      G4Exception("OverlayMessenger::SetNewValue()",
+        "MyCode0015", JustWarning, msg);
+      return;
+    }
+    fConfig->SetGate(minTime*scale, maxTime*scale);
+  }
+  else if ( command == fSimulateCmd ) {
+    fConfig->SetSimulatePrimaries(fSimulateCmd->GetNewBoolValue(newValue));
+  }
+  else if ( command == fPrintCmd ) {
+    fConfig->Print();
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
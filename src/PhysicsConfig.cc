@@ -0,0 +1,100 @@
+/// \file PhysicsConfig.cc
+/// \brief Implementation of the PhysicsConfig class
+
+#include "PhysicsConfig.hh"
+#include "PhysicsMessenger.hh"
+
+#include "G4ios.hh"
+
+PhysicsConfig* PhysicsConfig::fInstance = nullptr;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+PhysicsConfig* PhysicsConfig::Instance()
+{
+  // The instance is created on the master with the physics list,
+  // before any worker thread is started
+  if ( ! fInstance ) {
+    fInstance = new PhysicsConfig();
+  }
+  return fInstance;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+PhysicsConfig::PhysicsConfig()
+ : fMessenger(nullptr),
+   fPhysicsList("QGSP_BERT"),
+   fEmOption("opt0"),
+   fFastSimulation(false),
+   fGammaGeneralProcess(false),
+   fWoodcockRegion(),
+   fTableCache()
+{
+  fMessenger = new PhysicsMessenger(this);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+PhysicsConfig::~PhysicsConfig()
+{
+  delete fMessenger;
+  fInstance = nullptr;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void PhysicsConfig::SetPhysicsList(const G4String& name)
+{
+  fPhysicsList = name;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void PhysicsConfig::SetEmOption(const G4String& option)
+{
+  fEmOption = option;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void PhysicsConfig::SetFastSimulation(G4bool active)
+{
+  fFastSimulation = active;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void PhysicsConfig::SetGammaGeneralProcess(G4bool active)
+{
+  fGammaGeneralProcess = active;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void PhysicsConfig::SetWoodcockRegion(const G4String& regionName)
+{
+  fWoodcockRegion = ( regionName == "none" ) ? G4String() : regionName;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void PhysicsConfig::SetTableCache(const G4String& directory)
+{
+  fTableCache = ( directory == "none" ) ? G4String() : directory;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void PhysicsConfig::Print() const
+{
+  G4cout << "---> Physics: " << fPhysicsList << ", EM " << fEmOption
+         << ", fast simulation " << ( fFastSimulation ? "on" : "off" )
+         << ", gamma general process "
+         << ( IsGammaGeneralProcess() ? "on" : "off" ) << ", Woodcock tracking "
+         << ( fWoodcockRegion.empty() ? G4String("off") : "in " + fWoodcockRegion )
+         << ", table cache " << ( fTableCache.empty() ? G4String("off") : fTableCache )
+         << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
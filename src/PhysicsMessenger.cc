@@ -0,0 +1,80 @@
+/// \file PhysicsMessenger.cc
+/// \brief Implementation of the PhysicsMessenger class
+
+#include "PhysicsMessenger.hh"
+#include "PhysicsConfig.hh"
+
+#include "G4UIdirectory.hh"
+#include "G4UIcmdWithABool.hh"
+#include "G4UIcmdWithAString.hh"
+#include "G4UIcmdWithoutParameter.hh"
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+PhysicsMessenger::PhysicsMessenger(PhysicsConfig* config)
+ : G4UImessenger(),
+   fConfig(config)
+{
+  fPhysicsDir = new G4UIdirectory("/ATHENA/physics/");
+  fPhysicsDir->SetGuidance("Physics list options, applied at /run/initialize.");
+
+  fGammaGeneralCmd = new G4UIcmdWithABool("/ATHENA/physics/gammaGeneral", this);
+  fGammaGeneralCmd->SetGuidance("Combine the photon processes in a G4GammaGeneralProcess.");
+  fGammaGeneralCmd->SetGuidance("Default: false");
+  fGammaGeneralCmd->SetParameterName("active", false);
+  fGammaGeneralCmd->AvailableForStates(G4State_PreInit);
+  fGammaGeneralCmd->SetToBeBroadcasted(false);
+
+  fWoodcockCmd = new G4UIcmdWithAString("/ATHENA/physics/woodcock", this);
+  fWoodcockCmd->SetGuidance("Woodcock tracking of the photons in a detector region,");
+  fWoodcockCmd->SetGuidance("by default the ECal blocks (ECalPowder); none disables it.");
+  fWoodcockCmd->SetGuidance("Enables the gamma general process.");
+  fWoodcockCmd->SetParameterName("region", true);
+  fWoodcockCmd->SetDefaultValue("ECalPowder");
+  fWoodcockCmd->AvailableForStates(G4State_PreInit);
+  fWoodcockCmd->SetToBeBroadcasted(false);
+
+  fTableCacheCmd = new G4UIcmdWithAString("/ATHENA/physics/tableCache", this);
+  fTableCacheCmd->SetGuidance("Directory of the physics table cache: the tables are stored");
+  fTableCacheCmd->SetGuidance("per physics list, cuts and materials when they are built, and");
+  fTableCacheCmd->SetGuidance("retrieved by the later jobs with the same settings.");
+  fTableCacheCmd->SetGuidance("none disables the cache (default).");
+  fTableCacheCmd->SetParameterName("directory", false);
+  fTableCacheCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fTableCacheCmd->SetToBeBroadcasted(false);
+
+  fPrintCmd = new G4UIcmdWithoutParameter("/ATHENA/physics/print", this);
+  fPrintCmd->SetGuidance("Print the physics list options.");
+  fPrintCmd->SetToBeBroadcasted(false);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+PhysicsMessenger::~PhysicsMessenger()
+{
+  delete fGammaGeneralCmd;
+  delete fWoodcockCmd;
+  delete fTableCacheCmd;
+  delete fPrintCmd;
+  delete fPhysicsDir;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void PhysicsMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
+{
+  if ( command == fGammaGeneralCmd ) {
+    fConfig->SetGammaGeneralProcess(fGammaGeneralCmd->GetNewBoolValue(newValue));
+  }
+  else if ( command == fWoodcockCmd ) {
+    fConfig->SetWoodcockRegion(newValue);
+  }
+  else if ( command == fTableCacheCmd ) {
+    fConfig->SetTableCache(newValue);
+  }
+  else if ( command == fPrintCmd ) {
+    fConfig->Print();
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
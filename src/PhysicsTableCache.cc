@@ -0,0 +1,207 @@
+/// \file PhysicsTableCache.cc
+/// \brief Implementation of the PhysicsTableCache class
+
+#include "PhysicsTableCache.hh"
+#include "PhysicsConfig.hh"
+
+#include "G4VUserPhysicsList.hh"
+#include "G4StateManager.hh"
+#include "G4EmParameters.hh"
+#include "G4Region.hh"
+#include "G4RegionStore.hh"
+#include "G4ProductionCuts.hh"
+#include "G4Material.hh"
+#include "G4Element.hh"
+#include "G4Version.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4ios.hh"
+
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+#include <sys/stat.h>
+
+namespace
+{
+  const char* kKeyFileName = "key.txt";
+
+  // 64-bit FNV-1a hash, stable across platforms and builds
+  std::uint64_t Hash(const std::string& text)
+  {
+    std::uint64_t hash = 14695981039346656037ull;
+    for ( auto c : text ) {
+      hash ^= std::uint8_t(c);
+      hash *= 1099511628211ull;
+    }
+    return hash;
+  }
+
+  std::string ReadFile(const G4String& fileName)
+  {
+    std::ifstream file(fileName);
+    std::ostringstream content;
+    content << file.rdbuf();
+    return file ? content.str() : std::string();
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+PhysicsTableCache::PhysicsTableCache(G4VUserPhysicsList* physicsList)
+ : G4VStateDependent(),
+   fPhysicsList(physicsList),
+   fBuilding(false),
+   fRetrieved(false),
+   fDirectory(),
+   fKey(),
+   fTimer()
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+PhysicsTableCache::~PhysicsTableCache()
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool PhysicsTableCache::Notify(G4ApplicationState requestedState)
+{
+  // The tables are built between these two transitions at the beginning
+  // of each run; /run/initialize goes from PreInit to Init without them
+  auto currentState = G4StateManager::GetStateManager()->GetCurrentState();
+  if ( currentState == G4State_Idle && requestedState == G4State_Init ) {
+    BeginBuild();
+  }
+  else if ( currentState == G4State_Init && requestedState == G4State_Idle && fBuilding ) {
+    EndBuild();
+  }
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void PhysicsTableCache::BeginBuild()
+{
+  // The tables are only rebuilt when the cuts have changed since the
+  // previous run
+  auto key = MakeKey();
+  fBuilding = ( key != fKey );
+  if ( ! fBuilding ) return;
+
+  fKey = key;
+  fRetrieved = false;
+  fDirectory = "";
+  const auto& cache = PhysicsConfig::Instance()->GetTableCache();
+  if ( ! cache.empty() ) {
+    char hash[17];
+    std::snprintf(hash, sizeof(hash), "%016llx", (unsigned long long)Hash(fKey));
+    fDirectory = cache + "/" + hash;
+
+    fRetrieved = ( ReadFile(fDirectory + "/" + kKeyFileName) == fKey );
+    if ( fRetrieved ) {
+      fPhysicsList->SetPhysicsTableRetrieved(fDirectory);
+    }
+    else {
+      fPhysicsList->ResetPhysicsTableRetrieved();
+    }
+  }
+  fTimer.Start();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void PhysicsTableCache::EndBuild()
+{
+  fBuilding = false;
+  fTimer.Stop();
+  if ( fRetrieved ) {
+    G4cout << "---> Physics tables: retrieved from " << fDirectory << " in "
+           << fTimer.GetRealElapsed() << " s" << G4endl;
+    return;
+  }
+
+  G4cout << "---> Physics tables: built in " << fTimer.GetRealElapsed() << " s";
+  if ( fDirectory.empty() ) {
+    G4cout << G4endl;
+    return;
+  }
+
+  // The key is removed first and written last, so that an entry is only
+  // valid once all its tables are stored
+  mkdir(PhysicsConfig::Instance()->GetTableCache().c_str(), 0755);
+  mkdir(fDirectory.c_str(), 0755);
+  auto keyFileName = fDirectory + "/" + kKeyFileName;
+  std::remove(keyFileName.c_str());
+  G4Timer storeTimer;
+  storeTimer.Start();
+  G4bool stored = fPhysicsList->StorePhysicsTable(fDirectory);
+  storeTimer.Stop();
+  if ( stored ) {
+    std::ofstream keyFile(keyFileName);
+    keyFile << fKey;
+    stored = bool(keyFile);
+  }
+  if ( ! stored ) {
+    G4cout << G4endl;
+    G4ExceptionDescription msg;
+    msg << "Cannot store the physics tables in " << fDirectory;
+    G4Exception("PhysicsTableCache::EndBuild()",
+      "MyCode0014", JustWarning, msg);
+    return;
+  }
+  G4cout << ", stored in " << fDirectory << " in " << storeTimer.GetRealElapsed()
+         << " s" << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+std::string PhysicsTableCache::MakeKey() const
+{
+  std::ostringstream key;
+  key << std::setprecision(17);
+
+  auto config = PhysicsConfig::Instance();
+  key << G4Version << "\n"
+      << "physics list " << config->GetPhysicsList() << ", EM " << config->GetEmOption()
+      << ", gamma general process " << config->IsGammaGeneralProcess()
+      << ", Woodcock region " << config->GetWoodcockRegion() << "\n"
+      << *G4EmParameters::Instance();
+
+  // The regions without cuts of their own take those of their parent
+  // when the couples are updated
+  for ( auto region : *G4RegionStore::GetInstance() ) {
+    key << "region " << region->GetName() << ":";
+    auto cuts = region->GetProductionCuts();
+    if ( cuts ) {
+      for ( const auto& particle : { "gamma", "e-", "e+", "proton" } ) {
+        key << " " << particle << " " << cuts->GetProductionCut(particle)/mm << " mm";
+      }
+    }
+    else {
+      key << " inherited";
+    }
+    key << "\n";
+  }
+
+  for ( auto material : *G4Material::GetMaterialTable() ) {
+    key << "material " << material->GetName()
+        << ": density " << material->GetDensity()/(g/cm3) << " g/cm3"
+        << ", state " << material->GetState()
+        << ", temperature " << material->GetTemperature()/kelvin << " K"
+        << ", pressure " << material->GetPressure()/pascal << " Pa"
+        << ", I " << material->GetIonisation()->GetMeanExcitationEnergy()/eV << " eV";
+    auto fractions = material->GetFractionVector();
+    for ( std::size_t i=0; i<material->GetNumberOfElements(); ++i ) {
+      auto element = material->GetElement(G4int(i));
+      key << ", " << element->GetName() << " (Z " << element->GetZ()
+          << ", A " << element->GetA()/(g/mole) << ") " << fractions[i];
+    }
+    key << "\n";
+  }
+  return key.str();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -3,6 +3,9 @@
 /// \brief Implementation of the PrimaryGeneratorAction class
 
 #include "PrimaryGeneratorAction.hh"
+#include "OverlayConfig.hh"
+#include "ShardConfig.hh"
+#include "RandomConfig.hh"
 #include "G4RunManager.hh"
 #include "G4LogicalVolumeStore.hh"
 #include "G4LogicalVolume.hh"
@@ -42,6 +45,18 @@ void PrimaryGeneratorAction::GeneratePrimaries(G4Event* anEvent)
 {
   // This function is called at the begining of event
 
+  // The eventIDs of a shard follow those of the previous shards, a
+  // replayed event gets its eventID, and the engine is reseeded before
+  // any random number of the event is drawn
+  auto randomConfig = RandomConfig::Instance();
+  auto eventID = anEvent->GetEventID() + ShardConfig::Instance()->GetFirstEvent();
+  if ( randomConfig->GetReplayEvent() >= 0 ) eventID = randomConfig->GetReplayEvent();
+  anEvent->SetEventID(eventID);
+  randomConfig->SeedEvent(eventID);
+
+  // The events of a library-only overlay have no primary
+  if ( ! OverlayConfig::Instance()->IsSimulatingPrimaries() ) return;
+
   G4double worldZHalfLength = 0.;
   auto worldLV = G4LogicalVolumeStore::GetInstance()->GetVolume("WorldLogical");
 
@@ -0,0 +1,125 @@
+/// \file RandomConfig.cc
+/// \brief Implementation of the RandomConfig class
+
+#include "RandomConfig.hh"
+#include "RandomMessenger.hh"
+
+#include "G4RunManager.hh"
+#include "G4ios.hh"
+#include "Randomize.hh"
+
+#include <chrono>
+#include <cstdint>
+
+RandomConfig* RandomConfig::fInstance = nullptr;
+
+namespace
+{
+  // SplitMix64 finaliser: consecutive inputs give uncorrelated outputs
+  std::uint64_t Mix(std::uint64_t value)
+  {
+    value += 0x9e3779b97f4a7c15ULL;
+    value = (value ^ (value >> 30))*0xbf58476d1ce4e5b9ULL;
+    value = (value ^ (value >> 27))*0x94d049bb133111ebULL;
+    return value ^ (value >> 31);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+RandomConfig* RandomConfig::Instance()
+{
+  // The instance is created on the master with the RunAction,
+  // before any worker thread is started
+  if ( ! fInstance ) {
+    fInstance = new RandomConfig();
+  }
+  return fInstance;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+RandomConfig::RandomConfig()
+ : fMessenger(nullptr),
+   fSeed(1),
+   fEventSeeding(false),
+   fReplayEvent(-1)
+{
+  fMessenger = new RandomMessenger(this);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+RandomConfig::~RandomConfig()
+{
+  delete fMessenger;
+  fInstance = nullptr;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void RandomConfig::GetEventSeeds(G4long runSeed, G4int eventID, long seeds[2])
+{
+  auto hash = Mix(Mix(std::uint64_t(runSeed)) ^ std::uint64_t(std::uint32_t(eventID)));
+  // A zero seed would end the list given to the engine
+  seeds[0] = long((hash & 0xffffffffULL) % 0x7fffffffULL) + 1;
+  seeds[1] = long((hash >> 32) % 0x7fffffffULL) + 1;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void RandomConfig::SeedEvent(G4int eventID) const
+{
+  if ( ! fEventSeeding ) return;
+
+  long seeds[3] = { 0, 0, 0 };
+  GetEventSeeds(fSeed, eventID, seeds);
+  G4Random::setTheSeeds(seeds);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void RandomConfig::Replay(G4int eventID)
+{
+  long seeds[2];
+  GetEventSeeds(fSeed, eventID, seeds);
+  G4cout << "---> Replay of event " << eventID << " of run seed " << fSeed
+         << ", seeds " << seeds[0] << " " << seeds[1] << G4endl;
+
+  // Only the seeds of the eventID reproduce the event
+  auto eventSeeding = fEventSeeding;
+  fEventSeeding = true;
+  fReplayEvent = eventID;
+  auto start = std::chrono::steady_clock::now();
+  G4RunManager::GetRunManager()->BeamOn(1);
+  std::chrono::duration<G4double> time = std::chrono::steady_clock::now() - start;
+  fReplayEvent = -1;
+  fEventSeeding = eventSeeding;
+
+  G4cout << "---> Replay of event " << eventID << " in " << time.count() << " s" << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4String RandomConfig::GetOutputSuffix() const
+{
+  // The files of the run that is replayed are kept
+  if ( fReplayEvent < 0 ) return "";
+  return "_event" + std::to_string(fReplayEvent);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void RandomConfig::Print() const
+{
+  G4cout << "---> Random: ";
+  if ( fEventSeeding ) {
+    G4cout << "per-event seeds from run seed " << fSeed;
+  }
+  else {
+    G4cout << "seeds of the run manager";
+  }
+  G4cout << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
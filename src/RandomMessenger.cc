@@ -0,0 +1,85 @@
+/// \file RandomMessenger.cc
+/// \brief Implementation of the RandomMessenger class
+
+#include "RandomMessenger.hh"
+#include "RandomConfig.hh"
+
+#include "G4UIdirectory.hh"
+#include "G4UIcmdWithAnInteger.hh"
+#include "G4UIcmdWithABool.hh"
+#include "G4UIcmdWithoutParameter.hh"
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+RandomMessenger::RandomMessenger(RandomConfig* config)
+ : G4UImessenger(),
+   fConfig(config)
+{
+  fRandomDir = new G4UIdirectory("/ATHENA/random/");
+  fRandomDir->SetGuidance("Seeding of the random engine.");
+
+  fSeedCmd = new G4UIcmdWithAnInteger("/ATHENA/random/seed", this);
+  fSeedCmd->SetGuidance("Run seed from which the seeds of each event are derived, with");
+  fSeedCmd->SetGuidance("per-event seeding. Default: 1");
+  fSeedCmd->SetParameterName("seed", false);
+  fSeedCmd->SetRange("seed>=0");
+  fSeedCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fSeedCmd->SetToBeBroadcasted(false);
+
+  fEventSeedingCmd = new G4UIcmdWithABool("/ATHENA/random/eventSeeding", this);
+  fEventSeedingCmd->SetGuidance("Reseed the engine at the beginning of each event with seeds");
+  fEventSeedingCmd->SetGuidance("derived from the run seed and the eventID, so that the events");
+  fEventSeedingCmd->SetGuidance("do not depend on the threads and can be replayed. The runs of a");
+  fEventSeedingCmd->SetGuidance("job then need different run seeds, as the eventIDs restart at 0.");
+  fEventSeedingCmd->SetGuidance("Always on in /ATHENA/shard/beamOn and /ATHENA/random/replay.");
+  fEventSeedingCmd->SetGuidance("Default: false (seeds of the run manager, /random/setSeeds)");
+  fEventSeedingCmd->SetParameterName("eventSeeding", false);
+  fEventSeedingCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fEventSeedingCmd->SetToBeBroadcasted(false);
+
+  fReplayCmd = new G4UIcmdWithAnInteger("/ATHENA/random/replay", this);
+  fReplayCmd->SetGuidance("Simulate again the event of an eventID of a run with per-event seeding");
+  fReplayCmd->SetGuidance("or of a shard run, after /run/initialize and with the run seed and");
+  fReplayCmd->SetGuidance("settings of its run, e.g. with the visualisation");
+  fReplayCmd->SetGuidance("or the step output (/ATHENA/output/steps/prescale 1). The files are");
+  fReplayCmd->SetGuidance("written with the _event<eventID> suffix.");
+  fReplayCmd->SetParameterName("eventID", false);
+  fReplayCmd->SetRange("eventID>=0");
+  fReplayCmd->AvailableForStates(G4State_Idle);
+  fReplayCmd->SetToBeBroadcasted(false);
+
+  fPrintCmd = new G4UIcmdWithoutParameter("/ATHENA/random/print", this);
+  fPrintCmd->SetGuidance("Print the seeding configuration.");
+  fPrintCmd->SetToBeBroadcasted(false);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+RandomMessenger::~RandomMessenger()
+{
+  delete fSeedCmd;
+  delete fEventSeedingCmd;
+  delete fReplayCmd;
+  delete fPrintCmd;
+  delete fRandomDir;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void RandomMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
+{
+  if ( command == fSeedCmd ) {
+    fConfig->SetSeed(fSeedCmd->GetNewIntValue(newValue));
+  }
+  else if ( command == fEventSeedingCmd ) {
+    fConfig->SetEventSeeding(fEventSeedingCmd->GetNewBoolValue(newValue));
+  }
+  else if ( command == fReplayCmd ) {
+    fConfig->Replay(fReplayCmd->GetNewIntValue(newValue));
+  }
+  else if ( command == fPrintCmd ) {
+    fConfig->Print();
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,187 @@
+/// \file RegionConfig.cc
+/// \brief Implementation of the RegionConfig class
+
+#include "RegionConfig.hh"
+#include "RegionMessenger.hh"
+
+#include "G4Region.hh"
+#include "G4RegionStore.hh"
+#include "G4ProductionCuts.hh"
+#include "G4LogicalVolume.hh"
+#include "G4LogicalVolumeStore.hh"
+#include "G4UserLimits.hh"
+#include "G4ios.hh"
+#include "G4UnitsTable.hh"
+
+#include <algorithm>
+#include <limits>
+
+RegionConfig* RegionConfig::fInstance = nullptr;
+
+namespace
+{
+  // Geant4 name of the region of the world volume
+  const G4String kDefaultRegionName = "DefaultRegionForTheWorld";
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+RegionConfig* RegionConfig::Instance()
+{
+  // The instance is created on the master with the DetectorConstruction,
+  // before any worker thread is started
+  if ( ! fInstance ) {
+    fInstance = new RegionConfig();
+  }
+  return fInstance;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+RegionConfig::RegionConfig()
+ : fMessenger(nullptr),
+   fCuts(GetRegionNames().size(), -1.),
+   fStepLimits(GetRegionNames().size(), 0.),
+   fUserLimits(GetRegionNames().size(), nullptr)
+{
+  fMessenger = new RegionMessenger(this);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+RegionConfig::~RegionConfig()
+{
+  // The user limits stay attached to the logical volumes
+  delete fMessenger;
+  fInstance = nullptr;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+const std::vector<G4String>& RegionConfig::GetRegionNames()
+{
+  static const std::vector<G4String> names
+    = { "ECalFibers", "ECalPowder", "HCalAbsorber", "HCalScintillator", "World" };
+  return names;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4int RegionConfig::GetRegionId(const G4String& regionName)
+{
+  const auto& names = GetRegionNames();
+  auto it = std::find(names.begin(), names.end(), regionName);
+  return ( it != names.end() ) ? G4int(it - names.begin()) : -1;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void RegionConfig::SetCut(const G4String& regionName, G4double cut)
+{
+  auto id = GetRegionId(regionName);
+  if ( id < 0 ) return;
+  fCuts[id] = cut;
+  Apply();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void RegionConfig::SetStepLimit(const G4String& regionName, G4double stepLimit)
+{
+  auto id = GetRegionId(regionName);
+  if ( id < 0 ) return;
+  fStepLimits[id] = stepLimit;
+  Apply();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double RegionConfig::GetCut(const G4String& regionName) const
+{
+  auto id = GetRegionId(regionName);
+  return ( id >= 0 ) ? fCuts[id] : -1.;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double RegionConfig::GetStepLimit(const G4String& regionName) const
+{
+  auto id = GetRegionId(regionName);
+  return ( id >= 0 ) ? fStepLimits[id] : 0.;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4Region* RegionConfig::GetRegion(G4int id) const
+{
+  const auto& name = GetRegionNames()[id];
+  return G4RegionStore::GetInstance()->GetRegion(
+           ( name == "World" ) ? kDefaultRegionName : name, false);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void RegionConfig::Apply()
+{
+  auto defaultRegion = G4RegionStore::GetInstance()->GetRegion(kDefaultRegionName, false);
+
+  for ( G4int id=0; id<G4int(GetRegionNames().size()); ++id ) {
+    auto region = GetRegion(id);
+    if ( ! region ) continue;
+
+    if ( fCuts[id] > 0. ) {
+      // The regions without cuts share those of the default region
+      auto cuts = region->GetProductionCuts();
+      if ( ! cuts
+           || ( region != defaultRegion && defaultRegion
+                && cuts == defaultRegion->GetProductionCuts() ) ) {
+        cuts = new G4ProductionCuts();
+        region->SetProductionCuts(cuts);
+      }
+      cuts->SetProductionCut(fCuts[id]);
+    }
+
+    ApplyStepLimit(id, region);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void RegionConfig::ApplyStepLimit(G4int id, G4Region* region)
+{
+  auto maxStep = ( fStepLimits[id] > 0. ) ? fStepLimits[id]
+                                          : std::numeric_limits<G4double>::max();
+  if ( ! fUserLimits[id] ) {
+    if ( fStepLimits[id] <= 0. ) return;
+    fUserLimits[id] = new G4UserLimits(maxStep);
+  }
+  fUserLimits[id]->SetMaxAllowedStep(maxStep);
+
+  // The world volume is attached to the default region only when the
+  // run manager sets up the world, after the construction
+  auto world = ( GetRegionNames()[id] == "World" );
+  for ( auto volume : *G4LogicalVolumeStore::GetInstance() ) {
+    auto volumeRegion = volume->GetRegion();
+    if ( volumeRegion != region && ! ( world && ! volumeRegion ) ) continue;
+    if ( volume->GetUserLimits() && volume->GetUserLimits() != fUserLimits[id] ) continue;
+    volume->SetUserLimits(fUserLimits[id]);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void RegionConfig::Print() const
+{
+  G4cout << "---> Region configuration:" << G4endl;
+  for ( G4int id=0; id<G4int(GetRegionNames().size()); ++id ) {
+    G4cout << "       " << GetRegionNames()[id] << ": cut ";
+    if ( fCuts[id] > 0. ) G4cout << G4BestUnit(fCuts[id], "Length");
+    else                  G4cout << "global";
+    G4cout << ", step limit ";
+    if ( fStepLimits[id] > 0. ) G4cout << G4BestUnit(fStepLimits[id], "Length");
+    else                        G4cout << "none";
+    G4cout << G4endl;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,93 @@
+/// \file RegionMessenger.cc
+/// \brief Implementation of the RegionMessenger class
+
+#include "RegionMessenger.hh"
+#include "RegionConfig.hh"
+
+#include "G4UIdirectory.hh"
+#include "G4UIcommand.hh"
+#include "G4UIparameter.hh"
+#include "G4UIcmdWithoutParameter.hh"
+
+#include <sstream>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+RegionMessenger::RegionMessenger(RegionConfig* config)
+ : G4UImessenger(),
+   fConfig(config)
+{
+  fRegionsDir = new G4UIdirectory("/ATHENA/regions/");
+  fRegionsDir->SetGuidance("Production cuts and step limits of the detector regions.");
+
+  G4String candidates;
+  for ( const auto& name : RegionConfig::GetRegionNames() ) {
+    if ( ! candidates.empty() ) candidates += " ";
+    candidates += name;
+  }
+
+  fCutCmd = new G4UIcommand("/ATHENA/regions/cut", this);
+  fCutCmd->SetGuidance("Production cut of a region for gammas, electrons, positrons");
+  fCutCmd->SetGuidance("and protons. The regions without a cut keep the global cut");
+  fCutCmd->SetGuidance("(/run/setCut); the World cut is the global cut.");
+  auto regionParam = new G4UIparameter("region", 's', false);
+  regionParam->SetParameterCandidates(candidates);
+  fCutCmd->SetParameter(regionParam);
+  auto cutParam = new G4UIparameter("cut", 'd', false);
+  cutParam->SetParameterRange("cut>0.");
+  fCutCmd->SetParameter(cutParam);
+  auto cutUnitParam = new G4UIparameter("unit", 's', true);
+  cutUnitParam->SetDefaultUnit("mm");
+  fCutCmd->SetParameter(cutUnitParam);
+  fCutCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fCutCmd->SetToBeBroadcasted(false);
+
+  fStepLimitCmd = new G4UIcommand("/ATHENA/regions/stepLimit", this);
+  fStepLimitCmd->SetGuidance("Maximum step length in the volumes of a region, for the");
+  fStepLimitCmd->SetGuidance("charged particles. 0 removes the limit (default).");
+  auto limitRegionParam = new G4UIparameter("region", 's', false);
+  limitRegionParam->SetParameterCandidates(candidates);
+  fStepLimitCmd->SetParameter(limitRegionParam);
+  auto limitParam = new G4UIparameter("limit", 'd', false);
+  limitParam->SetParameterRange("limit>=0.");
+  fStepLimitCmd->SetParameter(limitParam);
+  auto limitUnitParam = new G4UIparameter("unit", 's', true);
+  limitUnitParam->SetDefaultUnit("mm");
+  fStepLimitCmd->SetParameter(limitUnitParam);
+  fStepLimitCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fStepLimitCmd->SetToBeBroadcasted(false);
+
+  fPrintCmd = new G4UIcmdWithoutParameter("/ATHENA/regions/print", this);
+  fPrintCmd->SetGuidance("Print the region configuration.");
+  fPrintCmd->SetToBeBroadcasted(false);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+RegionMessenger::~RegionMessenger()
+{
+  delete fCutCmd;
+  delete fStepLimitCmd;
+  delete fPrintCmd;
+  delete fRegionsDir;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void RegionMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
+{
+  if ( command == fCutCmd || command == fStepLimitCmd ) {
+    std::istringstream is(newValue);
+    G4String region, unit;
+    G4double value;
+    is >> region >> value >> unit;
+    value *= G4UIcommand::ValueOf(unit);
+    if ( command == fCutCmd ) fConfig->SetCut(region, value);
+    else                      fConfig->SetStepLimit(region, value);
+  }
+  else if ( command == fPrintCmd ) {
+    fConfig->Print();
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,175 @@
+/// \file ResolutionScan.cc
+/// \brief Implementation of the ResolutionScan class
+
+#include "ResolutionScan.hh"
+#include "AnalysisConfig.hh"
+#include "EventRecord.hh"
+#include "GlobalValues.hh"
+
+#include "G4SystemOfUnits.hh"
+
+#include <cmath>
+#include <cstdio>
+
+using namespace GlobalValues;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+ResolutionScan::ResolutionScan()
+ : fTailVeto(1.),
+   fTileCut(0.),
+   fNofBins(0),
+   fMaxEnergy(0.)
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ResolutionScan::Configure()
+{
+  auto config = AnalysisConfig::Instance();
+  fWeights = config->GetWeights();
+  fTailVeto = config->GetTailVeto();
+  fTileCut = config->GetTileCut();
+  fNofBins = config->GetNofEnergyBins();
+  fMaxEnergy = config->GetMaxEnergy();
+
+  fTotal = Moments();
+  fTotalVetoed = Moments();
+  fWeighted.assign(fWeights.size(), Moments());
+  fVetoed.assign(fWeights.size(), Moments());
+  fTotalHistogram.assign(fNofBins + 2, 0.);
+  fHistograms.assign(fWeights.size(), fTotalHistogram);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ResolutionScan::FillHistogram(std::vector<G4double>& histogram, G4double energy) const
+{
+  G4int bin = 0;
+  if ( energy >= fMaxEnergy ) bin = fNofBins + 1;
+  else if ( energy >= 0. ) bin = 1 + G4int(energy/fMaxEnergy*fNofBins);
+  histogram[bin] += 1.;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ResolutionScan::Fill(const EventRecord& record)
+{
+  // HCal and tail catcher from the tiles above the cut
+  G4double hcal = 0.;
+  G4double tail = 0.;
+  for ( std::size_t tower=0; tower<record.hcalTowers.size(); ++tower ) {
+    for ( G4int k=0; k<NumHCalLayers; ++k ) {
+      auto edep = record.hcalTiles[tower*NumHCalLayers + k].edepActive;
+      if ( edep < fTileCut ) continue;
+      hcal += edep;
+      if ( k >= NumHCalLayers - NumTailCatcherLayers ) tail += edep;
+    }
+  }
+  auto ecal = record.ecalTotal.edepActive;
+
+  // The veto is applied on the fraction of the (weighted) total energy
+  auto passVeto = [this, tail](G4double total) {
+    auto fraction = ( total != 0. ) ? tail/total : 1.;
+    return fraction < fTailVeto || fTailVeto >= 1.;
+  };
+
+  auto total = ecal + hcal;
+  fTotal.Add(total);
+  if ( passVeto(total) ) {
+    fTotalVetoed.Add(total);
+    FillHistogram(fTotalHistogram, total);
+  }
+
+  for ( std::size_t i=0; i<fWeights.size(); ++i ) {
+    auto weighted = ecal/fWeights[i] + hcal;
+    fWeighted[i].Add(weighted);
+    if ( passVeto(weighted) ) {
+      fVetoed[i].Add(weighted);
+      FillHistogram(fHistograms[i], weighted);
+    }
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool ResolutionScan::Merge(const ResolutionScan& other)
+{
+  if ( other.fWeights != fWeights || other.fNofBins != fNofBins
+       || other.fMaxEnergy != fMaxEnergy ) return false;
+
+  fTotal.Merge(other.fTotal);
+  fTotalVetoed.Merge(other.fTotalVetoed);
+  for ( std::size_t i=0; i<fWeights.size(); ++i ) {
+    fWeighted[i].Merge(other.fWeighted[i]);
+    fVetoed[i].Merge(other.fVetoed[i]);
+    for ( std::size_t bin=0; bin<fHistograms[i].size(); ++bin ) {
+      fHistograms[i][bin] += other.fHistograms[i][bin];
+    }
+  }
+  for ( std::size_t bin=0; bin<fTotalHistogram.size(); ++bin ) {
+    fTotalHistogram[bin] += other.fTotalHistogram[bin];
+  }
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4int ResolutionScan::GetOptimalWeightIndex() const
+{
+  G4int optimal = -1;
+  for ( std::size_t i=0; i<fVetoed.size(); ++i ) {
+    if ( fVetoed[i].n < 2. ) continue;
+    if ( optimal < 0
+         || fVetoed[i].GetResolution() < fVetoed[optimal].GetResolution() ) {
+      optimal = G4int(i);
+    }
+  }
+  return optimal;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+std::vector<ColumnarFormat::Histogram> ResolutionScan::GetHistograms() const
+{
+  std::vector<double> binning = { double(fNofBins), 0., fMaxEnergy/MeV };
+  std::vector<ColumnarFormat::Histogram> histograms;
+  histograms.push_back({ "Edep_Total", binning, fTotalHistogram });
+  for ( std::size_t i=0; i<fWeights.size(); ++i ) {
+    char name[64];
+    std::snprintf(name, sizeof(name), "Edep_Weighted_%.3f", fWeights[i]);
+    histograms.push_back({ name, binning, fHistograms[i] });
+  }
+  return histograms;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ResolutionScan::Print() const
+{
+  if ( fTotal.n == 0. ) return;
+
+  G4cout << "---> Resolution scan: " << fTotal.n << " events, "
+         << fTotalVetoed.n << " after the tail-catcher veto" << G4endl
+         << "       unweighted: mean " << fTotalVetoed.mean/MeV << " MeV, sigma "
+         << fTotalVetoed.GetSigma()/MeV << " MeV, resolution "
+         << fTotalVetoed.GetResolution()
+         << " (" << fTotal.GetResolution() << " without veto)" << G4endl
+         << "       weight      events   mean [MeV]  sigma [MeV]  resolution" << G4endl;
+
+  auto optimal = GetOptimalWeightIndex();
+  for ( std::size_t i=0; i<fWeights.size(); ++i ) {
+    char line[128];
+    std::snprintf(line, sizeof(line), "       %6.3f  %10.0f  %11.3f  %11.3f  %10.5f%s",
+                  fWeights[i], fVetoed[i].n, fVetoed[i].mean/MeV,
+                  fVetoed[i].GetSigma()/MeV, fVetoed[i].GetResolution(),
+                  G4int(i) == optimal ? "  <-" : "");
+    G4cout << line << G4endl;
+  }
+  if ( optimal >= 0 ) {
+    G4cout << "       optimal weight: " << fWeights[optimal]
+           << ", resolution " << fVetoed[optimal].GetResolution() << G4endl;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -1,23 +1,125 @@
-
 /// \file RunAction.cc
 /// \brief Implementation of the RunAction class
 
 #include "RunAction.hh"
 #include "Analysis.hh"
+#include "OutputConfig.hh"
+#include "AnalysisConfig.hh"
+#include "EventRecord.hh"
+#include "ColumnarWriter.hh"
+#include "TensorWriter.hh"
+#include "AsyncWriter.hh"
+#include "StepRecorder.hh"
+#include "ResolutionScan.hh"
+#include "ShowerMaps.hh"
+#include "ContainmentMonitor.hh"
+#include "RegionConfig.hh"
+#include "FastSimConfig.hh"
+#include "FastSimValidation.hh"
+#include "ShowerLibraryConfig.hh"
+#include "ShowerLibraryBuilder.hh"
+#include "ShowerLibraryModel.hh"
+#include "StackingConfig.hh"
+#include "StackingAction.hh"
+#include "PhysicsConfig.hh"
+#include "OverlayConfig.hh"
+#include "EventOverlay.hh"
+#include "ScanConfig.hh"
+#include "ShardConfig.hh"
+#include "RandomConfig.hh"
 
 #include "G4Run.hh"
 #include "G4RunManager.hh"
+#include "G4Threading.hh"
+#include "G4AutoLock.hh"
 #include "G4UnitsTable.hh"
 #include "G4SystemOfUnits.hh"
 
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+
+#include <sys/resource.h>
+
+namespace
+{
+  // Columnar files closed by the workers during the current run;
+  // only accessed once per worker at the end of the run
+  G4Mutex columnarFilesMutex = G4MUTEX_INITIALIZER;
+  std::vector<std::string> columnarFiles;
+  G4double columnarBytes = 0.;
+
+  void RegisterColumnarFile(const std::string& fileName, std::uint64_t nofBytes)
+  {
+    G4AutoLock lock(&columnarFilesMutex);
+    columnarFiles.push_back(fileName);
+    columnarBytes += G4double(nofBytes);
+  }
+
+  // Resolution scan of the run, merged from the threads at the end of
+  // the run; configured by the master before the workers start
+  G4Mutex resolutionScanMutex = G4MUTEX_INITIALIZER;
+  ResolutionScan resolutionScan;
+
+  // Shower maps of the threads which processed events; reduced into the
+  // first one by the master at the end of the run
+  G4Mutex showerMapsMutex = G4MUTEX_INITIALIZER;
+  std::vector<ShowerMaps> showerMaps;
+
+  // Processing times of the containment monitors, merged from the threads
+  // at the end of the run
+  G4Mutex containmentMutex = G4MUTEX_INITIALIZER;
+  ContainmentMonitor::Statistics containmentStatistics;
+
+  // Fast simulation validation, merged from the threads at the end of
+  // the run
+  G4Mutex fastSimValidationMutex = G4MUTEX_INITIALIZER;
+  FastSimValidation fastSimValidation;
+
+  // Shower library being generated, merged from the threads at the end of
+  // each run and kept over the runs with the same settings; configured by
+  // the master before the workers start
+  G4Mutex showerLibraryMutex = G4MUTEX_INITIALIZER;
+  ShowerLibraryBuilder showerLibraryBuilder;
+  ShowerLibraryModel::Statistics showerLibraryStatistics;
+
+  // Tracks killed by the stacking cuts, merged from the threads at the
+  // end of the run
+  G4Mutex stackingMutex = G4MUTEX_INITIALIZER;
+  StackingAction::Statistics stackingStatistics;
+
+  // Overlaid library events, merged from the threads at the end of the run
+  G4Mutex overlayMutex = G4MUTEX_INITIALIZER;
+  EventOverlay::Statistics overlayStatistics;
+}
+
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 RunAction::RunAction()
- : G4UserRunAction()
+ : G4UserRunAction(),
+   fNtuplesBooked(false),
+   fColumnarWriter(nullptr),
+   fTensorWriter(nullptr),
+   fNofEventsSinceFlush(0),
+   fNofFlushes(0),
+   fResolutionScan(new ResolutionScan()),
+   fShowerMaps(new ShowerMaps()),
+   fFastSimValidation(new FastSimValidation())
 { 
   // set printing event number per each event
   G4RunManager::GetRunManager()->SetPrintProgress(0);     
 
+  // Create the output configuration and its messenger
+  // (the first call happens on the master)
+  OutputConfig::Instance();
+  AnalysisConfig::Instance();
+  StackingConfig::Instance();
+  OverlayConfig::Instance();
+  ScanConfig::Instance();
+  ShardConfig::Instance();
+  RandomConfig::Instance();
+
   // Create analysis manager
   // The choice of analysis technology is done via selection of a namespace
   // in Analysis.hh
@@ -25,102 +127,600 @@ RunAction::RunAction()
 
   // Create directories 
   analysisManager->SetVerboseLevel(0);
-  analysisManager->SetNtupleMerging(true);
-  // Note: merging ntuples is available only with Root output
-
-  // Book histograms, ntuple
-
-  analysisManager->CreateNtuple("EdepTotal", "EdepTotal");
-  analysisManager->CreateNtupleDColumn("ECal_Edep_Active_Total");
-  analysisManager->CreateNtupleDColumn("ECal_EdepPi0_Active_Total");
-  analysisManager->CreateNtupleDColumn("HCal_Edep_Active_Total");
-  analysisManager->CreateNtupleDColumn("HCal_EdepPi0_Active_Total");
-  analysisManager->CreateNtupleDColumn("ECal_Edep_Absorber_Total");
-  analysisManager->CreateNtupleDColumn("ECal_EdepPi0_Absorber_Total");
-  analysisManager->CreateNtupleDColumn("HCal_Edep_Absorber_Total");
-  analysisManager->CreateNtupleDColumn("HCal_EdepPi0_Absorber_Total");
-  analysisManager->CreateNtupleIColumn("ECal_Num_Active_Pi0");
-  analysisManager->CreateNtupleIColumn("HCal_Num_Active_Pi0");
-  analysisManager->CreateNtupleIColumn("ECal_Num_Absorber_Pi0");
-  analysisManager->CreateNtupleIColumn("HCal_Num_Absorber_Pi0");
-  analysisManager->CreateNtupleIColumn("eventID");
-  analysisManager->FinishNtuple();
-
-  analysisManager->CreateNtuple("ECalBlocks", "ECalBlocks");
-  analysisManager->CreateNtupleDColumn("ECal_Edep_Active_Block");
-  analysisManager->CreateNtupleDColumn("ECal_EdepPi0_Active_Block");
-  analysisManager->CreateNtupleDColumn("ECal_Edep_Absorber_Block");
-  analysisManager->CreateNtupleDColumn("ECal_EdepPi0_Absorber_Block");
-  analysisManager->CreateNtupleIColumn("ECal_Num_Active_Pi0");
-  analysisManager->CreateNtupleIColumn("ECal_Num_Absorber_Pi0");
-  analysisManager->CreateNtupleIColumn("ECal_BlockXid");
-  analysisManager->CreateNtupleIColumn("ECal_BlockYid");
-  analysisManager->CreateNtupleIColumn("eventID");
-  analysisManager->FinishNtuple();
-
-  analysisManager->CreateNtuple("HCalTowers", "HCalTowers");
-  analysisManager->CreateNtupleDColumn("HCal_Edep_Active_Tower");
-  analysisManager->CreateNtupleDColumn("HCal_EdepPi0_Active_Tower");
-  analysisManager->CreateNtupleDColumn("HCal_Edep_Absorber_Tower");
-  analysisManager->CreateNtupleDColumn("HCal_EdepPi0_Absorber_Tower");
-  analysisManager->CreateNtupleIColumn("HCal_TowerXid");
-  analysisManager->CreateNtupleIColumn("HCal_TowerYid");
-  analysisManager->CreateNtupleIColumn("HCal_Num_Active_Pi0");
-  analysisManager->CreateNtupleIColumn("HCal_Num_Absorber_Pi0");
-  analysisManager->CreateNtupleIColumn("eventID");
-  analysisManager->FinishNtuple();
-
-  analysisManager->CreateNtuple("HCalTiles", "HCalTiles");
-  analysisManager->CreateNtupleDColumn("HCal_Edep_Active_Tile");
-  analysisManager->CreateNtupleDColumn("HCal_EdepPi0_Active_Tile");
-  analysisManager->CreateNtupleDColumn("HCal_Edep_Absorber_Tile");
-  analysisManager->CreateNtupleDColumn("HCal_EdepPi0_Absorber_Tile");
-  analysisManager->CreateNtupleIColumn("HCal_Layerid");
-  analysisManager->CreateNtupleIColumn("HCal_NumPi0_Active_Tile");
-  analysisManager->CreateNtupleIColumn("HCal_NumPi0_Absorber_Tile");
-  analysisManager->CreateNtupleIColumn("HCal_TowerXid");
-  analysisManager->CreateNtupleIColumn("HCal_TowerYid");
-  analysisManager->CreateNtupleIColumn("eventID");
-  analysisManager->FinishNtuple();
-
-  analysisManager->CreateNtuple("Pi0", "Pi0");
-  analysisManager->CreateNtupleDColumn("Energy");
-  analysisManager->CreateNtupleDColumn("PosX");
-  analysisManager->CreateNtupleDColumn("PosY");
-  analysisManager->CreateNtupleDColumn("PosZ");
-  analysisManager->CreateNtupleIColumn("eventID");
-  analysisManager->FinishNtuple();
 
+  // Ntuple merging is set and ntuples are booked in BeginOfRunAction,
+  // once the output configuration has been read from the macro
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 RunAction::~RunAction()
 {
+  delete fColumnarWriter;
+  delete fTensorWriter;
+  delete fResolutionScan;
+  delete fShowerMaps;
+  delete fFastSimValidation;
   delete G4AnalysisManager::Instance();  
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
+void RunAction::BookNtuples()
+{
+  auto analysisManager = G4AnalysisManager::Instance();
+
+  // Book histograms, ntuple
+  // The tables and columns are shared with the columnar output
+  for ( const auto& table : OutputConfig::Instance()->GetSchema() ) {
+    analysisManager->CreateNtuple(table.name, table.name);
+    for ( const auto& column : table.columns ) {
+      switch ( column.type ) {
+        case ColumnarFormat::ColumnType::Int32:
+          analysisManager->CreateNtupleIColumn(column.name);
+          break;
+        case ColumnarFormat::ColumnType::Float32:
+          analysisManager->CreateNtupleFColumn(column.name);
+          break;
+        case ColumnarFormat::ColumnType::Float64:
+          analysisManager->CreateNtupleDColumn(column.name);
+          break;
+      }
+    }
+    analysisManager->FinishNtuple();
+  }
+
+  fNtuplesBooked = true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4String RunAction::GetOutputName() const
+{
+  // File name of the current scan point, or set via macro, with or
+  // without the Root extension, and the suffix of the shard being run or
+  // of the event being replayed
+  auto point = ScanConfig::Instance()->GetCurrentPoint();
+  G4String name = point ? point->output : G4AnalysisManager::Instance()->GetFileName();
+  if ( name.size() > 5 && name.substr(name.size()-5) == ".root" ) {
+    name = name.substr(0, name.size()-5);
+  }
+  return name + ShardConfig::Instance()->GetOutputSuffix()
+         + RandomConfig::Instance()->GetOutputSuffix();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
 void RunAction::BeginOfRunAction(const G4Run* /*run*/)
 { 
   // Get analysis manager
   auto analysisManager = G4AnalysisManager::Instance();
+  auto outputConfig = OutputConfig::Instance();
+
+  // The library events of the overlaid particles are selected before
+  // the workers start
+  if ( G4Threading::IsMasterThread() ) OverlayConfig::Instance()->Prepare();
+
+  if ( ! fNtuplesBooked ) {
+    // In streaming mode each thread writes its own file instead of
+    // keeping its ntuples in memory until they are merged at end of run
+    // Note: merging ntuples is available only with Root output
+    analysisManager->SetNtupleMerging( ! outputConfig->IsStreaming() );
+    BookNtuples();
+    if ( G4Threading::IsMasterThread() ) {
+      outputConfig->Print();
+      AnalysisConfig::Instance()->Print();
+      RegionConfig::Instance()->Print();
+      FastSimConfig::Instance()->Print();
+      ShowerLibraryConfig::Instance()->Print();
+      StackingConfig::Instance()->Print();
+      PhysicsConfig::Instance()->Print();
+      OverlayConfig::Instance()->Print();
+      RandomConfig::Instance()->Print();
+    }
+  }
 
-  // Open an output file
-  analysisManager->OpenFile(analysisManager->GetFileName()); // File name set via macro
+  if ( AnalysisConfig::Instance()->IsResolutionScan() ) {
+    fResolutionScan->Configure();
+    if ( G4Threading::IsMasterThread() ) resolutionScan.Configure();
+  }
+  if ( AnalysisConfig::Instance()->IsShowerMaps() ) {
+    fShowerMaps->Reset();
+  }
+  ContainmentMonitor::Instance()->Configure();
+  fFastSimValidation->Reset();
+  ShowerLibraryBuilder::Instance()->Configure();
+  ShowerLibraryModel::GetStatistics() = ShowerLibraryModel::Statistics();
+  if ( G4Threading::IsMasterThread() ) {
+    G4AutoLock lock(&showerLibraryMutex);
+    showerLibraryBuilder.Configure();
+  }
+  StackingAction::GetStatistics() = StackingAction::Statistics();
+  EventOverlay::GetStatistics() = EventOverlay::Statistics();
+
+  if ( outputConfig->IsRootOutput() ) {
+    // Compression and basket settings; 0 keeps the Geant4 defaults
+    analysisManager->SetCompressionLevel(outputConfig->GetCompressionLevel());
+    if ( outputConfig->GetBasketSize() > 0 ) {
+      analysisManager->SetBasketSize(outputConfig->GetBasketSize());
+    }
+    if ( outputConfig->GetBasketEntries() > 0 ) {
+      analysisManager->SetBasketEntries(outputConfig->GetBasketEntries());
+    }
+
+    // Open an output file
+    analysisManager->OpenFile(GetOutputName()); // File name set via macro or scan
+  }
+
+  if ( outputConfig->IsColumnarOutput() || outputConfig->IsTensorOutput() ) {
+    OpenEventWriters();
+  }
+  if ( outputConfig->IsStepOutput() ) {
+    OpenStepRecorder();
+  }
+
+  // Write the manifest before the first event when streaming, so that
+  // the flushed part of the run can be read even if the job is killed
+  if ( outputConfig->IsColumnarOutput() && outputConfig->IsStreaming()
+       && G4Threading::IsMasterThread() ) {
+    std::vector<std::string> files;
+    if ( outputConfig->IsAsyncWriter() ) {
+      files.push_back(GetColumnarFileName(-1));
+    }
+    else {
+      auto nofThreads = std::max(G4RunManager::GetRunManager()->GetNumberOfThreads(), 1);
+      for ( G4int i=0; i<nofThreads; ++i ) files.push_back(GetColumnarFileName(i));
+    }
+    ColumnarFormat::WriteManifest(GetOutputName() + ColumnarFormat::kManifestExtension,
+                                  files, ShardConfig::Instance()->GetDescription());
+  }
+
+  fNofEventsSinceFlush = 0;
+  fNofFlushes = 0;
+  fRunTimer.Start();
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
-void RunAction::EndOfRunAction(const G4Run* /*run*/)
+void RunAction::EndOfRunAction(const G4Run* run)
 {
   auto analysisManager = G4AnalysisManager::Instance();
+  auto outputConfig = OutputConfig::Instance();
 
   // save histograms & ntuple
   //
-  analysisManager->Write();
-  analysisManager->CloseFile();
+  // Merge the resolution scan of this thread before the master closes
+  // the output of the writer thread
+  auto scan = AnalysisConfig::Instance()->IsResolutionScan();
+  if ( scan ) {
+    G4AutoLock lock(&resolutionScanMutex);
+    if ( ! resolutionScan.Merge(*fResolutionScan) ) {
+      G4Exception("RunAction::EndOfRunAction()",
+        "MyCode0010", JustWarning,
+        "Resolution scan settings changed during the run; scan not merged");
+    }
+  }
+  auto maps = AnalysisConfig::Instance()->IsShowerMaps();
+  if ( maps ) {
+    G4AutoLock lock(&showerMapsMutex);
+    if ( fShowerMaps->GetNumberOfEvents() > 0. ) showerMaps.push_back(*fShowerMaps);
+    // The workers have registered their maps when the master ends the run
+    if ( G4Threading::IsMasterThread() ) ShowerMaps::Reduce(showerMaps);
+  }
+  {
+    G4AutoLock lock(&containmentMutex);
+    containmentStatistics.Merge(ContainmentMonitor::Instance()->GetStatistics());
+  }
+  auto fastSim = FastSimConfig::Instance()->IsEnabled();
+  if ( fastSim ) {
+    G4AutoLock lock(&fastSimValidationMutex);
+    fastSimValidation.Merge(*fFastSimValidation);
+  }
+  {
+    G4AutoLock lock(&showerLibraryMutex);
+    auto builder = ShowerLibraryBuilder::Instance();
+    if ( ! showerLibraryBuilder.Merge(*builder) ) {
+      G4Exception("RunAction::EndOfRunAction()",
+        "MyCode0011", JustWarning,
+        "Shower library settings changed during the run; showers not merged");
+    }
+    builder->Clear();
+    showerLibraryStatistics.Merge(ShowerLibraryModel::GetStatistics());
+  }
+  {
+    G4AutoLock lock(&stackingMutex);
+    stackingStatistics.Merge(StackingAction::GetStatistics());
+  }
+  {
+    G4AutoLock lock(&overlayMutex);
+    overlayStatistics.Merge(EventOverlay::GetStatistics());
+  }
+
+  G4Timer writeTimer;
+  writeTimer.Start();
+  if ( outputConfig->IsRootOutput() ) {
+    analysisManager->Write();
+    analysisManager->CloseFile();
+  }
+  if ( outputConfig->IsColumnarOutput() || outputConfig->IsTensorOutput() ) {
+    CloseEventWriters();
+  }
+  auto stepRecorder = StepRecorder::Instance();
+  if ( stepRecorder->IsOpen() ) {
+    stepRecorder->Close();
+    stepRecorder->PrintStatistics();
+  }
+  writeTimer.Stop();
+  fRunTimer.Stop();
+
+  // The master holds the merged Root file and writes the columnar manifest
+  if ( ! G4Threading::IsMasterThread() ) return;
+
+  if ( scan ) {
+    G4AutoLock lock(&resolutionScanMutex);
+    resolutionScan.Print();
+  }
+  if ( maps ) {
+    G4AutoLock lock(&showerMapsMutex);
+    if ( ! showerMaps.empty() ) showerMaps.front().Print();
+    showerMaps.clear();
+  }
+  {
+    G4AutoLock lock(&containmentMutex);
+    if ( AnalysisConfig::Instance()->GetContainmentMode() != "off" ) {
+      containmentStatistics.Print();
+    }
+    containmentStatistics = ContainmentMonitor::Statistics();
+  }
+  if ( fastSim ) {
+    G4AutoLock lock(&fastSimValidationMutex);
+    fastSimValidation.Print();
+    fastSimValidation.Reset();
+  }
+  {
+    G4AutoLock lock(&showerLibraryMutex);
+    showerLibraryBuilder.Write();
+    showerLibraryStatistics.Print();
+    showerLibraryStatistics = ShowerLibraryModel::Statistics();
+  }
+  {
+    G4AutoLock lock(&stackingMutex);
+    if ( StackingConfig::Instance()->IsEnabled() ) {
+      stackingStatistics.Print(run->GetNumberOfEvent());
+    }
+    stackingStatistics = StackingAction::Statistics();
+  }
+  {
+    G4AutoLock lock(&overlayMutex);
+    overlayStatistics.Print();
+    overlayStatistics = EventOverlay::Statistics();
+  }
+
+  if ( outputConfig->IsRootOutput() ) {
+    // Without merging, the worker files hold the ntuples
+    std::vector<G4String> fileNames = { GetOutputName() + ".root" };
+    if ( outputConfig->IsStreaming() ) {
+      auto nofThreads = G4RunManager::GetRunManager()->GetNumberOfThreads();
+      for ( G4int i=0; i<nofThreads; ++i ) {
+        fileNames.push_back(GetOutputName() + "_t" + std::to_string(i) + ".root");
+      }
+    }
+    G4double fileSize = 0.;
+    for ( const auto& fileName : fileNames ) {
+      std::ifstream file(fileName, std::ios::binary | std::ios::ate);
+      if ( file ) fileSize += G4double(file.tellg());
+    }
+    PrintOutputStatistics(run, fileNames.front(), fileSize, 
+                          writeTimer.GetRealElapsed());
+  }
+  if ( outputConfig->IsColumnarOutput() ) {
+    WriteColumnarManifest(run, writeTimer.GetRealElapsed());
+  }
+  PrintPerformance(run);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void RunAction::WriteEvent(EventRecord& record)
+{
+  auto outputConfig = OutputConfig::Instance();
+  auto analysisConfig = AnalysisConfig::Instance();
+
+  // Analysis accumulated during the run, before the record is handed over;
+  // the events stopped by the containment monitor are left out
+  if ( record.containment.status == ContainmentStatus::Contained ) {
+    if ( analysisConfig->IsResolutionScan() ) fResolutionScan->Fill(record);
+    if ( analysisConfig->IsShowerMaps() ) fShowerMaps->Fill(record);
+    if ( FastSimConfig::Instance()->IsEnabled() ) fFastSimValidation->Fill(record);
+  }
+
+  if ( outputConfig->IsRootOutput() ) {
+    NtupleRowSink ntuples;
+    record.FillRows(ntuples, outputConfig->IsCellTables());
+  }
+  if ( outputConfig->IsAsyncWriter() ) {
+    // The record is swapped with an empty one, which the caller resets
+    AsyncWriter::Instance()->Push(record);
+    return;
+  }
+
+  G4bool written = false;
+  try {
+    if ( fColumnarWriter && fColumnarWriter->IsOpen() ) {
+      record.FillRows(*fColumnarWriter, outputConfig->IsCellTables());
+      written = true;
+    }
+    if ( fTensorWriter && fTensorWriter->IsOpen() ) {
+      fTensorWriter->Write(record);
+      written = true;
+    }
+    if ( written ) {
+      ++fNofEventsSinceFlush;
+      FlushEventWriters();
+    }
+  }
+  catch ( const std::exception& e ) {
+    G4ExceptionDescription msg;
+    msg << e.what();
+    G4Exception("RunAction::WriteEvent()", "MyCode0008", FatalException, msg);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void RunAction::FlushEventWriters()
+{
+  auto outputConfig = OutputConfig::Instance();
+  auto flushEvents = outputConfig->GetFlushEvents();
+  auto flushSize = outputConfig->GetFlushSize();
+  auto columnar = fColumnarWriter && fColumnarWriter->IsOpen();
+  G4bool flush 
+    = ( flushEvents > 0 && fNofEventsSinceFlush >= flushEvents )
+   || ( flushSize > 0. && columnar 
+        && fColumnarWriter->GetBufferedBytes() >= flushSize*1.e6 );
+  if ( ! flush ) return;
+
+  // Writes the buffered rows as complete blocks and hands them to the OS,
+  // so they survive if the process is killed afterwards
+  if ( columnar ) fColumnarWriter->Flush();
+  if ( fTensorWriter && fTensorWriter->IsOpen() ) fTensorWriter->Flush();
+  fNofEventsSinceFlush = 0;
+  ++fNofFlushes;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void RunAction::OpenEventWriters()
+{
+  auto outputConfig = OutputConfig::Instance();
+  auto async = outputConfig->IsAsyncWriter();
+
+  // With the writer thread the master opens the single set of output
+  // files; otherwise each thread processing events opens its own files
+  // and the master of a multi-threaded run does not process events
+  if ( async ) {
+    if ( ! G4Threading::IsMasterThread() ) return;
+  }
+  else if ( G4Threading::IsMasterThread() 
+            && G4Threading::IsMultithreadedApplication() ) return;
+
+  auto threadId = async ? -1 : std::max(G4Threading::G4GetThreadId(), 0);
+
+  ColumnarWriter* columnarWriter = nullptr;
+  if ( outputConfig->IsColumnarOutput() ) {
+    columnarWriter = ( async || ! fColumnarWriter ) 
+                     ? new ColumnarWriter(outputConfig->GetSchema()) : fColumnarWriter;
+    auto codec = ( outputConfig->GetCompressionAlgorithm() == "zlib" )
+                 ? ColumnarFormat::Codec::Zlib : ColumnarFormat::Codec::None;
+    columnarWriter->SetCompression(codec, outputConfig->GetCompressionLevel());
+
+    auto fileName = GetColumnarFileName(threadId);
+    if ( ! columnarWriter->Open(fileName) ) {
+      G4ExceptionDescription msg;
+      msg << "Cannot open columnar output file " << fileName;
+      G4Exception("RunAction::OpenEventWriters()",
+        "MyCode0006", FatalException, msg);
+    }
+  }
+
+  TensorWriter* tensorWriter = nullptr;
+  if ( outputConfig->IsTensorOutput() ) {
+    tensorWriter = ( async || ! fTensorWriter ) ? new TensorWriter() : fTensorWriter;
+    auto baseName = GetOutputName() 
+                  + ( threadId < 0 ? "" : "_t" + std::to_string(threadId) );
+    if ( ! tensorWriter->Open(baseName, outputConfig->IsTensorFloat16()) ) {
+      G4ExceptionDescription msg;
+      msg << "Cannot open tensor output files " << baseName << "_*.npy";
+      G4Exception("RunAction::OpenEventWriters()",
+        "MyCode0006", FatalException, msg);
+    }
+  }
+
+  if ( async ) {
+    // The eventIDs of a shard or of a replayed event do not start at 0
+    // (see PrimaryGeneratorAction::GeneratePrimaries())
+    auto firstEventID = ShardConfig::Instance()->GetFirstEvent();
+    auto replayEvent = RandomConfig::Instance()->GetReplayEvent();
+    if ( replayEvent >= 0 ) firstEventID = replayEvent;
+    AsyncWriter::Instance()->Start(columnarWriter, tensorWriter, firstEventID);
+  }
+  else {
+    if ( columnarWriter ) fColumnarWriter = columnarWriter;
+    if ( tensorWriter ) fTensorWriter = tensorWriter;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void RunAction::OpenStepRecorder()
+{
+  // Each thread processing events records the steps of its own events
+  if ( G4Threading::IsMasterThread()
+       && G4Threading::IsMultithreadedApplication() ) return;
+
+  auto threadId = std::max(G4Threading::G4GetThreadId(), 0);
+  auto fileName = GetOutputName() + "_steps_t" + std::to_string(threadId)
+                + StepFormat::kFileExtension;
+  if ( ! StepRecorder::Instance()->Open(fileName) ) {
+    G4ExceptionDescription msg;
+    msg << "Cannot open step output file " << fileName;
+    G4Exception("RunAction::OpenStepRecorder()",
+      "MyCode0006", FatalException, msg);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4String RunAction::GetColumnarFileName(G4int threadId) const
+{
+  if ( threadId < 0 ) return GetOutputName() + ColumnarFormat::kFileExtension;
+
+  return GetOutputName() + "_t" + std::to_string(threadId) 
+       + ColumnarFormat::kFileExtension;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void RunAction::CloseEventWriters()
+{
+  const ColumnarWriter* columnarWriter = nullptr;
+  const TensorWriter* tensorWriter = nullptr;
+
+  if ( OutputConfig::Instance()->IsAsyncWriter() ) {
+    // The workers have pushed all their events when the master ends the run
+    if ( ! G4Threading::IsMasterThread() ) return;
+
+    auto asyncWriter = AsyncWriter::Instance();
+    if ( ! asyncWriter->IsRunning() ) return;
+    // The scans of all threads are merged at this point
+    std::vector<ColumnarFormat::Histogram> histograms;
+    if ( AnalysisConfig::Instance()->IsResolutionScan() ) {
+      G4AutoLock lock(&resolutionScanMutex);
+      histograms = resolutionScan.GetHistograms();
+    }
+    if ( AnalysisConfig::Instance()->IsShowerMaps() ) {
+      G4AutoLock lock(&showerMapsMutex);
+      if ( ! showerMaps.empty() ) {
+        auto mapHistograms = showerMaps.front().GetHistograms();
+        histograms.insert(histograms.end(), mapHistograms.begin(), mapHistograms.end());
+      }
+    }
+    asyncWriter->Stop(histograms);
+    asyncWriter->PrintMetrics();
+    columnarWriter = asyncWriter->GetColumnarWriter();
+    tensorWriter = asyncWriter->GetTensorWriter();
+  }
+  else {
+    try {
+      if ( fColumnarWriter && fColumnarWriter->IsOpen() ) {
+        // The histograms of the files are summed when they are read together
+        if ( AnalysisConfig::Instance()->IsResolutionScan() ) {
+          for ( const auto& histogram : fResolutionScan->GetHistograms() ) {
+            fColumnarWriter->WriteHistogram(histogram);
+          }
+        }
+        if ( AnalysisConfig::Instance()->IsShowerMaps() ) {
+          for ( const auto& histogram : fShowerMaps->GetHistograms() ) {
+            fColumnarWriter->WriteHistogram(histogram);
+          }
+        }
+        columnarWriter = fColumnarWriter;
+        fColumnarWriter->Close();
+      }
+      if ( fTensorWriter && fTensorWriter->IsOpen() ) {
+        tensorWriter = fTensorWriter;
+        fTensorWriter->Close();
+      }
+    }
+    catch ( const std::exception& e ) {
+      G4ExceptionDescription msg;
+      msg << e.what();
+      G4Exception("RunAction::CloseEventWriters()", "MyCode0008", FatalException, msg);
+    }
+    if ( ( columnarWriter || tensorWriter ) 
+         && OutputConfig::Instance()->IsStreaming() ) {
+      G4cout << "---> Output of thread " << std::max(G4Threading::G4GetThreadId(), 0)
+             << " flushed " << fNofFlushes << " times during the run" << G4endl;
+    }
+  }
+
+  if ( columnarWriter ) {
+    RegisterColumnarFile(columnarWriter->GetFileName(), 
+                         columnarWriter->GetBytesWritten());
+  }
+  if ( tensorWriter ) {
+    G4cout << "---> Output: " << tensorWriter->GetBaseName() << "_*.npy: "
+           << tensorWriter->GetNumberOfEvents() << " events, "
+           << tensorWriter->GetBytesWritten()/1.e6 << " MB" << G4endl;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void RunAction::WriteColumnarManifest(const G4Run* run, G4double writeTime)
+{
+  // All workers have closed their files when the master ends the run
+  G4AutoLock lock(&columnarFilesMutex);
+
+  auto fileName = GetOutputName() + ColumnarFormat::kManifestExtension;
+  if ( ! ColumnarFormat::WriteManifest(fileName, columnarFiles,
+                                       ShardConfig::Instance()->GetDescription()) ) {
+    G4ExceptionDescription msg;
+    msg << "Cannot write columnar manifest " << fileName;
+    G4Exception("RunAction::WriteColumnarManifest()",
+      "MyCode0007", JustWarning, msg);
+  }
+  else {
+    PrintOutputStatistics(run, fileName, columnarBytes, writeTime);
+  }
+
+  columnarFiles.clear();
+  columnarBytes = 0.;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void RunAction::PrintPerformance(const G4Run* run) const
+{
+  auto nofEvents = run->GetNumberOfEvent();
+  if ( nofEvents == 0 ) return;
+
+  // Peak resident memory of the process, in kB on Linux and bytes on macOS
+  rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+  auto peakMemory = G4double(usage.ru_maxrss)/1.e6;
+#else
+  auto peakMemory = G4double(usage.ru_maxrss)/1.e3;
+#endif
+
+  auto physicsConfig = PhysicsConfig::Instance();
+  auto runTime = fRunTimer.GetRealElapsed();
+  G4cout << "---> Performance: " << physicsConfig->GetPhysicsList() << ", EM "
+         << physicsConfig->GetEmOption() << ", " << nofEvents << " events in "
+         << runTime << " s, " << ( runTime > 0. ? nofEvents/runTime : 0. )
+         << " events/s, peak memory " << peakMemory << " MB" << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void RunAction::PrintOutputStatistics(const G4Run* run, const G4String& fileName,
+                                      G4double fileSize, G4double writeTime) const
+{
+  auto nofEvents = run->GetNumberOfEvent();
+  if ( nofEvents == 0 ) return;
+
+  auto runTime = fRunTimer.GetRealElapsed();
+  G4cout
+    << "---> Output: " << fileName << G4endl
+    << "       file size: " << fileSize/1.e6 << " MB, " 
+    << fileSize/nofEvents << " bytes/event" << G4endl
+    << "       write time at end of run: " << writeTime << " s, "
+    << "run time: " << runTime << " s" << G4endl
+    << "       write throughput: " 
+    << ( writeTime > 0. ? fileSize/1.e6/writeTime : 0. ) << " MB/s (end of run), "
+    << ( runTime > 0. ? fileSize/1.e6/runTime : 0. ) << " MB/s (whole run)"
+    << G4endl;
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,189 @@
+/// \file ScanConfig.cc
+/// \brief Implementation of the ScanConfig class
+
+#include "ScanConfig.hh"
+#include "ScanMessenger.hh"
+
+#include "G4RunManager.hh"
+#include "G4UImanager.hh"
+#include "G4UIcommandStatus.hh"
+#include "G4ios.hh"
+#include "G4UnitsTable.hh"
+#include "G4SystemOfUnits.hh"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <sstream>
+
+ScanConfig* ScanConfig::fInstance = nullptr;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+ScanConfig* ScanConfig::Instance()
+{
+  // The instance is created on the master with the RunAction,
+  // before any worker thread is started
+  if ( ! fInstance ) {
+    fInstance = new ScanConfig();
+  }
+  return fInstance;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+ScanConfig::ScanConfig()
+ : fMessenger(nullptr),
+   fPoints(),
+   fCentres(),
+   fCurrentPoint(-1)
+{
+  fMessenger = new ScanMessenger(this);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+ScanConfig::~ScanConfig()
+{
+  delete fMessenger;
+  fInstance = nullptr;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ScanConfig::AddPoint(const Point& point)
+{
+  fPoints.push_back(point);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ScanConfig::SetCentre(G4double angle, const G4ThreeVector& centre)
+{
+  for ( auto& entry : fCentres ) {
+    if ( std::abs(entry.first - angle) < 1.e-6*rad ) {
+      entry.second = centre;
+      return;
+    }
+  }
+  fCentres.emplace_back(angle, centre);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ScanConfig::Clear()
+{
+  fPoints.clear();
+  fCentres.clear();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+const G4ThreeVector* ScanConfig::FindCentre(G4double angle) const
+{
+  for ( const auto& entry : fCentres ) {
+    if ( std::abs(entry.first - angle) < 1.e-6*rad ) return &entry.second;
+  }
+  return nullptr;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ScanConfig::Run()
+{
+  if ( fPoints.empty() ) {
+    G4Exception("ScanConfig::Run()",
+      "MyCode0016", JustWarning, "No scan points");
+    return;
+  }
+
+  // The gun is set with the commands of the macros, so that the workers
+  // receive them at the beginning of the run
+  auto uiManager = G4UImanager::GetUIpointer();
+  auto apply = [uiManager](const std::ostringstream& command) {
+    if ( uiManager->ApplyCommand(command.str()) == fCommandSucceeded ) return true;
+    G4ExceptionDescription msg;
+    msg << "Command " << command.str() << " failed; the scan point is skipped";
+    G4Exception("ScanConfig::Run()",
+      "MyCode0016", JustWarning, msg);
+    return false;
+  };
+
+  auto runManager = G4RunManager::GetRunManager();
+  std::vector<G4double> times(fPoints.size(), -1.);
+  for ( std::size_t i=0; i<fPoints.size(); ++i ) {
+    const auto& point = fPoints[i];
+    std::ostringstream particle, energyType, energy, direction;
+    particle << "/gps/particle " << point.particle;
+    energyType << "/gps/ene/type Mono";
+    energy.precision(12);
+    energy << "/gps/ene/mono " << point.energy/MeV << " MeV";
+    direction.precision(12);
+    direction << "/gps/direction 0 " << std::sin(point.angle) << " " << std::cos(point.angle);
+    if ( ! apply(particle) || ! apply(energyType) || ! apply(energy) || ! apply(direction) ) {
+      continue;
+    }
+    auto centre = FindCentre(point.angle);
+    if ( centre ) {
+      std::ostringstream position;
+      position.precision(12);
+      position << "/gps/pos/centre " << centre->x()/mm << " " << centre->y()/mm << " "
+               << centre->z()/mm << " mm";
+      if ( ! apply(position) ) continue;
+    }
+
+    G4cout << "---> Scan point " << i + 1 << "/" << fPoints.size() << ": " << point.particle
+           << " " << G4BestUnit(point.energy, "Energy") << " at " << point.angle/deg
+           << " deg, " << point.nofEvents << " events to " << point.output << G4endl;
+    fCurrentPoint = G4int(i);
+    auto start = std::chrono::steady_clock::now();
+    runManager->BeamOn(point.nofEvents);
+    std::chrono::duration<G4double> time = std::chrono::steady_clock::now() - start;
+    times[i] = time.count();
+  }
+  fCurrentPoint = -1;
+
+  G4double totalTime = 0.;
+  G4int totalEvents = 0;
+  for ( std::size_t i=0; i<fPoints.size(); ++i ) {
+    if ( times[i] < 0. ) continue;
+    totalTime += times[i];
+    totalEvents += fPoints[i].nofEvents;
+  }
+  G4cout << "---> Scan: " << fPoints.size() << " points, " << totalEvents << " events in "
+         << totalTime << " s" << G4endl
+         << "       point  particle      energy [GeV]  angle [deg]    events  time [s]"
+         << "  events/s  output" << G4endl;
+  for ( std::size_t i=0; i<fPoints.size(); ++i ) {
+    const auto& point = fPoints[i];
+    char line[160];
+    if ( times[i] < 0. ) {
+      std::snprintf(line, sizeof(line), "       %5zu  %-12s  %12.4g  %11.4g  skipped",
+                    i + 1, point.particle.c_str(), point.energy/GeV, point.angle/deg);
+    }
+    else {
+      std::snprintf(line, sizeof(line), "       %5zu  %-12s  %12.4g  %11.4g  %8d  %8.2f  %8.2f  ",
+                    i + 1, point.particle.c_str(), point.energy/GeV, point.angle/deg,
+                    point.nofEvents, times[i], ( times[i] > 0. ) ? point.nofEvents/times[i] : 0.);
+    }
+    G4cout << line << ( times[i] < 0. ? "" : point.output ) << G4endl;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ScanConfig::Print() const
+{
+  G4cout << "---> Scan: " << fPoints.size() << " points" << G4endl;
+  for ( const auto& point : fPoints ) {
+    G4cout << "       " << point.particle << " " << G4BestUnit(point.energy, "Energy")
+           << " at " << point.angle/deg << " deg, " << point.nofEvents << " events to "
+           << point.output << G4endl;
+  }
+  for ( const auto& entry : fCentres ) {
+    G4cout << "       gun centre at " << entry.first/deg << " deg: "
+           << G4BestUnit(entry.second, "Length") << G4endl;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
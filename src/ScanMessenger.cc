@@ -0,0 +1,124 @@
+/// \file ScanMessenger.cc
+/// \brief Implementation of the ScanMessenger class
+
+#include "ScanMessenger.hh"
+#include "ScanConfig.hh"
+
+#include "G4UIdirectory.hh"
+#include "G4UIcommand.hh"
+#include "G4UIparameter.hh"
+#include "G4UIcmdWithoutParameter.hh"
+
+#include <sstream>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+ScanMessenger::ScanMessenger(ScanConfig* config)
+ : G4UImessenger(),
+   fConfig(config)
+{
+  fScanDir = new G4UIdirectory("/ATHENA/scan/");
+  fScanDir->SetGuidance("Scan of beam points run back-to-back in one process.");
+
+  fAddPointCmd = new G4UIcommand("/ATHENA/scan/addPoint", this);
+  fAddPointCmd->SetGuidance("Add a point: particle, energy, angle to the z axis in the y-z");
+  fAddPointCmd->SetGuidance("plane, number of events and output file name, e.g.");
+  fAddPointCmd->SetGuidance("pi+ 10 GeV 5 deg 5000 pi+_10GeV_5deg");
+  auto particleParam = new G4UIparameter("particle", 's', false);
+  fAddPointCmd->SetParameter(particleParam);
+  auto energyParam = new G4UIparameter("energy", 'd', false);
+  energyParam->SetParameterRange("energy>0.");
+  fAddPointCmd->SetParameter(energyParam);
+  auto energyUnitParam = new G4UIparameter("energyUnit", 's', false);
+  energyUnitParam->SetDefaultUnit("GeV");
+  fAddPointCmd->SetParameter(energyUnitParam);
+  auto angleParam = new G4UIparameter("angle", 'd', false);
+  fAddPointCmd->SetParameter(angleParam);
+  auto angleUnitParam = new G4UIparameter("angleUnit", 's', false);
+  angleUnitParam->SetDefaultUnit("deg");
+  fAddPointCmd->SetParameter(angleUnitParam);
+  auto eventsParam = new G4UIparameter("events", 'i', false);
+  eventsParam->SetParameterRange("events>0");
+  fAddPointCmd->SetParameter(eventsParam);
+  auto outputParam = new G4UIparameter("output", 's', false);
+  fAddPointCmd->SetParameter(outputParam);
+  fAddPointCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fAddPointCmd->SetToBeBroadcasted(false);
+
+  fCentreCmd = new G4UIcommand("/ATHENA/scan/centre", this);
+  fCentreCmd->SetGuidance("Gun centre of the points at an angle, e.g. 20 deg 2.5025 -18.5547");
+  fCentreCmd->SetGuidance("-8.5 cm; the points at other angles keep the centre of the macro.");
+  auto centreAngleParam = new G4UIparameter("angle", 'd', false);
+  fCentreCmd->SetParameter(centreAngleParam);
+  auto centreAngleUnitParam = new G4UIparameter("angleUnit", 's', false);
+  centreAngleUnitParam->SetDefaultUnit("deg");
+  fCentreCmd->SetParameter(centreAngleUnitParam);
+  for ( auto name : { "x", "y", "z" } ) {
+    fCentreCmd->SetParameter(new G4UIparameter(name, 'd', false));
+  }
+  auto centreUnitParam = new G4UIparameter("unit", 's', true);
+  centreUnitParam->SetDefaultUnit("cm");
+  fCentreCmd->SetParameter(centreUnitParam);
+  fCentreCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fCentreCmd->SetToBeBroadcasted(false);
+
+  fClearCmd = new G4UIcmdWithoutParameter("/ATHENA/scan/clear", this);
+  fClearCmd->SetGuidance("Remove all points and gun centres.");
+  fClearCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fClearCmd->SetToBeBroadcasted(false);
+
+  fRunCmd = new G4UIcmdWithoutParameter("/ATHENA/scan/run", this);
+  fRunCmd->SetGuidance("Run the points, one run per point, after /run/initialize.");
+  fRunCmd->AvailableForStates(G4State_Idle);
+  fRunCmd->SetToBeBroadcasted(false);
+
+  fPrintCmd = new G4UIcmdWithoutParameter("/ATHENA/scan/print", this);
+  fPrintCmd->SetGuidance("Print the scan points.");
+  fPrintCmd->SetToBeBroadcasted(false);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+ScanMessenger::~ScanMessenger()
+{
+  delete fAddPointCmd;
+  delete fCentreCmd;
+  delete fClearCmd;
+  delete fRunCmd;
+  delete fPrintCmd;
+  delete fScanDir;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ScanMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
+{
+  std::istringstream is(newValue);
+  if ( command == fAddPointCmd ) {
+    ScanConfig::Point point;
+    G4String energyUnit, angleUnit;
+    is >> point.particle >> point.energy >> energyUnit >> point.angle >> angleUnit
+       >> point.nofEvents >> point.output;
+    point.energy *= G4UIcommand::ValueOf(energyUnit);
+    point.angle *= G4UIcommand::ValueOf(angleUnit);
+    fConfig->AddPoint(point);
+  }
+  else if ( command == fCentreCmd ) {
+    G4double angle, x, y, z;
+    G4String angleUnit, unit;
+    is >> angle >> angleUnit >> x >> y >> z >> unit;
+    auto scale = G4UIcommand::ValueOf(unit);
+    fConfig->SetCentre(angle*G4UIcommand::ValueOf(angleUnit), G4ThreeVector(x, y, z)*scale);
+  }
+  else if ( command == fClearCmd ) {
+    fConfig->Clear();
+  }
+  else if ( command == fRunCmd ) {
+    fConfig->Run();
+  }
+  else if ( command == fPrintCmd ) {
+    fConfig->Print();
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
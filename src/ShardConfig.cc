@@ -0,0 +1,124 @@
+/// \file ShardConfig.cc
+/// \brief Implementation of the ShardConfig class
+
+#include "ShardConfig.hh"
+#include "ShardMessenger.hh"
+#include "RandomConfig.hh"
+
+#include "G4RunManager.hh"
+#include "G4ios.hh"
+
+#include <chrono>
+#include <sstream>
+
+ShardConfig* ShardConfig::fInstance = nullptr;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+ShardConfig* ShardConfig::Instance()
+{
+  // The instance is created on the master, by main() or the RunAction,
+  // before any worker thread is started
+  if ( ! fInstance ) {
+    fInstance = new ShardConfig();
+  }
+  return fInstance;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+ShardConfig::ShardConfig()
+ : fMessenger(nullptr),
+   fIndex(0),
+   fCount(1),
+   fRunning(false),
+   fTotalEvents(0),
+   fFirstEvent(0),
+   fNofEvents(0)
+{
+  fMessenger = new ShardMessenger(this);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+ShardConfig::~ShardConfig()
+{
+  delete fMessenger;
+  fInstance = nullptr;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool ShardConfig::SetShard(G4int index, G4int count)
+{
+  if ( count < 1 || index < 0 || index >= count ) {
+    G4ExceptionDescription msg;
+    msg << "Invalid shard " << index << " of " << count
+        << "; the index must be in [0, count)";
+    G4Exception("ShardConfig::SetShard()",
+      "MyCode0017", JustWarning, msg);
+    return false;
+  }
+  fIndex = index;
+  fCount = count;
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ShardConfig::BeamOn(G4int totalEvents)
+{
+  // The range depends only on the total, the index and the count
+  fTotalEvents = totalEvents;
+  fFirstEvent = G4int(G4long(totalEvents)*fIndex/fCount);
+  fNofEvents = G4int(G4long(totalEvents)*(fIndex + 1)/fCount) - fFirstEvent;
+
+  G4cout << "---> Shard " << fIndex << "/" << fCount << ": eventIDs " << fFirstEvent
+         << " to " << fFirstEvent + fNofEvents - 1 << " of " << totalEvents << G4endl;
+  if ( fNofEvents == 0 ) return;
+
+  // The events must not depend on the events of the other shards
+  auto randomConfig = RandomConfig::Instance();
+  auto eventSeeding = randomConfig->IsEventSeeding();
+  randomConfig->SetEventSeeding(true);
+
+  fRunning = true;
+  auto start = std::chrono::steady_clock::now();
+  G4RunManager::GetRunManager()->BeamOn(fNofEvents);
+  std::chrono::duration<G4double> time = std::chrono::steady_clock::now() - start;
+  fRunning = false;
+
+  randomConfig->SetEventSeeding(eventSeeding);
+  G4cout << "---> Shard " << fIndex << "/" << fCount << ": " << fNofEvents
+         << " events in " << time.count() << " s" << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4String ShardConfig::GetOutputSuffix() const
+{
+  // A single shard writes the same files as a run of all events
+  if ( ! fRunning || fCount == 1 ) return "";
+  return "_shard" + std::to_string(fIndex);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4String ShardConfig::GetDescription() const
+{
+  if ( ! fRunning ) return "";
+  std::ostringstream description;
+  description << "shard " << fIndex << " of " << fCount << ": eventIDs " << fFirstEvent
+              << " to " << fFirstEvent + fNofEvents - 1 << " of " << fTotalEvents
+              << ", run seed " << RandomConfig::Instance()->GetSeed();
+  return description.str();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ShardConfig::Print() const
+{
+  G4cout << "---> Shard: " << fIndex << " of " << fCount << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,77 @@
+/// \file ShardMessenger.cc
+/// \brief Implementation of the ShardMessenger class
+
+#include "ShardMessenger.hh"
+#include "ShardConfig.hh"
+
+#include "G4UIdirectory.hh"
+#include "G4UIcommand.hh"
+#include "G4UIparameter.hh"
+#include "G4UIcmdWithAnInteger.hh"
+#include "G4UIcmdWithoutParameter.hh"
+
+#include <sstream>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+ShardMessenger::ShardMessenger(ShardConfig* config)
+ : G4UImessenger(),
+   fConfig(config)
+{
+  fShardDir = new G4UIdirectory("/ATHENA/shard/");
+  fShardDir->SetGuidance("Split of a production into shards run by independent processes.");
+
+  fSelectCmd = new G4UIcommand("/ATHENA/shard/select", this);
+  fSelectCmd->SetGuidance("Shard simulated by this process: index in [0, count) and number");
+  fSelectCmd->SetGuidance("of shards. Also set by the -s index/count option. Default: 0 1");
+  auto indexParam = new G4UIparameter("index", 'i', false);
+  indexParam->SetParameterRange("index>=0");
+  fSelectCmd->SetParameter(indexParam);
+  auto countParam = new G4UIparameter("count", 'i', false);
+  countParam->SetParameterRange("count>0");
+  fSelectCmd->SetParameter(countParam);
+  fSelectCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fSelectCmd->SetToBeBroadcasted(false);
+
+  fBeamOnCmd = new G4UIcmdWithAnInteger("/ATHENA/shard/beamOn", this);
+  fBeamOnCmd->SetGuidance("Run the events of the shard out of a total number of events,");
+  fBeamOnCmd->SetGuidance("with per-event seeding, after /run/initialize.");
+  fBeamOnCmd->SetParameterName("totalEvents", false);
+  fBeamOnCmd->SetRange("totalEvents>=0");
+  fBeamOnCmd->AvailableForStates(G4State_Idle);
+  fBeamOnCmd->SetToBeBroadcasted(false);
+
+  fPrintCmd = new G4UIcmdWithoutParameter("/ATHENA/shard/print", this);
+  fPrintCmd->SetGuidance("Print the shard.");
+  fPrintCmd->SetToBeBroadcasted(false);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+ShardMessenger::~ShardMessenger()
+{
+  delete fSelectCmd;
+  delete fBeamOnCmd;
+  delete fPrintCmd;
+  delete fShardDir;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ShardMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
+{
+  if ( command == fSelectCmd ) {
+    std::istringstream is(newValue);
+    G4int index, count;
+    is >> index >> count;
+    fConfig->SetShard(index, count);
+  }
+  else if ( command == fBeamOnCmd ) {
+    fConfig->BeamOn(fBeamOnCmd->GetNewIntValue(newValue));
+  }
+  else if ( command == fPrintCmd ) {
+    fConfig->Print();
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,293 @@
+/// \file ShowerLibraryBuilder.cc
+/// \brief Implementation of the ShowerLibraryBuilder class
+
+#include "ShowerLibraryBuilder.hh"
+#include "ShowerLibraryConfig.hh"
+#include "DetectorConstruction.hh"
+#include "Moments.hh"
+
+#include "G4Event.hh"
+#include "G4PrimaryVertex.hh"
+#include "G4PrimaryParticle.hh"
+#include "G4Step.hh"
+#include "G4VTouchable.hh"
+#include "G4UnitsTable.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4ios.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+G4ThreadLocal ShowerLibraryBuilder* ShowerLibraryBuilder::fInstance = nullptr;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+ShowerLibraryBuilder* ShowerLibraryBuilder::Instance()
+{
+  if ( ! fInstance ) {
+    fInstance = new ShowerLibraryBuilder();
+  }
+  return fInstance;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+ShowerLibraryBuilder::ShowerLibraryBuilder()
+ : fDetector(-1),
+   fFileName(),
+   fLattice(),
+   fBinning(),
+   fMaxShowers(0),
+   fVoxelSize(1.),
+   fPDGCodes(),
+   fBins(),
+   fNofShowers(0),
+   fRecording(false),
+   fParticle(0),
+   fCell(0),
+   fNode(),
+   fShower(),
+   fVoxels()
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+ShowerLibraryBuilder::~ShowerLibraryBuilder()
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ShowerLibraryBuilder::Configure()
+{
+  auto config = ShowerLibraryConfig::Instance();
+  ShowerLibraryBuilder settings;
+  settings.fDetector = config->GetGenerationDetector();
+  settings.fFileName = config->GetGenerationFile();
+  settings.fBinning = config->GetBinning();
+  settings.fMaxShowers = config->GetMaxShowers();
+  settings.fVoxelSize = config->GetVoxelSize();
+  if ( settings.fDetector >= 0 ) {
+    // The phases are binned along the lattice axes with a structure only
+    settings.fLattice = DetectorConstruction::GetShowerLibraryLattice(settings.fDetector);
+    auto transverse = ShowerLibraryFormat::HasTransverseStructure(settings.fLattice);
+    auto phaseBins = std::uint32_t(config->GetPhaseBins());
+    settings.fBinning.nofPhases[0] = transverse ? phaseBins : 1;
+    settings.fBinning.nofPhases[1] = transverse ? phaseBins : 1;
+    settings.fBinning.nofPhases[2] = ( settings.fLattice.pitchZ > 0. ) ? phaseBins : 1;
+  }
+
+  if ( ! HasSameSettings(settings) ) {
+    fDetector = settings.fDetector;
+    fFileName = settings.fFileName;
+    fLattice = settings.fLattice;
+    fBinning = settings.fBinning;
+    fMaxShowers = settings.fMaxShowers;
+    fVoxelSize = settings.fVoxelSize;
+    Clear();
+  }
+  fRecording = false;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ShowerLibraryBuilder::Clear()
+{
+  fPDGCodes.clear();
+  fBins.clear();
+  fNofShowers = 0;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool ShowerLibraryBuilder::HasSameSettings(const ShowerLibraryBuilder& other) const
+{
+  const auto& binning = fBinning;
+  const auto& otherBinning = other.fBinning;
+  return fDetector == other.fDetector
+      && fFileName == other.fFileName
+      && binning.nofEnergies == otherBinning.nofEnergies
+      && binning.minEnergy == otherBinning.minEnergy
+      && binning.maxEnergy == otherBinning.maxEnergy
+      && binning.nofCosTheta == otherBinning.nofCosTheta
+      && binning.nofPhi == otherBinning.nofPhi
+      && std::equal(binning.nofPhases, binning.nofPhases + 3, otherBinning.nofPhases)
+      && fMaxShowers == other.fMaxShowers
+      && fVoxelSize == other.fVoxelSize;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+std::size_t ShowerLibraryBuilder::GetParticleIndex(G4int pdg)
+{
+  auto it = std::find(fPDGCodes.begin(), fPDGCodes.end(), pdg);
+  if ( it != fPDGCodes.end() ) return std::size_t(it - fPDGCodes.begin());
+
+  fPDGCodes.push_back(pdg);
+  fBins.emplace_back(fBinning.GetNumberOfCells());
+  return fPDGCodes.size() - 1;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ShowerLibraryBuilder::BeginEvent(const G4Event* event)
+{
+  fRecording = false;
+  if ( fDetector < 0 || event->GetNumberOfPrimaryVertex() != 1 ) return;
+  auto vertex = event->GetPrimaryVertex(0);
+  if ( vertex->GetNumberOfParticle() != 1 ) return;
+  auto primary = vertex->GetPrimary(0);
+
+  // Bin of the primary, which must start inside the detector
+  G4double phase[3];
+  if ( ! DetectorConstruction::FindShowerLibraryNode(fDetector, vertex->GetPosition(),
+                                                     fNode, phase) ) return;
+  const auto& direction = primary->GetMomentumDirection();
+  G4double components[3] = { direction.x(), direction.y(), direction.z() };
+  auto energy = primary->GetKineticEnergy();
+  auto cell = fBinning.FindCell(energy/MeV, components, phase);
+  if ( cell < 0 ) return;
+
+  fParticle = GetParticleIndex(primary->GetPDGcode());
+  fCell = std::size_t(cell);
+  if ( fBins[fParticle][fCell].size() >= std::size_t(fMaxShowers) ) return;
+
+  fShower = ShowerLibraryFormat::Shower();
+  fShower.energy = float(energy/MeV);
+  fVoxels.clear();
+  fRecording = true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ShowerLibraryBuilder::Record(const G4Step* step, G4double edep, G4bool active)
+{
+  if ( edep <= 0. ) return;
+
+  // Deposit at the middle of the step, merged per voxel and volume so that
+  // each spot stays in the volume of its first step
+  auto preStepPoint = step->GetPreStepPoint();
+  auto position = 0.5*(preStepPoint->GetPosition() + step->GetPostStepPoint()->GetPosition())
+                - fNode;
+  auto touchable = preStepPoint->GetTouchable();
+  VoxelKey key(G4int(std::floor(position.x()/fVoxelSize)),
+               G4int(std::floor(position.y()/fVoxelSize)),
+               G4int(std::floor(position.z()/fVoxelSize)),
+               touchable->GetVolume(), touchable->GetReplicaNumber(0),
+               touchable->GetReplicaNumber(1));
+
+  auto voxel = fVoxels.find(key);
+  if ( voxel == fVoxels.end() ) {
+    fVoxels.emplace(key, fShower.spots.size());
+    fShower.spots.push_back({ float(position.x()/mm), float(position.y()/mm),
+                              float(position.z()/mm), float(edep/MeV) });
+  }
+  else {
+    fShower.spots[voxel->second].edep += float(edep/MeV);
+  }
+
+  fShower.edepTotal += float(edep/MeV);
+  if ( active ) fShower.edepActive += float(edep/MeV);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ShowerLibraryBuilder::EndEvent()
+{
+  if ( ! fRecording ) return;
+  fRecording = false;
+
+  // The showers without any deposit are kept, they belong to the
+  // fluctuations of the bin
+  fBins[fParticle][fCell].push_back(std::move(fShower));
+  ++fNofShowers;
+  fShower = ShowerLibraryFormat::Shower();
+  fVoxels.clear();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool ShowerLibraryBuilder::Merge(const ShowerLibraryBuilder& other)
+{
+  if ( other.fNofShowers == 0 ) return true;
+  if ( ! HasSameSettings(other) ) return false;
+
+  for ( std::size_t otherParticle=0; otherParticle<other.fPDGCodes.size(); ++otherParticle ) {
+    auto particle = GetParticleIndex(other.fPDGCodes[otherParticle]);
+    const auto& otherBins = other.fBins[otherParticle];
+    auto& bins = fBins[particle];
+    for ( std::size_t cell=0; cell<bins.size(); ++cell ) {
+      for ( const auto& shower : otherBins[cell] ) {
+        if ( bins[cell].size() >= std::size_t(fMaxShowers) ) break;
+        bins[cell].push_back(shower);
+        ++fNofShowers;
+      }
+    }
+  }
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ShowerLibraryBuilder::Write() const
+{
+  if ( fDetector < 0 ) return;
+
+  auto size = ShowerLibraryFormat::WriteLibrary(fFileName, fDetector, fLattice, fBinning,
+                                                fPDGCodes, fBins);
+  if ( size == 0 ) {
+    G4ExceptionDescription msg;
+    msg << "Cannot write shower library " << fFileName;
+    G4Exception("ShowerLibraryBuilder::Write()",
+      "MyCode0011", JustWarning, msg);
+    return;
+  }
+
+  G4cout << "---> Shower library " << fFileName << " ("
+         << ShowerLibraryFormat::GetDetectorName(fDetector) << "): " << fNofShowers
+         << " showers, " << size/1.e6 << " MB" << G4endl;
+  PrintReport();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ShowerLibraryBuilder::PrintReport() const
+{
+  // The accuracy of a library is limited by the showers per bin and by the
+  // bin widths: the spread of the deposits relative to the energy within
+  // an energy bin is what a substituted particle can be off by
+  auto cellsPerEnergy = fBinning.GetNumberOfCells()/fBinning.nofEnergies;
+  G4cout << "       particle  energy bin [MeV]    showers  filled bins  spots/shower"
+         << "  active/E (rms)     total/E (rms)" << G4endl;
+  for ( std::size_t particle=0; particle<fPDGCodes.size(); ++particle ) {
+    for ( std::uint32_t energyBin=0; energyBin<fBinning.nofEnergies; ++energyBin ) {
+      G4double nofShowers = 0.;
+      G4double nofSpots = 0.;
+      std::size_t nofFilled = 0;
+      Moments active;
+      Moments total;
+      for ( std::size_t i=0; i<cellsPerEnergy; ++i ) {
+        const auto& showers = fBins[particle][energyBin*cellsPerEnergy + i];
+        if ( ! showers.empty() ) ++nofFilled;
+        for ( const auto& shower : showers ) {
+          nofShowers += 1.;
+          nofSpots += shower.spots.size();
+          active.Add(shower.edepActive/shower.energy);
+          total.Add(shower.edepTotal/shower.energy);
+        }
+      }
+      if ( nofShowers == 0. ) continue;
+
+      char line[160];
+      std::snprintf(line, sizeof(line),
+                    "       %8d  %7.4g - %-7.4g %10.0f %6zu/%-6zu %12.1f  %7.4f (%6.4f)  %7.4f (%6.4f)",
+                    fPDGCodes[particle], fBinning.GetEnergyLowEdge(energyBin),
+                    fBinning.GetEnergyLowEdge(energyBin + 1), nofShowers,
+                    nofFilled, cellsPerEnergy, nofSpots/nofShowers,
+                    active.mean, active.GetSigma(), total.mean, total.GetSigma());
+      G4cout << line << G4endl;
+    }
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
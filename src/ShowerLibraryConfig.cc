@@ -0,0 +1,193 @@
+/// \file ShowerLibraryConfig.cc
+/// \brief Implementation of the ShowerLibraryConfig class
+
+#include "ShowerLibraryConfig.hh"
+#include "ShowerLibraryMessenger.hh"
+
+#include "G4ios.hh"
+#include "G4UnitsTable.hh"
+#include "G4SystemOfUnits.hh"
+
+ShowerLibraryConfig* ShowerLibraryConfig::fInstance = nullptr;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+ShowerLibraryConfig* ShowerLibraryConfig::Instance()
+{
+  // The instance is created on the master with the DetectorConstruction,
+  // before any worker thread is started
+  if ( ! fInstance ) {
+    fInstance = new ShowerLibraryConfig();
+  }
+  return fInstance;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+ShowerLibraryConfig::ShowerLibraryConfig()
+ : fMessenger(nullptr),
+   fMaxEnergy(0.),
+   fGenerationDetector(-1),
+   fGenerationFile(),
+   fBinning(),
+   fPhaseBins(4),
+   fMaxShowers(50),
+   fVoxelSize(0.5*mm)
+{
+  fBinning.nofEnergies = 8;
+  fBinning.minEnergy = 10.;
+  fBinning.maxEnergy = 1000.;
+  fBinning.nofCosTheta = 4;
+  fBinning.nofPhi = 4;
+
+  fMessenger = new ShowerLibraryMessenger(this);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+ShowerLibraryConfig::~ShowerLibraryConfig()
+{
+  delete fMessenger;
+  fInstance = nullptr;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4int ShowerLibraryConfig::GetDetector(const G4String& name)
+{
+  if ( name == "ecal" ) return ShowerLibraryFormat::kECal;
+  if ( name == "hcal" ) return ShowerLibraryFormat::kHCal;
+  return -1;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ShowerLibraryConfig::SetLibrary(G4int detector, const G4String& fileName)
+{
+  auto& library = fLibraries[detector];
+  library.Close();
+  if ( fileName.empty() || fileName == "none" ) return;
+
+  if ( ! library.Open(fileName) ) {
+    G4ExceptionDescription msg;
+    msg << "Cannot map shower library " << fileName;
+    G4Exception("ShowerLibraryConfig::SetLibrary()",
+      "MyCode0011", JustWarning, msg);
+    return;
+  }
+  if ( G4int(library.GetHeader().detector) != detector ) {
+    G4ExceptionDescription msg;
+    msg << fileName << " is a library of the "
+        << ShowerLibraryFormat::GetDetectorName(library.GetHeader().detector);
+    G4Exception("ShowerLibraryConfig::SetLibrary()",
+      "MyCode0011", JustWarning, msg);
+    library.Close();
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ShowerLibraryConfig::SetMaxEnergy(G4double energy)
+{
+  fMaxEnergy = energy;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ShowerLibraryConfig::SetGeneration(G4int detector, const G4String& fileName)
+{
+  fGenerationDetector = detector;
+  fGenerationFile = ( detector >= 0 ) ? fileName : G4String();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ShowerLibraryConfig::SetEnergyBins(G4int nofBins, G4double minEnergy, G4double maxEnergy)
+{
+  fBinning.nofEnergies = nofBins;
+  fBinning.minEnergy = minEnergy/MeV;
+  fBinning.maxEnergy = maxEnergy/MeV;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ShowerLibraryConfig::SetAngleBins(G4int nofCosTheta, G4int nofPhi)
+{
+  fBinning.nofCosTheta = nofCosTheta;
+  fBinning.nofPhi = nofPhi;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ShowerLibraryConfig::SetPhaseBins(G4int nofBins)
+{
+  fPhaseBins = nofBins;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ShowerLibraryConfig::SetMaxShowers(G4int nofShowers)
+{
+  fMaxShowers = nofShowers;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ShowerLibraryConfig::SetVoxelSize(G4double size)
+{
+  fVoxelSize = size;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+const ShowerLibraryFormat::MappedLibrary* ShowerLibraryConfig::GetLibrary(G4int detector) const
+{
+  return fLibraries[detector].IsOpen() ? &fLibraries[detector] : nullptr;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool ShowerLibraryConfig::IsLibraryLoaded() const
+{
+  for ( const auto& library : fLibraries ) {
+    if ( library.IsOpen() ) return true;
+  }
+  return false;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ShowerLibraryConfig::Print() const
+{
+  G4cout << "---> Shower libraries:";
+  if ( ! IsLibraryLoaded() ) G4cout << " none";
+  G4cout << G4endl;
+  for ( G4int detector=0; detector<G4int(ShowerLibraryFormat::kNofDetectors); ++detector ) {
+    const auto& library = fLibraries[detector];
+    if ( ! library.IsOpen() ) continue;
+    const auto& header = library.GetHeader();
+    G4cout << "       " << ShowerLibraryFormat::GetDetectorName(detector) << ": "
+           << library.GetFileName() << ", " << header.nofShowers << " showers of "
+           << header.nofParticles << " particles from "
+           << G4BestUnit(header.minEnergy*MeV, "Energy") << " to "
+           << G4BestUnit(header.maxEnergy*MeV, "Energy") << ", "
+           << library.GetFileSize()/1.e6 << " MB" << G4endl;
+  }
+  if ( IsLibraryLoaded() ) {
+    G4cout << "       replaced secondaries below ";
+    if ( fMaxEnergy > 0. ) G4cout << G4BestUnit(fMaxEnergy, "Energy") << G4endl;
+    else                   G4cout << "the library maximum" << G4endl;
+  }
+  if ( IsGenerating() ) {
+    G4cout << "       generating " << fGenerationFile << " ("
+           << ShowerLibraryFormat::GetDetectorName(fGenerationDetector) << "): "
+           << fBinning.nofEnergies << " energy bins from "
+           << G4BestUnit(fBinning.minEnergy*MeV, "Energy") << " to "
+           << G4BestUnit(fBinning.maxEnergy*MeV, "Energy") << ", "
+           << fBinning.nofCosTheta << " x " << fBinning.nofPhi << " direction bins, "
+           << fPhaseBins << " phase bins, up to " << fMaxShowers << " showers per bin, "
+           << G4BestUnit(fVoxelSize, "Length") << " voxels" << G4endl;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,324 @@
+/// \file ShowerLibraryFormat.cc
+/// \brief Implementation of the shower library file format helpers
+
+#include "ShowerLibraryFormat.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace
+{
+  const double kPi = 3.14159265358979323846;
+
+  // Size of the PDG code array, padded to 8 bytes
+  std::size_t ParticlesSize(std::uint64_t nofParticles)
+  {
+    return ( nofParticles*sizeof(std::int32_t) + 7 ) / 8 * 8;
+  }
+
+  std::uint32_t Bin(double fraction, std::uint32_t nofBins)
+  {
+    if ( fraction <= 0. ) return 0;
+    return std::min(std::uint32_t(fraction*nofBins), nofBins - 1);
+  }
+
+  template <typename T>
+  bool WriteArray(std::FILE* file, const T* data, std::size_t count)
+  {
+    return count == 0 || std::fwrite(data, sizeof(T), count, file) == count;
+  }
+}
+
+namespace ShowerLibraryFormat
+{
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+const char* GetDetectorName(std::uint32_t detector)
+{
+  switch ( detector ) {
+    case kECal: return "ECal";
+    case kHCal: return "HCal";
+    default:    return "unknown";
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+bool HasTransverseStructure(const Lattice& lattice)
+{
+  return lattice.a1[0]*lattice.a2[1] - lattice.a1[1]*lattice.a2[0] != 0.;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void FindNode(const Lattice& lattice, const double point[3],
+              double node[3], double phase[3])
+{
+  // Transverse: coordinates of the point in the lattice basis, rounded
+  // to the node of its cell
+  auto det = lattice.a1[0]*lattice.a2[1] - lattice.a1[1]*lattice.a2[0];
+  if ( det != 0. ) {
+    auto dx = point[0] - lattice.origin[0];
+    auto dy = point[1] - lattice.origin[1];
+    auto m = ( dx*lattice.a2[1] - dy*lattice.a2[0] )/det;
+    auto n = ( lattice.a1[0]*dy - lattice.a1[1]*dx )/det;
+    auto mNode = std::round(m);
+    auto nNode = std::round(n);
+    node[0] = lattice.origin[0] + mNode*lattice.a1[0] + nNode*lattice.a2[0];
+    node[1] = lattice.origin[1] + mNode*lattice.a1[1] + nNode*lattice.a2[1];
+    phase[0] = std::min(std::max(m - mNode + 0.5, 0.), 1.);
+    phase[1] = std::min(std::max(n - nNode + 0.5, 0.), 1.);
+  }
+  else {
+    node[0] = point[0];
+    node[1] = point[1];
+    phase[0] = phase[1] = 0.;
+  }
+
+  if ( lattice.pitchZ > 0. ) {
+    auto k = ( point[2] - lattice.originZ )/lattice.pitchZ;
+    auto kNode = std::floor(k);
+    node[2] = lattice.originZ + kNode*lattice.pitchZ;
+    phase[2] = k - kNode;
+  }
+  else {
+    node[2] = point[2];
+    phase[2] = 0.;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+std::size_t Binning::GetNumberOfCells() const
+{
+  return std::size_t(nofEnergies)*nofCosTheta*nofPhi
+       * nofPhases[0]*nofPhases[1]*nofPhases[2];
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+std::int64_t Binning::FindCell(double energy, const double direction[3],
+                               const double phase[3]) const
+{
+  if ( nofEnergies == 0 || energy < minEnergy || energy >= maxEnergy ) return -1;
+
+  auto energyBin = Bin(std::log(energy/minEnergy)/std::log(maxEnergy/minEnergy), nofEnergies);
+  auto cosThetaBin = Bin(0.5*(direction[2] + 1.), nofCosTheta);
+  auto phiBin = Bin((std::atan2(direction[1], direction[0]) + kPi)/(2.*kPi), nofPhi);
+
+  std::int64_t cell = ( std::int64_t(energyBin)*nofCosTheta + cosThetaBin )*nofPhi + phiBin;
+  for ( int axis=0; axis<3; ++axis ) {
+    cell = cell*nofPhases[axis] + Bin(phase[axis], nofPhases[axis]);
+  }
+  return cell;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+std::uint32_t Binning::GetEnergyBin(std::size_t cell) const
+{
+  return std::uint32_t(cell/( GetNumberOfCells()/nofEnergies ));
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+double Binning::GetEnergyLowEdge(std::uint32_t energyBin) const
+{
+  return minEnergy*std::pow(maxEnergy/minEnergy, double(energyBin)/nofEnergies);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+std::uint64_t WriteLibrary(const std::string& fileName, std::uint32_t detector,
+                           const Lattice& lattice, const Binning& binning,
+                           const std::vector<std::int32_t>& pdgCodes,
+                           const std::vector<std::vector<std::vector<Shower>>>& bins)
+{
+  auto nofCells = binning.GetNumberOfCells();
+  if ( bins.size() != pdgCodes.size() ) return 0;
+
+  // Index of the bins and showers
+  std::vector<BinEntry> binEntries;
+  std::vector<ShowerEntry> showerEntries;
+  std::uint64_t nofSpots = 0;
+  for ( const auto& particleBins : bins ) {
+    if ( particleBins.size() != nofCells ) return 0;
+    for ( const auto& showers : particleBins ) {
+      binEntries.push_back({ showerEntries.size(), showers.size() });
+      for ( const auto& shower : showers ) {
+        showerEntries.push_back({ nofSpots, std::uint32_t(shower.spots.size()),
+                                  shower.energy, shower.edepActive, shower.edepTotal });
+        nofSpots += shower.spots.size();
+      }
+    }
+  }
+
+  FileHeader header;
+  std::memset(&header, 0, sizeof(header));
+  std::memcpy(header.magic, kFileMagic, sizeof(kFileMagic));
+  header.version = kVersion;
+  header.detector = detector;
+  header.lattice = lattice;
+  header.minEnergy = binning.minEnergy;
+  header.maxEnergy = binning.maxEnergy;
+  header.nofParticles = std::uint32_t(pdgCodes.size());
+  header.nofEnergies = binning.nofEnergies;
+  header.nofCosTheta = binning.nofCosTheta;
+  header.nofPhi = binning.nofPhi;
+  std::copy(binning.nofPhases, binning.nofPhases + 3, header.nofPhases);
+  header.nofBins = binEntries.size();
+  header.nofShowers = showerEntries.size();
+  header.nofSpots = nofSpots;
+
+  auto file = std::fopen(fileName.c_str(), "wb");
+  if ( ! file ) return 0;
+
+  std::vector<char> particles(ParticlesSize(pdgCodes.size()), 0);
+  if ( ! pdgCodes.empty() ) {
+    std::memcpy(particles.data(), pdgCodes.data(), pdgCodes.size()*sizeof(std::int32_t));
+  }
+  auto ok = WriteArray(file, &header, 1)
+         && WriteArray(file, particles.data(), particles.size())
+         && WriteArray(file, binEntries.data(), binEntries.size())
+         && WriteArray(file, showerEntries.data(), showerEntries.size());
+  for ( const auto& particleBins : bins ) {
+    for ( const auto& showers : particleBins ) {
+      for ( const auto& shower : showers ) {
+        ok = ok && WriteArray(file, shower.spots.data(), shower.spots.size());
+      }
+    }
+  }
+  ok = ( std::fclose(file) == 0 ) && ok;
+  if ( ! ok ) return 0;
+
+  return sizeof(header) + particles.size() + binEntries.size()*sizeof(BinEntry)
+       + showerEntries.size()*sizeof(ShowerEntry) + nofSpots*sizeof(Spot);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+MappedLibrary::MappedLibrary()
+ : fData(nullptr),
+   fSize(0),
+   fHeader(nullptr),
+   fPDGCodes(nullptr),
+   fBins(nullptr),
+   fShowers(nullptr),
+   fSpots(nullptr)
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+MappedLibrary::~MappedLibrary()
+{
+  Close();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+bool MappedLibrary::Open(const std::string& fileName)
+{
+  Close();
+
+  auto fd = ::open(fileName.c_str(), O_RDONLY);
+  if ( fd < 0 ) return false;
+  struct stat status;
+  if ( ::fstat(fd, &status) != 0 || std::size_t(status.st_size) < sizeof(FileHeader) ) {
+    ::close(fd);
+    return false;
+  }
+  auto size = std::size_t(status.st_size);
+  auto data = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+  // The mapping stays valid after the descriptor is closed
+  ::close(fd);
+  if ( data == MAP_FAILED ) return false;
+
+  fData = data;
+  fSize = size;
+  fFileName = fileName;
+
+  // Layout of the sections
+  auto bytes = static_cast<const char*>(fData);
+  fHeader = reinterpret_cast<const FileHeader*>(bytes);
+  const auto& header = *fHeader;
+  auto particlesSize = ParticlesSize(header.nofParticles);
+  auto binsOffset = sizeof(FileHeader) + particlesSize;
+  auto showersOffset = binsOffset + header.nofBins*sizeof(BinEntry);
+  auto spotsOffset = showersOffset + header.nofShowers*sizeof(ShowerEntry);
+  auto expectedSize = spotsOffset + header.nofSpots*sizeof(Spot);
+
+  fBinning.nofEnergies = header.nofEnergies;
+  fBinning.minEnergy = header.minEnergy;
+  fBinning.maxEnergy = header.maxEnergy;
+  fBinning.nofCosTheta = header.nofCosTheta;
+  fBinning.nofPhi = header.nofPhi;
+  std::copy(header.nofPhases, header.nofPhases + 3, fBinning.nofPhases);
+
+  if ( std::memcmp(header.magic, kFileMagic, sizeof(kFileMagic)) != 0
+       || header.version != kVersion || header.detector >= kNofDetectors
+       || header.nofCosTheta == 0 || header.nofPhi == 0
+       || header.nofPhases[0] == 0 || header.nofPhases[1] == 0 || header.nofPhases[2] == 0
+       || header.nofBins != header.nofParticles*fBinning.GetNumberOfCells()
+       || expectedSize != fSize ) {
+    Close();
+    return false;
+  }
+
+  fPDGCodes = reinterpret_cast<const std::int32_t*>(bytes + sizeof(FileHeader));
+  fBins = reinterpret_cast<const BinEntry*>(bytes + binsOffset);
+  fShowers = reinterpret_cast<const ShowerEntry*>(bytes + showersOffset);
+  fSpots = reinterpret_cast<const Spot*>(bytes + spotsOffset);
+
+  // The index must stay inside the file
+  for ( std::uint64_t i=0; i<header.nofBins; ++i ) {
+    if ( fBins[i].firstShower + fBins[i].nofShowers > header.nofShowers ) {
+      Close();
+      return false;
+    }
+  }
+  for ( std::uint64_t i=0; i<header.nofShowers; ++i ) {
+    if ( fShowers[i].firstSpot + fShowers[i].nofSpots > header.nofSpots ) {
+      Close();
+      return false;
+    }
+  }
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void MappedLibrary::Close()
+{
+  if ( fData ) ::munmap(fData, fSize);
+  fData = nullptr;
+  fSize = 0;
+  fHeader = nullptr;
+  fPDGCodes = nullptr;
+  fBins = nullptr;
+  fShowers = nullptr;
+  fSpots = nullptr;
+  fBinning = Binning();
+  fFileName.clear();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+int MappedLibrary::GetParticleIndex(std::int32_t pdg) const
+{
+  for ( std::uint32_t i=0; i<fHeader->nofParticles; ++i ) {
+    if ( fPDGCodes[i] == pdg ) return int(i);
+  }
+  return -1;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+}
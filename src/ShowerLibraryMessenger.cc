@@ -0,0 +1,189 @@
+/// \file ShowerLibraryMessenger.cc
+/// \brief Implementation of the ShowerLibraryMessenger class
+
+#include "ShowerLibraryMessenger.hh"
+#include "ShowerLibraryConfig.hh"
+
+#include "G4UIdirectory.hh"
+#include "G4UIcommand.hh"
+#include "G4UIparameter.hh"
+#include "G4UIcmdWithAnInteger.hh"
+#include "G4UIcmdWithADoubleAndUnit.hh"
+#include "G4UIcmdWithoutParameter.hh"
+
+#include <sstream>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+ShowerLibraryMessenger::ShowerLibraryMessenger(ShowerLibraryConfig* config)
+ : G4UImessenger(),
+   fConfig(config)
+{
+  fShowerLibDir = new G4UIdirectory("/ATHENA/showerlib/");
+  fShowerLibDir->SetGuidance("Frozen shower libraries of the ECal and HCal.");
+
+  fUseCmd = new G4UIcommand("/ATHENA/showerlib/use", this);
+  fUseCmd->SetGuidance("Shower library file of a detector, used in the events of the");
+  fUseCmd->SetGuidance("fast simulation (/ATHENA/fastsim/mode); none removes it.");
+  auto useDetectorParam = new G4UIparameter("detector", 's', false);
+  useDetectorParam->SetParameterCandidates("ecal hcal");
+  fUseCmd->SetParameter(useDetectorParam);
+  auto useFileParam = new G4UIparameter("file", 's', true);
+  useFileParam->SetDefaultValue("none");
+  fUseCmd->SetParameter(useFileParam);
+  fUseCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fUseCmd->SetToBeBroadcasted(false);
+
+  fMaxEnergyCmd = new G4UIcmdWithADoubleAndUnit("/ATHENA/showerlib/maxEnergy", this);
+  fMaxEnergyCmd->SetGuidance("Maximum energy of the secondaries replaced by library showers;");
+  fMaxEnergyCmd->SetGuidance("0 takes the upper edge of the library (default).");
+  fMaxEnergyCmd->SetParameterName("energy", false);
+  fMaxEnergyCmd->SetRange("energy>=0.");
+  fMaxEnergyCmd->SetUnitCategory("Energy");
+  fMaxEnergyCmd->SetDefaultUnit("MeV");
+  fMaxEnergyCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fMaxEnergyCmd->SetToBeBroadcasted(false);
+
+  fGenerateCmd = new G4UIcommand("/ATHENA/showerlib/generate", this);
+  fGenerateCmd->SetGuidance("Generate a library from the primaries started inside a detector;");
+  fGenerateCmd->SetGuidance("the file is written at the end of each run with the showers of");
+  fGenerateCmd->SetGuidance("all runs since the command. off stops the generation.");
+  auto generateDetectorParam = new G4UIparameter("detector", 's', false);
+  generateDetectorParam->SetParameterCandidates("ecal hcal off");
+  fGenerateCmd->SetParameter(generateDetectorParam);
+  auto generateFileParam = new G4UIparameter("file", 's', true);
+  generateFileParam->SetDefaultValue("showers.aslib");
+  fGenerateCmd->SetParameter(generateFileParam);
+  fGenerateCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fGenerateCmd->SetToBeBroadcasted(false);
+
+  fEnergyBinsCmd = new G4UIcommand("/ATHENA/showerlib/energyBins", this);
+  fEnergyBinsCmd->SetGuidance("Energy bins of a generated library, uniform in log.");
+  fEnergyBinsCmd->SetGuidance("Default: 8 bins from 10 MeV to 1 GeV");
+  auto nofEnergiesParam = new G4UIparameter("nofBins", 'i', false);
+  nofEnergiesParam->SetParameterRange("nofBins>0");
+  fEnergyBinsCmd->SetParameter(nofEnergiesParam);
+  auto minEnergyParam = new G4UIparameter("min", 'd', false);
+  minEnergyParam->SetParameterRange("min>0.");
+  fEnergyBinsCmd->SetParameter(minEnergyParam);
+  auto maxEnergyParam = new G4UIparameter("max", 'd', false);
+  maxEnergyParam->SetParameterRange("max>0.");
+  fEnergyBinsCmd->SetParameter(maxEnergyParam);
+  auto energyUnitParam = new G4UIparameter("unit", 's', true);
+  energyUnitParam->SetDefaultUnit("MeV");
+  fEnergyBinsCmd->SetParameter(energyUnitParam);
+  fEnergyBinsCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fEnergyBinsCmd->SetToBeBroadcasted(false);
+
+  fAngleBinsCmd = new G4UIcommand("/ATHENA/showerlib/angleBins", this);
+  fAngleBinsCmd->SetGuidance("Direction bins of a generated library: cos theta to the z axis");
+  fAngleBinsCmd->SetGuidance("and phi. Default: 4 4");
+  auto nofCosThetaParam = new G4UIparameter("nofCosTheta", 'i', false);
+  nofCosThetaParam->SetParameterRange("nofCosTheta>0");
+  fAngleBinsCmd->SetParameter(nofCosThetaParam);
+  auto nofPhiParam = new G4UIparameter("nofPhi", 'i', false);
+  nofPhiParam->SetParameterRange("nofPhi>0");
+  fAngleBinsCmd->SetParameter(nofPhiParam);
+  fAngleBinsCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fAngleBinsCmd->SetToBeBroadcasted(false);
+
+  fPhaseBinsCmd = new G4UIcmdWithAnInteger("/ATHENA/showerlib/phaseBins", this);
+  fPhaseBinsCmd->SetGuidance("Bins of the start point in the fiber lattice (ECal, per lattice");
+  fPhaseBinsCmd->SetGuidance("axis) or in the layer (HCal). Default: 4");
+  fPhaseBinsCmd->SetParameterName("nofBins", false);
+  fPhaseBinsCmd->SetRange("nofBins>0");
+  fPhaseBinsCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fPhaseBinsCmd->SetToBeBroadcasted(false);
+
+  fMaxShowersCmd = new G4UIcmdWithAnInteger("/ATHENA/showerlib/maxShowers", this);
+  fMaxShowersCmd->SetGuidance("Maximum number of showers per bin of a generated library.");
+  fMaxShowersCmd->SetGuidance("Default: 50");
+  fMaxShowersCmd->SetParameterName("nofShowers", false);
+  fMaxShowersCmd->SetRange("nofShowers>0");
+  fMaxShowersCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fMaxShowersCmd->SetToBeBroadcasted(false);
+
+  fVoxelSizeCmd = new G4UIcmdWithADoubleAndUnit("/ATHENA/showerlib/voxel", this);
+  fVoxelSizeCmd->SetGuidance("Size of the voxels the deposits of a shower are merged in,");
+  fVoxelSizeCmd->SetGuidance("per volume. Default: 0.5 mm");
+  fVoxelSizeCmd->SetParameterName("size", false);
+  fVoxelSizeCmd->SetRange("size>0.");
+  fVoxelSizeCmd->SetUnitCategory("Length");
+  fVoxelSizeCmd->SetDefaultUnit("mm");
+  fVoxelSizeCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fVoxelSizeCmd->SetToBeBroadcasted(false);
+
+  fPrintCmd = new G4UIcmdWithoutParameter("/ATHENA/showerlib/print", this);
+  fPrintCmd->SetGuidance("Print the shower library configuration.");
+  fPrintCmd->SetToBeBroadcasted(false);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+ShowerLibraryMessenger::~ShowerLibraryMessenger()
+{
+  delete fUseCmd;
+  delete fMaxEnergyCmd;
+  delete fGenerateCmd;
+  delete fEnergyBinsCmd;
+  delete fAngleBinsCmd;
+  delete fPhaseBinsCmd;
+  delete fMaxShowersCmd;
+  delete fVoxelSizeCmd;
+  delete fPrintCmd;
+  delete fShowerLibDir;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ShowerLibraryMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
+{
+  std::istringstream is(newValue);
+  if ( command == fUseCmd ) {
+    G4String detector, fileName;
+    is >> detector >> fileName;
+    fConfig->SetLibrary(ShowerLibraryConfig::GetDetector(detector), fileName);
+  }
+  else if ( command == fMaxEnergyCmd ) {
+    fConfig->SetMaxEnergy(fMaxEnergyCmd->GetNewDoubleValue(newValue));
+  }
+  else if ( command == fGenerateCmd ) {
+    G4String detector, fileName;
+    is >> detector >> fileName;
+    fConfig->SetGeneration(ShowerLibraryConfig::GetDetector(detector), fileName);
+  }
+  else if ( command == fEnergyBinsCmd ) {
+    G4int nofBins;
+    G4double minEnergy, maxEnergy;
+    G4String unit;
+    is >> nofBins >> minEnergy >> maxEnergy >> unit;
+    auto scale = G4UIcommand::ValueOf(unit);
+    if ( maxEnergy <= minEnergy ) {
+      G4ExceptionDescription msg;
+      msg << "The maximum energy of the library must be above the minimum";
+      G4Exception("ShowerLibraryMessenger::SetNewValue()",
+        "MyCode0011", JustWarning, msg);
+      return;
+    }
+    fConfig->SetEnergyBins(nofBins, minEnergy*scale, maxEnergy*scale);
+  }
+  else if ( command == fAngleBinsCmd ) {
+    G4int nofCosTheta, nofPhi;
+    is >> nofCosTheta >> nofPhi;
+    fConfig->SetAngleBins(nofCosTheta, nofPhi);
+  }
+  else if ( command == fPhaseBinsCmd ) {
+    fConfig->SetPhaseBins(fPhaseBinsCmd->GetNewIntValue(newValue));
+  }
+  else if ( command == fMaxShowersCmd ) {
+    fConfig->SetMaxShowers(fMaxShowersCmd->GetNewIntValue(newValue));
+  }
+  else if ( command == fVoxelSizeCmd ) {
+    fConfig->SetVoxelSize(fVoxelSizeCmd->GetNewDoubleValue(newValue));
+  }
+  else if ( command == fPrintCmd ) {
+    fConfig->Print();
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
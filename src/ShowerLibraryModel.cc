@@ -0,0 +1,170 @@
+/// \file ShowerLibraryModel.cc
+/// \brief Implementation of the ShowerLibraryModel class
+
+#include "ShowerLibraryModel.hh"
+#include "ShowerLibraryConfig.hh"
+#include "FastSimConfig.hh"
+#include "DetectorConstruction.hh"
+
+#include "G4EventManager.hh"
+#include "G4Event.hh"
+#include "G4Track.hh"
+#include "G4UnitsTable.hh"
+#include "G4SystemOfUnits.hh"
+#include "Randomize.hh"
+
+#include <algorithm>
+
+namespace
+{
+  G4ThreadLocal ShowerLibraryModel::Statistics* statistics = nullptr;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ShowerLibraryModel::Statistics::Merge(const Statistics& other)
+{
+  for ( G4int detector=0; detector<G4int(ShowerLibraryFormat::kNofDetectors); ++detector ) {
+    nofSubstituted[detector] += other.nofSubstituted[detector];
+    nofMissed[detector] += other.nofMissed[detector];
+    energy[detector] += other.energy[detector];
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ShowerLibraryModel::Statistics::Print() const
+{
+  for ( G4int detector=0; detector<G4int(ShowerLibraryFormat::kNofDetectors); ++detector ) {
+    auto nofParticles = nofSubstituted[detector] + nofMissed[detector];
+    if ( nofParticles == 0. ) continue;
+    G4cout << "---> " << ShowerLibraryFormat::GetDetectorName(detector)
+           << " shower library: " << nofSubstituted[detector] << " of " << nofParticles
+           << " particles substituted (" << 100.*nofSubstituted[detector]/nofParticles
+           << "%), " << G4BestUnit(energy[detector], "Energy") << " deposited; "
+           << nofMissed[detector] << " fully simulated (no showers in their bin)" << G4endl;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+ShowerLibraryModel::ShowerLibraryModel(const G4String& name, G4int detector,
+                                       G4Region* envelope)
+ : G4VFastSimulationModel(name, envelope),
+   fDetector(detector),
+   fEventID(-1),
+   fLibrary(nullptr),
+   fMaxEnergy(0.),
+   fLastMissedTrackID(-1),
+   fBin(0),
+   fNode(),
+   fDepositor()
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+ShowerLibraryModel::~ShowerLibraryModel()
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+ShowerLibraryModel::Statistics& ShowerLibraryModel::GetStatistics()
+{
+  if ( ! statistics ) {
+    statistics = new Statistics();
+  }
+  return *statistics;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool ShowerLibraryModel::IsApplicable(const G4ParticleDefinition&)
+{
+  // The particles are selected by the library loaded when the event starts
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool ShowerLibraryModel::ModelTrigger(const G4FastTrack& fastTrack)
+{
+  // The settings are taken once per event; no substitution while a
+  // library is generated
+  auto eventID = G4EventManager::GetEventManager()->GetConstCurrentEvent()->GetEventID();
+  if ( eventID != fEventID ) {
+    auto config = ShowerLibraryConfig::Instance();
+    fEventID = eventID;
+    fLastMissedTrackID = -1;
+    fLibrary = nullptr;
+    if ( FastSimConfig::Instance()->IsFastEvent(eventID) && ! config->IsGenerating() ) {
+      fLibrary = config->GetLibrary(fDetector);
+    }
+    if ( fLibrary ) {
+      fMaxEnergy = fLibrary->GetHeader().maxEnergy*MeV;
+      if ( config->GetMaxEnergy() > 0. ) fMaxEnergy = config->GetMaxEnergy();
+    }
+  }
+  if ( ! fLibrary ) return false;
+
+  auto track = fastTrack.GetPrimaryTrack();
+  auto energy = track->GetKineticEnergy();
+  if ( track->GetParentID() == 0 || energy >= fMaxEnergy ) return false;
+
+  auto particle = fLibrary->GetParticleIndex(track->GetDefinition()->GetPDGEncoding());
+  if ( particle < 0 ) return false;
+
+  G4double phase[3];
+  if ( ! DetectorConstruction::FindShowerLibraryNode(fDetector, track->GetPosition(),
+                                                     fNode, phase) ) return false;
+
+  const auto& binning = fLibrary->GetBinning();
+  const auto& direction = track->GetMomentumDirection();
+  G4double components[3] = { direction.x(), direction.y(), direction.z() };
+  auto cell = binning.FindCell(energy/MeV, components, phase);
+  if ( cell >= 0 ) {
+    fBin = std::uint64_t(particle)*binning.GetNumberOfCells() + std::uint64_t(cell);
+    if ( fLibrary->GetBin(fBin).nofShowers > 0 ) return true;
+  }
+
+  // Below the library there is nothing to gain; the other particles are
+  // counted once, the trigger is asked at each of their steps
+  if ( energy/MeV >= binning.minEnergy && track->GetTrackID() != fLastMissedTrackID ) {
+    fLastMissedTrackID = track->GetTrackID();
+    GetStatistics().nofMissed[fDetector] += 1.;
+  }
+  return false;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ShowerLibraryModel::DoIt(const G4FastTrack& fastTrack, G4FastStep& fastStep)
+{
+  auto track = fastTrack.GetPrimaryTrack();
+  auto energy = track->GetKineticEnergy();
+  fastStep.KillPrimaryTrack();
+  fastStep.ProposePrimaryTrackPathLength(0.);
+  fDepositor.BeginShower(track);
+
+  // A shower of the bin drawn at random, scaled to the particle energy
+  const auto& bin = fLibrary->GetBin(fBin);
+  auto index = std::min(std::uint64_t(G4UniformRand()*bin.nofShowers), bin.nofShowers - 1);
+  const auto& shower = fLibrary->GetShower(bin.firstShower + index);
+  auto scale = ( shower.energy > 0.f ) ? energy/(shower.energy*MeV) : 0.;
+
+  auto spots = fLibrary->GetSpots(shower);
+  G4double edepTotal = 0.;
+  for ( std::uint32_t i=0; i<shower.nofSpots; ++i ) {
+    const auto& spot = spots[i];
+    G4ThreeVector position(fNode.x() + spot.x*mm, fNode.y() + spot.y*mm, fNode.z() + spot.z*mm);
+    if ( ! fDepositor.Locate(position) ) continue;
+    auto edep = spot.edep*MeV*scale;
+    fDepositor.Deposit(edep);
+    edepTotal += edep;
+  }
+
+  auto& statistics = GetStatistics();
+  statistics.nofSubstituted[fDetector] += 1.;
+  statistics.energy[fDetector] += edepTotal;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,204 @@
+/// \file ShowerMaps.cc
+/// \brief Implementation of the ShowerMaps class
+
+#include "ShowerMaps.hh"
+#include "EventRecord.hh"
+#include "GlobalValues.hh"
+
+#include "G4SystemOfUnits.hh"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace GlobalValues;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ShowerMaps::Map::Reset(std::size_t size)
+{
+  sum.assign(size, 0.);
+  sum2.assign(size, 0.);
+  sumPi0.assign(size, 0.);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ShowerMaps::Map::Merge(const Map& other)
+{
+  for ( std::size_t i=0; i<sum.size(); ++i ) {
+    sum[i] += other.sum[i];
+    sum2[i] += other.sum2[i];
+    sumPi0[i] += other.sumPi0[i];
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+ShowerMaps::ShowerMaps()
+ : fNofEvents(0.),
+   fNofContainmentEvents(0.)
+{
+  Reset();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ShowerMaps::Reset()
+{
+  fNofEvents = 0.;
+  fNofContainmentEvents = 0.;
+  fHCalTiles.Reset(NumHCalTowers*NumHCalTowers*NumHCalLayers);
+  fECalBlocks.Reset(NumECalBlocks*NumECalBlocks);
+  fContainment.Reset(NumHCalLayers + 1);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ShowerMaps::Fill(const EventRecord& record)
+{
+  fNofEvents += 1.;
+
+  auto fillMap = [](Map& map, const std::vector<CellRecord>& cells) {
+    for ( std::size_t i=0; i<cells.size(); ++i ) {
+      auto edep = cells[i].edepActive;
+      map.sum[i] += edep;
+      map.sum2[i] += edep*edep;
+      map.sumPi0[i] += cells[i].edepPi0Active;
+    }
+  };
+  fillMap(fHCalTiles, record.hcalTiles);
+  fillMap(fECalBlocks, record.ecalBlocks);
+
+  // Containment: all deposits (active and absorber) relative to the
+  // primary energy, so that the leakage is included
+  auto energy = record.primary.energy;
+  if ( energy <= 0. ) return;
+
+  fNofContainmentEvents += 1.;
+  auto contained = record.ecalTotal.edepActive + record.ecalTotal.edepAbsorber;
+  for ( G4int depth=0; depth<=NumHCalLayers; ++depth ) {
+    if ( depth > 0 ) {
+      for ( std::size_t tower=0; tower<record.hcalTowers.size(); ++tower ) {
+        const auto& tile = record.hcalTiles[tower*NumHCalLayers + depth - 1];
+        contained += tile.edepActive + tile.edepAbsorber;
+      }
+    }
+    auto fraction = contained/energy;
+    fContainment.sum[depth] += fraction;
+    fContainment.sum2[depth] += fraction*fraction;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ShowerMaps::Merge(const ShowerMaps& other)
+{
+  fNofEvents += other.fNofEvents;
+  fNofContainmentEvents += other.fNofContainmentEvents;
+  fHCalTiles.Merge(other.fHCalTiles);
+  fECalBlocks.Merge(other.fECalBlocks);
+  fContainment.Merge(other.fContainment);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ShowerMaps::Reduce(std::vector<ShowerMaps>& maps)
+{
+  // Pairwise sums keep the rounding errors of long runs with many
+  // threads at the level of a single thread
+  for ( std::size_t stride=1; stride<maps.size(); stride*=2 ) {
+    for ( std::size_t i=0; i+stride<maps.size(); i+=2*stride ) {
+      maps[i].Merge(maps[i+stride]);
+    }
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double ShowerMaps::Mean(const std::vector<G4double>& sum, std::size_t i,
+                          G4double n) const
+{
+  return ( n > 0. ) ? sum[i]/n : 0.;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+std::vector<ColumnarFormat::Histogram> ShowerMaps::GetHistograms() const
+{
+  std::vector<double> hcalBinning
+    = { double(NumHCalTowers), double(NumHCalTowers), double(NumHCalLayers) };
+  std::vector<double> ecalBinning = { double(NumECalBlocks), double(NumECalBlocks) };
+  std::vector<double> depthBinning = { double(NumHCalLayers + 1) };
+
+  // Energies in MeV
+  auto toMeV = [](const std::vector<G4double>& values, G4double power) {
+    std::vector<double> result(values);
+    for ( auto& value : result ) value /= std::pow(MeV, power);
+    return result;
+  };
+
+  return {
+    { "Maps_NofEvents", { 2. }, { fNofEvents, fNofContainmentEvents } },
+    { "HCal_EdepActive_Sum", hcalBinning, toMeV(fHCalTiles.sum, 1.) },
+    { "HCal_EdepActive_Sum2", hcalBinning, toMeV(fHCalTiles.sum2, 2.) },
+    { "HCal_EdepPi0Active_Sum", hcalBinning, toMeV(fHCalTiles.sumPi0, 1.) },
+    { "ECal_EdepActive_Sum", ecalBinning, toMeV(fECalBlocks.sum, 1.) },
+    { "ECal_EdepActive_Sum2", ecalBinning, toMeV(fECalBlocks.sum2, 2.) },
+    { "ECal_EdepPi0Active_Sum", ecalBinning, toMeV(fECalBlocks.sumPi0, 1.) },
+    { "Containment_Sum", depthBinning, fContainment.sum },
+    { "Containment_Sum2", depthBinning, fContainment.sum2 }
+  };
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ShowerMaps::Print() const
+{
+  if ( fNofEvents == 0. ) return;
+
+  // Totals of the maps
+  auto total = [this](const std::vector<G4double>& sum) {
+    G4double result = 0.;
+    for ( std::size_t i=0; i<sum.size(); ++i ) result += Mean(sum, i, fNofEvents);
+    return result;
+  };
+  auto ecal = total(fECalBlocks.sum);
+  auto hcal = total(fHCalTiles.sum);
+
+  // Hottest HCal tile with its spread
+  std::size_t hottest = 0;
+  for ( std::size_t i=1; i<fHCalTiles.sum.size(); ++i ) {
+    if ( fHCalTiles.sum[i] > fHCalTiles.sum[hottest] ) hottest = i;
+  }
+  auto tower = hottest/NumHCalLayers;
+  auto mean = Mean(fHCalTiles.sum, hottest, fNofEvents);
+  auto variance = Mean(fHCalTiles.sum2, hottest, fNofEvents) - mean*mean;
+
+  G4cout << "---> Shower maps: " << fNofEvents << " events" << G4endl
+         << "       mean active energy: ECal " << ecal/MeV << " MeV (pi0 fraction "
+         << ( ecal > 0. ? total(fECalBlocks.sumPi0)/ecal : 0. ) << "), HCal "
+         << hcal/MeV << " MeV (pi0 fraction "
+         << ( hcal > 0. ? total(fHCalTiles.sumPi0)/hcal : 0. ) << ")" << G4endl
+         << "       hottest HCal tile: tower (" << tower/NumHCalTowers << ", "
+         << tower%NumHCalTowers << "), layer " << hottest%NumHCalLayers << ", "
+         << mean/MeV << " +- " << std::sqrt(std::max(variance, 0.))/MeV << " MeV" << G4endl;
+
+  if ( fNofContainmentEvents == 0. ) return;
+
+  // Depths at which the mean containment reaches the given fractions
+  G4cout << "       mean containment: ECal "
+         << Mean(fContainment.sum, 0, fNofContainmentEvents) << ", ECal + HCal "
+         << Mean(fContainment.sum, NumHCalLayers, fNofContainmentEvents);
+  for ( auto level : { 0.90, 0.95, 0.99 } ) {
+    G4int depth = 0;
+    while ( depth <= NumHCalLayers
+            && Mean(fContainment.sum, depth, fNofContainmentEvents) < level ) ++depth;
+    G4cout << ", " << level*100. << "% ";
+    if ( depth == 0 ) G4cout << "in the ECal";
+    else if ( depth > NumHCalLayers ) G4cout << "not reached";
+    else G4cout << "after HCal layer " << depth - 1;
+  }
+  G4cout << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,105 @@
+/// \file SpotDepositor.cc
+/// \brief Implementation of the SpotDepositor class
+
+#include "SpotDepositor.hh"
+
+#include "G4Navigator.hh"
+#include "G4TransportationManager.hh"
+#include "G4TouchableHistory.hh"
+#include "G4Step.hh"
+#include "G4Track.hh"
+#include "G4VSensitiveDetector.hh"
+#include "G4LogicalVolume.hh"
+#include "G4VPhysicalVolume.hh"
+
+namespace
+{
+  G4ThreadLocal G4int nofShowers = 0;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+SpotDepositor::SpotDepositor()
+ : fNavigator(nullptr),
+   fTouchable(new G4TouchableHistory()),
+   fStep(new G4Step()),
+   fFirst(true),
+   fDetector(nullptr)
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+SpotDepositor::~SpotDepositor()
+{
+  delete fNavigator;
+  delete fStep;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4int& SpotDepositor::GetNumberOfShowers()
+{
+  return nofShowers;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void SpotDepositor::Begin(const G4Track* track)
+{
+  // The navigator is created once the geometry is closed
+  if ( ! fNavigator ) {
+    fNavigator = new G4Navigator();
+    fNavigator->SetWorldVolume(G4TransportationManager::GetTransportationManager()
+                                 ->GetNavigatorForTracking()->GetWorldVolume());
+  }
+
+  auto time = track->GetGlobalTime();
+  fStep->SetTrack(const_cast<G4Track*>(track));
+  fStep->SetStepLength(0.);
+  fStep->GetPreStepPoint()->SetGlobalTime(time);
+  fStep->GetPostStepPoint()->SetGlobalTime(time);
+  fFirst = true;
+  fDetector = nullptr;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void SpotDepositor::BeginShower(const G4Track* track)
+{
+  Begin(track);
+  ++nofShowers;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4LogicalVolume* SpotDepositor::Locate(const G4ThreeVector& position)
+{
+  fNavigator->LocateGlobalPointAndUpdateTouchable(position, fTouchable(), ! fFirst);
+  fFirst = false;
+  fDetector = nullptr;
+
+  auto volume = fTouchable->GetVolume();
+  if ( ! volume ) return nullptr;
+  auto logicalVolume = volume->GetLogicalVolume();
+  fDetector = logicalVolume->GetSensitiveDetector();
+  if ( ! fDetector ) return nullptr;
+
+  auto preStepPoint = fStep->GetPreStepPoint();
+  auto postStepPoint = fStep->GetPostStepPoint();
+  preStepPoint->SetPosition(position);
+  preStepPoint->SetTouchableHandle(fTouchable);
+  postStepPoint->SetPosition(position);
+  postStepPoint->SetTouchableHandle(fTouchable);
+  return logicalVolume;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void SpotDepositor::Deposit(G4double edep)
+{
+  if ( ! fDetector ) return;
+  fStep->SetTotalEnergyDeposit(edep);
+  fDetector->Hit(fStep);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,176 @@
+/// \file StackingAction.cc
+/// \brief Implementation of the StackingAction class
+
+#include "StackingAction.hh"
+#include "StackingConfig.hh"
+
+#include "G4Track.hh"
+#include "G4ParticleDefinition.hh"
+#include "G4ParticleTable.hh"
+#include "G4UnitsTable.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4ios.hh"
+
+#include <cstdio>
+
+namespace
+{
+  G4ThreadLocal StackingRecord* record = nullptr;
+  G4ThreadLocal StackingAction::Statistics* statistics = nullptr;
+
+  const G4String kTimeCut = "time cut";
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void StackingAction::Statistics::Merge(const Statistics& other)
+{
+  for ( const auto& entry : other.killed ) {
+    auto& counts = killed[entry.first];
+    counts.tracks += entry.second.tracks;
+    counts.energy += entry.second.energy;
+    counts.deposited += entry.second.deposited;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void StackingAction::Statistics::Print(G4int nofEvents) const
+{
+  if ( nofEvents == 0 ) return;
+
+  Counts total;
+  for ( const auto& entry : killed ) {
+    total.tracks += entry.second.tracks;
+    total.energy += entry.second.energy;
+    total.deposited += entry.second.deposited;
+  }
+  G4cout << "---> Stacking: " << total.tracks/nofEvents << " tracks killed per event, "
+         << G4BestUnit(total.energy/nofEvents, "Energy") << " per event, "
+         << G4BestUnit(total.deposited/nofEvents, "Energy") << " deposited locally" << G4endl;
+  if ( killed.empty() ) return;
+
+  G4cout << "       cut           tracks/event  energy/event [MeV]  deposited/event [MeV]"
+         << G4endl;
+  for ( const auto& entry : killed ) {
+    char line[128];
+    std::snprintf(line, sizeof(line), "       %-12s  %12.2f  %18.3f  %21.3f",
+                  entry.first.c_str(), entry.second.tracks/nofEvents,
+                  entry.second.energy/nofEvents/MeV, entry.second.deposited/nofEvents/MeV);
+    G4cout << line << G4endl;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+StackingAction::StackingAction()
+ : G4UserStackingAction(),
+   fThresholds(),
+   fTimeCut(0.),
+   fDepositKilled(false),
+   fUnknownParticles(),
+   fDepositor()
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+StackingAction::~StackingAction()
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+StackingRecord& StackingAction::GetRecord()
+{
+  if ( ! record ) {
+    record = new StackingRecord();
+  }
+  return *record;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+StackingAction::Statistics& StackingAction::GetStatistics()
+{
+  if ( ! statistics ) {
+    statistics = new Statistics();
+  }
+  return *statistics;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void StackingAction::PrepareNewEvent()
+{
+  GetRecord() = StackingRecord();
+
+  // The cuts may change between runs; the particle names are resolved
+  // here so that the tracks are matched by their definition
+  auto config = StackingConfig::Instance();
+  fTimeCut = config->GetTimeCut();
+  fDepositKilled = config->IsDepositKilled();
+  fThresholds.clear();
+  auto particleTable = G4ParticleTable::GetParticleTable();
+  for ( const auto& threshold : config->GetThresholds() ) {
+    auto particle = particleTable->FindParticle(threshold.first);
+    if ( particle ) {
+      fThresholds.emplace_back(particle, threshold.second);
+    }
+    else if ( fUnknownParticles.insert(threshold.first).second ) {
+      G4ExceptionDescription msg;
+      msg << "Unknown particle " << threshold.first << "; its stacking cut is ignored";
+      G4Exception("StackingAction::PrepareNewEvent()",
+        "MyCode0012", JustWarning, msg);
+    }
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4ClassificationOfNewTrack StackingAction::ClassifyNewTrack(const G4Track* track)
+{
+  if ( track->GetParentID() == 0 ) return fUrgent;
+
+  // The time cut is applied on the creation time of the secondary
+  if ( fTimeCut > 0. && track->GetGlobalTime() > fTimeCut ) {
+    Kill(track, kTimeCut);
+    return fKill;
+  }
+
+  auto particle = track->GetDefinition();
+  for ( const auto& threshold : fThresholds ) {
+    if ( threshold.first != particle ) continue;
+    if ( track->GetKineticEnergy() < threshold.second ) {
+      Kill(track, particle->GetParticleName());
+      return fKill;
+    }
+    break;
+  }
+  return fUrgent;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void StackingAction::Kill(const G4Track* track, const G4String& cut)
+{
+  auto energy = track->GetKineticEnergy();
+  G4double deposited = 0.;
+  if ( fDepositKilled && energy > 0. ) {
+    fDepositor.Begin(track);
+    if ( fDepositor.Locate(track->GetPosition()) ) {
+      fDepositor.Deposit(energy);
+      deposited = energy;
+    }
+  }
+
+  auto& eventRecord = GetRecord();
+  ++eventRecord.killedTracks;
+  eventRecord.killedEnergy += energy;
+  eventRecord.depositedEnergy += deposited;
+
+  auto& counts = GetStatistics().killed[cut];
+  counts.tracks += 1.;
+  counts.energy += energy;
+  counts.deposited += deposited;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,94 @@
+/// \file StackingConfig.cc
+/// \brief Implementation of the StackingConfig class
+
+#include "StackingConfig.hh"
+#include "StackingMessenger.hh"
+
+#include "G4ios.hh"
+#include "G4UnitsTable.hh"
+
+StackingConfig* StackingConfig::fInstance = nullptr;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+StackingConfig* StackingConfig::Instance()
+{
+  // The instance is created on the master with the RunAction,
+  // before any worker thread is started
+  if ( ! fInstance ) {
+    fInstance = new StackingConfig();
+  }
+  return fInstance;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+StackingConfig::StackingConfig()
+ : fMessenger(nullptr),
+   fThresholds(),
+   fTimeCut(0.),
+   fDepositKilled(false)
+{
+  fMessenger = new StackingMessenger(this);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+StackingConfig::~StackingConfig()
+{
+  delete fMessenger;
+  fInstance = nullptr;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void StackingConfig::SetThreshold(const G4String& particleName, G4double energy)
+{
+  if ( energy > 0. ) {
+    fThresholds[particleName] = energy;
+  }
+  else {
+    fThresholds.erase(particleName);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void StackingConfig::ClearThresholds()
+{
+  fThresholds.clear();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void StackingConfig::SetTimeCut(G4double time)
+{
+  fTimeCut = time;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void StackingConfig::SetDepositKilled(G4bool deposit)
+{
+  fDepositKilled = deposit;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void StackingConfig::Print() const
+{
+  G4cout << "---> Stacking cuts:";
+  if ( ! IsEnabled() ) {
+    G4cout << " none" << G4endl;
+    return;
+  }
+  for ( const auto& threshold : fThresholds ) {
+    G4cout << " " << threshold.first << " < " << G4BestUnit(threshold.second, "Energy") << ",";
+  }
+  if ( fTimeCut > 0. ) {
+    G4cout << " time > " << G4BestUnit(fTimeCut, "Time") << ",";
+  }
+  G4cout << ( fDepositKilled ? " energy deposited locally" : " energy discarded" ) << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,104 @@
+/// \file StackingMessenger.cc
+/// \brief Implementation of the StackingMessenger class
+
+#include "StackingMessenger.hh"
+#include "StackingConfig.hh"
+
+#include "G4UIdirectory.hh"
+#include "G4UIcommand.hh"
+#include "G4UIparameter.hh"
+#include "G4UIcmdWithABool.hh"
+#include "G4UIcmdWithADoubleAndUnit.hh"
+#include "G4UIcmdWithoutParameter.hh"
+
+#include <sstream>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+StackingMessenger::StackingMessenger(StackingConfig* config)
+ : G4UImessenger(),
+   fConfig(config)
+{
+  fStackingDir = new G4UIdirectory("/ATHENA/stacking/");
+  fStackingDir->SetGuidance("Track cuts applied when the secondaries are stacked.");
+
+  fKillBelowCmd = new G4UIcommand("/ATHENA/stacking/killBelow", this);
+  fKillBelowCmd->SetGuidance("Kill the secondaries of a particle below a kinetic energy,");
+  fKillBelowCmd->SetGuidance("e.g. neutron 1 MeV; 0 removes the cut of the particle.");
+  auto particleParam = new G4UIparameter("particle", 's', false);
+  fKillBelowCmd->SetParameter(particleParam);
+  auto energyParam = new G4UIparameter("energy", 'd', false);
+  energyParam->SetParameterRange("energy>=0.");
+  fKillBelowCmd->SetParameter(energyParam);
+  auto unitParam = new G4UIparameter("unit", 's', true);
+  unitParam->SetDefaultUnit("MeV");
+  fKillBelowCmd->SetParameter(unitParam);
+  fKillBelowCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fKillBelowCmd->SetToBeBroadcasted(false);
+
+  fClearCmd = new G4UIcmdWithoutParameter("/ATHENA/stacking/clear", this);
+  fClearCmd->SetGuidance("Remove the energy thresholds of all particles.");
+  fClearCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fClearCmd->SetToBeBroadcasted(false);
+
+  fTimeCutCmd = new G4UIcmdWithADoubleAndUnit("/ATHENA/stacking/timeCut", this);
+  fTimeCutCmd->SetGuidance("Kill the secondaries created later than this global time;");
+  fTimeCutCmd->SetGuidance("0 disables the cut (default).");
+  fTimeCutCmd->SetParameterName("time", false);
+  fTimeCutCmd->SetRange("time>=0.");
+  fTimeCutCmd->SetUnitCategory("Time");
+  fTimeCutCmd->SetDefaultUnit("ns");
+  fTimeCutCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fTimeCutCmd->SetToBeBroadcasted(false);
+
+  fDepositKilledCmd = new G4UIcmdWithABool("/ATHENA/stacking/depositKilled", this);
+  fDepositKilledCmd->SetGuidance("Deposit the kinetic energy of the killed tracks at their");
+  fDepositKilledCmd->SetGuidance("creation point, in the sensitive detector of the volume.");
+  fDepositKilledCmd->SetGuidance("Default: false");
+  fDepositKilledCmd->SetParameterName("deposit", false);
+  fDepositKilledCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fDepositKilledCmd->SetToBeBroadcasted(false);
+
+  fPrintCmd = new G4UIcmdWithoutParameter("/ATHENA/stacking/print", this);
+  fPrintCmd->SetGuidance("Print the stacking cuts.");
+  fPrintCmd->SetToBeBroadcasted(false);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+StackingMessenger::~StackingMessenger()
+{
+  delete fKillBelowCmd;
+  delete fClearCmd;
+  delete fTimeCutCmd;
+  delete fDepositKilledCmd;
+  delete fPrintCmd;
+  delete fStackingDir;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void StackingMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
+{
+  if ( command == fKillBelowCmd ) {
+    std::istringstream is(newValue);
+    G4String particleName, unit;
+    G4double energy;
+    is >> particleName >> energy >> unit;
+    fConfig->SetThreshold(particleName, energy*G4UIcommand::ValueOf(unit));
+  }
+  else if ( command == fClearCmd ) {
+    fConfig->ClearThresholds();
+  }
+  else if ( command == fTimeCutCmd ) {
+    fConfig->SetTimeCut(fTimeCutCmd->GetNewDoubleValue(newValue));
+  }
+  else if ( command == fDepositKilledCmd ) {
+    fConfig->SetDepositKilled(fDepositKilledCmd->GetNewBoolValue(newValue));
+  }
+  else if ( command == fPrintCmd ) {
+    fConfig->Print();
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,221 @@
+/// \file StepFormat.cc
+/// \brief Implementation of the step file format helpers
+
+#include "StepFormat.hh"
+
+#include <cstring>
+
+namespace
+{
+  template <typename T>
+  bool WriteValue(std::FILE* file, T value)
+  {
+    return std::fwrite(&value, sizeof(T), 1, file) == 1;
+  }
+
+  template <typename T>
+  void AppendValue(std::vector<char>& out, T value)
+  {
+    auto data = reinterpret_cast<const char*>(&value);
+    out.insert(out.end(), data, data + sizeof(T));
+  }
+
+  template <typename T>
+  bool ReadValue(std::FILE* file, T& value)
+  {
+    return std::fread(&value, sizeof(T), 1, file) == 1;
+  }
+
+  void AppendVarint(std::vector<char>& out, std::uint64_t value)
+  {
+    while ( value >= 0x80 ) {
+      out.push_back(char( ( value & 0x7f ) | 0x80 ));
+      value >>= 7;
+    }
+    out.push_back(char(value));
+  }
+
+  // Signed differences are zigzag encoded so that small negative values
+  // also take few bytes
+  void AppendSigned(std::vector<char>& out, std::int64_t value)
+  {
+    AppendVarint(out, ( std::uint64_t(value) << 1 ) ^ std::uint64_t(value >> 63));
+  }
+
+  bool ReadVarint(const char*& data, const char* end, std::uint64_t& value)
+  {
+    value = 0;
+    for ( int shift = 0; shift < 64 && data < end; shift += 7 ) {
+      auto byte = std::uint8_t(*data++);
+      value |= std::uint64_t(byte & 0x7f) << shift;
+      if ( ! ( byte & 0x80 ) ) return true;
+    }
+    return false;
+  }
+
+  bool ReadSigned(const char*& data, const char* end, std::int64_t& value)
+  {
+    std::uint64_t encoded = 0;
+    if ( ! ReadVarint(data, end, encoded) ) return false;
+    value = std::int64_t( encoded >> 1 ) ^ -std::int64_t( encoded & 1 );
+    return true;
+  }
+}
+
+namespace StepFormat
+{
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+int VolumeCode(int blockX, int blockY, bool absorber)
+{
+  return ( ( blockX << 5 | blockY ) << 1 ) | ( absorber ? 1 : 0 );
+}
+
+int VolumeBlockX(int code)
+{
+  return code >> 6;
+}
+
+int VolumeBlockY(int code)
+{
+  return ( code >> 1 ) & 0x1f;
+}
+
+bool IsAbsorberVolume(int code)
+{
+  return code & 1;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+bool WriteFileHeader(std::FILE* file, const Grid& grid)
+{
+  return std::fwrite(kFileMagic, 1, sizeof(kFileMagic), file) == sizeof(kFileMagic)
+      && WriteValue(file, kVersion)
+      && WriteValue(file, grid.transverse)
+      && WriteValue(file, grid.longitudinal)
+      && WriteValue(file, grid.time)
+      && WriteValue(file, grid.energy);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+bool ReadFileHeader(std::FILE* file, Grid& grid)
+{
+  char magic[sizeof(kFileMagic)];
+  std::uint32_t version = 0;
+  if ( std::fread(magic, 1, sizeof(magic), file) != sizeof(magic)
+       || std::memcmp(magic, kFileMagic, sizeof(magic)) != 0
+       || ! ReadValue(file, version) || version != kVersion ) return false;
+
+  return ReadValue(file, grid.transverse)
+      && ReadValue(file, grid.longitudinal)
+      && ReadValue(file, grid.time)
+      && ReadValue(file, grid.energy);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EncodeEvent(const Event& event, std::vector<char>& payload)
+{
+  AppendVarint(payload, std::uint32_t(event.eventID));
+  AppendVarint(payload, event.steps.size());
+  AppendVarint(payload, event.nofDropped);
+
+  Step previous = {};
+  for ( const auto& step : event.steps ) {
+    AppendSigned(payload, step.x - previous.x);
+    AppendSigned(payload, step.y - previous.y);
+    AppendSigned(payload, step.z - previous.z);
+    AppendSigned(payload, step.time - previous.time);
+    AppendSigned(payload, std::int64_t(step.pdg) - previous.pdg);
+    AppendSigned(payload, std::int64_t(step.volume) - previous.volume);
+    AppendSigned(payload, std::int64_t(step.trackID) - previous.trackID);
+    AppendSigned(payload, step.edep);
+    previous = step;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+bool DecodeEvent(const char*& data, const char* end, Event& event)
+{
+  std::uint64_t eventID = 0, nofSteps = 0, nofDropped = 0;
+  if ( ! ReadVarint(data, end, eventID) || ! ReadVarint(data, end, nofSteps)
+       || ! ReadVarint(data, end, nofDropped) ) return false;
+  // Every step takes at least 8 bytes
+  if ( nofSteps > std::uint64_t(end - data) / 8 ) return false;
+
+  event.eventID = std::int32_t(eventID);
+  event.nofDropped = std::uint32_t(nofDropped);
+  event.steps.resize(nofSteps);
+
+  Step previous = {};
+  for ( auto& step : event.steps ) {
+    std::int64_t pdg = 0, volume = 0, trackID = 0;
+    if ( ! ReadSigned(data, end, step.x) || ! ReadSigned(data, end, step.y)
+         || ! ReadSigned(data, end, step.z) || ! ReadSigned(data, end, step.time)
+         || ! ReadSigned(data, end, pdg) || ! ReadSigned(data, end, volume)
+         || ! ReadSigned(data, end, trackID) || ! ReadSigned(data, end, step.edep) ) {
+      return false;
+    }
+    step.x       += previous.x;
+    step.y       += previous.y;
+    step.z       += previous.z;
+    step.time    += previous.time;
+    step.pdg      = std::int32_t(pdg + previous.pdg);
+    step.volume   = std::int32_t(volume + previous.volume);
+    step.trackID  = std::int32_t(trackID + previous.trackID);
+    previous = step;
+  }
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+std::size_t WriteBlock(std::FILE* file, std::uint32_t nofEvents,
+                       const std::vector<char>& payload,
+                       ColumnarFormat::Codec codec, int level)
+{
+  std::vector<char> encoded;
+  auto storedCodec = ColumnarFormat::Encode(codec, level, payload.data(), payload.size(),
+                                            encoded);
+
+  std::vector<char> header;
+  AppendValue(header, kBlockMagic);
+  AppendValue(header, nofEvents);
+  AppendValue(header, std::uint8_t(storedCodec));
+  AppendValue(header, std::uint64_t(payload.size()));
+  AppendValue(header, std::uint64_t(encoded.size()));
+
+  if ( std::fwrite(header.data(), 1, header.size(), file) != header.size()
+       || std::fwrite(encoded.data(), 1, encoded.size(), file) != encoded.size() ) {
+    return 0;
+  }
+  return header.size() + encoded.size();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+bool ReadBlock(std::FILE* file, std::uint32_t& nofEvents, std::vector<char>& payload)
+{
+  std::uint32_t magic = 0;
+  std::uint8_t codec = 0;
+  ColumnarFormat::Chunk chunk = {};
+  if ( ! ReadValue(file, magic) || magic != kBlockMagic
+       || ! ReadValue(file, nofEvents) || ! ReadValue(file, codec)
+       || ! ReadValue(file, chunk.rawSize) || ! ReadValue(file, chunk.storedSize) ) {
+    return false;
+  }
+  chunk.codec = ColumnarFormat::Codec(codec);
+
+  std::vector<char> stored(chunk.storedSize);
+  if ( std::fread(stored.data(), 1, stored.size(), file) != stored.size() ) return false;
+  payload.resize(chunk.rawSize);
+  return ColumnarFormat::Decode(chunk, stored.data(), payload.data());
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+}
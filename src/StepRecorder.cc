@@ -0,0 +1,232 @@
+/// \file StepRecorder.cc
+/// \brief Implementation of the StepRecorder class
+
+#include "StepRecorder.hh"
+#include "OutputConfig.hh"
+
+#include "G4Step.hh"
+#include "G4Track.hh"
+#include "G4ParticleDefinition.hh"
+#include "G4SystemOfUnits.hh"
+
+#include <cmath>
+#include <limits>
+
+namespace
+{
+  // Encoded size of the events collected before a block is written
+  const std::size_t kBlockSize = 1 << 20;
+
+  std::int64_t Quantise(G4double value, G4double unit)
+  {
+    return std::llround(value/unit);
+  }
+}
+
+G4ThreadLocal StepRecorder* StepRecorder::fInstance = nullptr;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+StepRecorder* StepRecorder::Instance()
+{
+  if ( ! fInstance ) {
+    fInstance = new StepRecorder();
+  }
+  return fInstance;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+StepRecorder::StepRecorder()
+ : fFile(nullptr),
+   fGrid(),
+   fPrescale(0),
+   fFibersOnly(true),
+   fUseRegion(false),
+   fMinEdep(0.),
+   fMaxSteps(0),
+   fCodec(ColumnarFormat::Codec::None),
+   fLevel(0),
+   fRecording(false),
+   fEvent(),
+   fNofEventsInBlock(0),
+   fNofEvents(0),
+   fNofSteps(0),
+   fNofDropped(0),
+   fNofTruncatedEvents(0),
+   fNofBlocks(0),
+   fRawBytes(0),
+   fBytesWritten(0)
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+StepRecorder::~StepRecorder()
+{
+  Close();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+bool StepRecorder::Open(const G4String& fileName)
+{
+  Close();
+
+  auto outputConfig = OutputConfig::Instance();
+  fGrid = outputConfig->GetStepGrid();
+  fPrescale = outputConfig->GetStepPrescale();
+  fFibersOnly = outputConfig->GetStepVolumes() == "fibers";
+  fUseRegion = outputConfig->IsStepRegion();
+  fRegionMin = outputConfig->GetStepRegionMin();
+  fRegionMax = outputConfig->GetStepRegionMax();
+  fMinEdep = outputConfig->GetStepMinEdep();
+  fMaxSteps = ( outputConfig->GetStepMaxSteps() > 0 )
+              ? std::size_t(outputConfig->GetStepMaxSteps())
+              : std::numeric_limits<std::size_t>::max();
+  fCodec = ( outputConfig->GetCompressionAlgorithm() == "zlib" )
+           ? ColumnarFormat::Codec::Zlib : ColumnarFormat::Codec::None;
+  fLevel = outputConfig->GetCompressionLevel();
+
+  fRecording = false;
+  fPayload.clear();
+  fNofEventsInBlock = 0;
+  fNofEvents = 0;
+  fNofSteps = 0;
+  fNofDropped = 0;
+  fNofTruncatedEvents = 0;
+  fNofBlocks = 0;
+  fRawBytes = 0;
+  fBytesWritten = 0;
+
+  fFile = std::fopen(fileName.c_str(), "wb");
+  if ( ! fFile ) return false;
+  fFileName = fileName;
+
+  if ( ! StepFormat::WriteFileHeader(fFile, fGrid) ) {
+    std::fclose(fFile);
+    fFile = nullptr;
+    return false;
+  }
+  fBytesWritten = sizeof(StepFormat::kFileMagic) + sizeof(StepFormat::kVersion)
+                + sizeof(StepFormat::Grid);
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void StepRecorder::Close()
+{
+  if ( ! fFile ) return;
+
+  if ( fRecording ) EndEvent();
+  WriteBlock();
+  std::fclose(fFile);
+  fFile = nullptr;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void StepRecorder::BeginEvent(G4int eventID)
+{
+  fRecording = fFile && fPrescale > 0 && eventID % fPrescale == 0;
+  if ( ! fRecording ) return;
+
+  fEvent.eventID = eventID;
+  fEvent.nofDropped = 0;
+  fEvent.steps.clear();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void StepRecorder::Record(const G4Step* step, G4double edep, G4int volume)
+{
+  if ( edep <= 0. || edep < fMinEdep ) return;
+  if ( fFibersOnly && StepFormat::IsAbsorberVolume(volume) ) return;
+
+  // The deposit is attributed to the middle of the step
+  auto preStepPoint = step->GetPreStepPoint();
+  auto postStepPoint = step->GetPostStepPoint();
+  auto position = 0.5*( preStepPoint->GetPosition() + postStepPoint->GetPosition() );
+  if ( fUseRegion
+       && ( position.x() < fRegionMin.x() || position.x() > fRegionMax.x()
+         || position.y() < fRegionMin.y() || position.y() > fRegionMax.y()
+         || position.z() < fRegionMin.z() || position.z() > fRegionMax.z() ) ) return;
+
+  if ( fEvent.steps.size() >= fMaxSteps ) {
+    ++fEvent.nofDropped;
+    return;
+  }
+
+  auto time = 0.5*( preStepPoint->GetGlobalTime() + postStepPoint->GetGlobalTime() );
+  auto track = step->GetTrack();
+  fEvent.steps.push_back(
+    { Quantise(position.x()/mm, fGrid.transverse),
+      Quantise(position.y()/mm, fGrid.transverse),
+      Quantise(position.z()/mm, fGrid.longitudinal),
+      Quantise(time/ns, fGrid.time),
+      Quantise(edep/MeV, fGrid.energy),
+      std::int32_t(track->GetDefinition()->GetPDGEncoding()),
+      std::int32_t(volume),
+      std::int32_t(track->GetTrackID()) });
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void StepRecorder::EndEvent()
+{
+  if ( ! fRecording ) return;
+  fRecording = false;
+
+  auto size = fPayload.size();
+  StepFormat::EncodeEvent(fEvent, fPayload);
+  fRawBytes += fPayload.size() - size;
+  ++fNofEventsInBlock;
+  ++fNofEvents;
+  fNofSteps += fEvent.steps.size();
+  fNofDropped += fEvent.nofDropped;
+  if ( fEvent.nofDropped > 0 ) ++fNofTruncatedEvents;
+
+  if ( fPayload.size() >= kBlockSize ) WriteBlock();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void StepRecorder::WriteBlock()
+{
+  if ( fNofEventsInBlock == 0 ) return;
+
+  auto nofBytes = StepFormat::WriteBlock(fFile, fNofEventsInBlock, fPayload, fCodec, fLevel);
+  if ( nofBytes == 0 ) {
+    G4ExceptionDescription msg;
+    msg << "Cannot write " << fNofEventsInBlock << " events to " << fFileName;
+    G4Exception("StepRecorder::WriteBlock()",
+      "MyCode0009", JustWarning, msg);
+  }
+  // Complete blocks survive if the process is killed afterwards
+  std::fflush(fFile);
+
+  fBytesWritten += nofBytes;
+  ++fNofBlocks;
+  fPayload.clear();
+  fNofEventsInBlock = 0;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void StepRecorder::PrintStatistics() const
+{
+  G4cout << "---> Steps: " << fFileName << ": " << fNofEvents << " events, "
+         << fNofSteps << " steps in " << fNofBlocks << " blocks, "
+         << fBytesWritten/1.e6 << " MB";
+  if ( fNofSteps > 0 ) {
+    G4cout << " (" << G4double(fBytesWritten)/fNofSteps << " bytes/step, "
+           << G4double(fRawBytes)/fNofSteps << " before compression)";
+  }
+  G4cout << G4endl;
+  if ( fNofDropped > 0 ) {
+    G4cout << "       " << fNofDropped << " steps dropped in " << fNofTruncatedEvents
+           << " events over the limit of " << fMaxSteps << " steps" << G4endl;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
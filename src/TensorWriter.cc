@@ -0,0 +1,141 @@
+/// \file TensorWriter.cc
+/// \brief Implementation of the TensorWriter class
+
+#include "TensorWriter.hh"
+#include "EventRecord.hh"
+#include "GlobalValues.hh"
+
+#include "G4SystemOfUnits.hh"
+
+using namespace GlobalValues;
+
+namespace
+{
+  /// One record of the labels file; matches kLabelsDescr
+  struct LabelRecord
+  {
+    std::int32_t eventID;
+    std::int32_t pdg;
+    float        energy;
+    float        posX;
+    float        posY;
+    float        posZ;
+    float        dirX;
+    float        dirY;
+    float        dirZ;
+  };
+  static_assert(sizeof(LabelRecord) == 36, "LabelRecord must not be padded");
+
+  const char* kLabelsDescr
+    = "[('eventID', '<i4'), ('pdg', '<i4'), ('energy', '<f4'), "
+      "('x', '<f4'), ('y', '<f4'), ('z', '<f4'), "
+      "('dx', '<f4'), ('dy', '<f4'), ('dz', '<f4')]";
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+TensorWriter::TensorWriter()
+ : fFloat16(false)
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+TensorWriter::~TensorWriter()
+{
+  Close();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+bool TensorWriter::Open(const G4String& baseName, G4bool float16)
+{
+  Close();
+
+  fBaseName = baseName;
+  fFloat16 = float16;
+
+  std::string descr = float16 ? "'<f2'" : "'<f4'";
+  std::size_t valueSize = float16 ? 2 : 4;
+  std::size_t nofBlocks = NumECalBlocks;
+  std::size_t nofTowers = NumHCalTowers;
+  std::size_t nofLayers = NumHCalLayers;
+
+  return fECalWriter.Open(baseName + "_ecal.npy", descr,
+                          { nofBlocks, nofBlocks },
+                          nofBlocks*nofBlocks*valueSize)
+      && fHCalWriter.Open(baseName + "_hcal.npy", descr,
+                          { nofTowers, nofTowers, nofLayers },
+                          nofTowers*nofTowers*nofLayers*valueSize)
+      && fLabelsWriter.Open(baseName + "_labels.npy", kLabelsDescr,
+                            {}, sizeof(LabelRecord));
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void TensorWriter::AppendEnergies(NpyWriter& writer,
+                                  const std::vector<G4double>& energies)
+{
+  if ( fFloat16 ) {
+    fBuffer.resize(energies.size()*sizeof(std::uint16_t));
+    auto values = reinterpret_cast<std::uint16_t*>(fBuffer.data());
+    for ( std::size_t i=0; i<energies.size(); ++i ) {
+      values[i] = NpyWriter::ToFloat16(float(energies[i]/GeV));
+    }
+  }
+  else {
+    fBuffer.resize(energies.size()*sizeof(float));
+    auto values = reinterpret_cast<float*>(fBuffer.data());
+    for ( std::size_t i=0; i<energies.size(); ++i ) {
+      values[i] = float(energies[i]/GeV);
+    }
+  }
+  writer.Append(fBuffer.data());
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void TensorWriter::Write(const EventRecord& record)
+{
+  // The aborted events have no cells
+  if ( record.containment.status == ContainmentStatus::Aborted ) return;
+
+  // The cells of the record are stored in the tensor order already
+  fEnergies.resize(record.ecalBlocks.size());
+  for ( std::size_t i=0; i<record.ecalBlocks.size(); ++i ) {
+    fEnergies[i] = record.ecalBlocks[i].edepActive;
+  }
+  AppendEnergies(fECalWriter, fEnergies);
+
+  fEnergies.resize(record.hcalTiles.size());
+  for ( std::size_t i=0; i<record.hcalTiles.size(); ++i ) {
+    fEnergies[i] = record.hcalTiles[i].edepActive;
+  }
+  AppendEnergies(fHCalWriter, fEnergies);
+
+  const auto& primary = record.primary;
+  LabelRecord label = { std::int32_t(record.eventID), std::int32_t(primary.pdg),
+                        float(primary.energy/GeV),
+                        float(primary.posX), float(primary.posY), float(primary.posZ),
+                        float(primary.dirX), float(primary.dirY), float(primary.dirZ) };
+  fLabelsWriter.Append(&label);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void TensorWriter::Flush()
+{
+  fECalWriter.Flush();
+  fHCalWriter.Flush();
+  fLabelsWriter.Flush();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void TensorWriter::Close()
+{
+  fECalWriter.Close();
+  fHCalWriter.Close();
+  fLabelsWriter.Close();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,173 @@
+/// \file TopoClustering.cc
+/// \brief Implementation of the TopoClustering class
+
+#include "TopoClustering.hh"
+#include "EventRecord.hh"
+#include "GlobalValues.hh"
+
+#include "G4SystemOfUnits.hh"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace GlobalValues;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+TopoClustering::TopoClustering()
+ : fNofECalCells(NumECalBlocks*NumECalBlocks),
+   fECalSeed(0.),
+   fECalNeighbour(0.),
+   fHCalSeed(0.),
+   fHCalNeighbour(0.)
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void TopoClustering::Initialize(const std::vector<G4TwoVector>& ecalCenters,
+                                const std::vector<G4TwoVector>& hcalCenters)
+{
+  auto nofHCalCells = NumHCalTowers*NumHCalTowers;
+  fCenters.assign(fNofECalCells + nofHCalCells, G4TwoVector());
+  std::copy_n(ecalCenters.begin(), std::min<std::size_t>(ecalCenters.size(), fNofECalCells),
+              fCenters.begin());
+  std::copy_n(hcalCenters.begin(), std::min<std::size_t>(hcalCenters.size(), nofHCalCells),
+              fCenters.begin() + fNofECalCells);
+
+  std::vector<std::vector<G4int>> neighbours(fCenters.size());
+
+  // Surrounding cells of the same grid
+  auto addGrid = [&neighbours](G4int first, G4int size) {
+    for ( G4int i=0; i<size; ++i ) {
+      for ( G4int j=0; j<size; ++j ) {
+        for ( G4int di=-1; di<=1; ++di ) {
+          for ( G4int dj=-1; dj<=1; ++dj ) {
+            if ( di == 0 && dj == 0 ) continue;
+            if ( i+di < 0 || i+di >= size || j+dj < 0 || j+dj >= size ) continue;
+            neighbours[first + i*size + j].push_back(first + (i+di)*size + j+dj);
+          }
+        }
+      }
+    }
+  };
+  addGrid(0, NumECalBlocks);
+  addGrid(fNofECalCells, NumHCalTowers);
+
+  // Each ECal block and the HCal tower behind it
+  for ( G4int block=0; block<fNofECalCells; ++block ) {
+    auto tower = fNofECalCells;
+    for ( G4int cell=fNofECalCells+1; cell<G4int(fCenters.size()); ++cell ) {
+      if ( (fCenters[cell] - fCenters[block]).mag2()
+           < (fCenters[tower] - fCenters[block]).mag2() ) tower = cell;
+    }
+    neighbours[block].push_back(tower);
+    neighbours[tower].push_back(block);
+  }
+
+  fNeighbourOffsets.assign(1, 0);
+  fNeighbours.clear();
+  for ( const auto& cellNeighbours : neighbours ) {
+    fNeighbours.insert(fNeighbours.end(), cellNeighbours.begin(), cellNeighbours.end());
+    fNeighbourOffsets.push_back(G4int(fNeighbours.size()));
+  }
+
+  fEnergies.assign(fCenters.size(), 0.);
+  fLabels.assign(fCenters.size(), -1);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void TopoClustering::SetThresholds(G4double ecalSeed, G4double ecalNeighbour,
+                                   G4double hcalSeed, G4double hcalNeighbour)
+{
+  fECalSeed = std::max(ecalSeed, ecalNeighbour);
+  fECalNeighbour = ecalNeighbour;
+  fHCalSeed = std::max(hcalSeed, hcalNeighbour);
+  fHCalNeighbour = hcalNeighbour;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+std::vector<G4int> TopoClustering::GetNeighbours(G4int cell) const
+{
+  return std::vector<G4int>(fNeighbours.begin() + fNeighbourOffsets[cell],
+                            fNeighbours.begin() + fNeighbourOffsets[cell+1]);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void TopoClustering::Process(EventRecord& record)
+{
+  record.clusters.clear();
+
+  // Active energies and seeds, the most energetic first
+  fSeeds.clear();
+  for ( G4int cell=0; cell<GetNumberOfCells(); ++cell ) {
+    auto edep = IsECal(cell) ? record.ecalBlocks[cell].edepActive
+                             : record.hcalTowers[cell - fNofECalCells].edepActive;
+    fEnergies[cell] = edep;
+    fLabels[cell] = -1;
+    if ( edep > 0. && edep >= ( IsECal(cell) ? fECalSeed : fHCalSeed ) ) {
+      fSeeds.push_back(cell);
+    }
+  }
+  std::sort(fSeeds.begin(), fSeeds.end(), [this](G4int left, G4int right) {
+    return fEnergies[left] > fEnergies[right];
+  });
+
+  for ( auto seed : fSeeds ) {
+    if ( fLabels[seed] >= 0 ) continue;
+
+    G4int label = G4int(record.clusters.size());
+    ClusterRecord cluster;
+    G4double sumX[2] = { 0., 0. }, sumY[2] = { 0., 0. };
+    G4double sumX2[2] = { 0., 0. }, sumY2[2] = { 0., 0. };
+
+    // Breadth-first growth over the neighbours above threshold
+    fQueue.assign(1, seed);
+    fLabels[seed] = label;
+    for ( std::size_t next=0; next<fQueue.size(); ++next ) {
+      auto cell = fQueue[next];
+      auto edep = fEnergies[cell];
+      auto ecal = IsECal(cell);
+      auto x = fCenters[cell].x()/cm;
+      auto y = fCenters[cell].y()/cm;
+      if ( ecal ) {
+        cluster.edepECal += edep;
+        ++cluster.numECalBlocks;
+      }
+      else {
+        cluster.edepHCal += edep;
+        ++cluster.numHCalTowers;
+      }
+      sumX[ecal ? 0 : 1]  += edep*x;
+      sumY[ecal ? 0 : 1]  += edep*y;
+      sumX2[ecal ? 0 : 1] += edep*x*x;
+      sumY2[ecal ? 0 : 1] += edep*y*y;
+
+      for ( auto n=fNeighbourOffsets[cell]; n<fNeighbourOffsets[cell+1]; ++n ) {
+        auto neighbour = fNeighbours[n];
+        if ( fLabels[neighbour] >= 0 ) continue;
+        auto threshold = IsECal(neighbour) ? fECalNeighbour : fHCalNeighbour;
+        if ( fEnergies[neighbour] <= 0. || fEnergies[neighbour] < threshold ) continue;
+        fLabels[neighbour] = label;
+        fQueue.push_back(neighbour);
+      }
+    }
+
+    // Energy-weighted centroid and width per detector
+    G4double sums[2] = { cluster.edepECal, cluster.edepHCal };
+    TransverseShape* shapes[2] = { &cluster.ecal, &cluster.hcal };
+    for ( G4int d=0; d<2; ++d ) {
+      if ( sums[d] <= 0. ) continue;
+      auto& shape = *shapes[d];
+      shape.centroidX = sumX[d]/sums[d];
+      shape.centroidY = sumY[d]/sums[d];
+      shape.widthX = std::sqrt(std::max(sumX2[d]/sums[d] - shape.centroidX*shape.centroidX, 0.));
+      shape.widthY = std::sqrt(std::max(sumY2[d]/sums[d] - shape.centroidY*shape.centroidY, 0.));
+    }
+    record.clusters.push_back(cluster);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
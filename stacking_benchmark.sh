@@ -0,0 +1,70 @@
+#!/bin/bash
+# Stacking benchmark: runs the same pion beam without stacking cuts and
+# with energy thresholds for the neutrons and time cuts, with and without
+# local deposition of the killed tracks, and reports the events/s, the
+# killed tracks per event and the response (mean and resolution of the
+# total energy) printed by RunAction.
+# Run from the build directory: ./stacking_benchmark.sh [num_events] [num_threads]
+set -e
+
+num_events=${1:-500}
+num_threads=${2:-4}
+particle="pi+"
+energy=10
+
+# name:stacking settings, one command argument list per ';'
+configurations=(
+	"none:"
+	"neutron_1MeV:killBelow neutron 1 MeV"
+	"neutron_10MeV:killBelow neutron 10 MeV"
+	"neutron_10MeV_deposit:killBelow neutron 10 MeV;depositKilled true"
+	"time_1us:timeCut 1 us"
+	"time_100ns:timeCut 100 ns"
+	"time_100ns_deposit:timeCut 100 ns;depositKilled true"
+)
+
+macro="stacking_benchmark.mac"
+report="stacking_benchmark.txt"
+echo "configuration run_time(s) events/s killed/event mean(MeV) sigma(MeV) resolution" > $report
+
+for configuration in "${configurations[@]}"
+do
+	name=${configuration%%:*}
+	settings=${configuration#*:}
+	output="stacking_benchmark_${name}"
+	{
+		echo "/ATHENA/analysis/resolutionScan true"
+		echo "/analysis/setFileName ${output}"
+		echo "/run/initialize"
+		IFS=';' read -ra commands <<< "$settings"
+		for command in "${commands[@]}"
+		do
+			echo "/ATHENA/stacking/${command}"
+		done
+		cat <<MAC
+/gps/particle ${particle}
+/gps/ene/type Mono
+/gps/ene/mono ${energy} GeV
+/gps/pos/type Plane
+/gps/pos/shape Square
+/gps/pos/rot1 1 0 0
+/gps/pos/rot2 0 1 0
+/gps/pos/halfx 0.25 cm
+/gps/pos/halfy 0.25 cm
+/gps/pos/centre 2.5025 2.4747 -8.5 cm
+/gps/direction 0 .08715574275 .9961946981
+/run/beamOn ${num_events}
+MAC
+	} > $macro
+	echo "Running ${name}"
+	log="${output}.log"
+	./ATHENA_Geometry -m $macro -t ${num_threads} > $log 2>&1
+	run_time=$(grep "run time" $log | sed 's/.*run time: \([0-9.e+]*\) s/\1/')
+	rate=$(echo "${num_events} ${run_time}" | awk '{ if ($2 > 0) print $1/$2; else print "-" }')
+	killed=$(grep "tracks killed per event" $log | sed 's/.*Stacking: \([0-9.e+-]*\) tracks.*/\1/')
+	response=$(grep "unweighted: mean" $log | sed 's/.*mean \([0-9.e+-]*\) MeV, sigma \([0-9.e+-]*\) MeV, resolution \([0-9.e+-]*\).*/\1 \2 \3/')
+	echo "${name} ${run_time} ${rate} ${killed:-0} ${response}" >> $report
+	rm -f ${output}.root
+done
+
+column -t $report
@@ -0,0 +1,54 @@
+#!/bin/bash
+# Event dispatch: runs pions with energies uniform between 1 and 100 GeV,
+# whose cost varies several-fold between events, with the multi-threaded
+# and task-based run managers and different numbers of events per chunk,
+# and reports the run time and events/s printed by RunAction.
+# Run from the build directory: ./tasking_benchmark.sh [num_events] [num_threads]
+set -e
+
+num_events=${1:-500}
+num_threads=${2:-auto}
+particle="pi+"
+
+macro="tasking_benchmark.mac"
+cat > $macro <<MAC
+/ATHENA/analysis/resolutionScan false
+/analysis/setFileName tasking_benchmark
+/run/initialize
+/gps/particle ${particle}
+/gps/ene/type Lin
+/gps/ene/gradient 0
+/gps/ene/intercept 1
+/gps/ene/min 1 GeV
+/gps/ene/max 100 GeV
+/gps/pos/type Plane
+/gps/pos/shape Square
+/gps/pos/rot1 1 0 0
+/gps/pos/rot2 0 1 0
+/gps/pos/halfx 0.25 cm
+/gps/pos/halfy 0.25 cm
+/gps/pos/centre 2.5025 2.4747 -8.5 cm
+/gps/direction 0 .08715574275 .9961946981
+/run/beamOn ${num_events}
+MAC
+
+# run manager:events per chunk (0: Geant4 default)
+configurations=("mt:0" "mt:1" "tasking:0" "tasking:1" "tasking:4")
+
+report="tasking_benchmark.txt"
+echo "run_manager events/chunk threads run_time(s) events/s" > $report
+
+for configuration in "${configurations[@]}"
+do
+	IFS=':' read -r run_manager chunk <<< "$configuration"
+	echo "Running ${run_manager} with ${chunk} events per chunk"
+	log="tasking_benchmark_${run_manager}_${chunk}.log"
+	./ATHENA_Geometry -m $macro -t ${num_threads} -r ${run_manager} -c ${chunk} > $log 2>&1
+	threads=$(grep "Run manager:" $log | sed 's/.*, \([0-9]*\) threads.*/\1/')
+	run_time=$(grep "run time" $log | sed 's/.*run time: \([0-9.e+]*\) s/\1/')
+	rate=$(echo "${num_events} ${run_time}" | awk '{ if ($2 > 0) print $1/$2; else print "-" }')
+	echo "${run_manager} ${chunk} ${threads} ${run_time} ${rate}" >> $report
+	rm -f tasking_benchmark*.root
+done
+
+column -t $report
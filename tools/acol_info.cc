@@ -0,0 +1,112 @@
+/// \file acol_info.cc
+/// \brief Print the content of a columnar dataset
+///
+/// Usage: acol_info <dataset.acolset | file.acol> [table column | --event eventID]
+///
+/// Prints the files, tables, number of rows and events, and the run-level
+/// histograms of the dataset.
+/// With a table and a column name, also prints the sum, minimum and maximum
+/// of the column over the whole dataset. With --event, prints where the rows
+/// of that event are stored and its values in the EdepTotal table.
+
+#include "ColumnarReader.hh"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <numeric>
+#include <string>
+
+int main(int argc, char** argv)
+{
+  if ( argc != 2 && argc != 4 ) {
+    std::cerr << "Usage: acol_info <dataset.acolset | file.acol>"
+              << " [table column | --event eventID]" << std::endl;
+    return 1;
+  }
+
+  ColumnarDataset dataset;
+  if ( ! dataset.Open(argv[1]) ) {
+    std::cerr << "Cannot open " << argv[1] 
+              << " (missing file or schema mismatch)" << std::endl;
+    return 1;
+  }
+
+  std::cout << "Files: " << dataset.GetNumberOfFiles() << std::endl;
+  for ( std::size_t i=0; i<dataset.GetNumberOfFiles(); ++i ) {
+    const auto& file = dataset.GetFile(i);
+    std::cout << "  " << file.GetFileName() << ": " << file.GetBlocks().size() 
+              << " blocks, " << file.GetNumberOfEvents() << " events"
+              << ( file.IsIndexRebuilt() ? " (index rebuilt)" : "" )
+              << ( file.IsTruncated() ? " (truncated)" : "" ) << std::endl;
+  }
+  std::cout << "Events: " << dataset.GetNumberOfEvents();
+  if ( dataset.GetNumberOfDuplicateEvents() > 0 ) {
+    std::cout << " (" << dataset.GetNumberOfDuplicateEvents() << " duplicate eventIDs ignored)";
+  }
+  std::cout << std::endl;
+
+  const auto& schema = dataset.GetSchema();
+  std::cout << "Tables:" << std::endl;
+  for ( std::size_t i=0; i<schema.size(); ++i ) {
+    std::cout << "  " << schema[i].name << ": " << dataset.GetNumberOfRows(int(i)) 
+              << " rows, columns";
+    for ( const auto& column : schema[i].columns ) {
+      std::cout << " " << column.name << "/" << char(column.type);
+    }
+    std::cout << std::endl;
+  }
+
+  std::vector<ColumnarFormat::Histogram> histograms;
+  if ( ! dataset.GetHistograms(histograms) ) {
+    std::cerr << "Warning: histograms with different binnings" << std::endl;
+  }
+  for ( const auto& histogram : histograms ) {
+    std::cout << "Histogram " << histogram.name << ": " << histogram.contents.size()
+              << " bins, sum "
+              << std::accumulate(histogram.contents.begin(), histogram.contents.end(), 0.)
+              << std::endl;
+  }
+
+  if ( argc == 4 && std::string(argv[2]) == "--event" ) {
+    auto eventID = std::atoi(argv[3]);
+    auto location = dataset.FindEvent(eventID);
+    if ( ! location ) {
+      std::cerr << "Event " << eventID << " not found" << std::endl;
+      return 1;
+    }
+    const auto& file = dataset.GetFile(location->file);
+    std::cout << "Event " << eventID << " in " << file.GetFileName() << ":" << std::endl;
+    for ( std::size_t i=0; i<schema.size(); ++i ) {
+      auto rows = file.GetEventRows(location->entry, int(i));
+      std::cout << "  " << schema[i].name << ": rows " << rows.firstRow
+                << " - " << rows.firstRow + rows.nofRows << std::endl;
+    }
+    auto tableId = ColumnarFormat::FindTable(schema, "EdepTotal");
+    if ( tableId >= 0 ) {
+      for ( std::size_t i=0; i<schema[tableId].columns.size(); ++i ) {
+        auto values = dataset.ReadEventAsDouble(eventID, tableId, int(i));
+        if ( values.empty() ) continue;
+        std::cout << "  " << schema[tableId].columns[i].name << " = " << values[0] << std::endl;
+      }
+    }
+  }
+  else if ( argc == 4 ) {
+    auto tableId = ColumnarFormat::FindTable(schema, argv[2]);
+    auto columnId = ( tableId < 0 ) ? -1 : ColumnarFormat::FindColumn(schema[tableId], argv[3]);
+    if ( columnId < 0 ) {
+      std::cerr << "Unknown column " << argv[2] << "/" << argv[3] << std::endl;
+      return 1;
+    }
+    auto values = dataset.ReadColumnAsDouble(tableId, columnId);
+    if ( ! values.empty() ) {
+      std::cout << argv[2] << "/" << argv[3] << ": sum " 
+                << std::accumulate(values.begin(), values.end(), 0.)
+                << ", min " << *std::min_element(values.begin(), values.end())
+                << ", max " << *std::max_element(values.begin(), values.end()) 
+                << std::endl;
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,462 @@
+/// \file acol_merge.cc
+/// \brief Merge the columnar outputs of several jobs into one file
+///
+/// Usage: acol_merge [-j threads] [-l level] [--eventids keep|offset|renumber]
+///                   -o <output.acol> <input.acolset | input.acol> ...
+///
+/// The inputs (files, or datasets given by their manifest) must have the
+/// same schema. They are merged in the order given, each by its own thread:
+/// - the row blocks are copied as stored, without decompression; only the
+///   eventID chunks are re-encoded when the eventIDs change,
+/// - the eventIDs are kept (duplicates are an error), offset per input by
+///   the largest eventID of the previous inputs plus one, or renumbered
+///   from 0 in the order of the events,
+/// - the event indices are merged into one index block per input; the rows
+///   after the last index block of an input (events left incomplete by a
+///   killed job) are dropped,
+/// - the run-level histograms of all inputs are summed.
+/// The output offsets of all inputs are computed first, so that the blocks
+/// are written in parallel with positional I/O.
+
+#include "ColumnarReader.hh"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include <unistd.h>
+
+namespace
+{
+  enum class EventIDMode { Keep, Offset, Renumber };
+
+  /// Merged output of one input file, prepared before writing
+  struct Part
+  {
+    ColumnarReader*                 reader = nullptr;
+    std::int64_t                    eventIDOffset = 0; ///< Offset mode
+    std::unordered_map<int, int>    eventIDMap;        ///< Renumber mode
+    std::vector<std::uint64_t>      rowOffsets;        ///< Per table, rows of the previous inputs
+    std::vector<std::uint64_t>      nofRows;           ///< Per table, indexed rows of the input
+    std::vector<std::size_t>        blocks;            ///< Row blocks of the input
+    std::vector<std::vector<char>>  headers;           ///< Encoded header of each row block
+    std::vector<int>                eventIDColumns;    ///< Re-encoded column, -1 if none
+    std::vector<std::vector<char>>  eventIDChunks;     ///< Re-encoded eventID payloads
+    std::vector<char>               indexBlock;
+    std::uint64_t                   size = 0;          ///< Bytes in the output
+    std::uint64_t                   offset = 0;        ///< Position in the output
+    std::string                     error;
+  };
+
+  void PrintUsage()
+  {
+    std::cerr << "Usage: acol_merge [-j threads] [-l level] [--eventids keep|offset|renumber]"
+              << std::endl
+              << "                  -o <output.acol> <input.acolset | input.acol> ..."
+              << std::endl;
+  }
+
+  // Run a task for the indices 0 .. n-1 on a pool of threads
+  template <typename Task>
+  void ParallelFor(std::size_t n, unsigned int nofThreads, Task task)
+  {
+    std::atomic<std::size_t> next(0);
+    std::vector<std::thread> threads;
+    for ( unsigned int i=0; i<std::min<std::size_t>(nofThreads, n); ++i ) {
+      threads.emplace_back([&next, n, &task]() {
+        for ( auto index = next++; index < n; index = next++ ) task(index);
+      });
+    }
+    for ( auto& thread : threads ) thread.join();
+  }
+
+  // Rows of each table covered by the event index; all rows if the file
+  // has no index
+  std::vector<std::uint64_t> IndexedRows(const ColumnarReader& reader)
+  {
+    auto nofTables = reader.GetSchema().size();
+    std::vector<std::uint64_t> nofRows(nofTables, 0);
+    for ( std::size_t t=0; t<nofTables; ++t ) {
+      if ( reader.GetNumberOfEvents() == 0 ) {
+        nofRows[t] = reader.GetNumberOfRows(int(t));
+        continue;
+      }
+      for ( std::size_t entry=0; entry<reader.GetNumberOfEvents(); ++entry ) {
+        auto rows = reader.GetEventRows(entry, int(t));
+        nofRows[t] = std::max(nofRows[t], rows.firstRow + rows.nofRows);
+      }
+    }
+    return nofRows;
+  }
+
+  int NewEventID(const Part& part, EventIDMode mode, int eventID)
+  {
+    switch ( mode ) {
+      case EventIDMode::Keep:     return eventID;
+      case EventIDMode::Offset:   return int(eventID + part.eventIDOffset);
+      case EventIDMode::Renumber: return part.eventIDMap.at(eventID);
+    }
+    return eventID;
+  }
+
+  // Encode the headers, the new eventID chunks and the index of one input
+  void Prepare(Part& part, EventIDMode mode, int level)
+  {
+    const auto& reader = *part.reader;
+    const auto& schema = reader.GetSchema();
+    const auto& blocks = reader.GetBlocks();
+
+    std::vector<int> eventIDColumns(schema.size(), -1);
+    if ( mode != EventIDMode::Keep ) {
+      for ( std::size_t t=0; t<schema.size(); ++t ) {
+        eventIDColumns[t] = ColumnarFormat::FindColumn(schema[t], "eventID");
+      }
+    }
+
+    std::vector<char> data;
+    for ( std::size_t i=0; i<blocks.size(); ++i ) {
+      if ( blocks[i].header.kind != ColumnarFormat::BlockKind::Rows ) continue;
+      if ( blocks[i].firstRow >= part.nofRows[blocks[i].header.table] ) continue;
+
+      auto header = blocks[i].header;
+      auto columnId = eventIDColumns[header.table];
+      std::vector<char> chunk;
+      if ( columnId >= 0 ) {
+        if ( ! reader.ReadChunk(blocks[i], columnId, data) ) {
+          part.error = "cannot read eventID chunk";
+          return;
+        }
+        for ( std::size_t row=0; row<header.nofRows; ++row ) {
+          std::int32_t eventID;
+          std::memcpy(&eventID, data.data() + 4*row, 4);
+          eventID = NewEventID(part, mode, eventID);
+          std::memcpy(data.data() + 4*row, &eventID, 4);
+        }
+        auto& stored = header.chunks[columnId];
+        auto codec = ( stored.codec == ColumnarFormat::Codec::None )
+                     ? ColumnarFormat::Codec::None : ColumnarFormat::Codec::Zlib;
+        stored.codec = ColumnarFormat::Encode(codec, level, data.data(), data.size(), chunk);
+        stored.storedSize = chunk.size();
+      }
+
+      std::vector<char> encodedHeader;
+      ColumnarFormat::EncodeBlockHeader(header, encodedHeader);
+      part.size += encodedHeader.size();
+      for ( const auto& stored : header.chunks ) part.size += stored.storedSize;
+
+      part.blocks.push_back(i);
+      part.headers.push_back(std::move(encodedHeader));
+      part.eventIDColumns.push_back(columnId);
+      part.eventIDChunks.push_back(std::move(chunk));
+    }
+
+    // Index of the input, shifted to the rows of the output
+    auto nofEvents = reader.GetNumberOfEvents();
+    if ( nofEvents == 0 ) return;
+
+    std::vector<std::vector<char>> columns(1 + 2*schema.size());
+    columns[0].resize(nofEvents*sizeof(std::int32_t));
+    for ( std::size_t t=0; t<schema.size(); ++t ) {
+      columns[1 + 2*t].resize(nofEvents*sizeof(std::uint64_t));
+      columns[2 + 2*t].resize(nofEvents*sizeof(std::uint32_t));
+    }
+    for ( std::size_t entry=0; entry<nofEvents; ++entry ) {
+      std::int32_t eventID = NewEventID(part, mode, reader.GetEventID(entry));
+      std::memcpy(columns[0].data() + 4*entry, &eventID, 4);
+      for ( std::size_t t=0; t<schema.size(); ++t ) {
+        auto rows = reader.GetEventRows(entry, int(t));
+        std::uint64_t firstRow = rows.firstRow + part.rowOffsets[t];
+        auto nofRows = std::uint32_t(rows.nofRows);
+        std::memcpy(columns[1 + 2*t].data() + 8*entry, &firstRow, 8);
+        std::memcpy(columns[2 + 2*t].data() + 4*entry, &nofRows, 4);
+      }
+    }
+    ColumnarFormat::BlockHeader header;
+    header.kind = ColumnarFormat::BlockKind::Index;
+    header.table = std::uint32_t(schema.size());
+    header.nofRows = std::uint32_t(nofEvents);
+    ColumnarFormat::EncodeBlock(header, columns, ColumnarFormat::Codec::Zlib, level,
+                                part.indexBlock);
+    part.size += part.indexBlock.size();
+  }
+
+  bool WriteAt(int descriptor, const char* data, std::uint64_t size, std::uint64_t offset)
+  {
+    std::uint64_t done = 0;
+    while ( done < size ) {
+      auto nofBytes = ::pwrite(descriptor, data + done, size - done, off_t(offset + done));
+      if ( nofBytes <= 0 ) return false;
+      done += std::uint64_t(nofBytes);
+    }
+    return true;
+  }
+
+  // Copy the blocks of one input to its place in the output
+  void Write(Part& part, int descriptor)
+  {
+    const auto& blocks = part.reader->GetBlocks();
+    auto offset = part.offset;
+    std::vector<char> payload, data;
+
+    for ( std::size_t i=0; i<part.blocks.size(); ++i ) {
+      const auto& block = blocks[part.blocks[i]];
+      if ( ! part.reader->ReadStoredBlock(block, payload) ) {
+        part.error = "cannot read block";
+        return;
+      }
+
+      data = part.headers[i];
+      auto columnId = part.eventIDColumns[i];
+      if ( columnId < 0 ) {
+        data.insert(data.end(), payload.begin(), payload.end());
+      }
+      else {
+        // Splice the new eventID chunk into the stored payloads
+        auto begin = block.offsets[columnId] - block.offsets[0];
+        auto end = begin + block.header.chunks[columnId].storedSize;
+        data.insert(data.end(), payload.begin(), payload.begin() + begin);
+        data.insert(data.end(), part.eventIDChunks[i].begin(), part.eventIDChunks[i].end());
+        data.insert(data.end(), payload.begin() + end, payload.end());
+      }
+
+      if ( ! WriteAt(descriptor, data.data(), data.size(), offset) ) {
+        part.error = "cannot write output";
+        return;
+      }
+      offset += data.size();
+    }
+
+    if ( ! WriteAt(descriptor, part.indexBlock.data(), part.indexBlock.size(), offset) ) {
+      part.error = "cannot write output";
+    }
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+int main(int argc, char** argv)
+{
+  auto start = std::chrono::steady_clock::now();
+
+  // Options
+  unsigned int nofThreads = std::max(1u, std::thread::hardware_concurrency());
+  int level = 1;
+  auto mode = EventIDMode::Keep;
+  std::string outputName;
+  std::vector<std::string> inputNames;
+  for ( int i=1; i<argc; ++i ) {
+    std::string arg = argv[i];
+    if ( arg == "-j" && i+1 < argc ) {
+      nofThreads = unsigned(std::max(1, std::atoi(argv[++i])));
+    }
+    else if ( arg == "-l" && i+1 < argc ) {
+      level = std::atoi(argv[++i]);
+    }
+    else if ( arg == "-o" && i+1 < argc ) {
+      outputName = argv[++i];
+    }
+    else if ( arg == "--eventids" && i+1 < argc ) {
+      std::string value = argv[++i];
+      if ( value == "keep" )          mode = EventIDMode::Keep;
+      else if ( value == "offset" )   mode = EventIDMode::Offset;
+      else if ( value == "renumber" ) mode = EventIDMode::Renumber;
+      else {
+        PrintUsage();
+        return 1;
+      }
+    }
+    else if ( ! arg.empty() && arg[0] == '-' ) {
+      PrintUsage();
+      return 1;
+    }
+    else {
+      const auto& extension = ColumnarFormat::kManifestExtension;
+      if ( arg.size() > extension.size()
+           && arg.compare(arg.size() - extension.size(), extension.size(), extension) == 0 ) {
+        std::vector<std::string> fileNames;
+        if ( ! ColumnarFormat::ReadManifest(arg, fileNames) ) {
+          std::cerr << "Cannot read manifest " << arg << std::endl;
+          return 1;
+        }
+        inputNames.insert(inputNames.end(), fileNames.begin(), fileNames.end());
+      }
+      else {
+        inputNames.push_back(arg);
+      }
+    }
+  }
+  if ( outputName.empty() || inputNames.empty() ) {
+    PrintUsage();
+    return 1;
+  }
+
+  // Scan the inputs
+  std::vector<ColumnarReader> readers(inputNames.size());
+  std::vector<char> opened(inputNames.size(), 0);
+  ParallelFor(inputNames.size(), nofThreads, [&](std::size_t i) {
+    opened[i] = readers[i].Open(inputNames[i]);
+  });
+
+  const auto& schema = readers[0].GetSchema();
+  for ( std::size_t i=0; i<readers.size(); ++i ) {
+    if ( ! opened[i] ) {
+      std::cerr << "Cannot open " << inputNames[i] << std::endl;
+      return 1;
+    }
+    if ( ! ColumnarFormat::SameSchema(readers[i].GetSchema(), schema) ) {
+      std::cerr << "Schema of " << inputNames[i] << " differs from the one of "
+                << inputNames[0] << std::endl;
+      return 1;
+    }
+    if ( readers[i].IsTruncated() ) {
+      std::cerr << "Warning: " << inputNames[i]
+                << " is truncated, merged up to its last complete block" << std::endl;
+    }
+    if ( mode != EventIDMode::Keep && readers[i].GetNumberOfEvents() == 0
+         && readers[i].GetNumberOfRows(0) > 0 ) {
+      std::cerr << "Cannot change the eventIDs of " << inputNames[i]
+                << ": no event index" << std::endl;
+      return 1;
+    }
+  }
+
+  // Event and row offsets of each input
+  std::vector<Part> parts(readers.size());
+  std::vector<std::uint64_t> rowOffsets(schema.size(), 0);
+  std::uint64_t nofDroppedRows = 0;
+  std::int64_t nextEventID = 0;
+  std::unordered_set<int> eventIDs;
+  for ( std::size_t i=0; i<readers.size(); ++i ) {
+    auto& part = parts[i];
+    part.reader = &readers[i];
+    part.rowOffsets = rowOffsets;
+    part.nofRows = IndexedRows(readers[i]);
+    for ( std::size_t t=0; t<schema.size(); ++t ) {
+      rowOffsets[t] += part.nofRows[t];
+      nofDroppedRows += readers[i].GetNumberOfRows(int(t)) - part.nofRows[t];
+    }
+
+    std::int64_t maxEventID = -1;
+    for ( std::size_t entry=0; entry<readers[i].GetNumberOfEvents(); ++entry ) {
+      auto eventID = readers[i].GetEventID(entry);
+      maxEventID = std::max<std::int64_t>(maxEventID, eventID);
+      if ( mode == EventIDMode::Renumber ) {
+        part.eventIDMap.emplace(eventID, int(nextEventID + part.eventIDMap.size()));
+      }
+      else if ( mode == EventIDMode::Keep && ! eventIDs.insert(eventID).second ) {
+        std::cerr << "Event " << eventID << " of " << inputNames[i] << " is already in "
+                  << "a previous input; use --eventids offset or renumber" << std::endl;
+        return 1;
+      }
+    }
+    part.eventIDOffset = nextEventID;
+    if ( mode == EventIDMode::Offset )   nextEventID += maxEventID + 1;
+    if ( mode == EventIDMode::Renumber ) nextEventID += part.eventIDMap.size();
+    if ( nextEventID > INT_MAX ) {
+      std::cerr << "The eventIDs exceed the range of the eventID column" << std::endl;
+      return 1;
+    }
+  }
+
+  // Prepare the headers, then place the inputs one after the other
+  ParallelFor(parts.size(), nofThreads, [&](std::size_t i) {
+    try {
+      Prepare(parts[i], mode, level);
+    }
+    catch ( const std::out_of_range& ) {
+      parts[i].error = "eventID missing in the event index";
+    }
+  });
+
+  auto file = std::fopen(outputName.c_str(), "wb");
+  if ( ! file || ! ColumnarFormat::WriteFileHeader(file, schema) || std::fflush(file) != 0 ) {
+    std::cerr << "Cannot write " << outputName << std::endl;
+    return 1;
+  }
+  auto offset = std::uint64_t(std::ftell(file));
+  for ( auto& part : parts ) {
+    part.offset = offset;
+    offset += part.size;
+  }
+
+  ParallelFor(parts.size(), nofThreads, [&](std::size_t i) {
+    if ( parts[i].error.empty() ) Write(parts[i], fileno(file));
+  });
+  for ( std::size_t i=0; i<parts.size(); ++i ) {
+    if ( ! parts[i].error.empty() ) {
+      std::cerr << inputNames[i] << ": " << parts[i].error << std::endl;
+      std::fclose(file);
+      return 1;
+    }
+  }
+
+  // Run-level histograms, summed over the inputs
+  std::vector<ColumnarFormat::Histogram> histograms;
+  for ( std::size_t i=0; i<readers.size(); ++i ) {
+    if ( ! ColumnarFormat::MergeHistograms(histograms, readers[i].GetHistograms()) ) {
+      std::cerr << "Histograms of " << inputNames[i] << " do not match the previous inputs"
+                << std::endl;
+      std::fclose(file);
+      return 1;
+    }
+  }
+  std::vector<char> data;
+  for ( const auto& histogram : histograms ) {
+    std::vector<std::vector<char>> columns(3);
+    columns[0].assign(histogram.name.begin(), histogram.name.end());
+    auto binning = reinterpret_cast<const char*>(histogram.binning.data());
+    columns[1].assign(binning, binning + histogram.binning.size()*sizeof(double));
+    auto contents = reinterpret_cast<const char*>(histogram.contents.data());
+    columns[2].assign(contents, contents + histogram.contents.size()*sizeof(double));
+
+    ColumnarFormat::BlockHeader header;
+    header.kind = ColumnarFormat::BlockKind::Histogram;
+    header.table = 0;
+    header.nofRows = std::uint32_t(histogram.contents.size());
+    ColumnarFormat::EncodeBlock(header, columns, ColumnarFormat::Codec::Zlib, level, data);
+  }
+  if ( ! WriteAt(fileno(file), data.data(), data.size(), offset) ) {
+    std::cerr << "Cannot write " << outputName << std::endl;
+    std::fclose(file);
+    return 1;
+  }
+  offset += data.size();
+  std::fclose(file);
+
+  // Summary
+  std::size_t nofBlocks = 0;
+  std::size_t nofReencoded = 0;
+  std::size_t nofEvents = 0;
+  for ( const auto& part : parts ) {
+    nofBlocks += part.blocks.size();
+    for ( auto columnId : part.eventIDColumns ) nofReencoded += ( columnId >= 0 );
+    nofEvents += part.reader->GetNumberOfEvents();
+  }
+  auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  std::cout << "Merged " << readers.size() << " inputs into " << outputName << ": "
+            << nofEvents << " events, " << offset*1.e-6 << " MB" << std::endl
+            << "  row blocks: " << nofBlocks << " (" << nofBlocks - nofReencoded
+            << " copied as stored, " << nofReencoded << " with new eventIDs)" << std::endl;
+  for ( std::size_t t=0; t<schema.size(); ++t ) {
+    std::cout << "  " << schema[t].name << ": " << rowOffsets[t] << " rows" << std::endl;
+  }
+  if ( nofDroppedRows > 0 ) {
+    std::cout << "  dropped: " << nofDroppedRows << " rows of incomplete events" << std::endl;
+  }
+  std::cout << "  histograms: " << histograms.size() << std::endl
+            << "  time: " << seconds << " s with " << nofThreads << " threads ("
+            << offset*1.e-6/seconds << " MB/s)" << std::endl;
+
+  return 0;
+}
@@ -0,0 +1,101 @@
+/// \file aslib_info.cc
+/// \brief Print the content of a shower library
+///
+/// Usage: aslib_info <file.aslib> [--bins]
+///
+/// Prints the detector, lattice and binning of the library, and per
+/// particle and energy bin the number of showers and filled bins, the
+/// spots per shower and the mean and RMS of the active and total deposits
+/// relative to the particle energy. With --bins, also prints the number of
+/// showers of each filled bin.
+
+#include "ShowerLibraryFormat.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <string>
+
+int main(int argc, char** argv)
+{
+  if ( argc != 2 && ! ( argc == 3 && std::string(argv[2]) == "--bins" ) ) {
+    std::cerr << "Usage: aslib_info <file.aslib> [--bins]" << std::endl;
+    return 1;
+  }
+
+  ShowerLibraryFormat::MappedLibrary library;
+  if ( ! library.Open(argv[1]) ) {
+    std::cerr << "Cannot open " << argv[1]
+              << " (missing file or not a shower library)" << std::endl;
+    return 1;
+  }
+
+  const auto& header = library.GetHeader();
+  const auto& binning = library.GetBinning();
+  const auto& lattice = header.lattice;
+  std::cout << "Detector: " << ShowerLibraryFormat::GetDetectorName(header.detector)
+            << std::endl
+            << "Lattice: a1 (" << lattice.a1[0] << ", " << lattice.a1[1] << ") a2 ("
+            << lattice.a2[0] << ", " << lattice.a2[1] << ") pitch z " << lattice.pitchZ
+            << ", z from " << lattice.zMin << " to " << lattice.zMax << " mm" << std::endl
+            << "Binning: " << binning.nofEnergies << " energies from " << binning.minEnergy
+            << " to " << binning.maxEnergy << " MeV, " << binning.nofCosTheta
+            << " cos theta, " << binning.nofPhi << " phi, phases " << binning.nofPhases[0]
+            << " x " << binning.nofPhases[1] << " x " << binning.nofPhases[2] << std::endl
+            << "Showers: " << header.nofShowers << ", spots: " << header.nofSpots
+            << ", size: " << library.GetFileSize() << " bytes" << std::endl;
+
+  auto nofCells = binning.GetNumberOfCells();
+  auto cellsPerEnergy = nofCells/binning.nofEnergies;
+  std::printf("particle  energy bin [MeV]    showers  filled bins  spots/shower"
+              "  active/E (rms)     total/E (rms)\n");
+  for ( std::uint32_t particle=0; particle<header.nofParticles; ++particle ) {
+    for ( std::uint32_t energyBin=0; energyBin<binning.nofEnergies; ++energyBin ) {
+      double nofShowers = 0.;
+      double nofSpots = 0.;
+      double active[2] = { 0., 0. };
+      double total[2] = { 0., 0. };
+      std::size_t nofFilled = 0;
+      for ( std::size_t i=0; i<cellsPerEnergy; ++i ) {
+        const auto& bin = library.GetBin(particle*nofCells + energyBin*cellsPerEnergy + i);
+        if ( bin.nofShowers > 0 ) ++nofFilled;
+        for ( std::uint64_t s=0; s<bin.nofShowers; ++s ) {
+          const auto& shower = library.GetShower(bin.firstShower + s);
+          auto activeFraction = shower.edepActive/shower.energy;
+          auto totalFraction = shower.edepTotal/shower.energy;
+          nofShowers += 1.;
+          nofSpots += shower.nofSpots;
+          active[0] += activeFraction;
+          active[1] += activeFraction*activeFraction;
+          total[0] += totalFraction;
+          total[1] += totalFraction*totalFraction;
+        }
+      }
+      if ( nofShowers == 0. ) continue;
+
+      auto rms = [nofShowers](const double sums[2]) {
+        auto mean = sums[0]/nofShowers;
+        return std::sqrt(std::max(sums[1]/nofShowers - mean*mean, 0.));
+      };
+      std::printf("%8d  %7.4g - %-7.4g %10.0f %6zu/%-6zu %12.1f  %7.4f (%6.4f)  %7.4f (%6.4f)\n",
+                  library.GetPDGCode(particle), binning.GetEnergyLowEdge(energyBin),
+                  binning.GetEnergyLowEdge(energyBin + 1), nofShowers, nofFilled,
+                  cellsPerEnergy, nofSpots/nofShowers, active[0]/nofShowers, rms(active),
+                  total[0]/nofShowers, rms(total));
+    }
+  }
+
+  if ( argc == 3 ) {
+    std::cout << "Filled bins (particle, cell: showers):" << std::endl;
+    for ( std::uint32_t particle=0; particle<header.nofParticles; ++particle ) {
+      for ( std::size_t cell=0; cell<nofCells; ++cell ) {
+        const auto& bin = library.GetBin(particle*nofCells + cell);
+        if ( bin.nofShowers == 0 ) continue;
+        std::cout << "  " << library.GetPDGCode(particle) << ", " << cell << ": "
+                  << bin.nofShowers << std::endl;
+      }
+    }
+  }
+  return 0;
+}
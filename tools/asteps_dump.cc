@@ -0,0 +1,103 @@
+/// \file asteps_dump.cc
+/// \brief Print the content of a step file
+///
+/// Usage: asteps_dump <file.asteps> [eventID]
+///
+/// Prints the grid, the number of blocks, events and steps of the file and
+/// the steps per event. With an eventID, prints the steps of that event
+/// in physical units, one per line: x, y, z [mm], time [ns], energy
+/// deposit [keV], PDG code, trackID, ECal block and fiber or absorber.
+
+#include "StepFormat.hh"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+int main(int argc, char** argv)
+{
+  if ( argc != 2 && argc != 3 ) {
+    std::cerr << "Usage: asteps_dump <file.asteps> [eventID]" << std::endl;
+    return 1;
+  }
+  auto printEvent = ( argc == 3 );
+  auto eventID = printEvent ? std::atoi(argv[2]) : -1;
+
+  auto file = std::fopen(argv[1], "rb");
+  StepFormat::Grid grid;
+  if ( ! file || ! StepFormat::ReadFileHeader(file, grid) ) {
+    std::cerr << "Cannot read " << argv[1] << std::endl;
+    if ( file ) std::fclose(file);
+    return 1;
+  }
+
+  std::uint64_t nofBlocks = 0, nofEvents = 0, nofSteps = 0, nofDropped = 0;
+  std::uint64_t maxSteps = 0;
+  auto found = false;
+  auto blocksEnd = std::ftell(file);
+  std::vector<char> payload;
+  StepFormat::Event event;
+  std::uint32_t nofBlockEvents = 0;
+  while ( StepFormat::ReadBlock(file, nofBlockEvents, payload) ) {
+    ++nofBlocks;
+    blocksEnd = std::ftell(file);
+    const char* data = payload.data();
+    const char* end = data + payload.size();
+    for ( std::uint32_t i=0; i<nofBlockEvents; ++i ) {
+      if ( ! StepFormat::DecodeEvent(data, end, event) ) {
+        std::cerr << "Corrupted block " << nofBlocks - 1 << std::endl;
+        std::fclose(file);
+        return 1;
+      }
+      ++nofEvents;
+      nofSteps += event.steps.size();
+      nofDropped += event.nofDropped;
+      maxSteps = std::max<std::uint64_t>(maxSteps, event.steps.size());
+
+      if ( ! printEvent || event.eventID != eventID ) continue;
+      found = true;
+      std::cout << "Event " << event.eventID << ": " << event.steps.size() << " steps";
+      if ( event.nofDropped > 0 ) std::cout << ", " << event.nofDropped << " dropped";
+      std::cout << std::endl
+                << "       x[mm]       y[mm]       z[mm]     t[ns]  edep[keV]"
+                << "        pdg  trackID  block   volume" << std::endl;
+      for ( const auto& step : event.steps ) {
+        std::cout << std::fixed << std::setprecision(3)
+                  << std::setw(12) << step.x*grid.transverse
+                  << std::setw(12) << step.y*grid.transverse
+                  << std::setw(12) << step.z*grid.longitudinal
+                  << std::setw(10) << step.time*grid.time
+                  << std::setw(11) << step.edep*grid.energy*1.e3
+                  << std::setw(11) << step.pdg
+                  << std::setw(9)  << step.trackID
+                  << "    " << StepFormat::VolumeBlockX(step.volume)
+                  << " " << StepFormat::VolumeBlockY(step.volume)
+                  << "  " << ( StepFormat::IsAbsorberVolume(step.volume) ? "absorber" : "fiber" )
+                  << std::endl;
+      }
+    }
+  }
+  // Anything left after the last complete block was cut by a killed writer
+  std::fseek(file, 0, SEEK_END);
+  auto truncated = std::ftell(file) != blocksEnd;
+  std::fclose(file);
+
+  if ( printEvent ) {
+    if ( ! found ) std::cout << "Event " << eventID << " not in the file" << std::endl;
+    return found ? 0 : 1;
+  }
+
+  std::cout << "Grid: " << grid.transverse << " mm (x, y), " << grid.longitudinal
+            << " mm (z), " << grid.time << " ns, " << grid.energy*1.e6 << " eV" << std::endl
+            << "Blocks: " << nofBlocks << ( truncated ? " (truncated)" : "" ) << std::endl
+            << "Events: " << nofEvents << std::endl
+            << "Steps: " << nofSteps << ", at most " << maxSteps << " per event";
+  if ( nofEvents > 0 ) std::cout << ", " << double(nofSteps)/nofEvents << " on average";
+  std::cout << std::endl;
+  if ( nofDropped > 0 ) {
+    std::cout << "Dropped: " << nofDropped << " steps beyond the per-event limit" << std::endl;
+  }
+  return 0;
+}